@@ -0,0 +1,83 @@
+#
+#  Announcement throughput of the JSON-RPC TCP server.
+#
+#  Connects a number of listening clients to a running server, then has one more client fire
+#  JSONRPC.NotifyAll requests as fast as the server answers them (keeping a window of requests
+#  in flight) and counts the notifications every listener receives.
+#
+#    sent      - NotifyAll requests answered per second
+#    delivered - notifications received per second, summed over the listeners
+#    lag       - notifications the slowest listener had not received when sending stopped
+#
+#  usage: python NotificationLoad.py [host] [port] [listeners] [seconds]
+#
+
+from __future__ import print_function
+import json, select, socket, sys, time
+
+WINDOW = 32
+MESSAGE = "NotificationLoad"
+
+def connect(host, port):
+  s = socket.create_connection((host, port))
+  s.setblocking(False)
+  return s
+
+def main():
+  host = sys.argv[1] if len(sys.argv) > 1 else "127.0.0.1"
+  port = int(sys.argv[2]) if len(sys.argv) > 2 else 9090
+  count = int(sys.argv[3]) if len(sys.argv) > 3 else 100
+  seconds = float(sys.argv[4]) if len(sys.argv) > 4 else 10
+
+  listeners = [connect(host, port) for i in range(count)]
+  received = dict((s, 0) for s in listeners)
+  tails = dict((s, b"") for s in listeners)
+  driver = connect(host, port)
+  marker = MESSAGE.encode()
+
+  def request(id):
+    return json.dumps({"jsonrpc": "2.0", "method": "JSONRPC.NotifyAll", "id": id,
+                       "params": {"sender": "load", "message": MESSAGE, "data": {"id": id}}}).encode()
+
+  sent = answered = 0
+  pending = b""
+  start = time.time()
+  stop = start + seconds
+  drain = stop + 5
+  while time.time() < drain:
+    sending = time.time() < stop
+    while sending and sent - answered < WINDOW:
+      sent += 1
+      pending += request(sent)
+    if pending:
+      try:
+        pending = pending[driver.send(pending):]
+      except socket.error:
+        pass
+
+    readable = select.select(listeners + [driver], [], [], 0.1)[0]
+    for s in readable:
+      data = s.recv(65536)
+      if not data:
+        print("server closed a connection")
+        return 1
+      if s is driver:
+        answered += data.count(b'"result"')
+        continue
+      # count the marker, minding one split across reads
+      data = tails[s] + data
+      received[s] += data.count(marker)
+      tails[s] = data[-(len(marker) - 1):]
+
+    if not sending and min(received.values()) >= answered:
+      break
+
+  elapsed = min(time.time(), stop) - start
+  delivered = sum(received.values())
+  print("%10s %12s %14s %8s" % ("listeners", "sent/s", "delivered/s", "lag"))
+  print("%10i %12.0f %14.0f %8i" % (count, answered / elapsed, delivered / (time.time() - start),
+                                    answered - min(received.values())))
+  return 0
+
+if __name__ == "__main__":
+  sys.exit(main())
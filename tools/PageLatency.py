@@ -0,0 +1,144 @@
+#
+#  Page latency of the JSON-RPC AudioLibrary listings against library size.
+#
+#  Builds a synthetic music database with the tables, indexes and songview of
+#  MusicDatabase.cpp, then times fetching one page of songs sorted by title:
+#
+#    full    - the whole listing loaded and sorted in memory, then sliced
+#              (how AudioLibrary.GetSongs used to page)
+#    offset  - sorted and limited by the database (limit/offset)
+#    keyset  - the page after the previous one, carrying on from its last row
+#
+#  Before timing, it pages through a listing sorted on a column with NULLs
+#  (lastplayed) and one sorted on mixed case titles both ways, as
+#  CMusicDatabase::GetPageClause() does, and checks that the pages hold every
+#  row of the listing in order, titles regardless of case.
+#
+#  usage: python PageLatency.py [songs ...]
+#
+
+from __future__ import print_function
+import random, sqlite3, sys, time
+
+PAGE = 50
+RUNS = 5
+
+def create(songs):
+  db = sqlite3.connect(":memory:")
+  db.executescript("""
+    CREATE TABLE artist (idArtist integer primary key, strArtist varchar(256));
+    CREATE TABLE genre (idGenre integer primary key, strGenre text);
+    CREATE TABLE path (idPath integer primary key, strPath varchar(512));
+    CREATE TABLE pfcfile (idPFCFile integer primary key, idPath integer, strFileName text);
+    CREATE TABLE album (idAlbum integer primary key, strAlbum varchar(256), idArtist integer, idGenre integer, idPFCFile integer, iYear integer);
+    CREATE TABLE song (idSong integer primary key, idAlbum integer, idPath integer, idArtist integer, idGenre integer,
+                       strTitle varchar(512), iTrack integer, iDuration integer, iYear integer, strFileName text,
+                       iTimesPlayed integer, lastplayed varchar(20), rating char);
+    CREATE INDEX idxSong ON song(strTitle);
+    CREATE INDEX idxSongTitleNoCase ON song(strTitle COLLATE NOCASE);
+    CREATE INDEX idxSong3 ON song(idAlbum);
+    CREATE INDEX idxSong4 ON song(idArtist);
+    CREATE INDEX idxSong5 ON song(idGenre);
+    CREATE VIEW songview AS SELECT song.idSong AS idSong, song.idArtist AS idArtist, song.idAlbum AS idAlbum,
+                       strArtist, strAlbum, iTrack, strTitle, iDuration, path.strPath || pfcfile.strFileName AS strPath,
+                       song.strFileName, song.iYear AS iYear, iTimesPlayed, lastplayed, rating, song.idGenre AS idGenre, strGenre
+                     FROM song
+                     JOIN album ON song.idAlbum=album.idAlbum
+                     JOIN artist ON song.idArtist=artist.idArtist
+                     JOIN pfcfile ON album.idPFCFile=pfcfile.idPFCFile
+                     JOIN path ON pfcfile.idPath=path.idPath
+                     JOIN genre ON song.idGenre=genre.idGenre;
+  """)
+  albums = max(1, songs // 12)
+  db.execute("INSERT INTO path VALUES (1, '/media/music/')")
+  db.executemany("INSERT INTO genre VALUES (?, ?)", [(i, "Genre %i" % i) for i in range(1, 21)])
+  db.executemany("INSERT INTO artist VALUES (?, ?)", [(i, "Artist %i" % i) for i in range(1, albums // 3 + 2)])
+  db.executemany("INSERT INTO pfcfile VALUES (?, 1, ?)", [(i, "%i.pfc" % i) for i in range(1, albums + 1)])
+  db.executemany("INSERT INTO album VALUES (?, ?, ?, ?, ?, 2000)",
+                 [(i, "Album %i" % i, i // 3 + 1, i % 20 + 1, i) for i in range(1, albums + 1)])
+  random.seed(1)
+  db.executemany("INSERT INTO song VALUES (?, ?, 1, ?, ?, ?, ?, 200, 2000, ?, 0, NULL, '0')",
+                 [(i, i % albums + 1, (i % albums) // 3 + 1, i % 20 + 1, ("%08x" if i % 2 else "%08X") % random.getrandbits(32), i % 12 + 1, "%i.mp3" % i)
+                  for i in range(1, songs + 1)])
+  db.commit()
+  return db
+
+def timed(function):
+  best = None
+  for run in range(RUNS):
+    start = time.time()
+    function()
+    elapsed = time.time() - start
+    best = elapsed if best is None else min(best, elapsed)
+  return best * 1000
+
+def full(db, start):
+  rows = db.execute("select * from songview ORDER BY iTrack").fetchall()
+  rows.sort(key=lambda row: (row[6].lower(), row[0]))
+  return rows[start:start + PAGE]
+
+def offset(db, start):
+  return db.execute("select * from songview order by strTitle COLLATE NOCASE ASC, idSong ASC limit %i offset %i" % (PAGE, start)).fetchall()
+
+def keyset(db, start):
+  last = offset(db, start - PAGE)[-1]
+  return lambda: db.execute("select * from songview where (%s) order by strTitle COLLATE NOCASE ASC, idSong ASC limit %i"
+                            % (page_clause(TITLE, False), PAGE), (last[6], last[6], last[0])).fetchall()
+
+TITLE = "strTitle COLLATE NOCASE"
+
+def page_clause(column, descending):
+  # the keyset condition of CMusicDatabase::GetPageClause(), NULLs sorting first
+  after = "<" if descending else ">"
+  nulls = " or %s is null" % column.split()[0] if descending else ""
+  return "(%s %s ?%s or (%s = ? and idSong %s ?))" % (column, after, nulls, column, after)
+
+def check_paging(db, column, descending):
+  direction = "DESC" if descending else "ASC"
+  order = " order by %s %s, idSong %s" % (column, direction, direction)
+  listing = db.execute("select idSong, %s from songview%s" % (column, order)).fetchall()
+  pages = []
+  cursor = None
+  while len(pages) < len(listing):
+    if cursor is None:
+      page = db.execute("select idSong, %s from songview%s limit %i offset %i" % (column, order, PAGE, len(pages))).fetchall()
+    else:
+      page = db.execute("select idSong, %s from songview where %s%s limit %i" % (column, page_clause(column, descending), order, PAGE),
+                        (cursor[1], cursor[1], cursor[0])).fetchall()
+    assert page, "%s %s: page at %i is empty of %i rows" % (column, direction, len(pages), len(listing))
+    pages += page
+    # rows without a sort value set no cursor, the next page is fetched by offset
+    cursor = page[-1] if page[-1][1] is not None else None
+  assert pages == listing, "%s %s: pages don't hold the listing" % (column, direction)
+
+def check_nulls():
+  db = create(PAGE * 5)
+  # half the songs played, a few at the same time, so pages end both on and across NULLs and ties
+  db.execute("UPDATE song SET lastplayed = '2011-01-' || (10 + idSong % 7) WHERE idSong % 2 = 0")
+  for descending in (False, True):
+    check_paging(db, "lastplayed", descending)
+
+def check_case():
+  db = create(PAGE * 5)
+  for descending in (False, True):
+    check_paging(db, TITLE, descending)
+  # the order the listing had when it was sorted in memory
+  rows = db.execute("select * from songview").fetchall()
+  rows.sort(key=lambda row: (row[6].lower(), row[0]))
+  assert [row for start in range(0, len(rows), PAGE) for row in offset(db, start)] == rows
+
+def main():
+  check_nulls()
+  check_case()
+  sizes = [int(arg) for arg in sys.argv[1:]] or [1000, 10000, 60000]
+  print("%8s %8s %10s %10s %10s" % ("songs", "page at", "full ms", "offset ms", "keyset ms"))
+  for songs in sizes:
+    db = create(songs)
+    for start in (PAGE, songs // 2, songs - PAGE):
+      next_page = keyset(db, start)
+      assert next_page() == offset(db, start)
+      print("%8i %8i %10.2f %10.2f %10.2f" % (songs, start, timed(lambda: full(db, start)),
+            timed(lambda: offset(db, start)), timed(next_page)))
+
+if __name__ == "__main__":
+  main()
@@ -0,0 +1,87 @@
+#
+#  Text rendering cost while scrolling a track list.
+#
+#  Open a long track list (the catalogue's accented titles make the glyph cache work), then run
+#  this against the JSON-RPC TCP server. It samples every frame with the GUI control profiler,
+#  scrolls the list down and up for a while, and reports what the text controls took to render
+#  per frame, and what the whole window took.
+#
+#    text controls   - render time spent in the label, fadelabel and textbox controls themselves
+#    p50/p90/p99/max - render time of each window per frame, in us
+#
+#  Run it before and after a font change, on the same list and skin, to compare.
+#
+#  usage: python TextRenderLoad.py [host] [port] [seconds] [rows]
+#
+
+from __future__ import print_function
+import json, socket, sys, time
+
+TEXT_CONTROLS = ("label", "fadelabel", "textbox")
+
+class Client:
+  def __init__(self, host, port):
+    self.socket = socket.create_connection((host, port))
+    self.buffer = ""
+    self.decoder = json.JSONDecoder()
+    self.id = 0
+
+  def call(self, method, params=None):
+    self.id += 1
+    request = {"jsonrpc": "2.0", "method": method, "id": self.id}
+    if params is not None:
+      request["params"] = params
+    self.socket.sendall(json.dumps(request).encode())
+    while True:
+      # the server may send notifications before the answer
+      self.buffer = self.buffer.lstrip()
+      try:
+        message, end = self.decoder.raw_decode(self.buffer)
+      except ValueError:
+        data = self.socket.recv(65536)
+        if not data:
+          raise IOError("server closed the connection")
+        self.buffer += data.decode("utf-8")
+        continue
+      self.buffer = self.buffer[end:]
+      if message.get("id") == self.id:
+        if "error" in message:
+          raise IOError("%s: %s" % (method, message["error"]))
+        return message["result"]
+
+def is_text(stack):
+  control = stack.split(";")[-1]
+  return control.split("#")[0] in TEXT_CONTROLS
+
+def main():
+  host = sys.argv[1] if len(sys.argv) > 1 else "127.0.0.1"
+  port = int(sys.argv[2]) if len(sys.argv) > 2 else 9090
+  seconds = float(sys.argv[3]) if len(sys.argv) > 3 else 20
+  rows = int(sys.argv[4]) if len(sys.argv) > 4 else 200
+
+  client = Client(host, port)
+  client.call("XBMC.SetGUIProfiler", {"enabled": True, "interval": 1})
+  try:
+    # down through the list and back up, so new titles keep coming on screen
+    stop = time.time() + seconds
+    step = 0
+    while time.time() < stop:
+      client.call("Input.Down" if (step // rows) % 2 == 0 else "Input.Up")
+      step += 1
+      time.sleep(0.02)
+    profile = client.call("XBMC.GetGUIProfile")
+  finally:
+    client.call("XBMC.SetGUIProfiler", {"enabled": False})
+
+  frames = max(profile["frames"], 1)
+  text = sum(control["render"]["self"] for control in profile["controls"] if is_text(control["stack"]))
+  windows = [control for control in profile["controls"] if ";" not in control["stack"]]
+  print("%i sampled frames, %.0f us per frame in text controls" % (profile["frames"], text / float(frames)))
+  print("%-24s %8s %8s %8s %8s" % ("window render", "p50", "p90", "p99", "max"))
+  for window in windows:
+    render = window["render"]
+    print("%-24s %8i %8i %8i %8i" % (window["stack"], render["p50"], render["p90"], render["p99"], render["max"]))
+  return 0
+
+if __name__ == "__main__":
+  sys.exit(main())
@@ -0,0 +1,436 @@
+
+
+#include "AlbumArtAtlas.h"
+#include "FileItem.h"
+#include "TextureCache.h"
+#include "guilib/Texture.h"
+#include "guilib/DDSImage.h"
+#include "guilib/XBTF.h"
+#include "guilib/XBTFReader.h"
+#include "filesystem/File.h"
+#include "filesystem/Directory.h"
+#include "filesystem/SpecialProtocol.h"
+#include "settings/AdvancedSettings.h"
+#include "windowing/WindowingFactory.h"
+#include "threads/SingleLock.h"
+#include "utils/Crc32.h"
+#include "utils/EndianSwap.h"
+#include "utils/JobManager.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+#include "libsquish/squish.h"
+
+using namespace std;
+using namespace XFILE;
+
+#define ATLAS_PAGE_SIZE 2048
+#define ATLAS_GUTTER    1
+
+#define WRITE_STR(str, size, file) fwrite(str, size, 1, file)
+#define WRITE_U32(i, file) { uint32_t _n = Endian_SwapLE32(i); fwrite(&_n, 4, 1, file); }
+#define WRITE_U64(i, file) { uint64_t _n = i; _n = Endian_SwapLE64(i); fwrite(&_n, 8, 1, file); }
+
+static unsigned int GetCoverSize()
+{
+  // DXT blocks are 4x4, so keep the covers block aligned for the on-disk bundle
+  return ((unsigned int)g_advancedSettings.m_thumbSize + 3) & ~3;
+}
+
+static unsigned int GetCellSize()
+{
+  return GetCoverSize() + 2 * ATLAS_GUTTER;
+}
+
+static unsigned int GetPageSize()
+{
+  return min((unsigned int)ATLAS_PAGE_SIZE, g_Windowing.GetMaxTextureSize());
+}
+
+static unsigned int GetCellsPerRow()
+{
+  return GetPageSize() / GetCellSize();
+}
+
+static CStdString GetCoverName(const CStdString &cover)
+{
+  Crc32 crc;
+  crc.ComputeFromLowerCase(cover);
+  CStdString name;
+  name.Format("%08x", (unsigned int)crc);
+  return name;
+}
+
+CAlbumArtAtlasPage::CAlbumArtAtlasPage(const CStdString &key, const vector<CStdString> &covers)
+{
+  m_key = key;
+  m_covers = covers;
+  m_texture = NULL;
+  m_refCount = 0;
+  m_wanted = true;
+  m_jobID = 0;
+}
+
+CAlbumArtAtlasPage::~CAlbumArtAtlasPage()
+{
+  delete m_texture;
+}
+
+CAlbumArtAtlasJob::CAlbumArtAtlasJob(const CStdString &key, const vector<CStdString> &covers)
+{
+  m_key = key;
+  m_covers = covers;
+  m_texture = NULL;
+}
+
+CAlbumArtAtlasJob::~CAlbumArtAtlasJob()
+{
+  delete m_texture;
+}
+
+bool CAlbumArtAtlasJob::DoWork()
+{
+  m_texture = new CTexture(GetPageSize(), GetPageSize(), XB_FMT_A8R8G8B8);
+  memset(m_texture->GetPixels(), 0, m_texture->GetPitch() * m_texture->GetRows());
+
+  CStdString bundlePath = CTextureCache::GetCachedPath("atlas/" + m_key + ".xbt");
+  if (LoadBundle(bundlePath))
+    return true;
+
+  m_cells.clear();
+  memset(m_texture->GetPixels(), 0, m_texture->GetPitch() * m_texture->GetRows());
+  return BuildPage() && !m_cells.empty();
+}
+
+bool CAlbumArtAtlasJob::LoadBundle(const CStdString &bundlePath)
+{
+  CXBTFReader reader;
+  if (!reader.Open(CSpecialProtocol::TranslatePath(bundlePath)))
+    return false;
+
+  // a cover that has changed since the bundle was written means we rebuild
+  time_t bundleTime = reader.GetLastModificationTimestamp();
+  for (unsigned int i = 0; i < m_covers.size(); i++)
+  {
+    struct __stat64 st;
+    if (!m_covers[i].IsEmpty() && CFile::Stat(m_covers[i], &st) == 0 && st.st_mtime > bundleTime)
+      return false;
+  }
+
+  unsigned int pitch = m_texture->GetPitch();
+  unsigned int perRow = GetCellsPerRow();
+  vector<CXBTFFile> &files = reader.GetFiles();
+  for (vector<CXBTFFile>::iterator it = files.begin(); it != files.end(); ++it)
+  {
+    unsigned int cell = it->GetLoop();
+    if (cell >= m_covers.size() || GetCoverName(m_covers[cell]) != it->GetPath() || it->GetFrames().size() != 1)
+      return false;
+
+    const CXBTFFrame &frame = it->GetFrames()[0];
+    if (frame.GetWidth() > GetCoverSize() || frame.GetHeight() > GetCoverSize())
+      return false;
+
+    CAlbumArtAtlasPage::Cell rect;
+    rect.x = (cell % perRow) * GetCellSize() + ATLAS_GUTTER;
+    rect.y = (cell / perRow) * GetCellSize() + ATLAS_GUTTER;
+    rect.width = frame.GetWidth();
+    rect.height = frame.GetHeight();
+
+    unsigned char *blocks = new unsigned char[(size_t)frame.GetPackedSize()];
+    bool loaded = reader.Load(frame, blocks) &&
+                  CDDSImage::Decompress(m_texture->GetPixels() + rect.y * pitch + rect.x * 4, rect.width, rect.height, pitch, blocks, frame.GetFormat());
+    delete[] blocks;
+    if (!loaded)
+      return false;
+
+    m_cells[m_covers[cell]] = rect;
+  }
+  return !m_cells.empty();
+}
+
+bool CAlbumArtAtlasJob::BuildPage()
+{
+  unsigned int coverSize = GetCoverSize();
+  unsigned int pitch = m_texture->GetPitch();
+  vector<unsigned char*> blocks(m_covers.size(), (unsigned char *)NULL);
+
+  for (unsigned int i = 0; i < m_covers.size(); i++)
+  {
+    if (m_covers[i].IsEmpty() || URIUtils::GetExtension(m_covers[i]).Equals(".dds"))
+      continue;
+
+    CStdString loadPath = CTextureCache::Get().CheckAndCacheImage(m_covers[i], false);
+    if (loadPath.IsEmpty())
+      continue;
+
+    CTexture cover;
+    if (!cover.LoadFromFile(loadPath, coverSize, coverSize))
+      continue;
+
+    CAlbumArtAtlasPage::Cell rect;
+    PlaceCover(i, cover, rect);
+    m_cells[m_covers[i]] = rect;
+
+    // keep a DXT1 copy of the cell for the bundle - 1/8th the size of the raw pixels
+    int size = squish::GetStorageRequirements(rect.width, rect.height, squish::kDxt1);
+    blocks[i] = new unsigned char[size];
+    squish::CompressImage(m_texture->GetPixels() + rect.y * pitch + rect.x * 4, rect.width, rect.height, pitch,
+                          blocks[i], squish::kDxt1 | squish::kSourceBGRA);
+  }
+
+  CStdString bundlePath = CTextureCache::GetCachedPath("atlas/" + m_key + ".xbt");
+  if (!m_cells.empty() && !WriteBundle(bundlePath, blocks))
+    CLog::Log(LOGWARNING, "%s - unable to write atlas bundle %s", __FUNCTION__, bundlePath.c_str());
+
+  for (unsigned int i = 0; i < blocks.size(); i++)
+    delete[] blocks[i];
+  return true;
+}
+
+void CAlbumArtAtlasJob::PlaceCover(unsigned int cell, const CBaseTexture &cover, CAlbumArtAtlasPage::Cell &rect)
+{
+  unsigned int coverSize = GetCoverSize();
+  unsigned int perRow = GetCellsPerRow();
+  unsigned int srcWidth = cover.GetWidth();
+  unsigned int srcHeight = cover.GetHeight();
+
+  // fit within the cell, keeping aspect
+  rect.width = coverSize;
+  rect.height = coverSize;
+  if (srcWidth > srcHeight)
+    rect.height = max(1u, srcHeight * coverSize / srcWidth);
+  else if (srcHeight > srcWidth)
+    rect.width = max(1u, srcWidth * coverSize / srcHeight);
+  rect.x = (cell % perRow) * GetCellSize() + ATLAS_GUTTER;
+  rect.y = (cell / perRow) * GetCellSize() + ATLAS_GUTTER;
+
+  // box filter the cover into place (degenerates to point sampling when enlarging)
+  unsigned int srcPitch = cover.GetPitch();
+  unsigned int dstPitch = m_texture->GetPitch();
+  const unsigned char *src = cover.GetPixels();
+  unsigned char *dst = m_texture->GetPixels() + rect.y * dstPitch + rect.x * 4;
+  for (unsigned int y = 0; y < rect.height; y++)
+  {
+    unsigned int sy0 = y * srcHeight / rect.height;
+    unsigned int sy1 = max(sy0 + 1, (y + 1) * srcHeight / rect.height);
+    for (unsigned int x = 0; x < rect.width; x++)
+    {
+      unsigned int sx0 = x * srcWidth / rect.width;
+      unsigned int sx1 = max(sx0 + 1, (x + 1) * srcWidth / rect.width);
+      unsigned int sum[4] = { 0, 0, 0, 0 };
+      for (unsigned int sy = sy0; sy < sy1; sy++)
+      {
+        const unsigned char *s = src + sy * srcPitch + sx0 * 4;
+        for (unsigned int sx = sx0; sx < sx1; sx++, s += 4)
+        {
+          sum[0] += s[0]; sum[1] += s[1]; sum[2] += s[2]; sum[3] += s[3];
+        }
+      }
+      unsigned int count = (sy1 - sy0) * (sx1 - sx0);
+      unsigned char *d = dst + y * dstPitch + x * 4;
+      for (int c = 0; c < 4; c++)
+        d[c] = (unsigned char)(sum[c] / count);
+    }
+  }
+
+  // repeat the edges into the gutter so filtering doesn't pick up the neighbouring cell
+  for (unsigned int y = 0; y < rect.height; y++)
+  {
+    unsigned char *row = dst + y * dstPitch;
+    memcpy(row - 4, row, 4);
+    memcpy(row + rect.width * 4, row + (rect.width - 1) * 4, 4);
+  }
+  memcpy(dst - dstPitch - 4, dst - 4, (rect.width + 2) * 4);
+  memcpy(dst + rect.height * dstPitch - 4, dst + (rect.height - 1) * dstPitch - 4, (rect.width + 2) * 4);
+}
+
+bool CAlbumArtAtlasJob::WriteBundle(const CStdString &bundlePath, const vector<unsigned char*> &blocks)
+{
+  CXBTF xbtf;
+  for (unsigned int i = 0; i < m_covers.size(); i++)
+  {
+    if (!blocks[i])
+      continue;
+    const CAlbumArtAtlasPage::Cell &rect = m_cells[m_covers[i]];
+    CXBTFFrame frame;
+    frame.SetWidth(rect.width);
+    frame.SetHeight(rect.height);
+    frame.SetFormat(XB_FMT_DXT1);
+    frame.SetPackedSize(squish::GetStorageRequirements(rect.width, rect.height, squish::kDxt1));
+    frame.SetUnpackedSize(frame.GetPackedSize());
+    CXBTFFile file;
+    file.SetPath(GetCoverName(m_covers[i]));
+    file.SetLoop(i); // the cell the cover lives in
+    file.GetFrames().push_back(frame);
+    xbtf.GetFiles().push_back(file);
+  }
+
+  CDirectory::Create(URIUtils::GetParentPath(bundlePath));
+  FILE *file = fopen(CSpecialProtocol::TranslatePath(bundlePath).c_str(), "wb");
+  if (!file)
+    return false;
+
+  uint64_t offset = xbtf.GetHeaderSize();
+  WRITE_STR(XBTF_MAGIC, 4, file);
+  WRITE_STR(XBTF_VERSION, 1, file);
+  vector<CXBTFFile> &files = xbtf.GetFiles();
+  WRITE_U32(files.size(), file);
+  for (vector<CXBTFFile>::iterator it = files.begin(); it != files.end(); ++it)
+  {
+    WRITE_STR(it->GetPath(), 256, file);
+    WRITE_U32(it->GetLoop(), file);
+    WRITE_U32(1, file);
+    CXBTFFrame &frame = it->GetFrames()[0];
+    frame.SetOffset(offset);
+    offset += frame.GetPackedSize();
+    WRITE_U32(frame.GetWidth(), file);
+    WRITE_U32(frame.GetHeight(), file);
+    WRITE_U32(frame.GetFormat(true), file);
+    WRITE_U64(frame.GetPackedSize(), file);
+    WRITE_U64(frame.GetUnpackedSize(), file);
+    WRITE_U32(frame.GetDuration(), file);
+    WRITE_U64(frame.GetOffset(), file);
+  }
+  for (vector<CXBTFFile>::iterator it = files.begin(); it != files.end(); ++it)
+    fwrite(blocks[it->GetLoop()], 1, (size_t)it->GetFrames()[0].GetPackedSize(), file);
+
+  bool ok = !ferror(file);
+  fclose(file);
+  return ok;
+}
+
+CAlbumArtAtlas::CAlbumArtAtlas()
+{
+}
+
+CAlbumArtAtlas::~CAlbumArtAtlas()
+{
+}
+
+bool CAlbumArtAtlas::IsEnabled()
+{
+  return g_advancedSettings.m_guiAlbumArtAtlas;
+}
+
+unsigned int CAlbumArtAtlas::GetCoversPerPage()
+{
+  unsigned int perRow = GetCellsPerRow();
+  return perRow * perRow;
+}
+
+void CAlbumArtAtlas::Prefetch(const CFileItemList &items, int item)
+{
+  unsigned int perPage = GetCoversPerPage();
+  if (!perPage || item < 0)
+    return;
+
+  CSingleLock lock(m_section);
+  for (PageMap::iterator it = m_pages.begin(); it != m_pages.end(); ++it)
+    it->second->m_wanted = false;
+
+  // the page holding the selected item and the pages either side of it
+  int current = item / perPage;
+  for (int page = current - 1; page <= current + 1; page++)
+  {
+    if (page < 0 || page * perPage >= (unsigned int)items.Size())
+      continue;
+
+    vector<CStdString> covers;
+    CStdString allCovers;
+    allCovers.Format("%u:", GetCoverSize());
+    bool empty = true;
+    for (int i = page * perPage; i < items.Size() && i < (int)((page + 1) * perPage); i++)
+    {
+      CFileItemPtr pItem = items[i];
+      covers.push_back(pItem->HasThumbnail() ? pItem->GetThumbnailImage() : "");
+      allCovers += covers.back() + "|";
+      empty &= covers.back().IsEmpty();
+    }
+    if (empty)
+      continue;
+
+    CStdString key = GetCoverName(allCovers);
+    PageMap::iterator it = m_pages.find(key);
+    if (it != m_pages.end())
+    {
+      it->second->m_wanted = true;
+      continue;
+    }
+
+    CAlbumArtAtlasPage *atlasPage = new CAlbumArtAtlasPage(key, covers);
+    atlasPage->m_jobID = CJobManager::GetInstance().AddJob(new CAlbumArtAtlasJob(key, covers), this, CJob::PRIORITY_NORMAL);
+    m_pages.insert(make_pair(key, atlasPage));
+  }
+}
+
+bool CAlbumArtAtlas::GetImage(const CStdString &path, CTextureArray &texture)
+{
+  CSingleLock lock(m_section);
+  map<CStdString, CAlbumArtAtlasPage*>::iterator it = m_coverPages.find(path);
+  if (it == m_coverPages.end())
+    return false;
+
+  CAlbumArtAtlasPage *page = it->second;
+  const CAlbumArtAtlasPage::Cell &cell = page->m_cells[path];
+  texture.Reset();
+  texture.Set(page->m_texture, cell.width, cell.height);
+  texture.m_texOffsetX = cell.x;
+  texture.m_texOffsetY = cell.y;
+  page->m_refCount++;
+  return true;
+}
+
+void CAlbumArtAtlas::ReleaseImage(const CStdString &path)
+{
+  CSingleLock lock(m_section);
+  map<CStdString, CAlbumArtAtlasPage*>::iterator it = m_coverPages.find(path);
+  if (it != m_coverPages.end() && it->second->m_refCount)
+    it->second->m_refCount--;
+}
+
+void CAlbumArtAtlas::CleanupUnusedPages(bool immediately)
+{
+  CSingleLock lock(m_section);
+  PageMap::iterator it = m_pages.begin();
+  while (it != m_pages.end())
+  {
+    CAlbumArtAtlasPage *page = it->second;
+    if ((immediately || !page->m_wanted) && !page->m_refCount)
+    {
+      if (page->m_jobID)
+        CJobManager::GetInstance().CancelJob(page->m_jobID);
+      for (map<CStdString, CAlbumArtAtlasPage*>::iterator cover = m_coverPages.begin(); cover != m_coverPages.end(); )
+      {
+        if (cover->second == page)
+          m_coverPages.erase(cover++);
+        else
+          ++cover;
+      }
+      delete page;
+      m_pages.erase(it++);
+    }
+    else
+      ++it;
+  }
+}
+
+void CAlbumArtAtlas::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+{
+  CSingleLock lock(m_section);
+  CAlbumArtAtlasJob *atlasJob = (CAlbumArtAtlasJob *)job;
+  PageMap::iterator it = m_pages.find(atlasJob->m_key);
+  if (it == m_pages.end() || it->second->m_jobID != jobID)
+    return;
+
+  CAlbumArtAtlasPage *page = it->second;
+  page->m_jobID = 0;
+  if (!success)
+    return;
+
+  page->m_texture = atlasJob->m_texture;
+  atlasJob->m_texture = NULL; // the page owns it now, and jobs are auto-deleted.
+  page->m_cells = atlasJob->m_cells;
+
+  // a cover shown from another page keeps using that page until it is released
+  for (map<CStdString, CAlbumArtAtlasPage::Cell>::iterator cell = page->m_cells.begin(); cell != page->m_cells.end(); ++cell)
+    m_coverPages.insert(make_pair(cell->first, page));
+}
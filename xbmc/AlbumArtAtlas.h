@@ -0,0 +1,137 @@
+#pragma once
+
+
+
+#include <map>
+#include <vector>
+#include "threads/CriticalSection.h"
+#include "utils/Job.h"
+#include "guilib/TextureManager.h"
+
+class CFileItemList;
+
+/*!
+ \ingroup textures
+ \brief A single atlas page - a large texture holding a grid of album covers.
+
+ Covers are placed in fixed size cells (the thumb size plus a one pixel gutter that
+ repeats the cover's edge so that linear filtering doesn't bleed between neighbours).
+ */
+class CAlbumArtAtlasPage
+{
+public:
+  CAlbumArtAtlasPage(const CStdString &key, const std::vector<CStdString> &covers);
+  ~CAlbumArtAtlasPage();
+
+  struct Cell
+  {
+    unsigned int x;      ///< left of the cover within the page, in pixels
+    unsigned int y;      ///< top of the cover within the page, in pixels
+    unsigned int width;  ///< width of the cover (aspect is kept, so may be smaller than the cell)
+    unsigned int height; ///< height of the cover
+  };
+
+  CStdString             m_key;      ///< identifies the page on disk (hash of the covers it holds)
+  std::vector<CStdString> m_covers;  ///< cover paths in cell order, empty paths leave the cell blank
+  std::map<CStdString, Cell> m_cells;
+  CBaseTexture          *m_texture;  ///< the page texture, NULL until the page is built
+  unsigned int           m_refCount; ///< number of GUI textures currently drawing from this page
+  bool                   m_wanted;   ///< true while the page is the visible page or one of its neighbours
+  unsigned int           m_jobID;    ///< id of the build job while the page is being built
+};
+
+/*!
+ \ingroup textures,jobs
+ \brief Job that builds an atlas page
+
+ Loads the page from its XBT bundle in the thumbnails folder if it is up to date, otherwise
+ loads each cover at cell size, packs them into the page and writes the bundle for next time.
+ */
+class CAlbumArtAtlasJob : public CJob
+{
+public:
+  CAlbumArtAtlasJob(const CStdString &key, const std::vector<CStdString> &covers);
+  virtual ~CAlbumArtAtlasJob();
+
+  virtual const char* GetType() const { return "albumartatlas"; };
+  virtual bool DoWork();
+
+  CStdString    m_key;
+  std::vector<CStdString> m_covers;
+  std::map<CStdString, CAlbumArtAtlasPage::Cell> m_cells;
+  CBaseTexture *m_texture; ///< page texture, handed over to the atlas on completion
+private:
+  bool LoadBundle(const CStdString &bundlePath);
+  bool BuildPage();
+  bool WriteBundle(const CStdString &bundlePath, const std::vector<unsigned char*> &blocks);
+  void PlaceCover(unsigned int cell, const CBaseTexture &cover, CAlbumArtAtlasPage::Cell &rect);
+};
+
+/*!
+ \ingroup textures
+ \brief Packs the covers of the album wall into a few large textures.
+
+ The window showing the covers calls Prefetch() as the selection moves. The page of
+ covers around the selection and its neighbouring pages are built in the background, after
+ which GUI textures asking for one of those covers are handed the page texture along with
+ the offset of the cover inside it (see CTextureArray::m_texOffsetX).  Scrolling through
+ the wall then costs a single upload per page and the same bind for every cover on it,
+ rather than one load, upload and bind per cover.
+
+ \sa CGUILargeTextureManager, CGUITextureBase::AllocResources
+ */
+class CAlbumArtAtlas : public IJobCallback
+{
+public:
+  CAlbumArtAtlas();
+  virtual ~CAlbumArtAtlas();
+
+  /*!
+   \brief Whether atlas mode is enabled (<gui><albumartatlas> in advancedsettings.xml)
+   */
+  static bool IsEnabled();
+
+  /*!
+   \brief Make sure the pages around the given item are built, and let the others go.
+   \param items the list of items shown in the album wall.
+   \param item index of the selected item.
+   */
+  void Prefetch(const CFileItemList &items, int item);
+
+  /*!
+   \brief Retrieve a cover from an atlas page, if one holds it.
+   On success the page is referenced until ReleaseImage() is called.
+   \param path path of the cover image.
+   \param texture [out] the page texture, with offset and size of the cover inside it.
+   \return true if the cover is in a built page, false otherwise.
+   */
+  bool GetImage(const CStdString &path, CTextureArray &texture);
+
+  /*!
+   \brief Release a cover previously retrieved through GetImage().
+   \param path path of the cover image.
+   */
+  void ReleaseImage(const CStdString &path);
+
+  /*!
+   \brief Free pages that are no longer wanted nor referenced (called from app thread only)
+   \param immediately set to true to free every page regardless of whether it is wanted.
+   */
+  void CleanupUnusedPages(bool immediately = false);
+
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
+
+  /*!
+   \brief Number of covers held by a single page
+   */
+  static unsigned int GetCoversPerPage();
+
+private:
+  typedef std::map<CStdString, CAlbumArtAtlasPage*> PageMap;
+  PageMap m_pages;                                       ///< pages keyed by their covers hash
+  std::map<CStdString, CAlbumArtAtlasPage*> m_coverPages; ///< built page for each packed cover
+
+  CCriticalSection m_section;
+};
+
+extern CAlbumArtAtlas g_albumArtAtlas;
@@ -39,6 +39,7 @@
 #include "ApplicationMessenger.h"
 #include "SectionLoader.h"
 #include "cores/DllLoader/DllLoaderContainer.h"
+#include "cores/PlaybackTelemetry.h"
 #include "GUIUserMessages.h"
 #include "filesystem/DirectoryCache.h"
 #include "filesystem/StackDirectory.h"
@@ -56,6 +57,7 @@
 #include "utils/SystemInfo.h"
 #include "utils/TimeUtils.h"
 #include "GUILargeTextureManager.h"
+#include "AlbumArtAtlas.h"
 #include "TextureCache.h"
 #include "music/LastFmManager.h"
 #include "playlists/SmartPlayList.h"
@@ -780,6 +782,13 @@ bool CApplication::Create()
     m_splash->Show();
   }
 
+#ifdef IS_PROFESSIONAL
+  // the coin acceptor is bound to the coin builtins in the keymaps
+  CoinsManager::RegisterBuiltins();
+#endif
+  CPlaybackTelemetry::RegisterBuiltins();
+  CGUIControlProfiler::RegisterBuiltins();
+
   // The key mappings may already have been loaded by a peripheral
   CLog::Log(LOGINFO, "load keymapping");
   if (!CButtonTranslator::GetInstance().Load())
@@ -798,6 +807,7 @@ bool CApplication::Create()
 
   m_lastFrameTime = XbmcThreads::SystemClockMillis();
   m_lastRenderTime = m_lastFrameTime;
+  m_backBufferKept = false;
 
   return Initialize();
 }
@@ -1826,6 +1836,7 @@ void CApplication::UnloadSkin(bool forReload /* = false */)
 
   g_TextureManager.Cleanup();
   g_largeTextureManager.CleanupUnusedImages(true);
+  g_albumArtAtlas.CleanupUnusedPages(true);
 
   g_fontManager.Clear();
 
@@ -2089,21 +2100,35 @@ void CApplication::Render()
   else if (vsync_mode != VSYNC_DRIVER)
     g_Windowing.SetVSync(false);
 
-  if(!g_Windowing.BeginRender())
-    return;
+  // partial presents copy what was rendered out of the back buffer, so it must hold the whole frame
+  bool partialPresent = g_advancedSettings.m_guiPartialPresent && g_Windowing.CanPresentPartially() &&
+                        !g_graphicsContext.IsFullScreenVideo();
+  g_windowManager.SetBackBufferKept(partialPresent);
+  if (partialPresent && !m_backBufferKept)
+    g_windowManager.MarkDirty();
 
   CDirtyRegionList dirtyRegions = g_windowManager.GetDirty();
-  if (RenderNoPresent())
-    hasRendered = true;
+  // when nothing on screen has changed there's nothing to render
+  if (dirtyRegions.empty() && !g_graphicsContext.IsFullScreenVideo() &&
+      !g_advancedSettings.m_guiVisualizeDirtyRegions && !(m_pPlayer && m_pPlayer->IsRecording()))
+    g_windowManager.SkipRender();
+  else
+  {
+    if(!g_Windowing.BeginRender())
+      return;
 
-  g_Windowing.EndRender();
+    if (RenderNoPresent())
+      hasRendered = true;
+
+    g_Windowing.EndRender();
+  }
 
   g_TextureManager.FreeUnusedTextures();
 
   // reset our info cache - we do this at the end of Render so that it is
   // fresh for the next process(), or after a windowclose animation (where process()
   // isn't called)
-  g_infoManager.ResetCache();
+  g_infoManager.ResetFrameCache();
 
   lock.Leave();
 
@@ -2132,7 +2157,14 @@ void CApplication::Render()
   m_lastFrameTime = XbmcThreads::SystemClockMillis();
 
   if (flip)
-    g_graphicsContext.Flip(dirtyRegions);
+  {
+    // the screen already shows all but what was rendered
+    if (!partialPresent)
+      g_graphicsContext.Flip(dirtyRegions);
+    else if (hasRendered)
+      g_graphicsContext.Flip(dirtyRegions, true);
+  }
+  m_backBufferKept = partialPresent;
   CTimeUtils::UpdateFrameTime(flip);
 
   g_renderManager.UpdateResolution();
@@ -3261,6 +3293,8 @@ bool CApplication::Cleanup()
 
     CLog::Log(LOGNOTICE, "unload sections");
 
+    CBuiltins::LogStats();
+
 #ifdef HAS_PERFORMANCE_SAMPLE
     CLog::Log(LOGNOTICE, "performance statistics");
     m_perfStats.DumpStats();
@@ -3322,6 +3356,12 @@ void CApplication::Stop(int exitCode)
     // cancel any jobs from the jobmanager
     CJobManager::GetInstance().CancelJobs();
 
+    // keep the queue for next time, whatever happens to the playlists from here on
+    g_playlistPlayer.CloseQueue();
+
+    // no more coins once the application goes away
+    g_jukeboxManager.GetCoinAcceptor().Stop();
+
     g_alarmClock.StopThread();
 
 #ifdef HAS_HTTPAPI
@@ -4904,7 +4944,10 @@ void CApplication::ProcessSlow()
   }
 
   if (!IsPlayingVideo())
+  {
     g_largeTextureManager.CleanupUnusedImages();
+    g_albumArtAtlas.CleanupUnusedPages();
+  }
 
 #ifdef HAS_DVD_DRIVE
   // checks whats in the DVD drive and tries to autostart the content (xbox games, dvd, cdda, avi files...)
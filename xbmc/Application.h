@@ -320,6 +320,7 @@ protected:
   bool m_bPresentFrame;
   unsigned int m_lastFrameTime;
   unsigned int m_lastRenderTime;
+  bool m_backBufferKept; ///< whether the back buffer still holds the last frame presented
 
   bool m_bStandalone;
   bool m_bEnableLegacyRes;
@@ -4,13 +4,51 @@
 #include "FileItem.h"
 #include "settings/AdvancedSettings.h"
 #include "threads/SingleLock.h"
+#include "utils/JobManager.h"
+#include "utils/TimeUtils.h"
 #include "utils/log.h"
 
+#include <algorithm>
+
 using namespace std;
 
 #define ITEMS_PER_THREAD 5
+// each job runs until the listing is loaded, so more of them would keep the job manager's
+// workers from the lower priority jobs (texture caching, thumb extraction) for all that time
+#define MAX_JOBS         2
+
+CLatencyHistogram CBackgroundInfoLoader::m_visibleLatency;
 
-CBackgroundInfoLoader::CBackgroundInfoLoader(int nThreads)
+/*!
+ \brief A worker of a CBackgroundInfoLoader, loading items until there are none left.
+ */
+class CBackgroundLoaderJob : public CJob
+{
+public:
+  CBackgroundLoaderJob(CBackgroundInfoLoader *loader) : m_loader(loader), m_started(false) {}
+
+  virtual ~CBackgroundLoaderJob()
+  {
+    // cancelled before it got to run
+    if (!m_started)
+      m_loader->OnJobDropped();
+  }
+
+  virtual const char *GetType() const { return "backgroundinfoloader"; }
+
+  virtual bool DoWork()
+  {
+    m_started = true;
+    m_loader->Run();
+    return true;
+  }
+
+private:
+  CBackgroundInfoLoader *m_loader;
+  bool m_started;
+};
+
+CBackgroundInfoLoader::CBackgroundInfoLoader(int nThreads) : m_jobsDone(true, true)
 {
   m_bStop = true;
   m_pObserver=NULL;
@@ -19,6 +57,11 @@ CBackgroundInfoLoader::CBackgroundInfoLoader(int nThreads)
   m_nRequestedThreads = nThreads;
   m_bStartCalled = false;
   m_nActiveThreads = 0;
+  m_nextItem = 0;
+  m_visibleFirst = m_visibleLast = -1;
+  m_visibleRange = 0;
+  m_visiblePending = 0;
+  m_visibleSince = m_loadStart = 0;
 }
 
 CBackgroundInfoLoader::~CBackgroundInfoLoader()
@@ -38,7 +81,8 @@ void CBackgroundInfoLoader::Run()
     if (m_vecItems.size() > 0)
     {
       {
-        CSingleLock lock(m_lock);
+        // not under m_lock, the screen takes it every frame to give the visible range
+        CSingleLock lock(m_startLock);
         if (!m_bStartCalled)
         {
           OnLoaderStart();
@@ -49,13 +93,8 @@ void CBackgroundInfoLoader::Run()
       while (!m_bStop)
       {
         CSingleLock lock(m_lock);
-        CFileItemPtr pItem;
-        vector<CFileItemPtr>::iterator iter = m_vecItems.begin();
-        if (iter != m_vecItems.end())
-        {
-          pItem = *iter;
-          m_vecItems.erase(iter);
-        }
+        unsigned int visibleRange;
+        CFileItemPtr pItem = NextItem(visibleRange);
 
         if (pItem == NULL)
           break;
@@ -74,22 +113,95 @@ void CBackgroundInfoLoader::Run()
         {
           CLog::Log(LOGERROR, "%s::LoadItem - Unhandled exception for item %s", __FUNCTION__, pItem->GetPath().c_str());
         }
+        OnItemDone(visibleRange);
       }
     }
 
     CSingleLock lock(m_lock);
-    if (m_nActiveThreads == 1)
-      OnLoaderFinish();
-    m_nActiveThreads--;
-
+    bool last = --m_nActiveThreads == 0;
+    lock.Leave();
+    if (last)
+    {
+      CSingleLock startLock(m_startLock);
+      if (m_bStartCalled)
+      {
+        OnLoaderFinish();
+        m_bStartCalled = false;
+      }
+      startLock.Leave();
+      m_jobsDone.Set();
+    }
   }
   catch (...)
   {
-    m_nActiveThreads--;
+    CSingleLock lock(m_lock);
+    if (--m_nActiveThreads == 0)
+      m_jobsDone.Set();
     CLog::Log(LOGERROR, "%s - Unhandled exception", __FUNCTION__);
   }
 }
 
+CFileItemPtr CBackgroundInfoLoader::NextItem(unsigned int &visibleRange)
+{
+  CFileItemPtr pItem;
+  visibleRange = 0;
+  while (!m_visible.empty() && !pItem)
+  {
+    pItem.swap(m_vecItems[m_visible.front()]);
+    m_visible.pop_front();
+    visibleRange = m_visibleRange;
+  }
+  for (; m_nextItem < m_vecItems.size() && !pItem; m_nextItem++)
+  {
+    pItem.swap(m_vecItems[m_nextItem]);
+    visibleRange = 0;
+  }
+  return pItem;
+}
+
+void CBackgroundInfoLoader::OnItemDone(unsigned int visibleRange)
+{
+  CSingleLock lock(m_lock);
+  if (visibleRange == 0 || visibleRange != m_visibleRange || --m_visiblePending > 0)
+    return;
+
+  int64_t elapsed = (CurrentHostCounter() - m_visibleSince) * 1000000 / CurrentHostFrequency();
+  m_visibleLatency.Add(elapsed);
+  CLog::Log(LOGDEBUG, "%s - items on screen loaded in %.1f ms (median %.1f ms, 95%% %.1f ms over %ld ranges)",
+            __FUNCTION__, elapsed / 1000.0, m_visibleLatency.Percentile(0.5) / 1000.0,
+            m_visibleLatency.Percentile(0.95) / 1000.0, m_visibleLatency.Count());
+}
+
+void CBackgroundInfoLoader::OnJobDropped()
+{
+  CSingleLock lock(m_lock);
+  if (--m_nActiveThreads == 0)
+    m_jobsDone.Set();
+}
+
+void CBackgroundInfoLoader::SetVisibleRange(const CFileItemList& items, int first, int last)
+{
+  CSingleLock lock(m_lock);
+  if (first == m_visibleFirst && last == m_visibleLast)
+    return;
+  // the first range of a listing counts from the listing, the user waited since then
+  m_visibleSince = m_visibleFirst < 0 ? m_loadStart : CurrentHostCounter();
+  m_visibleFirst = first;
+  m_visibleLast = last;
+  m_visibleRange++;
+  m_visiblePending = 0;
+  m_visible.clear();
+  for (int i = max(first, 0); i <= last && i < items.Size(); i++)
+  {
+    map<const CFileItem*, unsigned int>::const_iterator it = m_positions.find(items[i].get());
+    if (it != m_positions.end() && m_vecItems[it->second])
+    {
+      m_visible.push_back(it->second);
+      m_visiblePending++;
+    }
+  }
+}
+
 void CBackgroundInfoLoader::Load(CFileItemList& items)
 {
   StopThread();
@@ -100,11 +212,15 @@ void CBackgroundInfoLoader::Load(CFileItemList& items)
   CSingleLock lock(m_lock);
 
   for (int nItem=0; nItem < items.Size(); nItem++)
+  {
     m_vecItems.push_back(items[nItem]);
+    m_positions.insert(make_pair(items[nItem].get(), (unsigned int)nItem));
+  }
 
   m_pVecItems = &items;
   m_bStop = false;
   m_bStartCalled = false;
+  m_loadStart = CurrentHostCounter();
 
   int nThreads = m_nRequestedThreads;
   if (nThreads == -1)
@@ -112,18 +228,17 @@ void CBackgroundInfoLoader::Load(CFileItemList& items)
 
   if (nThreads > g_advancedSettings.m_bgInfoLoaderMaxThreads)
     nThreads = g_advancedSettings.m_bgInfoLoaderMaxThreads;
+  if (nThreads > MAX_JOBS)
+    nThreads = MAX_JOBS;
+
+  if (nThreads <= 0)
+    return;
 
   m_nActiveThreads = nThreads;
+  m_jobsDone.Reset();
+  lock.Leave(); // the jobs take our lock as soon as they start
   for (int i=0; i < nThreads; i++)
-  {
-    CThread *pThread = new CThread(this, "Background Loader");
-    pThread->Create();
-#ifndef _LINUX
-    pThread->SetPriority(THREAD_PRIORITY_BELOW_NORMAL);
-#endif
-    m_workers.push_back(pThread);
-  }
-
+    m_jobs.push_back(CJobManager::GetInstance().AddJob(new CBackgroundLoaderJob(this), NULL, CJob::PRIORITY_NORMAL));
 }
 
 void CBackgroundInfoLoader::StopAsync()
@@ -136,14 +251,28 @@ void CBackgroundInfoLoader::StopThread()
 {
   StopAsync();
 
-  for (int i=0; i<(int)m_workers.size(); i++)
+  // jobs not started yet are dropped, the running ones stop after their current item
+  for (unsigned int i = 0; i < m_jobs.size(); i++)
+    CJobManager::GetInstance().CancelJob(m_jobs[i]);
+  m_jobs.clear();
+  m_jobsDone.Wait();
+
   {
-    m_workers[i]->StopThread();
-    delete m_workers[i];
+    CSingleLock startLock(m_startLock);
+    if (m_bStartCalled)
+    {
+      OnLoaderFinish();
+      m_bStartCalled = false;
+    }
   }
 
-  m_workers.clear();
+  CSingleLock lock(m_lock);
   m_vecItems.clear();
+  m_positions.clear();
+  m_visible.clear();
+  m_nextItem = 0;
+  m_visibleFirst = m_visibleLast = -1;
+  m_visiblePending = 0;
   m_pVecItems = NULL;
   m_nActiveThreads = 0;
 }
@@ -5,7 +5,11 @@
 #include "threads/Thread.h"
 #include "IProgressCallback.h"
 #include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "utils/LatencyHistogram.h"
 
+#include <deque>
+#include <map>
 #include <vector>
 #include "boost/shared_ptr.hpp"
 
@@ -19,8 +23,17 @@ public:
   virtual void OnItemLoaded(CFileItem* pItem) = 0;
 };
 
+/*!
+ \brief Loads the details of the items of a listing in the background.
+
+ The loading runs as jobs of CJobManager rather than on threads of its own, the number of
+ jobs being the number of workers asked for, but no more than two as each job runs until the
+ listing is loaded. Items on screen, as given by SetVisibleRange(), are loaded before the rest
+ of the listing.
+ */
 class CBackgroundInfoLoader : public IRunnable
 {
+  friend class CBackgroundLoaderJob;
 public:
   CBackgroundInfoLoader(int nThreads=-1);
   virtual ~CBackgroundInfoLoader();
@@ -37,6 +50,17 @@ public:
 
   void SetNumOfWorkers(int nThreads); // -1 means auto compute num of required threads
 
+  /*! \brief Load the items on screen next.
+   Does nothing if the range is the one last given, so it can be called every frame.
+   \param items the listing on screen, which may be sorted differently from the one loading.
+   \param first index of the first item on screen.
+   \param last index of the last item on screen.
+   */
+  void SetVisibleRange(const CFileItemList& items, int first, int last);
+
+  /*! \brief Time from a listing or a scroll until the items on screen were loaded, in us. */
+  static const CLatencyHistogram& GetVisibleLatency() { return m_visibleLatency; }
+
 protected:
   virtual void OnLoaderStart() {};
   virtual void OnLoaderFinish() {};
@@ -44,6 +68,7 @@ protected:
   CFileItemList *m_pVecItems;
   std::vector<CFileItemPtr> m_vecItems; // FileItemList would delete the items and we only want to keep a reference.
   CCriticalSection m_lock;
+  CCriticalSection m_startLock; ///< held around OnLoaderStart() and OnLoaderFinish(), guards m_bStartCalled
 
   bool m_bStartCalled;
   volatile bool m_bStop;
@@ -53,6 +78,24 @@ protected:
   IBackgroundLoaderObserver* m_pObserver;
   IProgressCallback* m_pProgressCallback;
 
-  std::vector<CThread *> m_workers;
+private:
+  CFileItemPtr NextItem(unsigned int &visibleRange);
+  void OnItemDone(unsigned int visibleRange);
+  void OnJobDropped();
+
+  std::vector<unsigned int> m_jobs;
+  CEvent       m_jobsDone;
+
+  unsigned int m_nextItem;                          ///< first item of m_vecItems that may not be taken yet
+  std::map<const CFileItem*, unsigned int> m_positions; ///< index of each item in m_vecItems
+  std::deque<unsigned int> m_visible;               ///< items on screen not taken yet
+  int          m_visibleFirst;
+  int          m_visibleLast;
+  unsigned int m_visibleRange;                      ///< counts the ranges given, 0 is none
+  unsigned int m_visiblePending;                    ///< items of the range not loaded yet
+  int64_t      m_visibleSince;
+  int64_t      m_loadStart;
+
+  static CLatencyHistogram m_visibleLatency;
 };
 
@@ -21,6 +21,9 @@
 #include "utils/TuxBoxUtil.h"
 #include "video/VideoInfoTag.h"
 #include "threads/SingleLock.h"
+#include "threads/Atomics.h"
+#include "threads/Thread.h"
+#include "utils/CPUInfo.h"
 #include "music/tags/MusicInfoTag.h"
 #include "pictures/PictureInfoTag.h"
 #include "music/Artist.h"
@@ -31,6 +34,7 @@
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "utils/RegExp.h"
+#include "utils/ExtensionSet.h"
 #include "utils/log.h"
 #include "utils/Variant.h"
 #include "music/karaoke/karaokelyricsfactory.h"
@@ -218,6 +222,7 @@ const CFileItem& CFileItem::operator=(const CFileItem& item)
   m_bLabelPreformated=item.m_bLabelPreformated;
   FreeMemory();
   m_strPath = item.GetPath();
+  m_classification = item.m_classification;
   m_bIsParentFolder = item.m_bIsParentFolder;
   m_iDriveType = item.m_iDriveType;
   m_bIsShareOrDrive = item.m_bIsShareOrDrive;
@@ -289,6 +294,7 @@ void CFileItem::Reset()
   m_strDVDLabel.Empty();
   m_strTitle.Empty();
   m_strPath.Empty();
+  ResetClassification();
   m_dwSize = 0;
   m_bIsFolder = false;
   m_bIsParentFolder=false;
@@ -371,6 +377,7 @@ void CFileItem::Archive(CArchive& ar)
     ar >> m_bIsParentFolder;
     ar >> m_bLabelPreformated;
     ar >> m_strPath;
+    ResetClassification();
     ar >> m_bIsShareOrDrive;
     ar >> m_iDriveType;
     ar >> m_dateTime;
@@ -546,14 +553,7 @@ bool CFileItem::IsAudio() const
      return true;
   }
 
-  URIUtils::GetExtension(m_strPath, extension);
-
-  if (extension.IsEmpty())
-    return false;
-
-  extension.ToLower();
-
-  return (g_settings.m_musicExtensions.Find(extension) != -1);
+  return (GetClassification() & CLASS_AUDIO_EXTENSION) != 0;
 }
 
 bool CFileItem::IsKaraoke() const
@@ -694,7 +694,63 @@ bool CFileItem::IsBDFile() const
 
 bool CFileItem::IsPFC() const
 {
-  return URIUtils::IsPFC(m_strPath);
+  return (GetClassification() & CLASS_PFC) != 0;
+}
+
+bool CFileItem::IsInPFC() const
+{
+  return (GetClassification() & CLASS_IN_PFC) != 0;
+}
+
+static CCriticalSection musicExtensionsSection;
+static CExtensionSet musicExtensions;
+
+// the music extensions compiled, and compiled anew when the settings change them
+static bool IsMusicExtension(const CStdString &extension)
+{
+  CSingleLock lock(musicExtensionsSection);
+  if (musicExtensions.GetSource() != g_settings.m_musicExtensions)
+    musicExtensions.Set(g_settings.m_musicExtensions);
+  return musicExtensions.Contains(extension);
+}
+
+int CFileItem::GetClassification() const
+{
+  long classification = m_classification;
+  if (classification & CLASSIFIED)
+    return classification;
+
+  classification = CLASSIFIED;
+  CStdString extension;
+  URIUtils::GetExtension(m_strPath, extension);
+
+  // as URIUtils::IsPFC() and IsInPFC(), parsing the path only if it is a URL
+  if (URIUtils::IsURL(m_strPath))
+  {
+    CURL url(m_strPath);
+    bool isPFCProtocol = url.GetProtocol() == "pfc";
+    if (url.GetFileName().IsEmpty())
+    {
+      if (isPFCProtocol)
+        classification |= CLASS_PFC;
+    }
+    else
+    {
+      if (extension.CompareNoCase(".pfc") == 0)
+        classification |= CLASS_PFC;
+      if (isPFCProtocol)
+        classification |= CLASS_IN_PFC;
+    }
+  }
+  else if (extension.CompareNoCase(".pfc") == 0)
+    classification |= CLASS_PFC;
+
+  if (IsMusicExtension(extension))
+    classification |= CLASS_AUDIO_EXTENSION;
+
+  // threads asking at once all work out the same answer, the first one publishes it
+  cas(&m_classification, 0, classification);
+  return classification;
 }
 
 bool CFileItem::IsRAR() const
@@ -1123,6 +1179,7 @@ const CStdString& CFileItem::GetMimeType(bool lookup /*= true*/) const
   {
     CStdString& m_path = (CStdString&)m_strPath;
     m_path.Replace("http:", "mms:");
+    const_cast<CFileItem *>(this)->ResetClassification();
   }
 
   return m_mimetype;
@@ -1647,14 +1704,133 @@ void CFileItemList::Sort(SORT_METHOD sortMethod, SORT_ORDER sortOrder)
       sortMethod == SORT_METHOD_VIDEO_SORT_TITLE_IGNORE_THE ||
       sortMethod == SORT_METHOD_LABEL_IGNORE_FOLDERS ||
       m_sortIgnoreFolders)
-    Sort(sortOrder==SORT_ORDER_ASC ? SSortFileItem::IgnoreFoldersAscending : SSortFileItem::IgnoreFoldersDescending);
+    SortByKey(sortOrder==SORT_ORDER_ASC, true);
   else if (sortMethod != SORT_METHOD_NONE && sortMethod != SORT_METHOD_UNSORTED)
-    Sort(sortOrder==SORT_ORDER_ASC ? SSortFileItem::Ascending : SSortFileItem::Descending);
+    SortByKey(sortOrder==SORT_ORDER_ASC, false);
 
   m_sortMethod=sortMethod;
   m_sortOrder=sortOrder;
 }
 
+#define PARALLEL_SORT_MIN_ITEMS 8192 // below this the threads cost more than they save
+
+enum SortKeyGroup { SORT_KEY_TOP = 0, SORT_KEY_FOLDER, SORT_KEY_FILE, SORT_KEY_BOTTOM };
+
+struct SSortKeyEntry
+{
+  unsigned int group;  // items only sort among their own group
+  unsigned int offset; // start of the collation key in the key buffer
+  unsigned int length;
+  unsigned int item;   // index of the item in the list
+};
+
+class CSortKeyCompare
+{
+public:
+  CSortKeyCompare(const char *keys, bool ascending) : m_keys(keys), m_ascending(ascending) {}
+
+  bool operator()(const SSortKeyEntry &left, const SSortKeyEntry &right) const
+  {
+    if (left.group != right.group)
+      return left.group < right.group;
+    if (left.group == SORT_KEY_TOP || left.group == SORT_KEY_BOTTOM)
+      return false; // both sort on top or bottom -> leave as-is
+    int cmp = memcmp(m_keys + left.offset, m_keys + right.offset, std::min(left.length, right.length));
+    if (cmp == 0)
+      cmp = (left.length < right.length) ? -1 : (left.length > right.length ? 1 : 0);
+    return m_ascending ? cmp < 0 : cmp > 0;
+  }
+private:
+  const char *m_keys;
+  bool m_ascending;
+};
+
+class CSortKeyWorker : public CThread
+{
+public:
+  CSortKeyWorker(vector<SSortKeyEntry>::iterator begin, vector<SSortKeyEntry>::iterator end, const CSortKeyCompare &compare)
+    : CThread("CSortKeyWorker"), m_begin(begin), m_end(end), m_compare(compare) {}
+protected:
+  virtual void Process() { stable_sort(m_begin, m_end, m_compare); }
+private:
+  vector<SSortKeyEntry>::iterator m_begin;
+  vector<SSortKeyEntry>::iterator m_end;
+  CSortKeyCompare m_compare;
+};
+
+void CFileItemList::SortByKey(bool ascending, bool ignoreFolders)
+{
+  CSingleLock lock(m_lock);
+
+  // gather the keys into one buffer so the sort never has to touch the items themselves
+  vector<SSortKeyEntry> entries(m_items.size());
+  string keys;
+  for (unsigned int i = 0; i < m_items.size(); i++)
+  {
+    const CFileItemPtr &item = m_items[i];
+    SSortKeyEntry &entry = entries[i];
+    entry.item = i;
+    entry.offset = keys.size();
+    entry.length = 0;
+    entry.group = SORT_KEY_FILE;
+    if (!item)
+      continue;
+    if (item->SortsOnTop())
+      entry.group = SORT_KEY_TOP;
+    else if (item->SortsOnBottom())
+      entry.group = SORT_KEY_BOTTOM;
+    else if (item->m_bIsFolder && !ignoreFolders)
+      entry.group = SORT_KEY_FOLDER;
+    const string &key = item->GetSortKey();
+    keys += key;
+    entry.length = key.size();
+  }
+
+  CSortKeyCompare compare(keys.c_str(), ascending);
+  unsigned int chunks = std::min(std::max(g_cpuInfo.getCPUCount(), 1), 4);
+  if (entries.size() < PARALLEL_SORT_MIN_ITEMS || chunks < 2)
+    stable_sort(entries.begin(), entries.end(), compare);
+  else
+  { // sort a chunk per core, then merge the sorted chunks pairwise
+    vector<unsigned int> bounds;
+    for (unsigned int i = 0; i <= chunks; i++)
+      bounds.push_back(entries.size() * i / chunks);
+
+    vector<CSortKeyWorker*> workers;
+    for (unsigned int i = 1; i < chunks; i++)
+    {
+      workers.push_back(new CSortKeyWorker(entries.begin() + bounds[i], entries.begin() + bounds[i + 1], compare));
+      workers.back()->Create();
+    }
+    stable_sort(entries.begin(), entries.begin() + bounds[1], compare);
+    for (unsigned int i = 0; i < workers.size(); i++)
+    {
+      workers[i]->StopThread();
+      delete workers[i];
+    }
+
+    while (bounds.size() > 2)
+    {
+      vector<unsigned int> merged;
+      for (unsigned int i = 0; i + 2 < bounds.size(); i += 2)
+      {
+        inplace_merge(entries.begin() + bounds[i], entries.begin() + bounds[i + 1], entries.begin() + bounds[i + 2], compare);
+        merged.push_back(bounds[i]);
+      }
+      if (bounds.size() % 2 == 0)
+        merged.push_back(bounds[bounds.size() - 2]);
+      merged.push_back(bounds.back());
+      bounds.swap(merged);
+    }
+  }
+
+  VECFILEITEMS sorted;
+  sorted.reserve(m_items.size());
+  for (unsigned int i = 0; i < entries.size(); i++)
+    sorted.push_back(m_items[entries[i].item]);
+  m_items.swap(sorted);
+}
+
 void CFileItemList::Randomize()
 {
   CSingleLock lock(m_lock);
@@ -2049,7 +2225,7 @@ void CFileItemList::StackFolders()
         || item->IsAfp()
         || URIUtils::IsInRAR(item->GetPath())
         || URIUtils::IsInZIP(item->GetPath())
-      	|| URIUtils::IsInPFC(item->GetPath()) // Laureon: Added: Filesystem
+      	|| item->IsInPFC() // Laureon: Added: Filesystem
         || URIUtils::IsOnLAN(item->GetPath())
         )
       {
@@ -60,7 +60,7 @@ public:
   virtual CGUIListItem *Clone() const { return new CFileItem(*this); };
 
   const CStdString &GetPath() const { return m_strPath; };
-  void SetPath(const CStdString &path) { m_strPath = path; };
+  void SetPath(const CStdString &path) { m_strPath = path; ResetClassification(); };
 
   void Reset();
   const CFileItem& operator=(const CFileItem& item);
@@ -93,6 +93,7 @@ public:
   bool IsDVDFile(bool bVobs = true, bool bIfos = true) const;
   bool IsBDFile() const;
   bool IsPFC() const; // Laureon: Added: Filesystem.
+  bool IsInPFC() const;
   bool IsRAR() const;
   bool IsZIP() const;
   bool IsCBZ() const;
@@ -305,7 +306,23 @@ public:
   int m_iBadPwdCount;
 
 private:
+  /*! \brief What the path says about the item, worked out once per path as the checks involve
+   parsing the path and looking up its extension. The jukebox windows and the playlist code ask
+   for each item over and over. Items are shared with the loader and job threads, so the
+   classification is published with a single compare and swap.
+   */
+  enum EClassification
+  {
+    CLASSIFIED            = 0x01,
+    CLASS_PFC             = 0x02,  ///< a PFC container
+    CLASS_IN_PFC          = 0x04,  ///< inside a PFC container
+    CLASS_AUDIO_EXTENSION = 0x08   ///< has one of the music extensions
+  };
+  int GetClassification() const;
+  void ResetClassification() { m_classification = 0; };
+
   CStdString m_strPath;            ///< complete path to item
+  mutable volatile long m_classification;
 
   SPECIAL_SORT m_specialSort;
   bool m_bIsParentFolder;
@@ -483,6 +500,13 @@ public:
 private:
   void Sort(FILEITEMLISTCOMPARISONFUNC func);
   void FillSortFields(FILEITEMFILLFUNC func);
+  /*! \brief Sort the items on the collation keys of their sort labels
+   Top/bottom items and folders are kept in place as SSortFileItem::Ascending() and friends do.
+   \param ascending true to sort ascending, false for descending.
+   \param ignoreFolders true to sort folders along with the files.
+   \sa CGUIListItem::GetSortKey
+   */
+  void SortByKey(bool ascending, bool ignoreFolders);
   CStdString GetDiscCacheFile(int windowID) const;
 
   /*!
@@ -53,6 +53,7 @@
 #include "storage/MediaManager.h"
 #include "utils/TimeUtils.h"
 #include "threads/SingleLock.h"
+#include "threads/Atomics.h"
 #include "utils/log.h"
 
 #include "addons/AddonManager.h"
@@ -88,6 +89,13 @@ CGUIInfoManager::CGUIInfoManager(void)
   m_frameCounter = 0;
   m_lastFPSTime = 0;
   m_updateTime = 1;
+  for (unsigned int i = 0; i < DEPENDENCY_COUNT; i++)
+    m_generations[i] = 1;
+  m_dependenciesChecked = false;
+  memset(m_playerState, 0, sizeof(m_playerState));
+  memset(m_playlistState, 0, sizeof(m_playlistState));
+  m_frameEvaluations = 0;
+  m_lastFrameEvaluations = 0;
   ResetLibraryBools();
 }
 
@@ -105,10 +113,30 @@ bool CGUIInfoManager::OnMessage(CGUIMessage &message)
     {
       CFileItemPtr item = boost::static_pointer_cast<CFileItem>(message.GetItem());
       if (item && m_currentFile->GetPath().Equals(item->GetPath()))
+      {
         *m_currentFile = *item;
+        InvalidateDependency(DEPENDS_PLAYER);
+      }
       return true;
     }
   }
+  // other targets need these messages too, so we never handle them
+  switch (message.GetMessage())
+  {
+  case GUI_MSG_PLAYBACK_STARTED:
+  case GUI_MSG_PLAYBACK_ENDED:
+  case GUI_MSG_PLAYBACK_STOPPED:
+    InvalidateDependency(DEPENDS_PLAYER | DEPENDS_PLAYLIST);
+    break;
+  case GUI_MSG_PLAYLIST_CHANGED:
+  case GUI_MSG_PLAYLISTPLAYER_STARTED:
+  case GUI_MSG_PLAYLISTPLAYER_CHANGED:
+  case GUI_MSG_PLAYLISTPLAYER_STOPPED:
+  case GUI_MSG_PLAYLISTPLAYER_RANDOM:
+  case GUI_MSG_PLAYLISTPLAYER_REPEAT:
+    InvalidateDependency(DEPENDS_PLAYLIST);
+    break;
+  }
   return false;
 }
 
@@ -247,7 +275,10 @@ const infomap system_labels[] =  {{ "hasnetwork",       SYSTEM_ETHERNET_LINK_ACT
                                   { "batterylevel",     SYSTEM_BATTERY_LEVEL },
                                   { "friendlyname",     SYSTEM_FRIENDLY_NAME },
                                   { "alarmpos",         SYSTEM_ALARM_POS },
-                                  { "haspvr",           SYSTEM_HAS_PVR }};
+                                  { "haspvr",           SYSTEM_HAS_PVR },
+                                  { "conditionevaluations", SYSTEM_CONDITION_EVALUATIONS },
+                                  { "renderedarea",     SYSTEM_RENDERED_AREA },
+                                  { "idleframes",       SYSTEM_IDLE_FRAMES }};
 
 const infomap system_param[] =   {{ "hasalarm",         SYSTEM_HAS_ALARM },
                                   { "getbool",          SYSTEM_GET_BOOL },
@@ -1108,6 +1139,15 @@ CStdString CGUIInfoManager::GetLabel(int info, int contextWindow)
   case SYSTEM_FPS:
     strLabel.Format("%02.2f", m_fps);
     break;
+  case SYSTEM_CONDITION_EVALUATIONS:
+    strLabel.Format("%u", m_lastFrameEvaluations);
+    break;
+  case SYSTEM_RENDERED_AREA:
+    strLabel.Format("%2.0f%%", g_windowManager.GetRenderedArea() * 100);
+    break;
+  case SYSTEM_IDLE_FRAMES:
+    strLabel.Format("%2.0f%%", g_windowManager.GetIdleFrames() * 100);
+    break;
   case PLAYER_VOLUME:
     strLabel.Format("%2.1f dB", (float)(g_settings.m_nVolumeLevel + g_settings.m_dynamicRangeCompressionLevel) * 0.01f);
     break;
@@ -1795,17 +1835,145 @@ bool CGUIInfoManager::EvaluateBool(const CStdString &expression, int contextWind
  */
 bool CGUIInfoManager::GetBoolValue(unsigned int expression, const CGUIListItem *item)
 {
+  if (!m_dependenciesChecked)
+    CheckDependencies();
   if (expression && --expression < m_bools.size())
-    return m_bools[expression]->Get(m_updateTime, item);
+    return m_bools[expression]->Get(m_updateTime, m_generations, item);
   return false;
 }
 
+unsigned int CGUIInfoManager::GetBoolDependencies(unsigned int expression) const
+{
+  if (expression && --expression < m_bools.size())
+    return m_bools[expression]->GetDependencies();
+  return DEPENDS_NONE;
+}
+
+unsigned int CGUIInfoManager::GetDependencies(int condition) const
+{
+  condition = abs(condition);
+  switch (condition)
+  {
+  case SYSTEM_ALWAYS_TRUE:
+  case SYSTEM_ALWAYS_FALSE:
+  case SYSTEM_ETHERNET_LINK_ACTIVE:
+  case SYSTEM_PLATFORM_LINUX:
+  case SYSTEM_PLATFORM_WINDOWS:
+  case SYSTEM_PLATFORM_OSX:
+  case SYSTEM_PLATFORM_DARWIN_OSX:
+  case SYSTEM_PLATFORM_DARWIN_IOS:
+  case SYSTEM_PLATFORM_DARWIN_ATV2:
+#ifdef IS_JUKEBOX
+  case SYSTEM_ISPROFESSIONAL:
+  case SYSTEM_ISHOMEEDITION:
+#endif
+    return DEPENDS_NONE;
+  case PLAYER_HAS_MEDIA:
+  case PLAYER_HAS_AUDIO:
+  case PLAYER_HAS_VIDEO:
+  case PLAYER_PLAYING:
+  case PLAYER_PAUSED:
+  case PLAYER_REWINDING:
+  case PLAYER_REWINDING_2x:
+  case PLAYER_REWINDING_4x:
+  case PLAYER_REWINDING_8x:
+  case PLAYER_REWINDING_16x:
+  case PLAYER_REWINDING_32x:
+  case PLAYER_FORWARDING:
+  case PLAYER_FORWARDING_2x:
+  case PLAYER_FORWARDING_4x:
+  case PLAYER_FORWARDING_8x:
+  case PLAYER_FORWARDING_16x:
+  case PLAYER_FORWARDING_32x:
+    return DEPENDS_PLAYER;
+  case MUSICPLAYER_HASPREVIOUS:
+  case MUSICPLAYER_HASNEXT:
+  case MUSICPLAYER_PLAYLISTPLAYING:
+  case PLAYLIST_ISRANDOM:
+  case PLAYLIST_ISREPEAT:
+  case PLAYLIST_ISREPEATONE:
+    return DEPENDS_PLAYER | DEPENDS_PLAYLIST;
+  }
+
+  if (condition >= MULTI_INFO_START && condition <= MULTI_INFO_END)
+  {
+    const GUIInfo &info = m_multiInfo[condition - MULTI_INFO_START];
+    switch (abs(info.m_info))
+    {
+    case SKIN_BOOL:
+    case SYSTEM_GET_BOOL:
+      return DEPENDS_SETTINGS;
+    case STRING_IS_EMPTY:
+    case INTEGER_GREATER_THAN:
+      return GetLabelDependencies(info.GetData1());
+    case STRING_COMPARE:
+      if (info.GetData2() < 0) // compared with another label
+        return GetLabelDependencies(info.GetData1()) | GetLabelDependencies(-info.GetData2());
+      return GetLabelDependencies(info.GetData1());
+    }
+  }
+  return DEPENDS_FRAME;
+}
+
+unsigned int CGUIInfoManager::GetLabelDependencies(int info) const
+{
+  switch (info)
+  {
+  case PLAYLIST_LENGTH:
+  case PLAYLIST_POSITION:
+  case PLAYLIST_RANDOM:
+  case PLAYLIST_REPEAT:
+  case MUSICPLAYER_PLAYLISTLEN:
+  case MUSICPLAYER_PLAYLISTPOS:
+    return DEPENDS_PLAYER | DEPENDS_PLAYLIST;
+#ifdef IS_PROFESSIONAL
+  case PLAYER_MODEINFO: // credits, or the songs party mode will still queue
+    return DEPENDS_COINS | DEPENDS_PLAYLIST | DEPENDS_SETTINGS;
+#endif
+  }
+  return DEPENDS_FRAME;
+}
+
+void CGUIInfoManager::InvalidateDependency(unsigned int dependencies)
+{
+  for (unsigned int i = 0; i < DEPENDENCY_COUNT; i++)
+  {
+    if (dependencies & (1 << i))
+      AtomicIncrement(&m_generations[i]);
+  }
+}
+
+void CGUIInfoManager::CheckDependencies()
+{
+  m_dependenciesChecked = true;
+
+  // pausing, changing speed and moving through the playlist don't all come with a message,
+  // so compare what the player and playlist conditions read with what they read last frame.
+  int player[] = { g_application.IsPlaying(), g_application.IsPlayingAudio(), g_application.IsPlayingVideo(),
+                   g_application.IsPaused(), g_application.GetPlaySpeed() };
+  if (memcmp(player, m_playerState, sizeof(m_playerState)) != 0)
+  {
+    memcpy(m_playerState, player, sizeof(m_playerState));
+    InvalidateDependency(DEPENDS_PLAYER);
+  }
+
+  int iPlaylist = g_playlistPlayer.GetCurrentPlaylist();
+  int playlist[] = { iPlaylist, g_playlistPlayer.GetCurrentSong(), g_playlistPlayer.GetPlaylist(iPlaylist).size(),
+                     g_playlistPlayer.IsShuffled(iPlaylist), g_playlistPlayer.GetRepeat(iPlaylist) };
+  if (memcmp(playlist, m_playlistState, sizeof(m_playlistState)) != 0)
+  {
+    memcpy(m_playlistState, playlist, sizeof(m_playlistState));
+    InvalidateDependency(DEPENDS_PLAYLIST);
+  }
+}
+
 // checks the condition and returns it as necessary.  Currently used
 // for toggle button controls and visibility of images.
 bool CGUIInfoManager::GetBool(int condition1, int contextWindow, const CGUIListItem *item)
 {
   bool bReturn = false;
   int condition = abs(condition1);
+  m_frameEvaluations++;
 
   if (item && condition >= LISTITEM_START && condition < LISTITEM_END)
     bReturn = GetItemBool(item, condition);
@@ -4281,6 +4449,17 @@ void CGUIInfoManager::ResetCache()
   // reset any animation triggers as well
   m_containerMoves.clear();
   m_updateTime++;
+  InvalidateDependency(DEPENDS_PLAYER | DEPENDS_PLAYLIST | DEPENDS_COINS | DEPENDS_SETTINGS);
+}
+
+void CGUIInfoManager::ResetFrameCache()
+{
+  m_lastFrameEvaluations = m_frameEvaluations;
+  m_frameEvaluations = 0;
+  m_dependenciesChecked = false;
+  // reset any animation triggers as well
+  m_containerMoves.clear();
+  m_updateTime++;
 }
 
 // Called from tuxbox service thread to update current status
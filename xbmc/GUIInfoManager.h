@@ -14,6 +14,7 @@
 #include "inttypes.h"
 #include "XBDateTime.h"
 #include "interfaces/info/SkinVariable.h"
+#include "interfaces/info/InfoBool.h"
 
 #include <list>
 #include <map>
@@ -167,6 +168,9 @@ namespace INFO
 #define SYSTEM_ISFULLSCREEN         182
 #define SYSTEM_ISSTANDALONE         183
 #define SYSTEM_HAS_PVR              184
+#define SYSTEM_CONDITION_EVALUATIONS 185
+#define SYSTEM_RENDERED_AREA        186
+#define SYSTEM_IDLE_FRAMES          187
 
 #define NETWORK_IP_ADDRESS          190
 #define NETWORK_MAC_ADDRESS         191
@@ -574,6 +578,24 @@ public:
    */
   bool EvaluateBool(const CStdString &expression, int context = 0);
 
+  /*! \brief Get what a previously registered boolean expression depends on
+   \return the INFO::DEPENDS_* flags of the expression
+   \sa Register, GetDependencies
+   */
+  unsigned int GetBoolDependencies(unsigned int expression) const;
+
+  /*! \brief Get what a single condition depends on
+   \param condition the condition, as returned by TranslateSingleString
+   \return the INFO::DEPENDS_* flags of the condition, DEPENDS_FRAME if it has no change events
+   */
+  unsigned int GetDependencies(int condition) const;
+
+  /*! \brief Have the conditions that depend on something evaluated again, as it has changed.
+   Safe to call from any thread.
+   \param dependencies the INFO::DEPENDS_* flags of what has changed
+   */
+  void InvalidateDependency(unsigned int dependencies);
+
   int TranslateString(const CStdString &strCondition);
 
   /*! \brief Get integer value of info.
@@ -645,7 +667,18 @@ public:
   void SetNextWindow(int windowID) { m_nextWindowID = windowID; };
   void SetPreviousWindow(int windowID) { m_prevWindowID = windowID; };
 
+  /*! \brief Have all conditions evaluated again, e.g. when a window is opened or the settings are loaded */
   void ResetCache();
+
+  /*! \brief Called at the end of each frame. Conditions that depend on DEPENDS_FRAME are evaluated
+   again in the next one, and the number of conditions evaluated in this one is kept.
+   \sa GetConditionEvaluations
+   */
+  void ResetFrameCache();
+
+  /*! \brief The number of conditions evaluated in the last frame (System.ConditionEvaluations) */
+  unsigned int GetConditionEvaluations() const { return m_lastFrameEvaluations; };
+
   bool GetItemInt(int &value, const CGUIListItem *item, int info) const;
   CStdString GetItemLabel(const CFileItem *item, int info);
   CStdString GetItemImage(const CFileItem *item, int info);
@@ -704,6 +737,8 @@ protected:
   int TranslateMusicPlayerString(const CStdString &info) const;
   TIME_FORMAT TranslateTimeFormat(const CStdString &format);
   bool GetItemBool(const CGUIListItem *item, int condition) const;
+  unsigned int GetLabelDependencies(int info) const;
+  void CheckDependencies();
 
   /*! \brief Split an info string into it's constituent parts and parameters
    Format is:
@@ -768,6 +803,14 @@ protected:
   std::vector<INFO::CSkinVariableString> m_skinVariableStrings;
   unsigned int m_updateTime;
 
+  // condition dependencies
+  volatile long m_generations[INFO::DEPENDENCY_COUNT]; ///< bumped whenever the dependency changes
+  bool m_dependenciesChecked;            ///< whether CheckDependencies() has run this frame
+  int m_playerState[5];                  ///< what the player conditions read last time, \sa CheckDependencies
+  int m_playlistState[5];                ///< what the playlist conditions read last time
+  unsigned int m_frameEvaluations;       ///< conditions evaluated in this frame
+  unsigned int m_lastFrameEvaluations;   ///< and in the last one
+
   int m_libraryHasMusic;
   int m_libraryHasMovies;
   int m_libraryHasTVShows;
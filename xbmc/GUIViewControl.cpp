@@ -8,6 +8,8 @@
 #include "GUIInfoManager.h"
 #include "guilib/Key.h"
 
+#include <algorithm>
+
 CGUIViewControl::CGUIViewControl(void)
 {
   m_viewAsControl = -1;
@@ -156,6 +158,26 @@ int CGUIViewControl::GetSelectedItem() const
   return GetSelectedItem(m_visibleViews[m_currentView]);
 }
 
+// the items that can be on screen with the selected item, a page either side of it
+bool CGUIViewControl::GetVisibleRange(int &first, int &last) const
+{
+  if (m_currentView < 0 || m_currentView >= (int)m_visibleViews.size())
+    return false; // no valid current view!
+
+  const CGUIControl *control = m_visibleViews[m_currentView];
+  if (!control->IsContainer())
+    return false;
+
+  int selected = GetSelectedItem(control);
+  if (selected < 0)
+    return false;
+
+  int page = ((const CGUIBaseContainer *)control)->GetItemsPerPage();
+  first = std::max(selected - page + 1, 0);
+  last = selected + page - 1;
+  return true;
+}
+
 void CGUIViewControl::SetSelectedItem(int item)
 {
   if (!m_fileItems || item < 0 || item >= m_fileItems->Size())
@@ -25,6 +25,7 @@ public:
   void SetSelectedItem(const CStdString &itemPath);
 
   int GetSelectedItem() const;
+  bool GetVisibleRange(int &first, int &last) const;
   void SetFocused();
 
   bool HasControl(int controlID) const;
@@ -15,12 +15,43 @@
 #include "settings/Settings.h"
 #include "utils/TimeUtils.h"
 #include "utils/log.h"
+#include "jukebox/JukeboxManager.h"
 
 using namespace std;
 using namespace PLAYLIST;
 
 #define QUEUE_DEPTH       10
 
+/*! \brief Random songs of the music library matching the party mode filter */
+class CRandomSongPicker : public IRandomPicker
+{
+public:
+  CRandomSongPicker(CMusicDatabase &database, const CStdString &where) : m_database(database), m_where(where) {}
+  virtual bool Pick(CFileItem &item)
+  {
+    int songID;
+    return m_database.GetRandomSong(&item, songID, m_where);
+  }
+private:
+  CMusicDatabase &m_database;
+  const CStdString &m_where;
+};
+
+/*! \brief Random music videos of the video library matching the party mode filter */
+class CRandomMusicVideoPicker : public IRandomPicker
+{
+public:
+  CRandomMusicVideoPicker(CVideoDatabase &database, const CStdString &where) : m_database(database), m_where(where) {}
+  virtual bool Pick(CFileItem &item)
+  {
+    int musicVideoID;
+    return m_database.GetRandomMusicVideo(&item, musicVideoID, m_where);
+  }
+private:
+  CVideoDatabase &m_database;
+  const CStdString &m_where;
+};
+
 CPartyModeManager::CPartyModeManager(void)
 {
   m_bIsVideo = false;
@@ -145,15 +176,7 @@ bool CPartyModeManager::Enable(PartyModeContext context /*= PARTYMODECONTEXT_MUS
     songIDs.insert(songIDs.end(),songIDs2.begin(),songIDs2.end());
   }
 
-  // calculate history size
-  if (m_iMatchingSongs < 50)
-    m_songsInHistory = 0;
-  else
-    m_songsInHistory = (int)(m_iMatchingSongs/2);
-  if (m_songsInHistory > 200)
-    m_songsInHistory = 200;
-
-  CLog::Log(LOGINFO,"PARTY MODE MANAGER: Matching songs = %i, History size = %i", m_iMatchingSongs, m_songsInHistory);
+  CLog::Log(LOGINFO,"PARTY MODE MANAGER: Matching songs = %i", m_iMatchingSongs);
   CLog::Log(LOGINFO,"PARTY MODE MANAGER: Party mode enabled!");
 
   int iPlaylist = m_bIsVideo ? PLAYLIST_VIDEO : PLAYLIST_MUSIC;
@@ -322,16 +345,16 @@ bool CPartyModeManager::AddRandomSongs(int iSongs /* = 0 */)
       // only want one here.  Any more than about 3 songs and it is more efficient
       // to use the technique in AddInitialSongs.  As it's unlikely that we'll require
       // more than 1 song at a time here, this method is faster.
+      CRecentlyPlayed &recentlyPlayed = g_jukeboxManager.GetRecentlyPlayed();
+      CRandomSongPicker picker(database, m_strCurrentFilterMusic);
       bool error(false);
       for (int i = 0; i < iSongsToAdd; i++)
       {
-        pair<CStdString,CStdString> whereClause = GetWhereClauseWithHistory();
-        CFileItemPtr item(new CFileItem);
-        int songID;
-        if (database.GetRandomSong(item.get(), songID, whereClause.first))
+        // pick again while the song was picked too recently
+        CFileItemPtr item = recentlyPlayed.Pick(picker);
+        if (item)
         { // success
           Add(item);
-          AddToHistory(1,songID);
         }
         else
         {
@@ -369,16 +392,16 @@ bool CPartyModeManager::AddRandomSongs(int iSongs /* = 0 */)
       // only want one here.  Any more than about 3 songs and it is more efficient
       // to use the technique in AddInitialSongs.  As it's unlikely that we'll require
       // more than 1 song at a time here, this method is faster.
+      CRecentlyPlayed &recentlyPlayed = g_jukeboxManager.GetRecentlyPlayed();
+      CRandomMusicVideoPicker picker(database, m_strCurrentFilterVideo);
       bool error(false);
       for (int i = 0; i < iVidsToAdd; i++)
       {
-        pair<CStdString,CStdString> whereClause = GetWhereClauseWithHistory();
-        CFileItemPtr item(new CFileItem);
-        int songID;
-        if (database.GetRandomMusicVideo(item.get(), songID, whereClause.second))
+        // pick again while the music video was picked too recently
+        CFileItemPtr item = recentlyPlayed.Pick(picker);
+        if (item)
         { // success
           Add(item);
-          AddToHistory(2,songID);
         }
         else
         {
@@ -416,6 +439,7 @@ void CPartyModeManager::Add(CFileItemPtr &pItem)
 
   CPlayList& playlist = g_playlistPlayer.GetPlaylist(iPlaylist);
   playlist.Add(pItem);
+  g_jukeboxManager.GetRecentlyPlayed().Add(*pItem);
   CLog::Log(LOGINFO,"PARTY MODE MANAGER: Adding randomly selected song at %i:[%s]", playlist.size() - 1, pItem->GetPath().c_str());
   m_iMatchingSongsPicked++;
 }
@@ -541,9 +565,6 @@ void CPartyModeManager::ClearState()
   m_iMatchingSongsLeft = 0;
   m_iRelaxedSongs = 0;
   m_iRandomSongs = 0;
-
-  m_songsInHistory = 0;
-  m_history.clear();
 }
 
 void CPartyModeManager::UpdateStats()
@@ -597,7 +618,6 @@ bool CPartyModeManager::AddInitialSongs(vector<pair<int,int> > &songIDs)
       database.GetMusicVideosByWhere("videodb://3/2/", sqlWhereVideo, items);
     }
 
-    m_history = chosenSongIDs;
     items.Randomize(); //randomizing the initial list or they will be in database order
     for (int i = 0; i < items.Size(); i++)
     {
@@ -609,46 +629,6 @@ bool CPartyModeManager::AddInitialSongs(vector<pair<int,int> > &songIDs)
   return true;
 }
 
-pair<CStdString,CStdString> CPartyModeManager::GetWhereClauseWithHistory() const
-{
-  CStdString historyWhereMusic;
-  CStdString historyWhereVideo;
-  // now add this on to the normal where clause
-  if (m_history.size())
-  {
-    if (m_strCurrentFilterMusic.IsEmpty())
-      historyWhereMusic = "where songview.idSong not in (";
-    else
-      historyWhereMusic = m_strCurrentFilterMusic + " and songview.idSong not in (";
-    if (m_strCurrentFilterVideo.IsEmpty())
-      historyWhereVideo = "where idMVideo not in (";
-    else
-      historyWhereVideo = m_strCurrentFilterVideo + " and idMVideo not in (";
-
-    for (unsigned int i = 0; i < m_history.size(); i++)
-    {
-      CStdString number;
-      number.Format("%i,", m_history[i].second);
-      if (m_history[i].first == 1)
-        historyWhereMusic += number;
-      if (m_history[i].first == 2)
-        historyWhereVideo += number;
-    }
-    historyWhereMusic.TrimRight(",");
-    historyWhereMusic += ")";
-    historyWhereVideo.TrimRight(",");
-    historyWhereVideo += ")";
-  }
-  return make_pair(historyWhereMusic,historyWhereVideo);
-}
-
-void CPartyModeManager::AddToHistory(int type, int songID)
-{
-  while (m_history.size() >= m_songsInHistory && m_songsInHistory)
-    m_history.erase(m_history.begin());
-  m_history.push_back(make_pair<int,int>(type,songID));
-}
-
 void CPartyModeManager::GetRandomSelection(vector< pair<int,int> >& in, unsigned int number, vector< pair<int,int> >& out)
 {
   // only works if we have < 32768 in the in vector
@@ -50,8 +50,6 @@ private:
   void OnError(int iError, const CStdString& strLogMessage);
   void ClearState();
   void UpdateStats();
-  std::pair<CStdString,CStdString> GetWhereClauseWithHistory() const;
-  void AddToHistory(int type, int songID);
   void GetRandomSelection(std::vector< std::pair<int,int> > &in, unsigned int number, std::vector< std::pair<int, int> > &out);
 
   // state
@@ -69,10 +67,6 @@ private:
   int m_iMatchingSongsLeft;
   int m_iRelaxedSongs;
   int m_iRandomSongs;
-
-  // history
-  unsigned int m_songsInHistory;
-  std::vector< std::pair<int,int> > m_history;
 };
 
 extern CPartyModeManager g_partyModeManager;
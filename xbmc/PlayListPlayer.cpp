@@ -17,6 +17,7 @@
 using namespace PLAYLIST;
 
 CPlayListPlayer::CPlayListPlayer(void)
+  : m_journal("special://masterprofile/queue.journal")
 {
   m_PlaylistMusic = new CPlayList;
   m_PlaylistVideo = new CPlayList;
@@ -29,6 +30,7 @@ CPlayListPlayer::CPlayListPlayer(void)
     m_repeatState[i] = REPEAT_NONE;
   m_iFailedSongs = 0;
   m_failedSongsStart = 0;
+  m_queueRestored = false;
 }
 
 CPlayListPlayer::~CPlayListPlayer(void)
@@ -64,6 +66,10 @@ bool CPlayListPlayer::OnMessage(CGUIMessage &message)
       }
     }
     break;
+  case GUI_MSG_PLAYLIST_CHANGED:
+    m_journal.Sync(*m_PlaylistMusic, m_iCurrentPlayList == PLAYLIST_MUSIC ? m_iCurrentSong : -1);
+    g_jukeboxManager.OnPlaylistChanged();
+    break;
   }
 
   return false;
@@ -295,6 +301,8 @@ bool CPlayListPlayer::Play(int iSong, bool bAutoPlay /* = false */, bool bPlayPr
   m_failedSongsStart = 0;
   m_bPlaybackStarted = true;
   m_bPlayedFirstFile = true;
+  if (m_iCurrentPlayList == PLAYLIST_MUSIC)
+    m_journal.OnPlay(m_iCurrentSong);
 //  if (iSong >0) {
 //    Remove(m_iCurrentPlayList,iSong - 1);
 //  }
@@ -676,3 +684,31 @@ void CPlayListPlayer::Swap(int iPlaylist, int indexItem1, int indexItem2)
   CGUIMessage msg(GUI_MSG_PLAYLIST_CHANGED, 0, 0);
   g_windowManager.SendMessage(msg);
 }
+
+bool CPlayListPlayer::RestoreQueue()
+{
+  if (m_queueRestored)
+    return false;
+  m_queueRestored = true;
+
+  CPlayList queue;
+  int current = m_journal.Open(queue);
+  if (queue.size() <= 0)
+    return false;
+
+  CLog::Log(LOGINFO, "Playlist Player: restoring %i queued songs", queue.size());
+  m_PlaylistMusic->Clear();
+  m_PlaylistMusic->Add(queue);
+  SetCurrentPlaylist(PLAYLIST_MUSIC);
+
+  CGUIMessage msg(GUI_MSG_PLAYLIST_CHANGED, 0, 0);
+  g_windowManager.SendMessage(msg);
+
+  Play(current >= 0 ? current : 0);
+  return true;
+}
+
+void CPlayListPlayer::CloseQueue()
+{
+  m_journal.Close();
+}
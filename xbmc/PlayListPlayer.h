@@ -2,6 +2,7 @@
 
 
 #include "guilib/IMsgTargetCallback.h"
+#include "playlists/PlayListJournal.h"
 #include <boost/shared_ptr.hpp>
 
 #define PLAYLIST_NONE    -1
@@ -145,6 +146,19 @@ public:
   void Insert(int iPlaylist, CFileItemList& items, int iIndex);
   void Remove(int iPlaylist, int iPosition);
   void Swap(int iPlaylist, int indexItem1, int indexItem2);
+
+  /*! \brief Restore the music queue from the queue journal and resume playing it.
+   Only does anything the first time it is called. From then on every change to the music
+   playlist is recorded in the journal.
+   \return true if songs were restored to the queue, false otherwise.
+   \sa CPlayListJournal
+   */
+  bool RestoreQueue();
+
+  /*! \brief Stop recording changes to the music queue, called on shutdown so the queue is kept.
+   \sa RestoreQueue
+   */
+  void CloseQueue();
 protected:
   /*! \brief Returns true if the given is set to repeat all
    \param playlist Playlist to be query
@@ -170,6 +184,8 @@ protected:
   CPlayList* m_PlaylistVideo;
   CPlayList* m_PlaylistEmpty;
   REPEAT_STATE m_repeatState[2];
+  CPlayListJournal m_journal;
+  bool m_queueRestored;
 };
 
 }
@@ -4,6 +4,7 @@
 #include "input/MouseStat.h"
 #include "Application.h"
 #include "GUILargeTextureManager.h"
+#include "AlbumArtAtlas.h"
 #include "guilib/TextureManager.h"
 #include "guilib/AudioContext.h"
 #include "settings/GUISettings.h"
@@ -44,6 +45,7 @@
 
   CGUITextureManager g_TextureManager;
   CGUILargeTextureManager g_largeTextureManager;
+  CAlbumArtAtlas     g_albumArtAtlas;
   CMouseStat         g_Mouse;
   CGUIPassword       g_passwordManager;
   CGUIInfoManager    g_infoManager;
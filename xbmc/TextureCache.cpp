@@ -13,6 +13,7 @@
 #include "pictures/Picture.h"
 #include "guilib/TextureManager.h"
 #include "utils/URIUtils.h"
+#include "utils/CPUInfo.h"
 
 using namespace XFILE;
 
@@ -107,6 +108,7 @@ CTextureCache &CTextureCache::Get()
 }
 
 CTextureCache::CTextureCache()
+  : CJobQueue(false, std::max(1, g_cpuInfo.getCPUCount()), CJob::PRIORITY_NORMAL) // image decoding is cpu bound, so keep every core busy
 {
 }
 
@@ -174,7 +176,7 @@ CStdString CTextureCache::CheckCachedImage(const CStdString &url, bool returnDDS
       CStdString ddsPath = URIUtils::ReplaceExtension(path, ".dds");
       if (CFile::Exists(ddsPath))
         return ddsPath;
-      if (g_advancedSettings.m_useDDSFanart)
+      if (UseDDS(url))
         AddJob(new CDDSJob(path));
     }
     return path;
@@ -201,7 +203,7 @@ CStdString CTextureCache::CacheImageFile(const CStdString &url)
   if (!hash.IsEmpty())
   {
     AddCachedTexture(url, originalFile, hash);
-    if (g_advancedSettings.m_useDDSFanart)
+    if (UseDDS(url))
       AddJob(new CDDSJob(GetCachedPath(originalFile)));
     return GetCachedPath(originalFile);
   }
@@ -328,12 +330,19 @@ void CTextureCache::OnJobComplete(unsigned int jobID, bool success, CJob *job)
     CCacheJob *cacheJob = (CCacheJob *)job;
     AddCachedTexture(cacheJob->m_url, cacheJob->m_original, cacheJob->m_hash);
     // TODO: call back to the UI indicating that it can update it's image...
-    if (g_advancedSettings.m_useDDSFanart)
+    if (UseDDS(cacheJob->m_url))
       AddJob(new CDDSJob(GetCachedPath(cacheJob->m_original)));
   }
   return CJobQueue::OnJobComplete(jobID, success, job);
 }
 
+bool CTextureCache::UseDDS(const CStdString &url)
+{
+  if (0 == strncmp(url.c_str(), "thumb://", 8))
+    return g_advancedSettings.m_useDDSThumbs;
+  return g_advancedSettings.m_useDDSFanart;
+}
+
 CStdString CTextureCache::GetUniqueImage(const CStdString &url, const CStdString &extension)
 {
   Crc32 crc;
@@ -190,6 +190,14 @@ private:
    */
   CStdString GetImageHash(const CStdString &url) const;
 
+  /*! \brief whether a ready-to-upload .dds version should be kept for this image
+   Thumbs are small and viewed over and over on the album wall, so they get one by default;
+   fanart only if <useddsfanart> is set.
+   \param url location of the image, thumb:// wrapped for thumbnails
+   \return true if a .dds version should be generated after caching
+   */
+  static bool UseDDS(const CStdString &url);
+
   virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
 
   CCriticalSection m_databaseSection;
@@ -8,6 +8,7 @@
 #include "utils/log.h"
 #include "limits.h"
 #include "guilib/LocalizeStrings.h"
+#include "cores/PlaybackTelemetry.h"
 
 #define CHECK_ALSA(l,s,e) if ((e)<0) CLog::Log(l,"%s - %s, alsa error: %d - %s",__FUNCTION__,s,e,snd_strerror(e));
 #define CHECK_ALSA_RETURN(l,s,e) CHECK_ALSA((l),(s),(e)); if ((e)<0) return false;
@@ -452,6 +453,7 @@ unsigned int CALSADirectSound::GetSpaceFrames()
     if(state != SND_PCM_STATE_RUNNING && state != SND_PCM_STATE_PREPARED && !m_bPause)
     {
       CLog::Log(LOGWARNING,"CALSADirectSound::GetSpace - buffer underun (%d)", state);
+      CPlaybackTelemetry::AddUnderrun();
       Flush();
       return m_uiBufferSize;
     }
@@ -527,6 +529,7 @@ unsigned int CALSADirectSound::AddPackets(const void* data, unsigned int len)
   {
     CLog::Log(LOGDEBUG, "CALSADirectSound::AddPackets - buffer underun (tried to write %d frames)",
             framesToWrite);
+    CPlaybackTelemetry::AddUnderrun();
     Flush();
     return 0;
   }
@@ -10,6 +10,7 @@
 #include "threads/SingleLock.h"
 #include "utils/SystemInfo.h"
 #include "utils/log.h"
+#include "cores/PlaybackTelemetry.h"
 #include "utils/TimeUtils.h"
 #include "utils/CharsetConverter.h"
 
@@ -396,6 +397,7 @@ void CWin32DirectSound::UpdateCacheStatus()
       (playCursor > writeCursor && playCursor <  m_BufferOffset))      // (3)
   {
     CLog::Log(LOGWARNING, "CWin32DirectSound::GetSpace - buffer underrun - W:%u, P:%u, O:%u.", writeCursor, playCursor, m_BufferOffset);
+    CPlaybackTelemetry::AddUnderrun();
     m_BufferOffset = writeCursor; // Catch up
     m_pBuffer->Stop(); // Wait until someone gives us some data to restart playback (prevents glitches)
   }
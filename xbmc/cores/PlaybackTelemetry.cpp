@@ -0,0 +1,103 @@
+
+
+#include "system.h"
+#include "PlaybackTelemetry.h"
+#include "interfaces/Builtins.h"
+#include "threads/Atomics.h"
+#include "utils/Variant.h"
+#include "utils/log.h"
+
+CLatencyHistogram CPlaybackTelemetry::m_stages[PLAYBACK_STAGES];
+int64_t CPlaybackTelemetry::m_bytesRead = 0;
+long CPlaybackTelemetry::m_bytesReadLock = 0;
+volatile long CPlaybackTelemetry::m_underruns = 0;
+
+static const char *StageNames[PLAYBACK_STAGES] =
+{
+  "read",
+  "pfcopen",
+  "audiodecode",
+  "videodecode",
+  "resample",
+  "audiowrite",
+  "videowrite"
+};
+
+void CPlaybackTelemetry::AddBytesRead(int64_t bytes)
+{
+  // 64 bits may not be written atomically on 32 bit platforms
+  CAtomicSpinLock lock(m_bytesReadLock);
+  m_bytesRead += bytes;
+}
+
+void CPlaybackTelemetry::AddUnderrun()
+{
+  AtomicIncrement(&m_underruns);
+}
+
+void CPlaybackTelemetry::Reset()
+{
+  for (int i = 0; i < PLAYBACK_STAGES; i++)
+    m_stages[i].Reset();
+  m_underruns = 0;
+  CAtomicSpinLock lock(m_bytesReadLock);
+  m_bytesRead = 0;
+}
+
+const char *CPlaybackTelemetry::GetStageName(EPlaybackStage stage)
+{
+  return stage >= 0 && stage < PLAYBACK_STAGES ? StageNames[stage] : "unknown";
+}
+
+void CPlaybackTelemetry::Serialize(CVariant &value)
+{
+  value["stages"] = CVariant(CVariant::VariantTypeObject);
+  for (int i = 0; i < PLAYBACK_STAGES; i++)
+  {
+    const CLatencyHistogram &histogram = m_stages[i];
+    CVariant &stage = value["stages"][StageNames[i]];
+    stage["count"] = (int64_t)histogram.Count();
+    stage["max"] = (int64_t)histogram.Max();
+    stage["p50"] = (int64_t)histogram.Percentile(0.5);
+    stage["p90"] = (int64_t)histogram.Percentile(0.9);
+    stage["p99"] = (int64_t)histogram.Percentile(0.99);
+    stage["buckets"] = CVariant(CVariant::VariantTypeArray);
+    for (int bucket = 0; bucket < CLatencyHistogram::BUCKETS; bucket++)
+      stage["buckets"].push_back((int64_t)histogram.Bucket(bucket));
+  }
+
+  CAtomicSpinLock lock(m_bytesReadLock);
+  value["bytesread"] = m_bytesRead;
+  value["underruns"] = (int64_t)m_underruns;
+}
+
+void CPlaybackTelemetry::Log()
+{
+  int64_t bytesRead;
+  {
+    CAtomicSpinLock lock(m_bytesReadLock);
+    bytesRead = m_bytesRead;
+  }
+  CLog::Log(LOGNOTICE, "Playback telemetry: %"PRId64" bytes read, %ld underruns, latencies in us:", bytesRead, (long)m_underruns);
+  for (int i = 0; i < PLAYBACK_STAGES; i++)
+  {
+    const CLatencyHistogram &histogram = m_stages[i];
+    if (histogram.Count() == 0)
+      continue;
+    CLog::Log(LOGNOTICE, "  %-12s count:%"PRId64" p50:%.0f p90:%.0f p99:%.0f max:%"PRId64, StageNames[i],
+              (int64_t)histogram.Count(), histogram.Percentile(0.5), histogram.Percentile(0.9), histogram.Percentile(0.99), (int64_t)histogram.Max());
+  }
+}
+
+static int DumpPlaybackTelemetryBuiltin(const std::vector<CStdString> &params)
+{
+  CPlaybackTelemetry::Log();
+  if (params.size() > 0 && params[0].Equals("reset"))
+    CPlaybackTelemetry::Reset();
+  return 0;
+}
+
+void CPlaybackTelemetry::RegisterBuiltins()
+{
+  CBuiltins::RegisterCommand("DumpPlaybackTelemetry", DumpPlaybackTelemetryBuiltin, false, "Write the playback stage latencies to the log, then start anew if given \"reset\"");
+}
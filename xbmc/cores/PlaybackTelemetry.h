@@ -0,0 +1,66 @@
+#pragma once
+
+
+#include "utils/LatencyHistogram.h"
+#include "utils/TimeUtils.h"
+#include <stdint.h>
+
+class CVariant;
+
+enum EPlaybackStage
+{
+  PLAYBACK_STAGE_READ = 0,      ///< reading a block or packet from the file or demuxer
+  PLAYBACK_STAGE_PFC_OPEN,      ///< finding and opening a file inside a PFC container
+  PLAYBACK_STAGE_AUDIO_DECODE,
+  PLAYBACK_STAGE_VIDEO_DECODE,
+  PLAYBACK_STAGE_RESAMPLE,
+  PLAYBACK_STAGE_AUDIO_WRITE,   ///< handing decoded audio to the audio renderer
+  PLAYBACK_STAGE_VIDEO_WRITE,   ///< handing a decoded picture to the render manager
+  PLAYBACK_STAGES
+};
+
+/*!
+ \brief Latencies of the stages of the playback pipeline, shared by DVDPlayer and PAPlayer.
+
+ Each stage has a CLatencyHistogram, so timing a stage costs two host counter reads and a few
+ atomic increments and can stay enabled. The numbers are retrieved through JSON-RPC
+ (Player.GetTelemetry) and written to the log by the DumpPlaybackTelemetry builtin, or
+ through the JSON-RPC call.
+ */
+class CPlaybackTelemetry
+{
+public:
+  static void AddSample(EPlaybackStage stage, int64_t us) { m_stages[stage].Add(us); }
+  static void AddBytesRead(int64_t bytes);
+  static void AddUnderrun();
+  static void Reset();
+
+  static void Serialize(CVariant &value);
+  static void Log();
+  static const char *GetStageName(EPlaybackStage stage);
+
+  static void RegisterBuiltins();
+
+private:
+  static CLatencyHistogram m_stages[PLAYBACK_STAGES];
+  static int64_t m_bytesRead;
+  static long m_bytesReadLock;
+  static volatile long m_underruns;
+};
+
+/*!
+ \brief Times the scope it lives in as a sample of a playback stage.
+ */
+class CPlaybackStageTimer
+{
+public:
+  CPlaybackStageTimer(EPlaybackStage stage) : m_stage(stage), m_start(CurrentHostCounter()) {}
+  ~CPlaybackStageTimer()
+  {
+    CPlaybackTelemetry::AddSample(m_stage, (CurrentHostCounter() - m_start) * 1000000 / CurrentHostFrequency());
+  }
+
+private:
+  EPlaybackStage m_stage;
+  int64_t m_start;
+};
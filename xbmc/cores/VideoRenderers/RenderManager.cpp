@@ -12,6 +12,8 @@
 #include "settings/Settings.h"
 #include "settings/GUISettings.h"
 #include "settings/AdvancedSettings.h"
+#include "guilib/GUIFont.h"
+#include "guilib/GUIFontTTF.h"
 
 #ifdef _LINUX
 #include "PlatformInclude.h"
@@ -254,6 +256,9 @@ void CXBMCRenderManager::Update(bool bPauseDrawing)
 
 void CXBMCRenderManager::RenderUpdate(bool clear, DWORD flags, DWORD alpha)
 {
+  // text queued up by the GUI goes below the video
+  CGUIFontTTFBase::FlushBatchedText();
+
   { CRetakeLock<CExclusiveLock> lock(m_sharedSection);
     if (!m_pRenderer)
       return;
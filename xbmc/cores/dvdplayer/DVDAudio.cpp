@@ -9,6 +9,7 @@
 #include "DVDPlayerAudio.h"
 #include "../AudioRenderers/AudioRendererFactory.h"
 #include "settings/Settings.h"
+#include "cores/PlaybackTelemetry.h"
 
 using namespace std;
 
@@ -142,7 +143,10 @@ DWORD CDVDAudio::AddPacketsRenderer(unsigned char* data, DWORD len, CSingleLock
   DWORD  copied;
   do
   {
-    copied = m_pAudioDecoder->AddPackets(data, len);
+    {
+      CPlaybackStageTimer timer(PLAYBACK_STAGE_AUDIO_WRITE);
+      copied = m_pAudioDecoder->AddPackets(data, len);
+    }
     data += copied;
     len -= copied;
     if (len < m_dwPacketSize)
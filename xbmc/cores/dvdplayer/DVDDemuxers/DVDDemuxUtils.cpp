@@ -5,7 +5,11 @@
 #endif
 #include "DVDDemuxUtils.h"
 #include "DVDClock.h"
+#include "DVDPerformanceCounter.h"
+#include "threads/Atomics.h"
+#include "threads/LockFree.h"
 #include "utils/log.h"
+#include <stddef.h>
 extern "C" {
 #if (defined USE_EXTERNAL_FFMPEG)
   #if (defined HAVE_LIBAVCODEC_AVCODEC_H)
@@ -18,13 +22,69 @@ extern "C" {
 #endif
 }
 
+// Packets with up to 64 KiB of data (all audio, most video) come from lock-free pools of
+// fixed size blocks, one for each power of two from 512 bytes up, holding the packet and its
+// data together. Bigger packets are allocated on their own, as they always were. Pools keep
+// their memory once grown, they are sized by the peak demand of playback.
+#define PACKET_POOL_COUNT     8
+#define PACKET_POOL_MIN_SHIFT 9
+#define PACKET_ALIGN          16
+
+namespace
+{
+  struct CPacketBlock
+  {
+    int pool; // pool the block belongs to, -1 if allocated on its own
+    DemuxPacket packet;
+  };
+
+  lf_heap g_packetPools[PACKET_POOL_COUNT];
+  volatile long g_packetPoolInit[PACKET_POOL_COUNT];
+  long g_packetPoolLock = 0;
+
+  int GetPacketPool(int iDataSize)
+  {
+    int pool = 0;
+    while (pool < PACKET_POOL_COUNT && (1 << (pool + PACKET_POOL_MIN_SHIFT)) < iDataSize + FF_INPUT_BUFFER_PADDING_SIZE)
+      pool++;
+    return pool < PACKET_POOL_COUNT ? pool : -1;
+  }
+
+  CPacketBlock *AllocatePacketBlock(int pool)
+  {
+    if (!g_packetPoolInit[pool])
+    {
+      CAtomicSpinLock lock(g_packetPoolLock);
+      if (!g_packetPoolInit[pool])
+      {
+        // room for the block, its data, and aligning the data
+        lf_heap_init(&g_packetPools[pool], sizeof(CPacketBlock) + PACKET_ALIGN + (1 << (pool + PACKET_POOL_MIN_SHIFT)));
+        g_packetPoolInit[pool] = 1;
+      }
+    }
+    return (CPacketBlock*)lf_heap_alloc(&g_packetPools[pool]);
+  }
+
+  inline CPacketBlock *GetPacketBlock(DemuxPacket* pPacket)
+  {
+    return (CPacketBlock*)((BYTE*)pPacket - offsetof(CPacketBlock, packet));
+  }
+}
+
 void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
 {
   if (pPacket)
   {
     try {
-      if (pPacket->pData) _aligned_free(pPacket->pData);
-      delete pPacket;
+      CPacketBlock *block = GetPacketBlock(pPacket);
+      AtomicDecrement(&g_dvdPerformanceCounter.m_packetsLive);
+      if (block->pool >= 0)
+        lf_heap_free(&g_packetPools[block->pool], block);
+      else
+      {
+        if (pPacket->pData) _aligned_free(pPacket->pData);
+        delete block;
+      }
     }
     catch(...) {
       CLog::Log(LOGERROR, "%s - Exception thrown while freeing packet", __FUNCTION__);
@@ -34,12 +94,25 @@ void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
 
 DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
 {
-  DemuxPacket* pPacket = new DemuxPacket;
-  if (!pPacket) return NULL;
+  int pool = GetPacketPool(iDataSize);
+  CPacketBlock* block;
+  if (pool >= 0)
+    block = AllocatePacketBlock(pool);
+  else
+  {
+    block = new CPacketBlock;
+    AtomicIncrement(&g_dvdPerformanceCounter.m_packetPoolMisses);
+  }
+  if (!block) return NULL;
+
+  AtomicIncrement(&g_dvdPerformanceCounter.m_packetAllocations);
+  AtomicIncrement(&g_dvdPerformanceCounter.m_packetsLive);
 
+  DemuxPacket* pPacket = &block->packet;
   try
   {
     memset(pPacket, 0, sizeof(DemuxPacket));
+    block->pool = pool;
 
     if (iDataSize > 0)
     {
@@ -52,7 +125,10 @@ DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
         * Note, if the first 23 bits of the additional bytes are not 0 then damaged
         * MPEG bitstreams could cause overread and segfault
         */
-      pPacket->pData =(BYTE*)_aligned_malloc(iDataSize + FF_INPUT_BUFFER_PADDING_SIZE, 16);
+      if (pool >= 0)
+        pPacket->pData = (BYTE*)(((uintptr_t)(block + 1) + PACKET_ALIGN - 1) & ~(uintptr_t)(PACKET_ALIGN - 1));
+      else
+        pPacket->pData =(BYTE*)_aligned_malloc(iDataSize + FF_INPUT_BUFFER_PADDING_SIZE, PACKET_ALIGN);
       if (!pPacket->pData)
       {
         FreeDemuxPacket(pPacket);
@@ -43,12 +43,19 @@ void CDVDMessageQueue::Flush(CDVDMsg::Message type)
 {
   CSingleLock lock(m_section);
 
-  for(SList::iterator it = m_list.begin(); it != m_list.end();)
+  for(SQueues::iterator it = m_queues.begin(); it != m_queues.end(); it++)
   {
-    if (it->message->IsType(type) ||  type == CDVDMsg::NONE)
-      it = m_list.erase(it);
-    else
-      it++;
+    SQueue& queue = it->second;
+    SQueue::iterator keep = queue.begin();
+    for(SQueue::iterator item = queue.begin(); item != queue.end(); item++)
+    {
+      if (item->message->IsType(type) ||  type == CDVDMsg::NONE)
+        continue;
+      if (keep != item)
+        *keep = *item;
+      keep++;
+    }
+    queue.erase(keep, queue.end());
   }
 
   if (type == CDVDMsg::DEMUXER_PACKET ||  type == CDVDMsg::NONE)
@@ -97,14 +104,7 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority)
     return MSGQ_INVALID_MSG;
   }
 
-  SList::iterator it = m_list.begin();
-  while(it != m_list.end())
-  {
-    if(priority <= it->priority)
-      break;
-    it++;
-  }
-  m_list.insert(it, DVDMessageListItem(pMsg, priority));
+  m_queues[priority].push_back(DVDMessageListItem(pMsg, priority));
 
   if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET) && priority == 0)
   {
@@ -142,7 +142,7 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
     return MSGQ_NOT_INITIALIZED;
   }
 
-  if(m_list.empty() && m_bEmptied == false && priority == 0 && m_owner != "teletext")
+  if(!GetFirstQueue() && m_bEmptied == false && priority == 0 && m_owner != "teletext")
   {
     CLog::Log(LOGWARNING, "CDVDMessageQueue(%s)::Get - asked for new data packet, with nothing available", m_owner.c_str());
     m_bEmptied = true;
@@ -150,9 +150,10 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
 
   while (!m_bAbortRequest)
   {
-    if(!m_list.empty() && m_list.back().priority >= priority && !m_bCaching)
+    SQueue* queue = GetFirstQueue();
+    if(queue && queue->front().priority >= priority && !m_bCaching)
     {
-      DVDMessageListItem& item(m_list.back());
+      DVDMessageListItem& item(queue->front());
       priority = item.priority;
 
       if (item.message->IsType(CDVDMsg::DEMUXER_PACKET) && item.priority == 0)
@@ -172,7 +173,7 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
       }
 
       *pMsg = item.message->Acquire();
-      m_list.pop_back();
+      queue->pop_front();
 
       ret = MSGQ_OK;
       break;
@@ -209,10 +210,13 @@ unsigned CDVDMessageQueue::GetPacketCount(CDVDMsg::Message type)
     return 0;
 
   unsigned count = 0;
-  for(SList::iterator it = m_list.begin(); it != m_list.end();it++)
+  for(SQueues::iterator it = m_queues.begin(); it != m_queues.end(); it++)
   {
-    if(it->message->IsType(type))
-      count++;
+    for(SQueue::iterator item = it->second.begin(); item != it->second.end(); item++)
+    {
+      if(item->message->IsType(type))
+        count++;
+    }
   }
 
   return count;
@@ -227,6 +231,16 @@ void CDVDMessageQueue::WaitUntilEmpty()
     msg->Release();
 }
 
+CDVDMessageQueue::SQueue* CDVDMessageQueue::GetFirstQueue()
+{
+  for(SQueues::iterator it = m_queues.begin(); it != m_queues.end(); it++)
+  {
+    if(!it->second.empty())
+      return &it->second;
+  }
+  return NULL;
+}
+
 int CDVDMessageQueue::GetLevel() const
 {
   if(m_iDataSize > m_iMaxDataSize)
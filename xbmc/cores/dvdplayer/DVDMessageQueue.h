@@ -4,7 +4,9 @@
 
 #include "DVDMessage.h"
 #include <string>
-#include <list>
+#include <deque>
+#include <map>
+#include <functional>
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
 
@@ -119,7 +121,12 @@ private:
   bool m_bEmptied;
   std::string m_owner;
 
-  typedef std::list<DVDMessageListItem> SList;
-  SList m_list;
+  // a queue per priority, highest first, each in the order messages were put. A deque grows in
+  // blocks rather than a node per message, so queueing a packet doesn't allocate.
+  typedef std::deque<DVDMessageListItem> SQueue;
+  typedef std::map<int, SQueue, std::greater<int> > SQueues;
+  SQueues m_queues;
+
+  SQueue* GetFirstQueue();
 };
 
@@ -98,6 +98,12 @@ HRESULT __stdcall DVDPerformanceCounterMainPerformance(PLARGE_INTEGER numerator,
   return S_OK;
 }
 
+HRESULT __stdcall DVDPerformanceCounterPacketsLive(PLARGE_INTEGER numerator, PLARGE_INTEGER demoninator)
+{
+  numerator->QuadPart = g_dvdPerformanceCounter.m_packetsLive;
+  return S_OK;
+}
+
 CDVDPerformanceCounter g_dvdPerformanceCounter;
 
 CDVDPerformanceCounter::CDVDPerformanceCounter()
@@ -105,6 +111,10 @@ CDVDPerformanceCounter::CDVDPerformanceCounter()
   m_pAudioQueue = NULL;
   m_pVideoQueue = NULL;
 
+  m_packetAllocations = 0;
+  m_packetPoolMisses  = 0;
+  m_packetsLive       = 0;
+
   memset(&m_videoDecodePerformance, 0, sizeof(m_videoDecodePerformance)); // video decoding
   memset(&m_audioDecodePerformance, 0, sizeof(m_audioDecodePerformance)); // audio decoding + output to audio device
   memset(&m_mainPerformance,        0, sizeof(m_mainPerformance));        // reading files, demuxing, decoding of subtitles + menu overlays
@@ -128,6 +138,7 @@ bool CDVDPerformanceCounter::Initialize()
   DmRegisterPerformanceCounter("DVDVideoDecodePerformance",   DMCOUNT_SYNC, DVDPerformanceCounterVideoDecodePerformance);
   DmRegisterPerformanceCounter("DVDAudioDecodePerformance",   DMCOUNT_SYNC, DVDPerformanceCounterAudioDecodePerformance);
   DmRegisterPerformanceCounter("DVDMainPerformance",          DMCOUNT_SYNC, DVDPerformanceCounterMainPerformance);
+  DmRegisterPerformanceCounter("DVDPacketsLive",              DMCOUNT_SYNC, DVDPerformanceCounterPacketsLive);
 
 #endif
 
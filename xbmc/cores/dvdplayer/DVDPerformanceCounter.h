@@ -48,6 +48,11 @@ public:
   ProcessPerformance        m_audioDecodePerformance;
   ProcessPerformance        m_mainPerformance;
 
+  // demux packet allocations (see CDVDDemuxUtils), counted without locking
+  volatile long             m_packetAllocations; ///< packets allocated
+  volatile long             m_packetPoolMisses;  ///< packets too big for the pools, allocated on their own
+  volatile long             m_packetsLive;       ///< packets allocated and not freed yet
+
 private:
   CCriticalSection m_critSection;
 };
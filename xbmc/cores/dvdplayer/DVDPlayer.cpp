@@ -55,6 +55,7 @@
 #include "dialogs/GUIDialogKaiToast.h"
 #include "utils/StringUtils.h"
 #include "Util.h"
+#include "cores/PlaybackTelemetry.h"
 
 using namespace std;
 
@@ -762,10 +763,15 @@ bool CDVDPlayer::ReadPacket(DemuxPacket*& packet, CDemuxStream*& stream)
 
   // read a data frame from stream.
   if(m_pDemuxer)
+  {
+    CPlaybackStageTimer timer(PLAYBACK_STAGE_READ);
     packet = m_pDemuxer->Read();
+  }
 
   if(packet)
   {
+    CPlaybackTelemetry::AddBytesRead(packet->iSize);
+
     // this groupId stuff is getting a bit messy, need to find a better way
     // currently it is used to determine if a menu overlay is associated with a picture
     // for dvd's we use as a group id, the current cell and the current title
@@ -1845,6 +1851,8 @@ void CDVDPlayer::SendPlayerMessage(CDVDMsg* pMsg, unsigned int target)
 void CDVDPlayer::OnExit()
 {
   g_dvdPerformanceCounter.DisableMainPerformance();
+  CLog::Log(LOGDEBUG, "CDVDPlayer::OnExit - %ld demux packets allocated so far, %ld too big for the pools",
+            g_dvdPerformanceCounter.m_packetAllocations, g_dvdPerformanceCounter.m_packetPoolMisses);
 
   try
   {
@@ -2436,6 +2444,7 @@ void CDVDPlayer::GetGeneralInfo(CStdString& strGeneralInfo)
       if(m_playSpeed == 0 || m_caching == CACHESTATE_FULL)
         strBuf.AppendFormat(" %d sec", DVD_TIME_TO_SEC(m_State.cache_delay));
     }
+    strBuf.AppendFormat(" pkt:%ld", g_dvdPerformanceCounter.m_packetsLive);
 
     strGeneralInfo.Format("C( ad:% 6.3f, a/v:% 6.3f%s, dcpu:%2i%% acpu:%2i%% vcpu:%2i%%%s )"
                          , dDelay
@@ -12,6 +12,7 @@
 #include "utils/log.h"
 #include "utils/TimeUtils.h"
 #include "utils/MathUtils.h"
+#include "cores/PlaybackTelemetry.h"
 
 #include <sstream>
 #include <iomanip>
@@ -283,7 +284,11 @@ int CDVDPlayerAudio::DecodeFrame(DVDAudioFrame &audioframe, bool bDropPacket)
       if (dts != DVD_NOPTS_VALUE)
         m_audioClock = dts;
 
-      int len = m_pAudioCodec->Decode(m_decode.data, m_decode.size);
+      int len;
+      {
+        CPlaybackStageTimer timer(PLAYBACK_STAGE_AUDIO_DECODE);
+        len = m_pAudioCodec->Decode(m_decode.data, m_decode.size);
+      }
       m_audioStats.AddSampleBytes(m_decode.size);
       if (len < 0)
       {
@@ -807,7 +812,10 @@ bool CDVDPlayerAudio::OutputPacket(DVDAudioFrame &audioframe)
     m_resampler.SetRatio(m_resampleratio);
 
     //add to the resampler
-    m_resampler.Add(audioframe, audioframe.pts);
+    {
+      CPlaybackStageTimer timer(PLAYBACK_STAGE_RESAMPLE);
+      m_resampler.Add(audioframe, audioframe.pts);
+    }
     //give any packets from the resampler to the audiorenderer
     bool packetadded = false;
     while(m_resampler.Retrieve(audioframe, audioframe.pts))
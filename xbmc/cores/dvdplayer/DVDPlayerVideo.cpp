@@ -26,6 +26,7 @@
 #include <numeric>
 #include <iterator>
 #include "utils/log.h"
+#include "cores/PlaybackTelemetry.h"
 
 using namespace std;
 
@@ -499,7 +500,11 @@ void CDVDPlayerVideo::Process()
 
       mFilters = m_pVideoCodec->SetFilters(mFilters);
 
-      int iDecoderState = m_pVideoCodec->Decode(pPacket->pData, pPacket->iSize, pPacket->dts, pPacket->pts);
+      int iDecoderState;
+      {
+        CPlaybackStageTimer timer(PLAYBACK_STAGE_VIDEO_DECODE);
+        iDecoderState = m_pVideoCodec->Decode(pPacket->pData, pPacket->iSize, pPacket->dts, pPacket->pts);
+      }
 
       // buffer packets so we can recover should decoder flush for some reason
       if(m_pVideoCodec->GetConvergeCount() > 0)
@@ -1223,14 +1228,18 @@ int CDVDPlayerVideo::OutputPicture(const DVDVideoPicture* src, double pts)
   ProcessOverlays(pPicture, pts);
   AutoCrop(pPicture);
 
-  int index = g_renderManager.AddVideoPicture(*pPicture);
-
-  // video device might not be done yet
-  while (index < 0 && !CThread::m_bStop &&
-         CDVDClock::GetAbsoluteClock(false) < iCurrentClock + iSleepTime + DVD_MSEC_TO_TIME(500) )
+  int index;
   {
-    Sleep(1);
+    CPlaybackStageTimer timer(PLAYBACK_STAGE_VIDEO_WRITE);
     index = g_renderManager.AddVideoPicture(*pPicture);
+
+    // video device might not be done yet
+    while (index < 0 && !CThread::m_bStop &&
+           CDVDClock::GetAbsoluteClock(false) < iCurrentClock + iSleepTime + DVD_MSEC_TO_TIME(500) )
+    {
+      Sleep(1);
+      index = g_renderManager.AddVideoPicture(*pPicture);
+    }
   }
 
   if (index < 0)
@@ -8,6 +8,7 @@
 #include "cores/dvdplayer/DVDDemuxers/DVDDemuxUtils.h"
 #include "cores/dvdplayer/DVDStreamInfo.h"
 #include "cores/dvdplayer/DVDCodecs/DVDFactoryCodec.h"
+#include "cores/PlaybackTelemetry.h"
 #include "utils/log.h"
 
 #include "AudioDecoder.h"
@@ -235,7 +236,10 @@ int DVDPlayerCodec::ReadPCM(BYTE *pBuffer, int size, int *actualsize)
     {
       do
       {
+        CPlaybackStageTimer timer(PLAYBACK_STAGE_READ);
         m_pPacket = m_pDemuxer->Read();
+        if (m_pPacket)
+          CPlaybackTelemetry::AddBytesRead(m_pPacket->iSize);
       } while (m_pPacket && m_pPacket->iStreamId != m_nAudioStream);
 
       if (!m_pPacket)
@@ -245,7 +249,10 @@ int DVDPlayerCodec::ReadPCM(BYTE *pBuffer, int size, int *actualsize)
       m_audioPos = 0;
     }
 
-    decodeLen = m_pAudioCodec->Decode(m_pPacket->pData + m_audioPos, m_pPacket->iSize - m_audioPos);
+    {
+      CPlaybackStageTimer timer(PLAYBACK_STAGE_AUDIO_DECODE);
+      decodeLen = m_pAudioCodec->Decode(m_pPacket->pData + m_audioPos, m_pPacket->iSize - m_audioPos);
+    }
 
     if (decodeLen < 0)
       m_audioPos = m_pPacket->iSize; // skip packet
@@ -2,6 +2,7 @@
 
 #include "MP3codec.h"
 #include "FileItem.h"
+#include "cores/PlaybackTelemetry.h"
 #include "utils/log.h"
 
 using namespace MUSIC_INFO;
@@ -205,7 +206,12 @@ int MP3Codec::Read(int size, bool init)
       if (inputBufferToRead >  fileLeft ) inputBufferToRead = fileLeft;
     }
 
-    DWORD dwBytesRead = m_file.Read(m_InputBuffer + m_InputBufferPos , inputBufferToRead);
+    DWORD dwBytesRead;
+    {
+      CPlaybackStageTimer timer(PLAYBACK_STAGE_READ);
+      dwBytesRead = m_file.Read(m_InputBuffer + m_InputBufferPos , inputBufferToRead);
+    }
+    CPlaybackTelemetry::AddBytesRead(dwBytesRead);
     if (!dwBytesRead)
     {
       CLog::Log(LOGERROR, "MP3Codec: Error reading file");
@@ -249,7 +255,10 @@ int MP3Codec::Read(int size, bool init)
       }
 
       // Now decode data into the vacant frame buffer.
-      result = Decode(&outputsize);
+      {
+        CPlaybackStageTimer timer(PLAYBACK_STAGE_AUDIO_DECODE);
+        result = Decode(&outputsize);
+      }
       if ( result != DECODING_ERROR)
       {
         if (init)
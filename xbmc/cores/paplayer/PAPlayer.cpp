@@ -12,6 +12,7 @@
 #include "settings/Settings.h"
 #include "music/tags/MusicInfoTag.h"
 #include "../AudioRenderers/AudioRendererFactory.h"
+#include "cores/PlaybackTelemetry.h"
 #include "utils/TimeUtils.h"
 #include "utils/log.h"
 #include "utils/MathUtils.h"
@@ -954,6 +955,7 @@ bool PAPlayer::AddPacketsToStream(int stream, CAudioDecoder &dec)
   int amount = m_resampler[stream].GetInputSamples();
   if (amount > 0 && amount <= (int)dec.GetDataSize())
   { // resampler wants more data - let's feed it
+    CPlaybackStageTimer timer(PLAYBACK_STAGE_RESAMPLE);
     m_resampler[stream].PutFloatData((float *)dec.GetData(amount), amount);
     ret = true;
   }
@@ -972,7 +974,11 @@ bool PAPlayer::AddPacketsToStream(int stream, CAudioDecoder &dec)
 
     while (m_bufferPos[stream] >= (int)m_pAudioDecoder[stream]->GetChunkLen())
     {
-      int rtn = m_pAudioDecoder[stream]->AddPackets(m_pcmBuffer[stream], m_bufferPos[stream]);
+      int rtn;
+      {
+        CPlaybackStageTimer timer(PLAYBACK_STAGE_AUDIO_WRITE);
+        rtn = m_pAudioDecoder[stream]->AddPackets(m_pcmBuffer[stream], m_bufferPos[stream]);
+      }
 
       if (rtn > 0)
       {
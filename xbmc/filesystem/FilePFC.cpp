@@ -2,6 +2,7 @@
 #include "URL.h"
 #include "Util.h"
 #include "../utils/URIUtils.h"
+#include "cores/PlaybackTelemetry.h"
 //#include "Rijndael.h"
 
 #include <sys/stat.h>
@@ -32,95 +33,38 @@ __inline void coolcopy(byte* pcSource, byte* pcDest, int64_t posSource, int64_t
 		pcDest[posDest+c] = pcSource[posSource+c];
 }
 
-bool CFilePFC::LoadHeader() {
-  m_file.Seek(0, SEEK_SET);
-  if (m_file.Read(&m_sHeader, sizeof(sRPFHeader)) != sizeof(sRPFHeader))
-  {
-    CLog::Log(LOGERROR, "PFCFile: Unable to read header: %s", strPFCFileName.c_str());
-    return false;
-  }
-
-  if (m_sHeader.Signature[0] == RPF_PACKFILE_SGN0 && m_sHeader.Signature[1] == RPF_PACKFILE_SGN1
-      && m_sHeader.Signature[2] == RPF_PACKFILE_SGN2 && m_sHeader.Signature[3] == RPF_PACKFILE_SGN3)
-  {
-    CLog::Log(LOGDEBUG, "PFCFile: Signed! Files declared: %i", m_sHeader.FileEntries);
-    return true;
-  }
-
-  return false;
-}
-
-bool CFilePFC::LoadFileTable() {
-  uint32_t headerEntries = m_sHeader.FileEntries;
-  uint32_t iFileTableSize = ENTRYSIZE* m_sHeader.FileEntries;
-
-  if (headerEntries > 0)
-  {
-    int64_t seekpos = m_file.GetLength() - iFileTableSize;
-
-    if (!m_file.Seek(seekpos, SEEK_SET))
-    {
-      CLog::Log(LOGERROR, "PFCFile: Can't seek: %s!", strPFCFileName.c_str());
-      return false;
-    }
-
-    m_vecFileTable.clear();
-    m_vecFileTable.resize(headerEntries);
-
-    if (m_file.Read(m_vecFileTable.data(), iFileTableSize) != iFileTableSize)
-    {
-      CLog::Log(LOGERROR, "PFCFile: Corrupted file: %s!", strPFCFileName.c_str());
-      return false;
-    }
-  }
-  else
-  {
-    CLog::Log(LOGERROR, "PFCFile: Broken or empty file: %s!", strPFCFileName.c_str());
-    return false;
-  }
-  if (m_vecFileTable.size() <= 0) return false;
-
-  return true;
-}
-
 bool CFilePFC::GetFileEntry(const CStdString& strFileName, sFileEntry& item) {
-  for (VECFILEENTRY::iterator it2 = m_vecFileTable.begin(); it2 != m_vecFileTable.end(); ++it2)
+  const sFileEntry* entry = m_index->FindEntry(strFileName);
+  if (entry)
   {
-    if (CStdString(it2->FileName) == strFileName)
-    {
-      memcpy(&item, &(*it2), sizeof(sFileEntry));
-      return true;
-    }
+    memcpy(&item, entry, sizeof(sFileEntry));
+    return true;
   }
   CLog::Log( LOGERROR, "PFCFile: unable to find: %s", strFileName.c_str() );
   return false;
 }
 
 bool CFilePFC::GetEntriesList(VECFILEENTRY& items) {
-  if ( m_vecFileTable.size() == 0) return false;
-  items.clear();
-  for (VECFILEENTRY::iterator it = m_vecFileTable.begin(); it != m_vecFileTable.end(); ++it)
-  {
-    items.push_back(*it);
-  }
-
-  //memcpy(&items, &m_vecFileTable, sizeof(sFileEntry));
+  if ( !m_index ) return false;
+  items = m_index->GetEntries();
   return true;
 }
 
 bool CFilePFC::Open(const CURL&url) {
+  CPlaybackStageTimer timer(PLAYBACK_STAGE_PFC_OPEN);
   CLog::Log(LOGDEBUG, "CFilePFC::%s(%s)", __FUNCTION__, url.Get().c_str());
   strPFCFileName = url.GetHostName();
   strCurrentFileItemName = url.GetFileName();
 
+  // header and entry table come from the cached index, unless the container changed
+  m_index = CPFCIndex::Get(strPFCFileName);
+  if ( !m_index ) return false;
+
   if ( !m_file.Open(strPFCFileName) ) { // this is the pfs-file, always open binary
     CLog::Log(LOGERROR,"FilePFC: unable to open PFC file %s!", strPFCFileName.c_str());
     return false;
   }
 
-  if ( !LoadHeader() ) return false;
-  if ( !LoadFileTable() ) return false;
-
 	//URIUtils::
   if (URIUtils::IsInPFC(url.Get())) {
     if ( !GetFileEntry(strCurrentFileItemName, m_sCurrentFileRecord) ) return false;
@@ -4,6 +4,7 @@
 #include "IFile.h"
 #include "utils/log.h"
 #include "File.h"
+#include "PFCIndex.h"
 #include "../jukebox/PFCHeaders.h"
 //#include "PFCManager.h"
 
@@ -57,12 +58,9 @@ private:
 	CStdString strPFCFileName;
 	CStdString strCurrentFileItemName;
 
-  sRPFHeader        m_sHeader;
   sFileEntry            m_sCurrentFileRecord;
-  VECFILEENTRY    m_vecFileTable;
+  CPFCIndexPtr    m_index;
 
-  bool LoadHeader();
-  bool LoadFileTable();
   bool GetFileEntry(const CStdString& strFileName, sFileEntry& item);
 
 	FILE * pDumpFile;
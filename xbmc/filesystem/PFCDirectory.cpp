@@ -1,6 +1,6 @@
 #include "PFCDirectory.h"
 //#include "PFCManager.h"
-#include "FilePFC.h"
+#include "PFCIndex.h"
 #include "utils/log.h"
 #include "utils/CharsetConverter.h"
 #include "utils/URIUtils.h"
@@ -47,119 +47,59 @@ bool CPFCDirectory::GetDirectory(const CStdString& strPathOrig, CFileItemList& i
 	// the RAR code depends on things having a "/" at the end of the path
 	URIUtils::AddSlashAtEnd(strSlashPath);
 
-	VECFILEENTRY entries;
-	// turn on fast lookups
-	bool bWasFast(items.GetFastLookup());
-	items.SetFastLookup(true);
+	CPFCIndexPtr index = CPFCIndex::Get(strArchive);
+	if (!index) return false;
 
-	CFilePFC PFCFile;
-	if ( !PFCFile.Open(strPath) ) return false;
-	if (!PFCFile.GetEntriesList(entries)) return false;
+	// the folder's children come straight from the tree, in entry table order
+	const CPathTree& tree = index->GetTree();
+	const CPathTree::Node* folder = tree.FindFolder(strPathInZip);
+	if (!folder) return true;
 
-	CStdString strSkip;
-	vector<CStdString> baseTokens;
-
-	if (!strPathInZip.IsEmpty()) CUtil::Tokenize(strPathInZip, baseTokens, "/");
-
-	for (VECFILEENTRY::iterator itFileEntry = entries.begin(); itFileEntry != entries.end(); ++itFileEntry)
+	const VECFILEENTRY& entries = index->GetEntries();
+	items.Reserve(folder->children.size());
+	for (vector<unsigned int>::const_iterator itChild = folder->children.begin(); itChild != folder->children.end(); ++itChild)
 	{
+		const CPathTree::Node& child = tree.GetNode(*itChild);
+		const sFileEntry& entry = entries[child.value];
 
-		CStdString strEntryName(itFileEntry->FileName);
-		strEntryName.Replace('\\', '/');
-
-		if (strEntryName == strPathInZip) // skip the listed dir
-			continue;
-
-		vector<CStdString> pathTokens;
-		CUtil::Tokenize(strEntryName, pathTokens, "/");
-
-		if (pathTokens.size() < baseTokens.size() + 1) continue;
+		CFileItemPtr pFileItem(new CFileItem); // Laureon: This fileItem should receive the extra info from plexus album file...
 
-		bool bAdd = (itFileEntry->EntryType != RPF_ENTRY_TYPE_FILE_HIDDEN && itFileEntry->EntryType != RPF_ENTRY_TYPE_SYSTEM);
+		CStdString strLabel(child.name);
+		if (g_charsetConverter.isValidUtf8(strLabel))
+			g_charsetConverter.utf8ToStringCharset(strLabel);
 
-		strEntryName = "";
+		pFileItem->SetLabel(strLabel);
 
-		for (unsigned int i = 0; i < baseTokens.size(); ++i)
+		if (child.folder)
 		{
-			if (pathTokens[i] != baseTokens[i])
-			{
-				bAdd = false;
-				break;
-			}
-			strEntryName += pathTokens[i] + "/";
-		}
-
-		if (!bAdd) continue;
-
-		strEntryName += pathTokens[baseTokens.size()];
-		char c = itFileEntry->FileName[strEntryName.size()];
-
-		if (c == '/' || c == '\\') strEntryName += '/';
-
-		bool bIsFolder = false;
-
-		if (strEntryName[strEntryName.size() - 1] != '/')
-		{ // this is a file
-			strBuffer = strSlashPath + strEntryName + strOptions;
+			strBuffer = strSlashPath + CStdString(child.path) + "/" + strOptions;
+			URIUtils::AddSlashAtEnd(strBuffer);
+			pFileItem->m_dwSize = 0;
 		}
 		else
-		{ // this is new folder. add if not already added
-			bIsFolder = true;
-			strBuffer = strSlashPath + strEntryName + strOptions;
-			if (items.Contains(strBuffer)) // already added
-				continue;
+		{
+			strBuffer = strSlashPath + CStdString(child.path) + strOptions;
+			pFileItem->m_dwSize = entry.UncryptedFileSize;
 		}
 
-		CFileItemPtr pFileItem(new CFileItem); // Laureon: This fileItem should receive the extra info from plexus album file...
-
-		if (g_charsetConverter.isValidUtf8(pathTokens[baseTokens.size()]))
-			g_charsetConverter.utf8ToStringCharset(pathTokens[baseTokens.size()]);
-
-		pFileItem->SetLabel(pathTokens[baseTokens.size()]);
-
-		if (bIsFolder)
-			pFileItem->m_dwSize = 0;
-		else
-			pFileItem->m_dwSize = itFileEntry->UncryptedFileSize;
-
 		pFileItem->SetPath(strBuffer);
-		pFileItem->m_bIsFolder = bIsFolder;
-		pFileItem->m_idepth = itFileEntry->Crypt;
-
-
-		if (bIsFolder) {
-			CStdString filepath = pFileItem->GetPath();
-			URIUtils::AddSlashAtEnd(filepath);
-			pFileItem->SetPath(filepath);
-		}
+		pFileItem->m_bIsFolder = child.folder;
+		pFileItem->m_idepth = entry.Crypt;
 
 		items.Add(pFileItem);
 	}
 
-	items.SetFastLookup(bWasFast);
 	return true;
 }
 
 bool CPFCDirectory::ContainsFiles(const CStdString& strPath)
 {
-	VECFILEENTRY items;
-
-	CFilePFC PFCFile;
-  if ( !PFCFile.Open(strPath) ) return false;
-  if (!PFCFile.GetEntriesList(items)) return false;
-
-	//g_PFCManager.GetEntriesList(strPath, items);
-
-	//return (items.size() > 1)? true:false;
-
-	if (items.size())
-	{
-		if (items.size() > 1) return true;
-
-		return false;
-	}
+	/* as in GetDirectory, a path that isn't an archive path is the archive file */
+	CStdString strContainer = strPath.Left(6).Equals("pfc://") ? CURL(strPath).GetHostName() : strPath;
+	CPFCIndexPtr index = CPFCIndex::Get(strContainer);
+	if (!index) return false;
 
-	return false;
+	return index->GetEntries().size() > 1;
 }
 
 }
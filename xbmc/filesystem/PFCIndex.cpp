@@ -0,0 +1,129 @@
+#include "PFCIndex.h"
+#include "File.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+// containers whose index is kept, the least recently used one makes room
+#define PFC_INDEX_CACHE_SIZE 64
+
+using namespace XFILE;
+using namespace std;
+
+map<CStdString, CPFCIndex::CCachedIndex> CPFCIndex::m_cache;
+unsigned int CPFCIndex::m_uses = 0;
+CCriticalSection CPFCIndex::m_cacheSection;
+
+CPFCIndexPtr CPFCIndex::Get(const CStdString& strContainer)
+{
+  struct __stat64 statData = {};
+  if (CFile::Stat(strContainer, &statData))
+  {
+    CLog::Log(LOGERROR, "PFCIndex: unable to stat PFC file %s!", strContainer.c_str());
+    return CPFCIndexPtr();
+  }
+
+  {
+    CSingleLock lock(m_cacheSection);
+    map<CStdString, CCachedIndex>::iterator it = m_cache.find(strContainer);
+    if (it != m_cache.end())
+    {
+      if (it->second.modified == (int64_t)statData.st_mtime)
+      {
+        it->second.lastUse = ++m_uses;
+        return it->second.index;
+      }
+      m_cache.erase(it);
+    }
+  }
+
+  CFile file;
+  if (!file.Open(strContainer))
+  {
+    CLog::Log(LOGERROR, "PFCIndex: unable to open PFC file %s!", strContainer.c_str());
+    return CPFCIndexPtr();
+  }
+  CPFCIndex *index = new CPFCIndex;
+  CPFCIndexPtr result(index);
+  if (!index->Load(file, strContainer))
+    return CPFCIndexPtr();
+
+  CSingleLock lock(m_cacheSection);
+  if (m_cache.size() >= PFC_INDEX_CACHE_SIZE)
+  {
+    map<CStdString, CCachedIndex>::iterator oldest = m_cache.begin();
+    for (map<CStdString, CCachedIndex>::iterator it = m_cache.begin(); it != m_cache.end(); ++it)
+    {
+      if (it->second.lastUse < oldest->second.lastUse)
+        oldest = it;
+    }
+    m_cache.erase(oldest);
+  }
+  CCachedIndex &cached = m_cache[strContainer];
+  cached.index = result;
+  cached.modified = statData.st_mtime;
+  cached.lastUse = ++m_uses;
+  return result;
+}
+
+void CPFCIndex::Release(const CStdString& strContainer)
+{
+  CSingleLock lock(m_cacheSection);
+  m_cache.erase(strContainer);
+}
+
+const sFileEntry* CPFCIndex::FindEntry(const CStdString& strFileName) const
+{
+  map<CStdString, unsigned int>::const_iterator it = m_names.find(strFileName);
+  if (it == m_names.end())
+    return NULL;
+  return &m_entries[it->second];
+}
+
+bool CPFCIndex::Load(CFile& file, const CStdString& strContainer)
+{
+  if (file.Read(&m_header, sizeof(sRPFHeader)) != sizeof(sRPFHeader))
+  {
+    CLog::Log(LOGERROR, "PFCFile: Unable to read header: %s", strContainer.c_str());
+    return false;
+  }
+
+  if (m_header.Signature[0] != RPF_PACKFILE_SGN0 || m_header.Signature[1] != RPF_PACKFILE_SGN1
+      || m_header.Signature[2] != RPF_PACKFILE_SGN2 || m_header.Signature[3] != RPF_PACKFILE_SGN3)
+    return false;
+
+  CLog::Log(LOGDEBUG, "PFCFile: Signed! Files declared: %i", m_header.FileEntries);
+
+  uint32_t headerEntries = m_header.FileEntries;
+  uint32_t iFileTableSize = ENTRYSIZE * headerEntries;
+  if (headerEntries == 0)
+  {
+    CLog::Log(LOGERROR, "PFCFile: Broken or empty file: %s!", strContainer.c_str());
+    return false;
+  }
+
+  if (file.Seek(file.GetLength() - iFileTableSize, SEEK_SET) < 0)
+  {
+    CLog::Log(LOGERROR, "PFCFile: Can't seek: %s!", strContainer.c_str());
+    return false;
+  }
+
+  m_entries.resize(headerEntries);
+  if (file.Read(&m_entries[0], iFileTableSize) != iFileTableSize)
+  {
+    CLog::Log(LOGERROR, "PFCFile: Corrupted file: %s!", strContainer.c_str());
+    return false;
+  }
+
+  for (unsigned int i = 0; i < m_entries.size(); i++)
+  {
+    const sFileEntry &entry = m_entries[i];
+    CStdString strName(entry.FileName);
+    m_names.insert(make_pair(strName, i)); // the first of duplicate names is found
+
+    if (entry.EntryType == RPF_ENTRY_TYPE_FILE_HIDDEN || entry.EntryType == RPF_ENTRY_TYPE_SYSTEM)
+      continue;
+    strName.Replace('\\', '/');
+    m_tree.Add(strName, i);
+  }
+  return true;
+}
@@ -0,0 +1,72 @@
+#ifndef PFC_INDEX_H
+#define PFC_INDEX_H
+
+#include "utils/StdString.h"
+#include "utils/PathTree.h"
+#include "threads/CriticalSection.h"
+#include "../jukebox/PFCHeaders.h"
+
+#include <boost/shared_ptr.hpp>
+#include <map>
+
+namespace XFILE {
+
+class CFile;
+class CPFCIndex;
+typedef boost::shared_ptr<const CPFCIndex> CPFCIndexPtr;
+
+/*!
+ \brief Header and entry table of a PFC container, with the folder tree of its entries.
+
+ Indexes are cached per container, like CZipManager caches zip listings, and are reread when
+ the container's modification time changes. Opening a file in a container or listing one of
+ its folders then costs a stat of the container instead of reading its header and table, and
+ listing a folder walks only its children.
+
+ The tree leaves out hidden and system entries, which are not listed; FindEntry() finds
+ every entry. The value of each tree node is the index of its entry in GetEntries() (for
+ folders, of the first entry inside them).
+ */
+class CPFCIndex
+{
+public:
+  /*! \brief Get the index of a container, from the cache if the container is unchanged.
+   \param strContainer path of the .pfc file.
+   \return the index, empty if the container can't be read. Holders keep it valid while the
+   cache moves on.
+   */
+  static CPFCIndexPtr Get(const CStdString& strContainer);
+  static void Release(const CStdString& strContainer);
+
+  const sRPFHeader& GetHeader() const { return m_header; }
+  const VECFILEENTRY& GetEntries() const { return m_entries; }
+  const CPathTree& GetTree() const { return m_tree; }
+
+  /*! \brief Find an entry by its name, as stored in the entry table.
+   \return the entry, NULL if the container has no such entry.
+   */
+  const sFileEntry* FindEntry(const CStdString& strFileName) const;
+
+private:
+  CPFCIndex() {}
+  bool Load(CFile& file, const CStdString& strContainer);
+
+  sRPFHeader m_header;
+  VECFILEENTRY m_entries;
+  std::map<CStdString, unsigned int> m_names;
+  CPathTree m_tree;
+
+  struct CCachedIndex
+  {
+    CPFCIndexPtr index;
+    int64_t modified;
+    unsigned int lastUse;
+  };
+  static std::map<CStdString, CCachedIndex> m_cache;
+  static unsigned int m_uses;
+  static CCriticalSection m_cacheSection;
+};
+
+}
+
+#endif
@@ -16,6 +16,8 @@ public:
   CDirtyRegionTracker(int buffering = DEFAULT_BUFFERING);
   ~CDirtyRegionTracker();
   void SelectAlgorithm();
+  /*! \brief Set the number of frames a marked region is rendered for */
+  void SetBuffering(int buffering) { m_buffering = buffering; }
   void MarkDirtyRegion(const CDirtyRegion &region);
 
   const CDirtyRegionList &GetMarkedRegions() const;
@@ -39,6 +39,8 @@ public:
   virtual void UpdateVisibility(const CGUIListItem *item = NULL);
 
   virtual unsigned int GetRows() const;
+  /*! \brief Number of items that fit on screen. */
+  virtual int GetItemsPerPage() const { return m_itemsPerPage; };
 
   virtual bool HasNextPage() const;
   virtual bool HasPreviousPage() const;
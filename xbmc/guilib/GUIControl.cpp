@@ -119,7 +119,11 @@ void CGUIControl::DoProcess(unsigned int currentTime, CDirtyRegionList &dirtyreg
     g_graphicsContext.SetCameraPosition(m_camera);
 
   if (IsVisible())
+  {
+    GUIPROFILER_PROCESS_BEGIN(this);
     Process(currentTime, dirtyregions);
+    GUIPROFILER_PROCESS_END(this);
+  }
 
   changed |=  m_controlIsDirty;
 
@@ -154,9 +158,14 @@ void CGUIControl::DoRender()
     g_graphicsContext.SetCameraPosition(m_camera);
   if (IsVisible())
   {
-    GUIPROFILER_RENDER_BEGIN(this);
-    Render();
-    GUIPROFILER_RENDER_END(this);
+    if (IsCulled())
+      m_hasRendered = true; // as it would have, had it been in the region being rendered
+    else
+    {
+      GUIPROFILER_RENDER_BEGIN(this);
+      Render();
+      GUIPROFILER_RENDER_END(this);
+    }
   }
   if (m_hasCamera)
     g_graphicsContext.RestoreCameraPosition();
@@ -168,6 +177,15 @@ void CGUIControl::Render()
   m_hasRendered = true;
 }
 
+bool CGUIControl::IsCulled() const
+{
+  const CRect &scissors = g_graphicsContext.GetScissors();
+  if (m_renderRegion.IsEmpty() || scissors.IsEmpty())
+    return false;
+  return m_renderRegion.x2 <= scissors.x1 || m_renderRegion.x1 >= scissors.x2 ||
+         m_renderRegion.y2 <= scissors.y1 || m_renderRegion.y1 >= scissors.y2;
+}
+
 bool CGUIControl::OnAction(const CAction &action)
 {
   if (HasFocus())
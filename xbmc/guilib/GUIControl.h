@@ -150,6 +150,11 @@ public:
 
   void MarkDirtyRegion();
 
+  /*! \brief whether the control lies outside the region being rendered, so rendering it can be skipped.
+   Controls that don't track their render region are never culled.
+   */
+  bool IsCulled() const;
+
   /*! \brief return the render region in screen coordinates of this control
    */
   const CRect &GetRenderRegion() const { return m_renderRegion; };
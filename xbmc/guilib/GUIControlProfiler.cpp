@@ -1,19 +1,44 @@
 
 
 #include "GUIControlProfiler.h"
+#include "GUIWindow.h"
+#include "filesystem/File.h"
+#include "interfaces/Builtins.h"
+#include "threads/SingleLock.h"
 #include "tinyXML/tinyxml.h"
 #include "utils/TimeUtils.h"
+#include "utils/Variant.h"
+#include "utils/log.h"
+#include <map>
+#include <stdlib.h>
+
+using namespace std;
 
 bool CGUIControlProfiler::m_bIsRunning = false;
+volatile bool CGUIControlProfiler::m_bIsSampling = false;
 
 CGUIControlProfilerItem::CGUIControlProfilerItem(CGUIControlProfiler *pProfiler, CGUIControlProfilerItem *pParent, CGUIControl *pControl)
-: m_pProfiler(pProfiler), m_pParent(pParent), m_pControl(pControl), m_visTime(0), m_renderTime(0)
+: m_pProfiler(pProfiler), m_pParent(pParent), m_pControl(pControl), m_visTime(0), m_processTime(0), m_renderTime(0),
+  m_detached(false), m_sampleProcess(0), m_sampleRender(0), m_sampled(false)
 {
   if (m_pControl)
   {
     m_controlID = m_pControl->GetID();
     m_ControlType = m_pControl->GetControlType();
     m_strDescription = m_pControl->GetDescription();
+
+    // descriptions change with what the control shows, so they don't name it in sampled profiles
+    CGUIWindow *window = dynamic_cast<CGUIWindow *>(m_pControl);
+    if (window)
+      m_strName = window->GetProperty("xmlfile").asString();
+    else
+    {
+      const char *type = GetTypeName(m_ControlType);
+      m_strName = type ? type : "control";
+      if (m_controlID != 0)
+        m_strName.AppendFormat("#%d", m_controlID);
+    }
+    m_strName.Replace(';', ':'); // the separator of folded stacks
   }
   else
   {
@@ -34,7 +59,13 @@ void CGUIControlProfilerItem::Reset(CGUIControlProfiler *pProfiler)
   m_pControl = NULL;
 
   m_visTime = 0;
+  m_processTime = 0;
   m_renderTime = 0;
+  m_sampleProcess = 0;
+  m_sampleRender = 0;
+  m_sampled = false;
+  m_samples[0].Reset();
+  m_samples[1].Reset();
   const unsigned int dwSize = m_vecChildren.size();
   for (unsigned int i=0; i<dwSize; ++i)
     delete m_vecChildren[i];
@@ -53,6 +84,19 @@ void CGUIControlProfilerItem::EndVisibility(void)
   m_visTime += (unsigned int)(m_pProfiler->m_fPerfScale * (CurrentHostCounter() - m_i64VisStart));
 }
 
+void CGUIControlProfilerItem::BeginProcess(void)
+{
+  m_i64ProcessStart = CurrentHostCounter();
+}
+
+void CGUIControlProfilerItem::EndProcess(void)
+{
+  int64_t ticks = CurrentHostCounter() - m_i64ProcessStart;
+  m_processTime += (unsigned int)(m_pProfiler->m_fPerfScale * ticks);
+  m_sampleProcess += ticks;
+  m_sampled = true;
+}
+
 void CGUIControlProfilerItem::BeginRender(void)
 {
   m_i64RenderStart = CurrentHostCounter();
@@ -60,16 +104,73 @@ void CGUIControlProfilerItem::BeginRender(void)
 
 void CGUIControlProfilerItem::EndRender(void)
 {
-  m_renderTime += (unsigned int)(m_pProfiler->m_fPerfScale * (CurrentHostCounter() - m_i64RenderStart));
+  int64_t ticks = CurrentHostCounter() - m_i64RenderStart;
+  m_renderTime += (unsigned int)(m_pProfiler->m_fPerfScale * ticks);
+  m_sampleRender += ticks;
+  m_sampled = true;
 }
 
-void CGUIControlProfilerItem::SaveToXML(TiXmlElement *parent)
+void CGUIControlProfilerItem::EndSampledFrame(int generation)
 {
-  TiXmlElement *xmlControl = new TiXmlElement("control");
-  parent->LinkEndChild(xmlControl);
+  if (m_sampled)
+  {
+    // a control processed but culled from rendering counts as rendering in no time
+    CGUIControlProfilerSamples &samples = m_samples[generation];
+    int64_t process = (int64_t)(m_sampleProcess * m_pProfiler->m_fSampleScale);
+    int64_t render = (int64_t)(m_sampleRender * m_pProfiler->m_fSampleScale);
+    samples.process.Add(process);
+    samples.render.Add(render);
+    samples.processTotal += process;
+    samples.renderTotal += render;
+    m_sampleProcess = 0;
+    m_sampleRender = 0;
+    m_sampled = false;
+  }
+
+  const unsigned int dwSize = m_vecChildren.size();
+  for (unsigned int i=0; i<dwSize; ++i)
+    m_vecChildren[i]->EndSampledFrame(generation);
+}
+
+void CGUIControlProfilerItem::ResetGeneration(int generation)
+{
+  m_samples[generation].Reset();
+  for (vector<CGUIControlProfilerItem *>::iterator it = m_vecChildren.begin(); it != m_vecChildren.end();)
+  {
+    CGUIControlProfilerItem *p = *it;
+    p->ResetGeneration(generation);
+    // a control not sampled for a whole generation is likely freed, as the layouts of the items
+    // of a list that was reloaded are, and it is added again if it shows up
+    if (p->m_vecChildren.empty() && p->m_samples[0].IsEmpty() && p->m_samples[1].IsEmpty())
+    {
+      delete p;
+      it = m_vecChildren.erase(it);
+    }
+    else
+      ++it;
+  }
+}
+
+bool CGUIControlProfilerItem::IsControl(const CGUIControl *pControl) const
+{
+  // a control freed and another allocated at its address must not take over its item
+  return !m_detached && m_pControl == pControl &&
+         m_ControlType == pControl->GetControlType() && m_controlID == pControl->GetID();
+}
+
+void CGUIControlProfilerItem::Detach(void)
+{
+  m_detached = true;
+  m_pControl = NULL;
+  const unsigned int dwSize = m_vecChildren.size();
+  for (unsigned int i=0; i<dwSize; ++i)
+    m_vecChildren[i]->Detach();
+}
 
+const char *CGUIControlProfilerItem::GetTypeName(CGUIControl::GUICONTROLTYPES type)
+{
   const char *lpszType = NULL;
-  switch (m_ControlType)
+  switch (type)
   {
   case CGUIControl::GUICONTROL_BUTTON:
     lpszType = "button"; break;
@@ -140,7 +241,15 @@ void CGUIControlProfilerItem::SaveToXML(TiXmlElement *parent)
   default:
     break;
   }
+  return lpszType;
+}
 
+void CGUIControlProfilerItem::SaveToXML(TiXmlElement *parent)
+{
+  TiXmlElement *xmlControl = new TiXmlElement("control");
+  parent->LinkEndChild(xmlControl);
+
+  const char *lpszType = GetTypeName(m_ControlType);
   if (lpszType)
     xmlControl->SetAttribute("type", lpszType);
   if (m_controlID != 0)
@@ -168,8 +277,9 @@ void CGUIControlProfilerItem::SaveToXML(TiXmlElement *parent)
 
   // Note time is stored in 1/100 milliseconds but reported in ms
   unsigned int vis = m_visTime / 100;
+  unsigned int proc = m_processTime / 100;
   unsigned int rend = m_renderTime / 100;
-  if (vis || rend)
+  if (vis || proc || rend)
   {
     CStdString val;
     TiXmlElement *elem = new TiXmlElement("rendertime");
@@ -178,6 +288,12 @@ void CGUIControlProfilerItem::SaveToXML(TiXmlElement *parent)
     TiXmlText *text = new TiXmlText(val.c_str());
     elem->LinkEndChild(text);
 
+    elem = new TiXmlElement("processtime");
+    xmlControl->LinkEndChild(elem);
+    val.Format("%u", proc);
+    text = new TiXmlText(val.c_str());
+    elem->LinkEndChild(text);
+
     elem = new TiXmlElement("visibletime");
     xmlControl->LinkEndChild(elem);
     val.Format("%u", vis);
@@ -197,6 +313,7 @@ void CGUIControlProfilerItem::SaveToXML(TiXmlElement *parent)
 
 CGUIControlProfilerItem *CGUIControlProfilerItem::AddControl(CGUIControl *pControl)
 {
+  CSingleLock lock(m_pProfiler->m_section);
   m_vecChildren.push_back(new CGUIControlProfilerItem(m_pProfiler, this, pControl));
   return m_vecChildren.back();
 }
@@ -207,7 +324,7 @@ CGUIControlProfilerItem *CGUIControlProfilerItem::FindOrAddControl(CGUIControl *
   for (unsigned int i=0; i<dwSize; ++i)
   {
     CGUIControlProfilerItem *p = m_vecChildren[i];
-    if (p->m_pControl == pControl)
+    if (p->IsControl(pControl))
       return p;
     if (recurse && (p = p->FindOrAddControl(pControl, true)))
       return p;
@@ -220,10 +337,13 @@ CGUIControlProfilerItem *CGUIControlProfilerItem::FindOrAddControl(CGUIControl *
 }
 
 CGUIControlProfiler::CGUIControlProfiler(void)
-: m_ItemHead(NULL, NULL, NULL), m_pLastItem(NULL), m_iMaxFrameCount(200)
+: m_ItemHead(NULL, NULL, NULL), m_pLastItem(NULL), m_iMaxFrameCount(200),
+  m_bIsCapturing(false), m_bResetSamples(false), m_iSampleInterval(DEFAULT_SAMPLE_INTERVAL), m_iFrame(0), m_iGeneration(0)
 // m_bIsRunning(false), no isRunning because it is static
 {
   m_fPerfScale = 100000.0f / CurrentHostFrequency();
+  m_fSampleScale = 1000000.0 / CurrentHostFrequency();
+  m_iGenerationFrames[0] = m_iGenerationFrames[1] = 0;
 }
 
 CGUIControlProfiler &CGUIControlProfiler::Instance(void)
@@ -239,12 +359,79 @@ bool CGUIControlProfiler::IsRunning(void)
 
 void CGUIControlProfiler::Start(void)
 {
+  CSingleLock lock(m_section);
+  m_bIsSampling = false;
+  m_bIsCapturing = true;
   m_iFrameCount = 0;
   m_bIsRunning = true;
   m_pLastItem = NULL;
   m_ItemHead.Reset(this);
 }
 
+void CGUIControlProfiler::StartSampling(unsigned int interval)
+{
+  // the tree of items is reset from the rendering thread, at the end of the frame
+  CSingleLock lock(m_section);
+  m_iSampleInterval = interval ? interval : 1;
+  m_bIsCapturing = false;
+  m_bResetSamples = true;
+  m_bIsSampling = true;
+  CLog::Log(LOGNOTICE, "%s - sampling one frame in %u", __FUNCTION__, m_iSampleInterval);
+}
+
+void CGUIControlProfiler::StopSampling(void)
+{
+  CSingleLock lock(m_section);
+  if (!m_bIsSampling)
+    return;
+  m_bIsSampling = false;
+  m_bIsRunning = false;
+  CLog::Log(LOGNOTICE, "%s - stopped after %u sampled frames", __FUNCTION__, m_iGenerationFrames[0] + m_iGenerationFrames[1]);
+}
+
+void CGUIControlProfiler::EndSampledFrame(void)
+{
+  CSingleLock lock(m_section);
+  if (!m_bIsSampling)
+    return;
+
+  if (m_bResetSamples)
+  {
+    m_ItemHead.Reset(this);
+    m_pLastItem = NULL;
+    m_iFrame = 0;
+    m_iGeneration = 0;
+    m_iGenerationFrames[0] = m_iGenerationFrames[1] = 0;
+    m_bResetSamples = false;
+  }
+  else if (m_bIsRunning)
+  {
+    m_ItemHead.EndSampledFrame(m_iGeneration);
+    // roll over to the other generation once this one is full, forgetting the oldest samples
+    if (++m_iGenerationFrames[m_iGeneration] >= ROLLING_FRAMES)
+    {
+      m_iGeneration = 1 - m_iGeneration;
+      m_ItemHead.ResetGeneration(m_iGeneration);
+      m_iGenerationFrames[m_iGeneration] = 0;
+      m_pLastItem = NULL; // may have been pruned
+    }
+  }
+  m_bIsRunning = (++m_iFrame % m_iSampleInterval) == 0;
+}
+
+void CGUIControlProfiler::RemoveWindow(CGUIControl *pWindow)
+{
+  CSingleLock lock(m_section);
+  const unsigned int dwSize = m_ItemHead.m_vecChildren.size();
+  for (unsigned int i=0; i<dwSize; ++i)
+  {
+    CGUIControlProfilerItem *p = m_ItemHead.m_vecChildren[i];
+    if (!p->m_detached && p->m_pControl == pWindow)
+      p->Detach();
+  }
+  m_pLastItem = NULL;
+}
+
 void CGUIControlProfiler::BeginVisibility(CGUIControl *pControl)
 {
   CGUIControlProfilerItem *item = FindOrAddControl(pControl);
@@ -257,6 +444,18 @@ void CGUIControlProfiler::EndVisibility(CGUIControl *pControl)
   item->EndVisibility();
 }
 
+void CGUIControlProfiler::BeginProcess(CGUIControl *pControl)
+{
+  CGUIControlProfilerItem *item = FindOrAddControl(pControl);
+  item->BeginProcess();
+}
+
+void CGUIControlProfiler::EndProcess(CGUIControl *pControl)
+{
+  CGUIControlProfilerItem *item = FindOrAddControl(pControl);
+  item->EndProcess();
+}
+
 void CGUIControlProfiler::BeginRender(CGUIControl *pControl)
 {
   CGUIControlProfilerItem *item = FindOrAddControl(pControl);
@@ -275,13 +474,13 @@ CGUIControlProfilerItem *CGUIControlProfiler::FindOrAddControl(CGUIControl *pCon
   {
     // Typically calls come in pairs so the last control we found is probably
     // the one we want again next time
-    if (m_pLastItem->m_pControl == pControl)
+    if (m_pLastItem->IsControl(pControl))
       return m_pLastItem;
     // If that control is not a match, usually the one we want is the next
     // sibling of that control, or the parent of that control so check
     // the parent first as it is more convenient
     m_pLastItem = m_pLastItem->m_pParent;
-    if (m_pLastItem && m_pLastItem->m_pControl == pControl)
+    if (m_pLastItem && m_pLastItem->IsControl(pControl))
       return m_pLastItem;
     // continued from above, this searches the original control's siblings
     if (m_pLastItem)
@@ -299,6 +498,9 @@ CGUIControlProfilerItem *CGUIControlProfiler::FindOrAddControl(CGUIControl *pCon
 
 void CGUIControlProfiler::EndFrame(void)
 {
+  if (!m_bIsCapturing)
+    return; // sampling, frames end in EndSampledFrame()
+
   m_iFrameCount++;
   if (m_iFrameCount >= m_iMaxFrameCount)
   {
@@ -307,12 +509,18 @@ void CGUIControlProfiler::EndFrame(void)
     {
       CGUIControlProfilerItem *p = m_ItemHead.m_vecChildren[i];
       m_ItemHead.m_visTime += p->m_visTime;
+      m_ItemHead.m_processTime += p->m_processTime;
       m_ItemHead.m_renderTime += p->m_renderTime;
     }
 
+    m_bIsCapturing = false;
     m_bIsRunning = false;
     if (SaveResults())
+    {
+      CSingleLock lock(m_section);
+      m_pLastItem = NULL;
       m_ItemHead.Reset(this);
+    }
   }
 }
 
@@ -335,3 +543,153 @@ bool CGUIControlProfiler::SaveResults(void)
   m_ItemHead.SaveToXML(root);
   return doc.SaveFile(m_strOutputFile);
 }
+
+namespace
+{
+  /*! \brief The samples of the controls that share a stack of windows and controls */
+  struct CGUIControlProfile
+  {
+    CLatencyHistogram process;
+    CLatencyHistogram render;
+    int64_t processTotal;
+    int64_t renderTotal;
+    int64_t processSelf;   ///< time spent in the controls, not in their children
+    int64_t renderSelf;
+
+    CGUIControlProfile() : processTotal(0), renderTotal(0), processSelf(0), renderSelf(0) {}
+  };
+
+  typedef map<CStdString, CGUIControlProfile> CGUIControlProfileMap;
+}
+
+static void GetSampledTotals(const CGUIControlProfilerItem *item, int64_t &process, int64_t &render)
+{
+  process = item->m_samples[0].processTotal + item->m_samples[1].processTotal;
+  render = item->m_samples[0].renderTotal + item->m_samples[1].renderTotal;
+}
+
+// controls of a window unloaded and loaded again are new items, but are merged by their stack
+static void CollectSamples(const CGUIControlProfilerItem *item, const CStdString &stack, CGUIControlProfileMap &profiles)
+{
+  const unsigned int dwSize = item->m_vecChildren.size();
+  for (unsigned int i=0; i<dwSize; ++i)
+  {
+    const CGUIControlProfilerItem *child = item->m_vecChildren[i];
+    CStdString childStack = stack.IsEmpty() ? child->m_strName : stack + ";" + child->m_strName;
+    CGUIControlProfile &profile = profiles[childStack];
+    for (unsigned int generation = 0; generation < 2; generation++)
+    {
+      profile.process.Merge(child->m_samples[generation].process);
+      profile.render.Merge(child->m_samples[generation].render);
+    }
+
+    int64_t process, render;
+    GetSampledTotals(child, process, render);
+    profile.processTotal += process;
+    profile.renderTotal += render;
+    for (unsigned int j=0; j<child->m_vecChildren.size(); ++j)
+    {
+      int64_t childProcess, childRender;
+      GetSampledTotals(child->m_vecChildren[j], childProcess, childRender);
+      process -= childProcess;
+      render -= childRender;
+    }
+    profile.processSelf += max(process, (int64_t)0);
+    profile.renderSelf += max(render, (int64_t)0);
+
+    CollectSamples(child, childStack, profiles);
+  }
+}
+
+static void SerializeHistogram(const CLatencyHistogram &histogram, int64_t total, int64_t self, CVariant &value)
+{
+  value["count"] = (int64_t)histogram.Count();
+  value["max"] = (int64_t)histogram.Max();
+  value["p50"] = (int64_t)histogram.Percentile(0.5);
+  value["p90"] = (int64_t)histogram.Percentile(0.9);
+  value["p99"] = (int64_t)histogram.Percentile(0.99);
+  value["total"] = total;
+  value["self"] = self;
+}
+
+void CGUIControlProfiler::Serialize(CVariant &value)
+{
+  CGUIControlProfileMap profiles;
+  {
+    CSingleLock lock(m_section);
+    CollectSamples(&m_ItemHead, "", profiles);
+    value["sampling"] = (bool)m_bIsSampling;
+    value["interval"] = (int64_t)m_iSampleInterval;
+    value["frames"] = (int64_t)(m_iGenerationFrames[0] + m_iGenerationFrames[1]);
+  }
+
+  value["controls"] = CVariant(CVariant::VariantTypeArray);
+  for (CGUIControlProfileMap::const_iterator it = profiles.begin(); it != profiles.end(); ++it)
+  {
+    const CGUIControlProfile &profile = it->second;
+    if (profile.process.Count() == 0 && profile.render.Count() == 0)
+      continue;
+    CVariant control;
+    control["stack"] = it->first;
+    SerializeHistogram(profile.process, profile.processTotal, profile.processSelf, control["process"]);
+    SerializeHistogram(profile.render, profile.renderTotal, profile.renderSelf, control["render"]);
+    value["controls"].push_back(control);
+  }
+}
+
+CStdString CGUIControlProfiler::GetFlameGraph(void)
+{
+  CGUIControlProfileMap profiles;
+  {
+    CSingleLock lock(m_section);
+    CollectSamples(&m_ItemHead, "", profiles);
+  }
+
+  CStdString folded;
+  for (CGUIControlProfileMap::const_iterator it = profiles.begin(); it != profiles.end(); ++it)
+  {
+    if (it->second.processSelf > 0)
+      folded.AppendFormat("process;%s %"PRId64"\n", it->first.c_str(), it->second.processSelf);
+  }
+  for (CGUIControlProfileMap::const_iterator it = profiles.begin(); it != profiles.end(); ++it)
+  {
+    if (it->second.renderSelf > 0)
+      folded.AppendFormat("render;%s %"PRId64"\n", it->first.c_str(), it->second.renderSelf);
+  }
+  return folded;
+}
+
+bool CGUIControlProfiler::SaveFlameGraph(const CStdString &strFile)
+{
+  CStdString folded = GetFlameGraph();
+  XFILE::CFile file;
+  if (!file.OpenForWrite(strFile, true) || file.Write(folded.c_str(), folded.size()) != (int)folded.size())
+  {
+    CLog::Log(LOGERROR, "%s - unable to write %s", __FUNCTION__, strFile.c_str());
+    return false;
+  }
+  CLog::Log(LOGNOTICE, "%s - saved the sampled GUI profile to %s", __FUNCTION__, strFile.c_str());
+  return true;
+}
+
+static int GUIProfilerBuiltin(const vector<CStdString> &params)
+{
+  CGUIControlProfiler &profiler = CGUIControlProfiler::Instance();
+  if (params[0].Equals("start"))
+    profiler.StartSampling(params.size() > 1 ? atoi(params[1].c_str()) : CGUIControlProfiler::DEFAULT_SAMPLE_INTERVAL);
+  else if (params[0].Equals("stop"))
+    profiler.StopSampling();
+  else if (params[0].Equals("save"))
+    return profiler.SaveFlameGraph(params.size() > 1 ? params[1] : "special://home/guiprofiler.folded") ? 0 : -1;
+  else
+  {
+    CLog::Log(LOGERROR, "GUIProfiler - unknown command %s", params[0].c_str());
+    return -1;
+  }
+  return 0;
+}
+
+void CGUIControlProfiler::RegisterBuiltins()
+{
+  CBuiltins::RegisterCommand("GUIProfiler", GUIProfilerBuiltin, true, "Sample the time each skin control takes: start[,interval], stop, or save[,file] as folded stacks for flame graphs");
+}
@@ -5,9 +5,33 @@
 #pragma once
 
 #include "GUIControl.h"
+#include "threads/CriticalSection.h"
+#include "utils/LatencyHistogram.h"
 
 class CGUIControlProfiler;
 class TiXmlElement;
+class CVariant;
+
+/*!
+ \brief What a control took per sampled frame, over one generation of the rolling profile.
+ Times are in microseconds and include the control's children.
+ */
+struct CGUIControlProfilerSamples
+{
+  CLatencyHistogram process;
+  CLatencyHistogram render;
+  int64_t processTotal;
+  int64_t renderTotal;
+
+  CGUIControlProfilerSamples() : processTotal(0), renderTotal(0) {}
+  void Reset()
+  {
+    process.Reset();
+    render.Reset();
+    processTotal = renderTotal = 0;
+  }
+  bool IsEmpty() const { return process.Count() == 0 && render.Count() == 0; }
+};
 
 class CGUIControlProfilerItem
 {
@@ -20,23 +44,44 @@ public:
   int m_controlID;
   CGUIControl::GUICONTROLTYPES m_ControlType;
   unsigned int m_visTime;
+  unsigned int m_processTime;
   unsigned int m_renderTime;
   int64_t m_i64VisStart;
+  int64_t m_i64ProcessStart;
   int64_t m_i64RenderStart;
 
+  CStdString m_strName;  ///< name of the control in sampled profiles: the xml file of a window, type#id otherwise
+  bool m_detached;       ///< the control has been freed, the item only holds its samples
+  int64_t m_sampleProcess; ///< host counter ticks spent in the control this sampled frame
+  int64_t m_sampleRender;
+  bool m_sampled;
+  CGUIControlProfilerSamples m_samples[2];
+
   CGUIControlProfilerItem(CGUIControlProfiler *pProfiler, CGUIControlProfilerItem *pParent, CGUIControl *pControl);
   ~CGUIControlProfilerItem(void);
 
   void Reset(CGUIControlProfiler *pProfiler);
   void BeginVisibility(void);
   void EndVisibility(void);
+  void BeginProcess(void);
+  void EndProcess(void);
   void BeginRender(void);
   void EndRender(void);
   void SaveToXML(TiXmlElement *parent);
-  unsigned int GetTotalTime(void) const { return m_visTime + m_renderTime; };
+  unsigned int GetTotalTime(void) const { return m_visTime + m_processTime + m_renderTime; };
 
   CGUIControlProfilerItem *AddControl(CGUIControl *pControl);
   CGUIControlProfilerItem *FindOrAddControl(CGUIControl *pControl, bool recurse);
+
+  /*! \brief Move the times of this sampled frame into the histograms of a generation */
+  void EndSampledFrame(int generation);
+  /*! \brief Forget a generation, and the controls that have no samples left in either generation */
+  void ResetGeneration(int generation);
+  /*! \brief Whether this item times the given control, rather than one freed at the same address */
+  bool IsControl(const CGUIControl *pControl) const;
+  void Detach(void);
+
+  static const char *GetTypeName(CGUIControl::GUICONTROLTYPES type);
 };
 
 class CGUIControlProfiler
@@ -45,10 +90,44 @@ public:
   static CGUIControlProfiler &Instance(void);
   static bool IsRunning(void);
 
+  /*! \brief Time the next GetMaxFrameCount() window renders, then save them to GetOutputFile() */
   void Start(void);
   void EndFrame(void);
+
+  /*! \brief Keep sampling until stopped, and keep the samples of the last ROLLING_FRAMES
+   to 2 * ROLLING_FRAMES sampled frames in a histogram per window and control.
+   Stops a capture started with Start().
+   \param interval sample one frame in every interval frames, to keep the overhead low.
+   */
+  void StartSampling(unsigned int interval = DEFAULT_SAMPLE_INTERVAL);
+  void StopSampling(void);
+  static bool IsSampling(void) { return m_bIsSampling; };
+  /*! \brief Mark the end of a frame, rendered or not. Called by the window manager while sampling. */
+  void EndSampledFrame(void);
+
+  /*! \brief Retrieve the sampled histograms of each control, keyed by the stack of windows and
+   controls leading to it. Safe to call from any thread.
+   */
+  void Serialize(CVariant &value);
+  /*! \brief Save the sampled times in the folded stack format of flame graph tools: a line per
+   control, "phase;window;group#id;...;control#id <us>", with the time spent in the control
+   itself over the sampled frames. Safe to call from any thread.
+   */
+  bool SaveFlameGraph(const CStdString &strFile);
+  CStdString GetFlameGraph(void);
+
+  /*! \brief Forget the controls of a window that is unloading, keeping what was sampled of them */
+  void RemoveWindow(CGUIControl *pWindow);
+
+  static void RegisterBuiltins();
+
+  static const unsigned int DEFAULT_SAMPLE_INTERVAL = 5;
+  static const unsigned int ROLLING_FRAMES = 1000;
+
   void BeginVisibility(CGUIControl *pControl);
   void EndVisibility(CGUIControl *pControl);
+  void BeginProcess(CGUIControl *pControl);
+  void EndProcess(CGUIControl *pControl);
   void BeginRender(CGUIControl *pControl);
   void EndRender(CGUIControl *pControl);
   int GetMaxFrameCount(void) const { return m_iMaxFrameCount; };
@@ -59,7 +138,9 @@ public:
   unsigned int GetTotalTime(void) const { return m_ItemHead.GetTotalTime(); };
 
   float m_fPerfScale;
+  double m_fSampleScale; ///< microseconds per host counter tick
 private:
+  friend class CGUIControlProfilerItem;
   CGUIControlProfiler(void);
   ~CGUIControlProfiler(void) {};
   CGUIControlProfiler(const CGUIControlProfiler &that);
@@ -70,13 +151,24 @@ private:
   CGUIControlProfilerItem *FindOrAddControl(CGUIControl *pControl);
 
   static bool m_bIsRunning;
+  static volatile bool m_bIsSampling;
   CStdString m_strOutputFile;
   int m_iMaxFrameCount;
   int m_iFrameCount;
+
+  bool m_bIsCapturing;               ///< Start() was called, and the frames aren't all timed yet
+  bool m_bResetSamples;              ///< sampling restarted, the samples go at the end of the frame
+  unsigned int m_iSampleInterval;
+  unsigned int m_iFrame;
+  int m_iGeneration;
+  unsigned int m_iGenerationFrames[2];
+  CCriticalSection m_section;        ///< guards the tree of items against the threads reading the samples
 };
 
 #define GUIPROFILER_VISIBILITY_BEGIN(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().BeginVisibility(x); }
 #define GUIPROFILER_VISIBILITY_END(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().EndVisibility(x); }
+#define GUIPROFILER_PROCESS_BEGIN(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().BeginProcess(x); }
+#define GUIPROFILER_PROCESS_END(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().EndProcess(x); }
 #define GUIPROFILER_RENDER_BEGIN(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().BeginRender(x); }
 #define GUIPROFILER_RENDER_END(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().EndRender(x); }
 
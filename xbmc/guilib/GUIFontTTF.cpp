@@ -29,11 +29,13 @@ using namespace std;
 
 
 #define CHARS_PER_TEXTURE_LINE 20 // number of characters to cache per texture line
-#define CHAR_CHUNK    64      // 64 chars allocated at a time (1024 bytes)
+#define CHAR_PAGES    (4*256)     // one page per style and high byte of the letter
+#define CHAR_EMPTY    0xffffffff  // letterAndStyle of a slot that holds no character
 
 int CGUIFontTTFBase::justification_word_weight = 6;   // weight of word spacing over letter spacing when justifying.
                                                   // A larger number means more of the "dead space" is placed between
                                                   // words rather than between letters.
+std::vector<CGUIFontTTFBase*> CGUIFontTTFBase::m_batchedFonts;
 
 class CFreeTypeLibrary
 {
@@ -120,8 +122,7 @@ CFreeTypeLibrary g_freeTypeLibrary; // our freetype library
 CGUIFontTTFBase::CGUIFontTTFBase(const CStdString& strFileName)
 {
   m_texture = NULL;
-  m_char = NULL;
-  m_maxChars = 0;
+  memset(m_charPages, 0, sizeof(m_charPages));
   m_nestedBeginCount = 0;
 
   m_bTextureLoaded = false;
@@ -130,7 +131,6 @@ CGUIFontTTFBase::CGUIFontTTFBase(const CStdString& strFileName)
 
   m_face = NULL;
   m_stroker = NULL;
-  memset(m_charquick, 0, sizeof(m_charquick));
   m_strFileName = strFileName;
   m_referenceCount = 0;
   m_originX = m_originY = 0.0f;
@@ -143,6 +143,9 @@ CGUIFontTTFBase::CGUIFontTTFBase(const CStdString& strFileName)
   m_color = 0;
   m_vertex_count = 0;
   m_nTexture = 0;
+  m_useStamp = 0;
+  m_textureFull = false;
+  m_batched = false;
 }
 
 CGUIFontTTFBase::~CGUIFontTTFBase(void)
@@ -164,6 +167,16 @@ void CGUIFontTTFBase::RemoveReference()
 }
 
 
+void CGUIFontTTFBase::FreeCharacters()
+{
+  for (unsigned int i = 0; i < CHAR_PAGES; i++)
+    delete[] m_charPages[i];
+  memset(m_charPages, 0, sizeof(m_charPages));
+  m_numChars = 0;
+  m_rowStamps.clear();
+  m_textureFull = false;
+}
+
 void CGUIFontTTFBase::ClearCharacterCache()
 {
   delete(m_texture);
@@ -171,11 +184,7 @@ void CGUIFontTTFBase::ClearCharacterCache()
   DeleteHardwareTexture();
 
   m_texture = NULL;
-  delete[] m_char;
-  m_char = new Character[CHAR_CHUNK];
-  memset(m_charquick, 0, sizeof(m_charquick));
-  m_numChars = 0;
-  m_maxChars = CHAR_CHUNK;
+  FreeCharacters();
   // set the posX and posY so that our texture will be created on first character write.
   m_posX = m_textureWidth;
   m_posY = -(int)m_cellHeight;
@@ -184,13 +193,10 @@ void CGUIFontTTFBase::ClearCharacterCache()
 
 void CGUIFontTTFBase::Clear()
 {
+  RemoveFromBatch();
   delete(m_texture);
   m_texture = NULL;
-  delete[] m_char;
-  memset(m_charquick, 0, sizeof(m_charquick));
-  m_char = NULL;
-  m_maxChars = 0;
-  m_numChars = 0;
+  FreeCharacters();
   m_posX = 0;
   m_posY = 0;
   m_nestedBeginCount = 0;
@@ -259,11 +265,7 @@ bool CGUIFontTTFBase::Load(const CStdString& strFilename, float height, float as
 
   delete(m_texture);
   m_texture = NULL;
-  delete[] m_char;
-  m_char = NULL;
-
-  m_maxChars = 0;
-  m_numChars = 0;
+  FreeCharacters();
 
   m_strFilename = strFilename;
 
@@ -290,6 +292,9 @@ void CGUIFontTTFBase::DrawTextInternal(float x, float y, const vecColors &colors
 {
   Begin();
 
+  // glyphs drawn from now on are the most recently used
+  m_useStamp++;
+
   // save the origin, which is scaled separately
   m_originX = x;
   m_originY = y;
@@ -434,83 +439,84 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
   if (letter == L'\r')
     return NULL;
 
-  // quick access to ascii chars
-  if (letter < 255)
-  {
-    character_t ch = (style << 8) | letter;
-    if (m_charquick[ch])
-      return m_charquick[ch];
-  }
-
   // letters are stored based on style and letter
   character_t ch = (style << 16) | letter;
 
-  int low = 0;
-  int high = m_numChars - 1;
-  int mid;
-  while (low <= high)
+  Character *page = m_charPages[ch >> 8];
+  if (page && page[ch & 0xff].letterAndStyle == ch)
   {
-    mid = (low + high) >> 1;
-    if (ch > m_char[mid].letterAndStyle)
-      low = mid + 1;
-    else if (ch < m_char[mid].letterAndStyle)
-      high = mid - 1;
-    else
-      return &m_char[mid];
+    Character *cached = page + (ch & 0xff);
+    m_rowStamps[cached->row] = m_useStamp;
+    return cached;
   }
-  // if we get to here, then low is where we should insert the new character
 
-  // increase the size of the buffer if we need it
-  if (m_numChars >= m_maxChars)
-  { // need to increase the size of the buffer
-    Character *newTable = new Character[m_maxChars + CHAR_CHUNK];
-    if (m_char)
-    {
-      memcpy(newTable, m_char, low * sizeof(Character));
-      memcpy(newTable + low + 1, m_char + low, (m_numChars - low) * sizeof(Character));
-      delete[] m_char;
-    }
-    m_char = newTable;
-    m_maxChars += CHAR_CHUNK;
-
-  }
-  else
-  { // just move the data along as necessary
-    memmove(m_char + low + 1, m_char + low, (m_numChars - low) * sizeof(Character));
-  }
   // render the character to our texture
   // must End() as we can't render text to our texture during a Begin(), End() block
   unsigned int nestedBeginCount = m_nestedBeginCount;
   m_nestedBeginCount = 1;
   if (nestedBeginCount) End();
-  if (!CacheCharacter(letter, style, m_char + low))
-  { // unable to cache character - try clearing them all out and starting over
-    CLog::Log(LOGDEBUG, "GUIFontTTF::GetCharacter: Unable to cache character.  Clearing character cache of %i characters", m_numChars);
-    ClearCharacterCache();
-    low = 0;
-    if (!CacheCharacter(letter, style, m_char + low))
+  // and anything we've batched up needs drawing before the texture changes underneath it
+  FlushVertices();
+  Character *cached = NULL;
+  for (int attempt = 0; attempt < 2 && !cached; attempt++)
+  {
+    if (attempt)
+    { // unable to cache character - try clearing them all out and starting over
+      CLog::Log(LOGDEBUG, "GUIFontTTF::GetCharacter: Unable to cache character.  Clearing character cache of %i characters", m_numChars);
+      ClearCharacterCache();
+    }
+    if (!m_charPages[ch >> 8])
     {
-      CLog::Log(LOGERROR, "GUIFontTTF::GetCharacter: Unable to cache character (out of memory?)");
-      if (nestedBeginCount) Begin();
-      m_nestedBeginCount = nestedBeginCount;
-      return NULL;
+      m_charPages[ch >> 8] = new Character[256];
+      for (unsigned int i = 0; i < 256; i++)
+        m_charPages[ch >> 8][i].letterAndStyle = CHAR_EMPTY;
     }
+    if (CacheCharacter(letter, style, m_charPages[ch >> 8] + (ch & 0xff)))
+      cached = m_charPages[ch >> 8] + (ch & 0xff);
   }
+  if (!cached)
+    CLog::Log(LOGERROR, "GUIFontTTF::GetCharacter: Unable to cache character (out of memory?)");
   if (nestedBeginCount) Begin();
   m_nestedBeginCount = nestedBeginCount;
 
-  // fixup quick access
-  memset(m_charquick, 0, sizeof(m_charquick));
-  for(int i=0;i<m_numChars;i++)
+  return cached;
+}
+
+bool CGUIFontTTFBase::EvictRow()
+{
+  if (m_rowStamps.empty())
+    return false;
+
+  unsigned int row = 0;
+  for (unsigned int i = 1; i < m_rowStamps.size(); i++)
   {
-    if ((m_char[i].letterAndStyle & 0xffff) < 255)
+    if (m_rowStamps[i] < m_rowStamps[row])
+      row = i;
+  }
+
+  // drop the characters living in that row, everything else stays cached
+  int evicted = 0;
+  for (unsigned int i = 0; i < CHAR_PAGES; i++)
+  {
+    Character *page = m_charPages[i];
+    if (!page)
+      continue;
+    for (unsigned int j = 0; j < 256; j++)
     {
-      character_t ch = ((m_char[i].letterAndStyle & 0xffff0000) >> 8) | (m_char[i].letterAndStyle & 0xff);
-      m_charquick[ch] = m_char+i;
+      if (page[j].letterAndStyle != CHAR_EMPTY && page[j].row == row)
+      {
+        page[j].letterAndStyle = CHAR_EMPTY;
+        evicted++;
+      }
     }
   }
+  m_numChars -= evicted;
 
-  return m_char + low;
+  m_posY = row * m_cellHeight;
+  m_rowStamps[row] = m_useStamp;
+  m_textureFull = true;
+  ClearTextureRow(m_posY, m_cellHeight);
+  return true;
 }
 
 bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *ch)
@@ -552,22 +558,24 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   if (m_posX + bitGlyph->left + bitmap.width > (int)m_textureWidth)
   { // no space - gotta drop to the next line (which means creating a new texture and copying it across)
     m_posX = 0;
-    m_posY += m_cellHeight;
+    if (!m_textureFull)
+      m_posY += m_cellHeight;
     if (bitGlyph->left < 0)
       m_posX += -bitGlyph->left;
 
-    if(m_posY + m_cellHeight >= m_textureHeight)
-    {
-      // create the new larger texture
-      unsigned int newHeight = m_posY + m_cellHeight;
-      // check for max height
-      if (newHeight > g_Windowing.GetMaxTextureSize())
+    unsigned int newHeight = m_posY + m_cellHeight;
+    if (m_textureFull || newHeight > g_Windowing.GetMaxTextureSize())
+    { // can't grow any further - recycle the least recently used row rather than flushing the lot
+      if (!EvictRow())
       {
         CLog::Log(LOGDEBUG, "GUIFontTTF::CacheCharacter: New cache texture is too large (%u > %u pixels long)", newHeight, g_Windowing.GetMaxTextureSize());
         FT_Done_Glyph(glyph);
         return false;
       }
-
+    }
+    else if(m_posY + m_cellHeight >= m_textureHeight)
+    {
+      // create the new larger texture
       CBaseTexture* newTexture = NULL;
       newTexture = ReallocTexture(newHeight);
       if(newTexture == NULL)
@@ -587,6 +595,11 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   }
 
   // set the character in our table
+  unsigned int row = m_posY / m_cellHeight;
+  if (row >= m_rowStamps.size())
+    m_rowStamps.resize(row + 1, m_useStamp);
+  m_rowStamps[row] = m_useStamp;
+  ch->row = (unsigned short)row;
   ch->letterAndStyle = (style << 16) | letter;
   ch->offsetX = (short)bitGlyph->left;
   ch->offsetY = (short)max((short)m_cellBaseLine - bitGlyph->top, 0);
@@ -613,6 +626,35 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   return true;
 }
 
+void CGUIFontTTFBase::AddToBatch()
+{
+  if (!m_batched && m_vertex_count)
+  {
+    m_batchedFonts.push_back(this);
+    m_batched = true;
+  }
+}
+
+void CGUIFontTTFBase::RemoveFromBatch()
+{
+  if (m_batched)
+  {
+    m_batchedFonts.erase(find(m_batchedFonts.begin(), m_batchedFonts.end(), this));
+    m_batched = false;
+  }
+}
+
+void CGUIFontTTFBase::FlushBatchedText()
+{
+  // fonts are drawn in the order their first label of the batch was
+  for (unsigned int i = 0; i < m_batchedFonts.size(); i++)
+  {
+    m_batchedFonts[i]->FlushVertices();
+    m_batchedFonts[i]->m_batched = false;
+  }
+  m_batchedFonts.clear();
+}
+
 void CGUIFontTTFBase::RenderCharacter(float posX, float posY, const Character *ch, color_t color, bool roundX)
 {
   // actual image width isn't same as the character width as that is
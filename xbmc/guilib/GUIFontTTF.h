@@ -64,6 +64,14 @@ public:
 
   const CStdString& GetFileName() const { return m_strFileName; };
 
+  /*!
+   \brief Draw the text that fonts have batched up since the last flush.
+   Fonts hold back their vertices after End() so that consecutive labels go out in one
+   draw per font.  Anything that draws other geometry or changes render state (viewport,
+   scissors, camera, transforms) must flush first so the text keeps its place in the frame.
+   */
+  static void FlushBatchedText();
+
 protected:
   struct Character
   {
@@ -71,6 +79,7 @@ protected:
     float left, top, right, bottom;
     float advance;
     character_t letterAndStyle;
+    unsigned short row;     // row of the texture the glyph lives in, for eviction
   };
   void AddReference();
   void RemoveReference();
@@ -92,10 +101,18 @@ protected:
   bool CacheCharacter(wchar_t letter, uint32_t style, Character *ch);
   void RenderCharacter(float posX, float posY, const Character *ch, color_t color, bool roundX);
   void ClearCharacterCache();
+  void FreeCharacters();
+  bool EvictRow();
 
   virtual CBaseTexture* ReallocTexture(unsigned int& newHeight) = 0;
   virtual bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, Character *ch) = 0;
   virtual void DeleteHardwareTexture() = 0;
+  virtual void ClearTextureRow(unsigned int posY, unsigned int height) {};
+
+  // batching of vertices across Begin()/End() blocks
+  void AddToBatch();
+  void RemoveFromBatch();
+  virtual void FlushVertices() {};
 
   // modifying glyphs
   void EmboldenGlyph(FT_GlyphSlot slot);
@@ -110,10 +127,11 @@ protected:
 
   color_t m_color;
 
-  Character *m_char;                 // our characters
-  Character *m_charquick[256*4];     // ascii chars (4 styles) here
-  int m_maxChars;                    // size of character array (can be incremented)
+  Character *m_charPages[4*256];     // our characters, paged on style and high byte of the letter
   int m_numChars;                    // the current number of cached characters
+  std::vector<unsigned int> m_rowStamps; // when each texture row was last drawn from
+  unsigned int m_useStamp;
+  bool m_textureFull;                // texture is at max size, so new rows recycle old ones
 
   float m_ellipsesWidth;               // this is used every character (width of '.')
 
@@ -140,6 +158,8 @@ protected:
   float    m_textureScaleY;
 
   static int justification_word_weight;
+  static std::vector<CGUIFontTTFBase*> m_batchedFonts;
+  bool m_batched;
 
   CStdString m_strFileName;
 
@@ -288,6 +288,45 @@ bool CGUIFontTTFDX::CopyCharToTexture(FT_BitmapGlyph bitGlyph, Character* ch)
   return TRUE;
 }
 
+void CGUIFontTTFDX::ClearTextureRow(unsigned int posY, unsigned int height)
+{
+  if (!m_texture)
+    return;
+
+  height = std::min(height, m_textureHeight - posY);
+
+  LPDIRECT3DSURFACE9 target;
+  if (m_speedupTexture)
+    m_speedupTexture->GetSurfaceLevel(0, &target);
+  else
+    m_texture->GetTextureObject()->GetSurfaceLevel(0, &target);
+
+  const RECT rect = { 0, posY, m_textureWidth, posY + height };
+  D3DLOCKED_RECT lr;
+  if (FAILED(target->LockRect(&lr, &rect, 0)))
+  {
+    CLog::Log(LOGERROR, __FUNCTION__" - failed to lock the glyph row");
+    SAFE_RELEASE(target);
+    return;
+  }
+
+  unsigned char *dst = (unsigned char *)lr.pBits;
+  for (unsigned int y = 0; y < height; y++)
+  {
+    memset(dst, 0, m_textureWidth);
+    dst += lr.Pitch;
+  }
+  target->UnlockRect();
+  SAFE_RELEASE(target);
+
+  if (m_speedupTexture)
+  {
+    // Upload to GPU - locking the rect marked it dirty.
+    HRESULT hr = g_Windowing.Get3DDevice()->UpdateTexture(m_speedupTexture->Get(), m_texture->GetTextureObject());
+    if (FAILED(hr))
+      CLog::Log(LOGERROR, __FUNCTION__": Failed to upload from sysmem to vidmem (0x%08X)", hr);
+  }
+}
 
 void CGUIFontTTFDX::DeleteHardwareTexture()
 {
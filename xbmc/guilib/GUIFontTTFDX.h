@@ -29,6 +29,7 @@ public:
 protected:
   virtual CBaseTexture* ReallocTexture(unsigned int& newHeight);
   virtual bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, Character *ch);
+  virtual void ClearTextureRow(unsigned int posY, unsigned int height);
   virtual void DeleteHardwareTexture();
   CD3DTexture *m_speedupTexture;  // extra texture to speed up reallocations when the main texture is in d3dpool_default.
                                   // that's the typical situation of Windows Vista and above.
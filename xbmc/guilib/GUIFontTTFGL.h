@@ -30,6 +30,8 @@ protected:
   virtual CBaseTexture* ReallocTexture(unsigned int& newHeight);
   virtual bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, Character *ch);
   virtual void DeleteHardwareTexture();
+  virtual void ClearTextureRow(unsigned int posY, unsigned int height);
+  virtual void FlushVertices();
 
 };
 
@@ -4,6 +4,7 @@
 #include "GUIListItemLayout.h"
 #include "utils/Archive.h"
 #include "utils/CharsetConverter.h"
+#include "utils/StringUtils.h"
 #include "utils/Variant.h"
 
 CGUIListItem::CGUIListItem(const CGUIListItem& item)
@@ -77,7 +78,14 @@ const CStdString& CGUIListItem::GetLabel2() const
 
 void CGUIListItem::SetSortLabel(const CStdString &label)
 {
-  g_charsetConverter.utf8ToW(label, m_sortLabel, false);
+  CStdStringW sortLabel;
+  g_charsetConverter.utf8ToW(label, sortLabel, false);
+  // keep the collation key if we're re-sorting on the same field
+  if (sortLabel != m_sortLabel)
+  {
+    m_sortLabel = sortLabel;
+    m_sortKey.clear();
+  }
   // no need to invalidate - this is never shown in the UI
 }
 
@@ -86,6 +94,13 @@ const CStdStringW& CGUIListItem::GetSortLabel() const
   return m_sortLabel;
 }
 
+const std::string& CGUIListItem::GetSortKey() const
+{
+  if (m_sortKey.empty())
+    StringUtils::AlphaNumericSortKey(m_sortLabel.c_str(), m_sortKey);
+  return m_sortKey;
+}
+
 void CGUIListItem::SetThumbnailImage(const CStdString& strThumbnail)
 {
   if (m_strThumbnailImage == strThumbnail)
@@ -186,6 +201,7 @@ const CGUIListItem& CGUIListItem::operator =(const CGUIListItem& item)
   m_strLabel2 = item.m_strLabel2;
   m_strLabel = item.m_strLabel;
   m_sortLabel = item.m_sortLabel;
+  m_sortKey = item.m_sortKey;
   FreeMemory();
   m_bSelected = item.m_bSelected;
   m_strIcon = item.m_strIcon;
@@ -222,6 +238,7 @@ void CGUIListItem::Archive(CArchive &ar)
     ar >> m_strLabel;
     ar >> m_strLabel2;
     ar >> m_sortLabel;
+    m_sortKey.clear();
     ar >> m_strThumbnailImage;
     ar >> m_strIcon;
     ar >> m_bSelected;
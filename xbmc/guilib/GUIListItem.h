@@ -67,6 +67,10 @@ public:
 
   void SetSortLabel(const CStdString &label);
   const CStdStringW &GetSortLabel() const;
+  /*! \brief Collation key of the sort label, built on first use and kept until the sort label changes.
+   \sa StringUtils::AlphaNumericSortKey
+   */
+  const std::string &GetSortKey() const;
 
   void Select(bool bOnOff);
   bool IsSelected() const;
@@ -133,6 +137,7 @@ protected:
   PropertyMap m_mapProperties;
 private:
   CStdStringW m_sortLabel;    // text for sorting. Need to be UTF16 for proper sorting
+  mutable std::string m_sortKey; // collation key of m_sortLabel, empty until needed
   CStdString m_strLabel;      // text of column1
 };
 #endif
@@ -29,6 +29,7 @@ public:
   virtual void OnUp();
   virtual void OnDown();
   virtual bool GetCondition(int condition, int data) const;
+  virtual int GetItemsPerPage() const { return m_itemsPerPage * m_itemsPerRow; };
 protected:
   virtual bool MoveUp(bool wrapAround);
   virtual bool MoveDown(bool wrapAround);
@@ -4,6 +4,7 @@
 #include "GraphicContext.h"
 #include "TextureManager.h"
 #include "GUILargeTextureManager.h"
+#include "AlbumArtAtlas.h"
 #include "utils/MathUtils.h"
 
 using namespace std;
@@ -231,6 +232,15 @@ void CGUITextureBase::Render(float left, float top, float right, float bottom, f
   int orientation = GetOrientation();
   OrientateTexture(texture, u3, v3, orientation);
 
+  // move into place if our frame is part of a larger (atlas) texture
+  if (m_texture.m_texOffsetX || m_texture.m_texOffsetY)
+  {
+    if (m_texture.m_texCoordsArePixels)
+      texture += CPoint((float)m_texture.m_texOffsetX, (float)m_texture.m_texOffsetY);
+    else
+      texture += CPoint(m_texture.m_texOffsetX * m_texCoordsScaleU, m_texture.m_texOffsetY * m_texCoordsScaleV);
+  }
+
   if (m_diffuse.size())
   {
     // flip the texture as necessary.  Diffuse just gets flipped according to m_info.orientation.
@@ -291,7 +301,17 @@ bool CGUITextureBase::AllocResources()
         changed = true;
       }
     }
-    if (m_isAllocated != NORMAL)
+    if (!IsAllocated() && CAlbumArtAtlas::IsEnabled())
+    { // album covers may already be packed into an atlas page
+      CTextureArray texture;
+      if (g_albumArtAtlas.GetImage(m_info.filename, texture))
+      {
+        m_isAllocated = ATLAS;
+        m_texture = texture;
+        changed = true;
+      }
+    }
+    if (m_isAllocated != NORMAL && m_isAllocated != ATLAS)
     { // use our large image background loader
       CTextureArray texture;
       if (g_largeTextureManager.GetImage(m_info.filename, texture, !IsAllocated()))
@@ -438,6 +458,8 @@ void CGUITextureBase::FreeResources(bool immediately /* = false */)
 {
   if (m_isAllocated == LARGE || m_isAllocated == LARGE_FAILED)
     g_largeTextureManager.ReleaseImage(m_info.filename, immediately || (m_isAllocated == LARGE_FAILED));
+  else if (m_isAllocated == ATLAS)
+    g_albumArtAtlas.ReleaseImage(m_info.filename);
   else if (m_isAllocated == NORMAL && m_texture.size())
     g_TextureManager.ReleaseTexture(m_info.filename);
 
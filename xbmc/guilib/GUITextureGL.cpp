@@ -5,6 +5,8 @@
 #include "GUITextureGL.h"
 #endif
 #include "Texture.h"
+#include "GUIFont.h"
+#include "GUIFontTTF.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
 
@@ -17,6 +19,8 @@ CGUITextureGL::CGUITextureGL(float posX, float posY, float width, float height,
 
 void CGUITextureGL::Begin(color_t color)
 {
+  CGUIFontTTFBase::FlushBatchedText();
+
   m_col[0] = (GLubyte)GET_R(color);
   m_col[1] = (GLubyte)GET_G(color);
   m_col[2] = (GLubyte)GET_B(color);
@@ -122,6 +126,8 @@ void CGUITextureGL::Draw(float *x, float *y, float *z, const CRect &texture, con
 
 void CGUITextureGL::DrawQuad(const CRect &rect, color_t color, CBaseTexture *texture, const CRect *texCoords)
 {
+  CGUIFontTTFBase::FlushBatchedText();
+
   if (texture)
   {
     glActiveTextureARB(GL_TEXTURE0_ARB);
@@ -5,6 +5,8 @@
 #include "GUITextureGLES.h"
 #endif
 #include "Texture.h"
+#include "GUIFont.h"
+#include "GUIFontTTF.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
 #include "utils/MathUtils.h"
@@ -21,6 +23,8 @@ CGUITextureGLES::CGUITextureGLES(float posX, float posY, float width, float heig
 
 void CGUITextureGLES::Begin(color_t color)
 {
+  CGUIFontTTFBase::FlushBatchedText();
+
   CBaseTexture* texture = m_texture.m_textures[m_currentFrame];
   glActiveTexture(GL_TEXTURE0);
   texture->LoadToGPU();
@@ -196,6 +200,8 @@ void CGUITextureGLES::Draw(float *x, float *y, float *z, const CRect &texture, c
 
 void CGUITextureGLES::DrawQuad(const CRect &rect, color_t color, CBaseTexture *texture, const CRect *texCoords)
 {
+  CGUIFontTTFBase::FlushBatchedText();
+
   if (texture)
   {
     glActiveTexture(GL_TEXTURE0);
@@ -678,6 +678,8 @@ void CGUIWindow::DynamicResourceAlloc(bool bOnOff)
 void CGUIWindow::ClearAll()
 {
   OnWindowUnload();
+  if (CGUIControlProfiler::IsRunning() || CGUIControlProfiler::IsSampling())
+    CGUIControlProfiler::Instance().RemoveWindow(this);
   CGUIControlGroup::ClearAll();
   m_windowLoaded = false;
   m_dynamicResourceAlloc = true;
@@ -13,6 +13,9 @@
 #include "settings/AdvancedSettings.h"
 #include "addons/Skin.h"
 #include "GUITexture.h"
+#include "GUIFont.h"
+#include "GUIFontTTF.h"
+#include "GUIControlProfiler.h"
 #include "windowing/WindowingFactory.h"
 #include "utils/Variant.h"
 
@@ -24,6 +27,11 @@ CGUIWindowManager::CGUIWindowManager(void)
   m_bShowOverlay = true;
   m_iNested = 0;
   m_initialized = false;
+  m_statsFrames = 0;
+  m_statsIdleFrames = 0;
+  m_statsArea = 0;
+  m_renderedArea = 0;
+  m_idleFrames = 0;
 }
 
 CGUIWindowManager::~CGUIWindowManager(void)
@@ -523,6 +531,9 @@ void CGUIWindowManager::RenderPass()
     if ((*it)->IsDialogRunning())
       (*it)->DoRender();
   }
+
+  // text batched up by the fonts must be out before the scissors change for the next region
+  CGUIFontTTFBase::FlushBatchedText();
 }
 
 bool CGUIWindowManager::Render()
@@ -533,11 +544,13 @@ bool CGUIWindowManager::Render()
   CDirtyRegionList dirtyRegions = m_tracker.GetDirtyRegions();
 
   bool hasRendered = false;
+  float renderedArea = 0;
   // If we visualize the regions we will always render the entire viewport
   if (g_advancedSettings.m_guiVisualizeDirtyRegions || g_advancedSettings.m_guiAlgorithmDirtyRegions == DIRTYREGION_SOLVER_FILL_VIEWPORT_ALWAYS)
   {
     RenderPass();
     hasRendered = true;
+    renderedArea = 1;
   }
   else if (g_advancedSettings.m_guiAlgorithmDirtyRegions == DIRTYREGION_SOLVER_FILL_VIEWPORT_ON_CHANGE)
   {
@@ -545,10 +558,13 @@ bool CGUIWindowManager::Render()
     {
       RenderPass();
       hasRendered = true;
+      renderedArea = 1;
     }
   }
   else
   {
+    // controls outside the region are culled, so each pass only renders what is in it
+    CRect screen(0, 0, (float)g_graphicsContext.GetWidth(), (float)g_graphicsContext.GetHeight());
     for (CDirtyRegionList::const_iterator i = dirtyRegions.begin(); i != dirtyRegions.end(); i++)
     {
       if (i->IsEmpty())
@@ -557,9 +573,16 @@ bool CGUIWindowManager::Render()
       g_graphicsContext.SetScissors(*i);
       RenderPass();
       hasRendered = true;
+      renderedArea += CRect(*i).Intersect(screen).Area();
     }
     g_graphicsContext.ResetScissors();
+    if (!screen.IsEmpty())
+      renderedArea /= screen.Area();
+    if (renderedArea > 1) // regions may overlap
+      renderedArea = 1;
   }
+  UpdateRenderStats(renderedArea);
+  if (CGUIControlProfiler::IsSampling()) CGUIControlProfiler::Instance().EndSampledFrame();
 
   if (g_advancedSettings.m_guiVisualizeDirtyRegions)
   {
@@ -576,6 +599,32 @@ bool CGUIWindowManager::Render()
   return hasRendered;
 }
 
+void CGUIWindowManager::SkipRender()
+{
+  UpdateRenderStats(0);
+  if (CGUIControlProfiler::IsSampling()) CGUIControlProfiler::Instance().EndSampledFrame();
+}
+
+void CGUIWindowManager::SetBackBufferKept(bool kept)
+{
+  m_tracker.SetBuffering(kept ? 1 : DEFAULT_BUFFERING);
+}
+
+void CGUIWindowManager::UpdateRenderStats(float renderedArea)
+{
+  m_statsArea += renderedArea;
+  if (renderedArea == 0)
+    m_statsIdleFrames++;
+  if (++m_statsFrames == RENDER_STATS_FRAMES)
+  {
+    m_renderedArea = m_statsArea / m_statsFrames;
+    m_idleFrames = (float)m_statsIdleFrames / m_statsFrames;
+    m_statsFrames = 0;
+    m_statsIdleFrames = 0;
+    m_statsArea = 0;
+  }
+}
+
 void CGUIWindowManager::FrameMove()
 {
   assert(g_application.IsCurrentThread());
@@ -68,6 +68,26 @@ public:
    */
   bool Render();
 
+  /*! \brief Account for a frame in which nothing on screen changed, so Render() wasn't called
+   */
+  void SkipRender();
+
+  /*! \brief Tell whether the back buffer keeps its contents from one frame to the next
+   When it is swapped, regions that change are rendered for as many frames as there are buffers.
+   When it is kept (partial presents copy from it, rather than swap it), they're rendered just once.
+   */
+  void SetBackBufferKept(bool kept);
+
+  /*! \brief Get the average fraction of the screen rendered a frame, over the last RENDER_STATS_FRAMES frames
+   */
+  float GetRenderedArea() const { return m_renderedArea; };
+
+  /*! \brief Get the fraction of the last RENDER_STATS_FRAMES frames that rendered nothing
+   */
+  float GetIdleFrames() const { return m_idleFrames; };
+
+  static const unsigned int RENDER_STATS_FRAMES = 100;
+
   /*! \brief Per-frame updating of the current window and any dialogs
    FrameMove is called every frame to update the current window and any dialogs
    on screen. It should only be called from the application thread.
@@ -113,6 +133,7 @@ public:
 #endif
 private:
   void RenderPass();
+  void UpdateRenderStats(float renderedArea);
 
   void LoadNotOnDemandWindows();
   void UnloadNotOnDemandWindows();
@@ -147,6 +168,13 @@ private:
   bool m_initialized;
 
   CDirtyRegionTracker m_tracker;
+
+  // render statistics, gathered over RENDER_STATS_FRAMES frames
+  unsigned int m_statsFrames;
+  unsigned int m_statsIdleFrames;
+  float        m_statsArea;
+  float        m_renderedArea;
+  float        m_idleFrames;
 };
 
 /*!
@@ -10,6 +10,8 @@
 #include "cores/VideoRenderers/RenderManager.h"
 #include "windowing/WindowingFactory.h"
 #include "TextureManager.h"
+#include "GUIFont.h"
+#include "GUIFontTTF.h"
 #include "input/MouseStat.h"
 #include "GUIWindowManager.h"
 #include "utils/JobManager.h"
@@ -135,6 +137,7 @@ void CGraphicContext::ClipRect(CRect &vertex, CRect &texture, CRect *texture2)
 
 bool CGraphicContext::SetViewPort(float fx, float fy, float fwidth, float fheight, bool intersectPrevious /* = false */)
 {
+  CGUIFontTTFBase::FlushBatchedText();
   CRect oldviewport;
   g_Windowing.GetViewPort(oldviewport);
 
@@ -207,6 +210,7 @@ bool CGraphicContext::SetViewPort(float fx, float fy, float fwidth, float fheigh
 
 void CGraphicContext::RestoreViewPort()
 {
+  CGUIFontTTFBase::FlushBatchedText();
   if (!m_viewStack.size()) return;
 
   CRect oldviewport = m_viewStack.top();
@@ -219,6 +223,7 @@ void CGraphicContext::RestoreViewPort()
 
 void CGraphicContext::SetScissors(const CRect &rect)
 {
+  CGUIFontTTFBase::FlushBatchedText();
   m_scissors = rect;
   m_scissors.Intersect(CRect(0,0,(float)m_iScreenWidth, (float)m_iScreenHeight));
   g_Windowing.SetScissors(m_scissors);
@@ -226,6 +231,7 @@ void CGraphicContext::SetScissors(const CRect &rect)
 
 void CGraphicContext::ResetScissors()
 {
+  CGUIFontTTFBase::FlushBatchedText();
   m_scissors.SetRect(0, 0, (float)m_iScreenWidth, (float)m_iScreenHeight);
   g_Windowing.ResetScissors(); // SetScissors(m_scissors) instead?
 }
@@ -525,16 +531,19 @@ float CGraphicContext::GetPixelRatio(RESOLUTION iRes) const
 
 void CGraphicContext::Clear(color_t color)
 {
+  CGUIFontTTFBase::FlushBatchedText();
   g_Windowing.ClearBuffers(color);
 }
 
 void CGraphicContext::CaptureStateBlock()
 {
+  CGUIFontTTFBase::FlushBatchedText();
   g_Windowing.CaptureStateBlock();
 }
 
 void CGraphicContext::ApplyStateBlock()
 {
+  CGUIFontTTFBase::FlushBatchedText();
   g_Windowing.ApplyStateBlock();
 }
 
@@ -706,6 +715,7 @@ CRect CGraphicContext::generateAABB(const CRect &rect) const
 //       to cut down on one setting)
 void CGraphicContext::UpdateCameraPosition(const CPoint &camera)
 {
+  CGUIFontTTFBase::FlushBatchedText();
   g_Windowing.SetCameraPosition(camera, m_iScreenWidth, m_iScreenHeight);
 }
 
@@ -786,18 +796,24 @@ void CGraphicContext::SetMediaDir(const CStdString &strMediaDir)
   m_strMediaDir = strMediaDir;
 }
 
-void CGraphicContext::Flip(const CDirtyRegionList& dirty)
+void CGraphicContext::Flip(const CDirtyRegionList& dirty, bool partial)
 {
-  g_Windowing.PresentRender(dirty);
+  CGUIFontTTFBase::FlushBatchedText();
+  if (partial)
+    g_Windowing.PresentPartial(dirty);
+  else
+    g_Windowing.PresentRender(dirty);
 }
 
 void CGraphicContext::ApplyHardwareTransform()
 {
+  CGUIFontTTFBase::FlushBatchedText();
   g_Windowing.ApplyHardwareTransform(m_finalTransform);
 }
 
 void CGraphicContext::RestoreHardwareTransform()
 {
+  CGUIFontTTFBase::FlushBatchedText();
   g_Windowing.RestoreHardwareTransform();
 }
 
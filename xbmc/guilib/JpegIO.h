@@ -25,6 +25,8 @@ public:
   unsigned int   Width()       { return m_width; }
   unsigned int   Height()      { return m_height; }
   unsigned int   Orientation() { return m_orientation; }
+  unsigned int   OriginalWidth()  { return m_cinfo.image_width; }  ///< size before DCT scaling
+  unsigned int   OriginalHeight() { return m_cinfo.image_height; }
 
 protected:
   static  void   jpeg_error_exit(j_common_ptr cinfo);
@@ -154,8 +154,9 @@ bool CBaseTexture::LoadFromFile(const CStdString& texturePath, unsigned int maxW
   //ImageLib is sooo sloow for jpegs. Try our own decoder first. If it fails, fall back to ImageLib.
   if (URIUtils::GetExtension(texturePath).Equals(".jpg") || URIUtils::GetExtension(texturePath).Equals(".tbn"))
   {
+    // let libjpeg do the downscaling in the DCT rather than decoding full size and squishing it
     CJpegIO jpegfile;
-    if (jpegfile.Open(texturePath))
+    if (jpegfile.Open(texturePath, maxWidth, maxHeight))
     {
       if (jpegfile.Width() > 0 && jpegfile.Height() > 0)
       {
@@ -164,6 +165,10 @@ bool CBaseTexture::LoadFromFile(const CStdString& texturePath, unsigned int maxW
         {
           if (autoRotate && jpegfile.Orientation())
             m_orientation = jpegfile.Orientation() - 1;
+          if (originalWidth)
+            *originalWidth = jpegfile.OriginalWidth();
+          if (originalHeight)
+            *originalHeight = jpegfile.OriginalHeight();
           m_hasAlpha=false;
           return true;
         }
@@ -9,6 +9,7 @@
 #include "utils/log.h"
 #include "utils/URIUtils.h"
 #include "addons/Skin.h"
+#include "settings/AdvancedSettings.h"
 #ifdef _DEBUG
 #include "utils/TimeUtils.h"
 #endif
@@ -30,6 +31,8 @@ CTextureArray::CTextureArray(int width, int height, int loops,  bool texCoordsAr
   m_orientation = 0;
   m_texWidth = 0;
   m_texHeight = 0;
+  m_texOffsetX = 0;
+  m_texOffsetY = 0;
   m_texCoordsArePixels = false;
 }
 
@@ -59,6 +62,8 @@ void CTextureArray::Reset()
   m_orientation = 0;
   m_texWidth = 0;
   m_texHeight = 0;
+  m_texOffsetX = 0;
+  m_texOffsetY = 0;
   m_texCoordsArePixels = false;
 }
 
@@ -194,6 +199,10 @@ void CTextureMap::Add(CBaseTexture* texture, int delay)
 /************************************************************************/
 CGUITextureManager::CGUITextureManager(void)
 {
+  m_usedMemory = 0;
+  m_unusedMemory = 0;
+  m_cacheHits = 0;
+  m_cacheMisses = 0;
   // we set the theme bundle to be the first bundle (thus prioritizing it)
   m_TexBundle[0].SetThemeBundle(true);
 }
@@ -207,18 +216,33 @@ const CTextureArray& CGUITextureManager::GetTexture(const CStdString& strTexture
 {
   static CTextureArray emptyTexture;
   //  CLog::Log(LOGINFO, " refcount++ for  GetTexture(%s)\n", strTextureName.c_str());
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
-  {
-    CTextureMap *pMap = m_vecTextures[i];
-    if (pMap->GetName() == strTextureName)
-    {
-      //CLog::Log(LOGDEBUG, "Total memusage %u", GetMemoryUsage());
-      return pMap->GetTexture();
-    }
-  }
+  CTextureMap *pMap = FindTexture(strTextureName);
+  if (pMap)
+    return pMap->GetTexture();
   return emptyTexture;
 }
 
+CTextureMap *CGUITextureManager::FindTexture(const CStdString &textureName)
+{
+  TextureMap::iterator i = m_textures.find(textureName);
+  if (i != m_textures.end())
+    return i->second;
+
+  // not in use - see if it is still cached from an earlier release
+  CSingleLock lock(g_graphicsContext);
+  TextureListIndex::iterator j = m_unusedIndex.find(textureName);
+  if (j == m_unusedIndex.end())
+    return NULL;
+
+  CTextureMap *pMap = *j->second;
+  m_unusedTextures.erase(j->second);
+  m_unusedIndex.erase(j);
+  m_unusedMemory -= pMap->GetMemoryUsage();
+  m_usedMemory += pMap->GetMemoryUsage();
+  m_textures.insert(make_pair(textureName, pMap));
+  return pMap;
+}
+
 /************************************************************************/
 /*                                                                      */
 /************************************************************************/
@@ -246,14 +270,10 @@ bool CGUITextureManager::HasTexture(const CStdString &textureName, CStdString *p
 
   // Check our loaded and bundled textures - we store in bundles using \\.
   CStdString bundledName = CTextureBundle::Normalize(textureName);
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
+  if (m_textures.find(textureName) != m_textures.end() || m_unusedIndex.find(textureName) != m_unusedIndex.end())
   {
-    CTextureMap *pMap = m_vecTextures[i];
-    if (pMap->GetName() == textureName)
-    {
-      if (size) *size = 1;
-      return true;
-    }
+    if (size) *size = 1;
+    return true;
   }
 
   for (int i = 0; i < 2; i++)
@@ -281,13 +301,18 @@ int CGUITextureManager::Load(const CStdString& strTextureName, bool checkBundleO
     return 0;
 
   if (size) // we found the texture
+  {
+    FindTexture(strTextureName); // pulls it back out of the unused cache if need be
+    m_cacheHits++;
     return size;
+  }
 
   if (checkBundleOnly && bundle == -1)
     return 0;
 
   //Lock here, we will do stuff that could break rendering
   CSingleLock lock(g_graphicsContext);
+  m_cacheMisses++;
 
 #ifdef _DEBUG
   int64_t start;
@@ -365,7 +390,8 @@ int CGUITextureManager::Load(const CStdString& strTextureName, bool checkBundleO
     OutputDebugString(temp);
 #endif
 
-    m_vecTextures.push_back(pMap);
+    m_textures.insert(make_pair(strTextureName, pMap));
+    m_usedMemory += pMap->GetMemoryUsage();
     return 1;
   } // of if (strPath.Right(4).ToLower()==".gif")
 
@@ -392,7 +418,8 @@ int CGUITextureManager::Load(const CStdString& strTextureName, bool checkBundleO
 
   CTextureMap* pMap = new CTextureMap(strTextureName, width, height, 0);
   pMap->Add(pTexture, 100);
-  m_vecTextures.push_back(pMap);
+  m_textures.insert(make_pair(strTextureName, pMap));
+  m_usedMemory += pMap->GetMemoryUsage();
 
 #ifdef _DEBUG_TEXTURES
   int64_t end, freq;
@@ -411,62 +438,73 @@ void CGUITextureManager::ReleaseTexture(const CStdString& strTextureName)
 {
   CSingleLock lock(g_graphicsContext);
 
-  ivecTextures i;
-  i = m_vecTextures.begin();
-  while (i != m_vecTextures.end())
+  TextureMap::iterator i = m_textures.find(strTextureName);
+  if (i == m_textures.end())
   {
-    CTextureMap* pMap = *i;
-    if (pMap->GetName() == strTextureName)
-    {
-      if (pMap->Release())
-      {
-        //CLog::Log(LOGINFO, "  cleanup:%s", strTextureName.c_str());
-        // add to our textures to free
-        m_unusedTextures.push_back(pMap);
-        i = m_vecTextures.erase(i);
-      }
-      return;
-    }
-    ++i;
+    CLog::Log(LOGWARNING, "%s: Unable to release texture %s", __FUNCTION__, strTextureName.c_str());
+    return;
+  }
+
+  CTextureMap* pMap = i->second;
+  if (pMap->Release())
+  {
+    //CLog::Log(LOGINFO, "  cleanup:%s", strTextureName.c_str());
+    // add to our textures to free - it stays available for reuse until
+    // FreeUnusedTextures() needs the memory back
+    m_textures.erase(i);
+    m_usedMemory -= pMap->GetMemoryUsage();
+    m_unusedTextures.push_front(pMap);
+    m_unusedIndex[strTextureName] = m_unusedTextures.begin();
+    m_unusedMemory += pMap->GetMemoryUsage();
   }
-  CLog::Log(LOGWARNING, "%s: Unable to release texture %s", __FUNCTION__, strTextureName.c_str());
 }
 
 void CGUITextureManager::FreeUnusedTextures()
 {
   CSingleLock lock(g_graphicsContext);
-  for (ivecTextures i = m_unusedTextures.begin(); i != m_unusedTextures.end(); ++i)
-    delete *i;
-  m_unusedTextures.clear();
+  EvictUnusedTextures(g_advancedSettings.m_guiTextureMemoryBudget);
+}
+
+void CGUITextureManager::EvictUnusedTextures(uint32_t budget)
+{
+  // least recently released textures live at the back of the list
+  while (!m_unusedTextures.empty() && m_usedMemory + m_unusedMemory > budget)
+  {
+    CTextureMap *pMap = m_unusedTextures.back();
+    m_unusedTextures.pop_back();
+    m_unusedIndex.erase(pMap->GetName());
+    m_unusedMemory -= pMap->GetMemoryUsage();
+    delete pMap;
+  }
 }
 
 void CGUITextureManager::Cleanup()
 {
   CSingleLock lock(g_graphicsContext);
 
-  ivecTextures i;
-  i = m_vecTextures.begin();
-  while (i != m_vecTextures.end())
+  for (TextureMap::iterator i = m_textures.begin(); i != m_textures.end(); ++i)
   {
-    CTextureMap* pMap = *i;
+    CTextureMap* pMap = i->second;
     CLog::Log(LOGWARNING, "%s: Having to cleanup texture %s", __FUNCTION__, pMap->GetName().c_str());
     delete pMap;
-    i = m_vecTextures.erase(i);
   }
+  m_textures.clear();
+  m_usedMemory = 0;
   for (int i = 0; i < 2; i++)
     m_TexBundle[i].Cleanup();
-  FreeUnusedTextures();
+  EvictUnusedTextures(0);
 }
 
 void CGUITextureManager::Dump() const
 {
   CStdString strLog;
-  strLog.Format("total texturemaps size:%i\n", m_vecTextures.size());
+  strLog.Format("total texturemaps size:%i (%i cached), resident %u bytes, %u hits, %u misses\n",
+                m_textures.size(), m_unusedTextures.size(), GetResidentMemory(), m_cacheHits, m_cacheMisses);
   OutputDebugString(strLog.c_str());
 
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
+  for (TextureMap::const_iterator i = m_textures.begin(); i != m_textures.end(); ++i)
   {
-    const CTextureMap* pMap = m_vecTextures[i];
+    const CTextureMap* pMap = i->second;
     if (!pMap->IsEmpty())
       pMap->Dump();
   }
@@ -476,32 +514,33 @@ void CGUITextureManager::Flush()
 {
   CSingleLock lock(g_graphicsContext);
 
-  ivecTextures i;
-  i = m_vecTextures.begin();
-  while (i != m_vecTextures.end())
+  TextureMap::iterator i = m_textures.begin();
+  while (i != m_textures.end())
   {
-    CTextureMap* pMap = *i;
+    CTextureMap* pMap = i->second;
     pMap->Flush();
     if (pMap->IsEmpty() )
     {
+      m_usedMemory -= pMap->GetMemoryUsage();
       delete pMap;
-      i = m_vecTextures.erase(i);
+      m_textures.erase(i++);
     }
     else
     {
       ++i;
     }
   }
+  EvictUnusedTextures(0);
 }
 
 unsigned int CGUITextureManager::GetMemoryUsage() const
 {
-  unsigned int memUsage = 0;
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
-  {
-    memUsage += m_vecTextures[i]->GetMemoryUsage();
-  }
-  return memUsage;
+  return m_usedMemory;
+}
+
+uint32_t CGUITextureManager::GetResidentMemory() const
+{
+  return m_usedMemory + m_unusedMemory;
 }
 
 void CGUITextureManager::SetTexturePath(const CStdString &texturePath)
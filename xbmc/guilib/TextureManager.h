@@ -9,6 +9,8 @@
 #define GUILIB_TEXTUREMANAGER_H
 
 #include <vector>
+#include <list>
+#include <boost/unordered_map.hpp>
 #include "TextureBundle.h"
 #include "threads/CriticalSection.h"
 
@@ -40,6 +42,8 @@ public:
   int m_loops;
   int m_texWidth;
   int m_texHeight;
+  int m_texOffsetX; ///< position of the frame within the texture, non-zero when the texture is shared (see CAlbumArtAtlas)
+  int m_texOffsetY;
   bool m_texCoordsArePixels;
 };
 
@@ -105,10 +109,26 @@ public:
   void RemoveTexturePath(const CStdString &texturePath); ///< Remove a path from the paths to check when loading media
 
   void FreeUnusedTextures(); ///< Free textures (called from app thread only)
+
+  uint32_t GetResidentMemory() const;              ///< Bytes held by both in-use and cached (released) textures
+  unsigned int GetCacheHits() const   { return m_cacheHits; }   ///< Loads satisfied without touching disk or bundle
+  unsigned int GetCacheMisses() const { return m_cacheMisses; } ///< Loads that had to decode the texture
 protected:
-  std::vector<CTextureMap*> m_vecTextures;
-  std::vector<CTextureMap*> m_unusedTextures;
-  typedef std::vector<CTextureMap*>::iterator ivecTextures;
+  CTextureMap *FindTexture(const CStdString &textureName);
+  void EvictUnusedTextures(uint32_t budget);
+
+  typedef boost::unordered_map<CStdString, CTextureMap*, boost::hash<std::string> > TextureMap;
+  typedef std::list<CTextureMap*> TextureList;
+  typedef boost::unordered_map<CStdString, TextureList::iterator, boost::hash<std::string> > TextureListIndex;
+
+  TextureMap m_textures;            ///< textures currently referenced by controls, keyed by name
+  TextureList m_unusedTextures;     ///< released textures kept for reuse, most recently released first
+  TextureListIndex m_unusedIndex;   ///< lookup into m_unusedTextures by name
+  uint32_t m_usedMemory;
+  uint32_t m_unusedMemory;
+  unsigned int m_cacheHits;
+  unsigned int m_cacheMisses;
+
   // we have 2 texture bundles (one for the base textures, one for the theme)
   CTextureBundle m_TexBundle[2];
 
@@ -872,6 +872,8 @@ void CButtonTranslator::MapAction(uint32_t buttonCode, const char *szAction, but
   int action = ACTION_NONE;
   if (!TranslateActionString(szAction, action) || !buttonCode)
     return;   // no valid action, or an invalid buttoncode
+  if (action == ACTION_BUILT_IN_FUNCTION)
+    CBuiltins::Prepare(szAction);
   // have a valid action, and a valid button - map it.
   // check to see if we've already got this (button,action) pair defined
   buttonMap::iterator it = map.find(buttonCode);
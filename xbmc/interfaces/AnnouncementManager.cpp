@@ -2,9 +2,14 @@
 
 #include "AnnouncementManager.h"
 #include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "threads/Event.h"
 #include <stdio.h>
+#include <deque>
+#include <boost/shared_ptr.hpp>
 #include "utils/log.h"
 #include "utils/Variant.h"
+#include "utils/TimeUtils.h"
 #include "FileItem.h"
 #include "music/tags/MusicInfoTag.h"
 #include "music/MusicDatabase.h"
@@ -12,19 +17,180 @@
 
 #define LOOKUP_PROPERTY "database-lookup"
 
+// deliveries taking longer than this (in ms, from announcing) get logged
+#define ANNOUNCEMENT_SLOW_LATENCY 1000
+
 using namespace std;
 using namespace ANNOUNCEMENT;
 
+namespace ANNOUNCEMENT
+{
+  // an announcement as queued, shared by every announcer it goes to
+  struct CAnnouncement
+  {
+    EAnnouncementFlag flag;
+    string sender;
+    string message;
+    CVariant data;
+    int64_t timestamp;
+  };
+  typedef boost::shared_ptr<const CAnnouncement> CAnnouncementPtr;
+
+  /*
+   An announcer with its options. Synchronous announcers are called straight from Post(),
+   asynchronous ones from a thread of their own that works through their queue.
+   */
+  class CAnnouncementSubscriber : public CThread
+  {
+  public:
+    CAnnouncementSubscriber(IAnnouncer *announcer, const CAnnouncerOptions &options)
+      : CThread("CAnnouncementSubscriber"), m_announcer(announcer), m_options(options)
+    {
+      m_delivered = m_dropped = m_coalesced = 0;
+      m_totalLatency = m_maxLatency = 0;
+      if (m_options.queueLimit == 0)
+        m_options.queueLimit = 1;
+    }
+
+    IAnnouncer *GetAnnouncer() const { return m_announcer; }
+    bool Wants(EAnnouncementFlag flag) const { return (m_options.flags & flag) != 0; }
+
+    void Start()
+    {
+      if (m_options.async)
+        Create();
+    }
+
+    void Stop()
+    {
+      if (!m_options.async)
+        return;
+
+      // an announcer removing itself from its own Announce() can't wait for itself
+      StopThread(!IsCurrentThread());
+      CSingleLock lock(m_critSection);
+      m_queue.clear();
+    }
+
+    void Post(const CAnnouncementPtr &announcement)
+    {
+      if (!m_options.async)
+      {
+        Deliver(*announcement);
+        return;
+      }
+
+      CSingleLock lock(m_critSection);
+      if (m_options.overflow == AnnouncementCoalesce)
+      {
+        for (deque<CAnnouncementPtr>::iterator it = m_queue.begin(); it != m_queue.end(); it++)
+        {
+          if ((*it)->flag == announcement->flag && (*it)->sender == announcement->sender && (*it)->message == announcement->message)
+          {
+            *it = announcement;
+            m_coalesced++;
+            return;
+          }
+        }
+      }
+
+      if (m_queue.size() >= m_options.queueLimit)
+      {
+        if (m_dropped++ % 100 == 0)
+          CLog::Log(LOGWARNING, "CAnnouncementManager - %s is behind by %u announcements, %llu dropped so far",
+                    m_options.name.c_str(), (unsigned int)m_queue.size(), (unsigned long long)m_dropped);
+        if (m_options.overflow == AnnouncementDropNewest)
+          return;
+        m_queue.pop_front();
+      }
+
+      m_queue.push_back(announcement);
+      m_queued.Set();
+    }
+
+    void GetStatistics(CAnnouncerStatistics &statistics)
+    {
+      CSingleLock lock(m_critSection);
+      double msPerTick = 1000.0 / CurrentHostFrequency();
+      statistics.name = m_options.name;
+      statistics.async = m_options.async;
+      statistics.queued = m_queue.size();
+      statistics.delivered = m_delivered;
+      statistics.dropped = m_dropped;
+      statistics.coalesced = m_coalesced;
+      statistics.averageLatency = m_delivered ? m_totalLatency * msPerTick / m_delivered : 0.0;
+      statistics.maxLatency = m_maxLatency * msPerTick;
+    }
+
+  protected:
+    virtual void Process()
+    {
+      while (!m_bStop)
+      {
+        CAnnouncementPtr announcement;
+        {
+          CSingleLock lock(m_critSection);
+          if (!m_queue.empty())
+          {
+            announcement = m_queue.front();
+            m_queue.pop_front();
+          }
+        }
+
+        if (announcement)
+          Deliver(*announcement);
+        else
+          AbortableWait(m_queued);
+      }
+    }
+
+  private:
+    void Deliver(const CAnnouncement &announcement)
+    {
+      m_announcer->Announce(announcement.flag, announcement.sender.c_str(), announcement.message.c_str(), announcement.data);
+
+      int64_t latency = CurrentHostCounter() - announcement.timestamp;
+      CSingleLock lock(m_critSection);
+      m_delivered++;
+      m_totalLatency += latency;
+      if (latency > m_maxLatency)
+        m_maxLatency = latency;
+      if (latency * 1000 > ANNOUNCEMENT_SLOW_LATENCY * CurrentHostFrequency())
+        CLog::Log(LOGWARNING, "CAnnouncementManager - %s took %.0f ms to get %s from %s",
+                  m_options.name.c_str(), latency * 1000.0 / CurrentHostFrequency(), announcement.message.c_str(), announcement.sender.c_str());
+    }
+
+    IAnnouncer *m_announcer;
+    CAnnouncerOptions m_options;
+    CCriticalSection m_critSection;
+    deque<CAnnouncementPtr> m_queue;
+    CEvent m_queued;
+    uint64_t m_delivered;
+    uint64_t m_dropped;
+    uint64_t m_coalesced;
+    int64_t m_totalLatency;        ///< in host counter ticks
+    int64_t m_maxLatency;          ///< in host counter ticks
+  };
+}
+
 CCriticalSection CAnnouncementManager::m_critSection;
-vector<IAnnouncer *> CAnnouncementManager::m_announcers;
+vector<CAnnouncementSubscriber *> CAnnouncementManager::m_announcers;
 
 void CAnnouncementManager::AddAnnouncer(IAnnouncer *listener)
+{
+  AddAnnouncer(listener, CAnnouncerOptions());
+}
+
+void CAnnouncementManager::AddAnnouncer(IAnnouncer *listener, const CAnnouncerOptions &options)
 {
   if (!listener)
     return;
 
+  CAnnouncementSubscriber *subscriber = new CAnnouncementSubscriber(listener, options);
+  subscriber->Start();
+
   CSingleLock lock (m_critSection);
-  m_announcers.push_back(listener);
+  m_announcers.push_back(subscriber);
 }
 
 void CAnnouncementManager::RemoveAnnouncer(IAnnouncer *listener)
@@ -32,15 +198,33 @@ void CAnnouncementManager::RemoveAnnouncer(IAnnouncer *listener)
   if (!listener)
     return;
 
-  CSingleLock lock (m_critSection);
-  for (unsigned int i = 0; i < m_announcers.size(); i++)
+  CAnnouncementSubscriber *subscriber = NULL;
   {
-    if (m_announcers[i] == listener)
+    CSingleLock lock (m_critSection);
+    for (unsigned int i = 0; i < m_announcers.size(); i++)
     {
-      m_announcers.erase(m_announcers.begin() + i);
-      return;
+      if (m_announcers[i]->GetAnnouncer() == listener)
+      {
+        subscriber = m_announcers[i];
+        m_announcers.erase(m_announcers.begin() + i);
+        break;
+      }
     }
   }
+  if (!subscriber)
+    return;
+
+  // not under the lock, the announcer may be announcing something itself
+  subscriber->Stop();
+
+  CAnnouncerStatistics statistics;
+  subscriber->GetStatistics(statistics);
+  CLog::Log(LOGINFO, "CAnnouncementManager - %s got %llu announcements, %.2f ms on average and %.2f ms at most after announcing, %llu dropped, %llu coalesced",
+            statistics.name.c_str(), (unsigned long long)statistics.delivered, statistics.averageLatency, statistics.maxLatency,
+            (unsigned long long)statistics.dropped, (unsigned long long)statistics.coalesced);
+
+  if (!subscriber->IsCurrentThread())
+    delete subscriber;
 }
 
 void CAnnouncementManager::Announce(EAnnouncementFlag flag, const char *sender, const char *message)
@@ -52,9 +236,35 @@ void CAnnouncementManager::Announce(EAnnouncementFlag flag, const char *sender,
 void CAnnouncementManager::Announce(EAnnouncementFlag flag, const char *sender, const char *message, CVariant &data)
 {
   CLog::Log(LOGDEBUG, "CAnnouncementManager - Announcement: %s from %s", message, sender);
+
+  // copied once, for whichever announcers want it
+  boost::shared_ptr<CAnnouncement> announcement;
+
+  CSingleLock lock (m_critSection);
+  for (unsigned int i = 0; i < m_announcers.size(); i++)
+  {
+    if (!m_announcers[i]->Wants(flag))
+      continue;
+
+    if (!announcement)
+    {
+      announcement.reset(new CAnnouncement);
+      announcement->flag = flag;
+      announcement->sender = sender;
+      announcement->message = message;
+      announcement->data = data;
+      announcement->timestamp = CurrentHostCounter();
+    }
+    m_announcers[i]->Post(announcement);
+  }
+}
+
+void CAnnouncementManager::GetStatistics(vector<CAnnouncerStatistics> &statistics)
+{
   CSingleLock lock (m_critSection);
+  statistics.resize(m_announcers.size());
   for (unsigned int i = 0; i < m_announcers.size(); i++)
-    m_announcers[i]->Announce(flag, sender, message, data);
+    m_announcers[i]->GetStatistics(statistics[i]);
 }
 
 void CAnnouncementManager::Announce(EAnnouncementFlag flag, const char *sender, const char *message, CFileItemPtr item)
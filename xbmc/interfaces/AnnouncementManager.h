@@ -4,21 +4,76 @@
 #include "IAnnouncer.h"
 #include "FileItem.h"
 #include "threads/CriticalSection.h"
+#include <string>
 #include <vector>
+#include <stdint.h>
 
 namespace ANNOUNCEMENT
 {
+  /*!
+   \brief What happens to an announcement for an asynchronous announcer whose queue is full.
+   */
+  enum EAnnouncementOverflow
+  {
+    AnnouncementDropOldest,  ///< the oldest queued announcement makes room
+    AnnouncementDropNewest,  ///< the new announcement is dropped
+    AnnouncementCoalesce     ///< a queued announcement with the same flag, sender and message takes the new data
+                             ///< (always, not only when full), otherwise the oldest makes room
+  };
+
+  /*!
+   \brief How an announcer wants its announcements.
+
+   Synchronous announcers are called on the announcing thread, as all announcers used to be.
+   Asynchronous announcers get a thread and a bounded queue of their own, so a slow one delays
+   neither the announcing thread (often the player, starting or ending playback) nor the other
+   announcers.
+   */
+  struct CAnnouncerOptions
+  {
+    CAnnouncerOptions(const char *announcerName = "announcer", int announcementFlags = ANNOUNCE_ALL)
+      : name(announcerName), flags(announcementFlags), async(false), queueLimit(256), overflow(AnnouncementDropOldest) {}
+
+    std::string name;              ///< used in logs and statistics
+    int flags;                     ///< the EAnnouncementFlags the announcer is given
+    bool async;
+    unsigned int queueLimit;       ///< announcements queued at most, for asynchronous announcers
+    EAnnouncementOverflow overflow;
+  };
+
+  /*!
+   \brief Delivery statistics of an announcer, latencies are from announcing to the announcer returning.
+   */
+  struct CAnnouncerStatistics
+  {
+    std::string name;
+    bool async;
+    unsigned int queued;
+    uint64_t delivered;
+    uint64_t dropped;
+    uint64_t coalesced;
+    double averageLatency;         ///< in ms
+    double maxLatency;             ///< in ms
+  };
+
+  class CAnnouncementSubscriber;
+
   class CAnnouncementManager
   {
   public:
     static void AddAnnouncer(IAnnouncer *listener);
+    static void AddAnnouncer(IAnnouncer *listener, const CAnnouncerOptions &options);
+    /*! \brief Stop announcing to a listener. Announcements still queued for it are dropped, and once
+     this returns the listener is not called any more.
+     */
     static void RemoveAnnouncer(IAnnouncer *listener);
     static void Announce(EAnnouncementFlag flag, const char *sender, const char *message);
     static void Announce(EAnnouncementFlag flag, const char *sender, const char *message, CVariant &data);
     static void Announce(EAnnouncementFlag flag, const char *sender, const char *message, CFileItemPtr item);
     static void Announce(EAnnouncementFlag flag, const char *sender, const char *message, CFileItemPtr item, CVariant &data);
+    static void GetStatistics(std::vector<CAnnouncerStatistics> &statistics);
   private:
-    static std::vector<IAnnouncer *> m_announcers;
+    static std::vector<CAnnouncementSubscriber *> m_announcers;
     static CCriticalSection m_critSection;
   };
 }
@@ -32,7 +32,9 @@
 #include "PartyModeManager.h"
 #include "settings/Settings.h"
 #include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
 #include "utils/URIUtils.h"
+#include "threads/SingleLock.h"
 #include "Util.h"
 
 #include "filesystem/PluginDirectory.h"
@@ -71,6 +73,7 @@
 #endif
 
 
+#include <boost/unordered_map.hpp>
 #include <vector>
 
 using namespace std;
@@ -89,11 +92,6 @@ typedef struct
 } BUILT_IN;
 
 const BUILT_IN commands[] = {
-#ifdef IS_PROFESSIONAL   // Laureon: Added: Jukebox Credits System
-  { "InsertCredit",               false,   "Jukebox: Inserts a credit" },
-  { "RemoveCredit",               false,   "Jukebox: Removes a credit" },
-  { "RemoveLastSong",               false,   "Jukebox: Remove the last song and returns 1 coin" },
-#endif
   { "Help",                       false,  "This help message" },
   { "Reboot",                     false,  "Reboot the xbox (power cycle)" },
   { "Restart",                    false,  "Restart the xbox (power cycle)" },
@@ -198,11 +196,102 @@ const BUILT_IN commands[] = {
 #endif
   { "VideoLibrary.Search",        false,  "Brings up a search dialog which will search the library" }};
 
+// builtins registered by other subsystems, keyed by lower case name
+typedef struct
+{
+  CBuiltins::Handler handler;
+  bool needsParameters;
+  CStdString command;
+  CStdString description;
+} REGISTERED_BUILT_IN;
+
+// a builtin bound in the keymaps, split when the keymap was loaded
+typedef struct
+{
+  CStdString execute;
+  vector<CStdString> params;
+} PREPARED_BUILT_IN;
+
+// how often a builtin ran and how long it took, in host counter ticks
+typedef struct
+{
+  unsigned int count;
+  int64_t total;
+  int64_t max;
+} BUILT_IN_STATS;
+
+// looked up on every builtin executed, by lower-case name or by exec string
+typedef boost::unordered_map<CStdString, REGISTERED_BUILT_IN, boost::hash<std::string> > RegisteredMap;
+typedef boost::unordered_map<CStdString, PREPARED_BUILT_IN, boost::hash<std::string> > PreparedMap;
+typedef boost::unordered_map<CStdString, BUILT_IN_STATS, boost::hash<std::string> > StatsMap;
+
+static RegisteredMap &RegisteredCommands()
+{
+  static RegisteredMap registered;
+  return registered;
+}
+
+static PreparedMap &PreparedCommands()
+{
+  static PreparedMap prepared;
+  return prepared;
+}
+
+static StatsMap &CommandStats()
+{
+  static StatsMap stats;
+  return stats;
+}
+
+static CCriticalSection &BuiltinsSection()
+{
+  static CCriticalSection section;
+  return section;
+}
+
+void CBuiltins::RegisterCommand(const CStdString &command, Handler handler, bool needsParameters, const CStdString &description)
+{
+  CStdString name(command);
+  name.ToLower();
+  REGISTERED_BUILT_IN builtin = { handler, needsParameters, command, description };
+  CSingleLock lock(BuiltinsSection());
+  RegisteredCommands()[name] = builtin;
+}
+
+void CBuiltins::Prepare(const CStdString &execString)
+{
+  PREPARED_BUILT_IN prepared;
+  CUtil::SplitExecFunction(execString, prepared.execute, prepared.params);
+  prepared.execute.ToLower();
+  CSingleLock lock(BuiltinsSection());
+  PreparedCommands()[execString] = prepared;
+}
+
+void CBuiltins::LogStats()
+{
+  CSingleLock lock(BuiltinsSection());
+  double frequency = (double)CurrentHostFrequency();
+  for (StatsMap::const_iterator it = CommandStats().begin(); it != CommandStats().end(); ++it)
+  {
+    const BUILT_IN_STATS &stats = it->second;
+    CLog::Log(LOGNOTICE, "builtin %s: ran %u times, %.3f ms average, %.3f ms max", it->first.c_str(), stats.count,
+              1000.0 * stats.total / stats.count / frequency, 1000.0 * stats.max / frequency);
+  }
+}
+
 bool CBuiltins::HasCommand(const CStdString& execString)
 {
   CStdString function;
   vector<CStdString> parameters;
   CUtil::SplitExecFunction(execString, function, parameters);
+  {
+    CStdString name(function);
+    name.ToLower();
+    CSingleLock lock(BuiltinsSection());
+    RegisteredMap::const_iterator it = RegisteredCommands().find(name);
+    if (it != RegisteredCommands().end())
+      return !it->second.needsParameters || parameters.size();
+  }
   for (unsigned int i = 0; i < sizeof(commands)/sizeof(BUILT_IN); i++)
   {
     if (function.CompareNoCase(commands[i].command) == 0 && (!commands[i].needsParameters || parameters.size()))
@@ -214,6 +303,16 @@ bool CBuiltins::HasCommand(const CStdString& execString)
 void CBuiltins::GetHelp(CStdString &help)
 {
   help.Empty();
+  {
+    CSingleLock lock(BuiltinsSection());
+    for (RegisteredMap::const_iterator it = RegisteredCommands().begin(); it != RegisteredCommands().end(); ++it)
+    {
+      help += it->second.command;
+      help += "\t";
+      help += it->second.description;
+      help += "\n";
+    }
+  }
   for (unsigned int i = 0; i < sizeof(commands)/sizeof(BUILT_IN); i++)
   {
     help += commands[i].command;
@@ -228,8 +327,45 @@ int CBuiltins::Execute(const CStdString& execString)
   // Get the text after the "XBMC."
   CStdString execute;
   vector<CStdString> params;
-  CUtil::SplitExecFunction(execString, execute, params);
-  execute.ToLower();
+  Handler handler = NULL;
+  {
+    CSingleLock lock(BuiltinsSection());
+    PreparedMap::const_iterator prepared = PreparedCommands().find(execString);
+    if (prepared != PreparedCommands().end())
+    {
+      execute = prepared->second.execute;
+      params = prepared->second.params;
+    }
+    else
+    {
+      lock.Leave();
+      CUtil::SplitExecFunction(execString, execute, params);
+      execute.ToLower();
+      lock.Enter();
+    }
+    RegisteredMap::const_iterator registered = RegisteredCommands().find(execute);
+    if (registered != RegisteredCommands().end())
+      handler = registered->second.handler;
+  }
+
+  int64_t start = CurrentHostCounter();
+  int result = handler ? handler(params) : ExecuteCommand(execute, params);
+  int64_t elapsed = CurrentHostCounter() - start;
+
+  if (result == 0)
+  {
+    CSingleLock lock(BuiltinsSection());
+    BUILT_IN_STATS &stats = CommandStats()[execute];
+    stats.count++;
+    stats.total += elapsed;
+    if (elapsed > stats.max)
+      stats.max = elapsed;
+  }
+  return result;
+}
+
+int CBuiltins::ExecuteCommand(const CStdString &execute, vector<CStdString> params)
+{
   CStdString parameter = params.size() ? params[0] : "";
   CStdString strParameterCaseIntact = parameter;
 
@@ -408,25 +544,6 @@ int CBuiltins::Execute(const CStdString& execString)
 #endif
   }
 
-#ifdef IS_PROFESSIONAL // Laureon: Added: Jukebox Credits System
-  else if (execute.Equals("insertcredit")) {
-    int64_t toinsert = 1;
-
-    //if (params.size())
-    //	toinsert = (int64_t) params;
-    g_jukeboxManager.GetCoinsManager().InsertCoin(toinsert);
-    CLog::Log(LOGDEBUG, "Jukebox: 1 coin inserted");
-  }	
-  else if (execute.Equals("removecredit")) {
-    g_jukeboxManager.GetCoinsManager().RemoveCoin();
-    CLog::Log(LOGDEBUG, "Jukebox: 1 coin removed");
-  }	
-  else if (execute.Equals("removelastsong")) {
-    g_jukeboxManager.GetCoinsManager().RemoveLastSong();
-    CLog::Log(LOGDEBUG, "Jukebox: 1 music removed and 1 coin inserted");
-  }
-#endif
-
   else if (execute.Equals("extract") && params.size())
   {
     // Detects if file is zip or zip then extracts
@@ -3,12 +3,43 @@
 
 
 #include "utils/StdString.h"
+#include <vector>
 
 class CBuiltins
 {
 public:
+  /*! \brief Handler of a builtin registered through RegisterCommand().
+   \param params the parameters of the builtin, if any.
+   \return 0 on success, as for Execute().
+   */
+  typedef int (*Handler)(const std::vector<CStdString> &params);
+
   static bool HasCommand(const CStdString& execString);
   static void GetHelp(CStdString &help);
   static int Execute(const CStdString& execString);
+
+  /*! \brief Register a builtin handled by another subsystem.
+   Registered builtins are looked up before the builtins of this file, so this is also the
+   place for builtins that need to respond quickly (the jukebox coin builtins). Register before
+   the keymaps are loaded, or keymaps won't be able to bind the builtin.
+   \param command name of the builtin, case insensitive.
+   \param handler function that runs the builtin.
+   \param needsParameters whether the builtin needs parameters to be valid.
+   \param description line shown for the builtin in the help.
+   */
+  static void RegisterCommand(const CStdString &command, Handler handler, bool needsParameters, const CStdString &description);
+
+  /*! \brief Split a builtin ahead of time, so that running it later doesn't have to.
+   Called for builtins bound in the keymaps as they are loaded.
+   \param execString the builtin and its parameters, as passed to Execute().
+   */
+  static void Prepare(const CStdString &execString);
+
+  /*! \brief Log how many times each builtin ran and how long it took.
+   */
+  static void LogStats();
+
+private:
+  static int ExecuteCommand(const CStdString &execute, std::vector<CStdString> params);
 };
 
@@ -12,6 +12,7 @@ InfoSingle::InfoSingle(const CStdString &expression, int context)
 : InfoBool(expression, context)
 {
   m_condition = g_infoManager.TranslateSingleString(expression);
+  m_dependencies = g_infoManager.GetDependencies(m_condition);
 }
 
 void InfoSingle::Update(const CGUIListItem *item)
@@ -124,6 +125,11 @@ void InfoExpression::Parse(const CStdString &expression)
     operators.pop();
   }
 
+  // we need evaluating whenever any of our operands do
+  m_dependencies = DEPENDS_NONE;
+  for (unsigned int i = 0; i < m_operands.size(); i++)
+    m_dependencies |= g_infoManager.GetBoolDependencies(m_operands[i]);
+
   // test evaluate
   bool test;
   if (!Evaluate(NULL, test))
@@ -10,6 +10,24 @@ class CGUIListItem;
 
 namespace INFO
 {
+/*!
+ \ingroup info
+ \brief What a condition's value depends on.
+ A condition is evaluated again only once one of its dependencies has changed. Conditions
+ that aren't tagged with anything else depend on DEPENDS_FRAME, and are evaluated every frame.
+ */
+enum
+{
+  DEPENDS_NONE     = 0,          ///< a constant
+  DEPENDS_PLAYER   = 0x01,       ///< what is playing, and whether it is paused or seeking
+  DEPENDS_PLAYLIST = 0x02,       ///< the current playlist, its items and the position in it
+  DEPENDS_COINS    = 0x04,       ///< the jukebox credits
+  DEPENDS_SETTINGS = 0x08,       ///< the gui and skin settings
+  DEPENDS_FRAME    = 0x80000000  ///< anything without change events
+};
+
+static const unsigned int DEPENDENCY_COUNT = 4; ///< the dependencies other than DEPENDS_FRAME
+
 /*!
  \ingroup info
  \brief Base class, wrapping boolean conditions and expressions
@@ -20,6 +38,7 @@ public:
   InfoBool(const CStdString &expression, int context)
     : m_value(false),
       m_context(context),
+      m_dependencies(DEPENDS_FRAME),
       m_expression(expression),
       m_lastUpdate(0)
   {
@@ -30,20 +49,28 @@ public:
   /*! \brief Get the value of this info bool
    This is called to update (if necessary) and fetch the value of the info bool
    \param time current time (used to test if we need to update yet)
+   \param generations the number of changes of each dependency, bumped whenever it changes
    \param item the item used to evaluate the bool
    */
-  inline bool Get(unsigned int time, const CGUIListItem *item = NULL)
+  inline bool Get(unsigned int time, const volatile long *generations, const CGUIListItem *item = NULL)
   {
     if (item)
       Update(item);
-    else if (time - m_lastUpdate > 0)
+    else
     {
-      Update(NULL);
-      m_lastUpdate = time;
+      unsigned int stamp = GetStamp(time, generations);
+      if (stamp != m_lastUpdate)
+      {
+        Update(NULL);
+        m_lastUpdate = stamp;
+      }
     }
     return m_value;
   }
 
+  /*! \brief The DEPENDS_* flags of this info bool */
+  unsigned int GetDependencies() const { return m_dependencies; }
+
   bool operator==(const InfoBool &right) const
   {
     return (m_context == right.m_context && 
@@ -59,8 +86,23 @@ protected:
 
   bool m_value;                ///< current value
   int m_context;               ///< contextual information to go with the condition
+  unsigned int m_dependencies; ///< DEPENDS_* flags, set by the derived class
 
 private:
+  /*! \brief A value that changes whenever one of our dependencies does, 0 never being one */
+  inline unsigned int GetStamp(unsigned int time, const volatile long *generations) const
+  {
+    if (m_dependencies & DEPENDS_FRAME)
+      return time;
+    unsigned int stamp = 1;
+    for (unsigned int i = 0; i < DEPENDENCY_COUNT; i++)
+    {
+      if (m_dependencies & (1 << i))
+        stamp += (unsigned int)generations[i];
+    }
+    return stamp;
+  }
+
   CStdString m_expression;     ///< original expression
   unsigned int m_lastUpdate;   ///< last update time (to determine dirty status)
 };
@@ -35,9 +35,23 @@ JSON_STATUS CAudioLibrary::GetArtists(const CStdString &method, ITransportLayer
   if (parameterObject["albumartistsonly"].isBoolean())
     albumArtistsOnly = parameterObject["albumartistsonly"].asBoolean();
 
+  // the artist info is a query per artist, only worth it when any of it is asked for
+  bool withInfo = false;
+  for (unsigned int i = 0; i < param["properties"].size() && !withInfo; i++)
+  {
+    CStdString field = param["properties"][i].asString();
+    withInfo = field != "artist" && field != "thumbnail" && field != "fanart";
+  }
+
+  SORT_METHOD sortMethod;
+  SORT_ORDER sortOrder;
+  ParseSort(parameterObject["sort"], sortMethod, sortOrder);
+
   CFileItemList items;
-  if (musicdatabase.GetArtistsNav("musicdb://2/", items, genreID, albumArtistsOnly))
-    HandleFileItemList("artistid", false, "artists", items, param, result);
+  int total;
+  if (musicdatabase.GetArtistsNav("musicdb://2/", items, genreID, albumArtistsOnly, sortMethod, sortOrder,
+                                  (int)parameterObject["limits"]["start"].asInteger(), (int)parameterObject["limits"]["end"].asInteger(), total, withInfo))
+    StreamFileItemList("artistid", false, "artists", items, param, result, total, false);
 
   musicdatabase.Close();
   return OK;
@@ -78,9 +92,15 @@ JSON_STATUS CAudioLibrary::GetAlbums(const CStdString &method, ITransportLayer *
   int artistID  = (int)parameterObject["artistid"].asInteger();
   int genreID   = (int)parameterObject["genreid"].asInteger();
 
+  SORT_METHOD sortMethod;
+  SORT_ORDER sortOrder;
+  ParseSort(parameterObject["sort"], sortMethod, sortOrder);
+
   CFileItemList items;
-  if (musicdatabase.GetAlbumsNav("musicdb://3/", items, genreID, artistID, -1, -1))
-    HandleFileItemList("albumid", false, "albums", items, parameterObject, result);
+  int total;
+  if (musicdatabase.GetAlbumsNav("musicdb://3/", items, genreID, artistID, sortMethod, sortOrder,
+                                 (int)parameterObject["limits"]["start"].asInteger(), (int)parameterObject["limits"]["end"].asInteger(), total))
+    StreamFileItemList("albumid", false, "albums", items, parameterObject, result, total, false);
 
   musicdatabase.Close();
   return OK;
@@ -122,9 +142,15 @@ JSON_STATUS CAudioLibrary::GetSongs(const CStdString &method, ITransportLayer *t
   int albumID  = (int)parameterObject["albumid"].asInteger();
   int genreID  = (int)parameterObject["genreid"].asInteger();
 
+  SORT_METHOD sortMethod;
+  SORT_ORDER sortOrder;
+  ParseSort(parameterObject["sort"], sortMethod, sortOrder);
+
   CFileItemList items;
-  if (musicdatabase.GetSongsNav("musicdb://4/", items, genreID, artistID, albumID))
-    HandleFileItemList("songid", true, "songs", items, parameterObject, result);
+  int total;
+  if (musicdatabase.GetSongsNav("musicdb://4/", items, genreID, artistID, albumID, sortMethod, sortOrder,
+                                (int)parameterObject["limits"]["start"].asInteger(), (int)parameterObject["limits"]["end"].asInteger(), total))
+    StreamFileItemList("songid", true, "songs", items, parameterObject, result, total, false);
 
   musicdatabase.Close();
   return OK;
@@ -172,7 +198,7 @@ JSON_STATUS CAudioLibrary::GetRecentlyAddedAlbums(const CStdString &method, ITra
       items.Add(item);
     }
 
-    HandleFileItemList("albumid", false, "albums", items, parameterObject, result);
+    StreamFileItemList("albumid", false, "albums", items, parameterObject, result);
   }
 
   musicdatabase.Close();
@@ -191,7 +217,7 @@ JSON_STATUS CAudioLibrary::GetRecentlyAddedSongs(const CStdString &method, ITran
 
   CFileItemList items;
   if (musicdatabase.GetRecentlyAddedAlbumSongs("musicdb://", items, (unsigned int)amount))
-    HandleFileItemList("songid", true, "songs", items, parameterObject, result);
+    StreamFileItemList("songid", true, "songs", items, parameterObject, result);
 
   musicdatabase.Close();
   return OK;
@@ -210,7 +236,7 @@ JSON_STATUS CAudioLibrary::GetGenres(const CStdString &method, ITransportLayer *
     for (unsigned int i = 0; i < (unsigned int)items.Size(); i++)
       items[i]->GetMusicInfoTag()->SetTitle(items[i]->GetLabel());
 
-    HandleFileItemList("genreid", false, "genres", items, parameterObject, result);
+    StreamFileItemList("genreid", false, "genres", items, parameterObject, result);
   }
 
   musicdatabase.Close();
@@ -0,0 +1,24 @@
+#pragma once
+
+
+#include "utils/StdString.h"
+#include "utils/Variant.h"
+#include "FileItem.h"
+#include <vector>
+
+namespace JSONRPC
+{
+  /*!
+   \brief A listing in a method result that is only serialized when the response is written.
+   */
+  typedef struct
+  {
+    CStdString resultname;
+    const char *ID;
+    bool allowFile;
+    std::vector<CFileItemPtr> items;
+    CVariant validFields;
+  } DeferredFileItemList;
+
+  typedef std::vector<DeferredFileItemList> DeferredFileItemLists;
+}
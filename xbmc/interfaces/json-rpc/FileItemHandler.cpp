@@ -21,6 +21,8 @@ using namespace MUSIC_INFO;
 using namespace JSONRPC;
 using namespace XFILE;
 
+XbmcThreads::ThreadLocal<DeferredFileItemLists> CFileItemHandler::m_deferredLists;
+
 void CFileItemHandler::FillDetails(ISerializable* info, CFileItemPtr item, const CVariant& fields, CVariant &result)
 {
   if (info == NULL || fields.size() == 0)
@@ -74,29 +76,92 @@ void CFileItemHandler::FillDetails(ISerializable* info, CFileItemPtr item, const
 
 void CFileItemHandler::HandleFileItemList(const char *ID, bool allowFile, const char *resultname, CFileItemList &items, const CVariant &parameterObject, CVariant &result)
 {
-  int size  = items.Size();
+  HandleFileItemList(ID, allowFile, resultname, items, parameterObject, result, items.Size());
+}
+
+void CFileItemHandler::HandleFileItemList(const char *ID, bool allowFile, const char *resultname, CFileItemList &items, const CVariant &parameterObject, CVariant &result, int size, bool sortLimit /* = true */)
+{
+  AddFileItemList(ID, allowFile, resultname, items, parameterObject, result, size, sortLimit, false);
+}
+
+void CFileItemHandler::StreamFileItemList(const char *ID, bool allowFile, const char *resultname, CFileItemList &items, const CVariant &parameterObject, CVariant &result, int size /* = -1 */, bool sortLimit /* = true */)
+{
+  if (size < 0)
+    size = items.Size();
+  AddFileItemList(ID, allowFile, resultname, items, parameterObject, result, size, sortLimit, m_deferredLists.get() != NULL);
+}
+
+void CFileItemHandler::AddFileItemList(const char *ID, bool allowFile, const char *resultname, CFileItemList &items, const CVariant &parameterObject, CVariant &result, int size, bool sortLimit, bool defer)
+{
   int start = (int)parameterObject["limits"]["start"].asInteger();
   int end   = (int)parameterObject["limits"]["end"].asInteger();
   end = (end <= 0 || end > size) ? size : end;
   start = start > end ? end : start;
 
-  Sort(items, parameterObject["sort"]);
+  if (sortLimit)
+    Sort(items, parameterObject["sort"]);
 
   result["limits"]["start"] = start;
   result["limits"]["end"]   = end;
   result["limits"]["total"] = size;
 
-  for (int i = start; i < end; i++)
+  // a page from the database starts at its first item
+  int offset = sortLimit ? 0 : start;
+  if (defer && start < end)
+  {
+    DeferredFileItemList list;
+    list.resultname = resultname;
+    list.ID = ID;
+    list.allowFile = allowFile;
+    list.validFields = parameterObject["properties"];
+    for (int i = start; i < end && i - offset < items.Size(); i++)
+      list.items.push_back(items.Get(i - offset));
+    m_deferredLists.get()->push_back(list);
+    result[resultname] = CVariant(CVariant::VariantTypeArray);
+    return;
+  }
+
+  for (int i = start; i < end && i - offset < items.Size(); i++)
   {
     CVariant object;
-    CFileItemPtr item = items.Get(i);
+    CFileItemPtr item = items.Get(i - offset);
     HandleFileItem(ID, allowFile, resultname, item, parameterObject, parameterObject["properties"], result);
   }
 }
 
+void CFileItemHandler::DeferFileItemLists(DeferredFileItemLists *lists)
+{
+  m_deferredLists.set(lists);
+}
+
+bool CFileItemHandler::WriteDeferredList(CJSONStreamWriter &writer, const DeferredFileItemList &list)
+{
+  bool success = writer.OpenArray();
+  for (unsigned int i = 0; i < list.items.size() && success; i++)
+  {
+    CVariant object;
+    SerializeFileItem(list.ID, list.allowFile, list.items[i], list.validFields, object);
+    success = writer.Write(object);
+  }
+  return success && writer.CloseArray();
+}
+
 void CFileItemHandler::HandleFileItem(const char *ID, bool allowFile, const char *resultname, CFileItemPtr item, const CVariant &parameterObject, const CVariant &validFields, CVariant &result, bool append /* = true */)
 {
   CVariant object;
+  SerializeFileItem(ID, allowFile, item, validFields, object);
+
+  if (resultname)
+  {
+    if (append)
+      result[resultname].append(object);
+    else
+      result[resultname] = object;
+  }
+}
+
+void CFileItemHandler::SerializeFileItem(const char *ID, bool allowFile, CFileItemPtr item, const CVariant &validFields, CVariant &object)
+{
   bool hasFileField = false;
   bool hasThumbnailField = false;
 
@@ -206,14 +271,6 @@ void CFileItemHandler::HandleFileItem(const char *ID, bool allowFile, const char
   }
   else
     object = CVariant(CVariant::VariantTypeNull);
-
-  if (resultname)
-  {
-    if (append)
-      result[resultname].append(object);
-    else
-      result[resultname] = object;
-  }
 }
 
 bool CFileItemHandler::FillFileItemList(const CVariant &parameterObject, CFileItemList &list)
@@ -324,7 +381,7 @@ bool CFileItemHandler::ParseSortMethods(const CStdString &method, const bool &ig
   return true;
 }
 
-void CFileItemHandler::Sort(CFileItemList &items, const CVariant &parameterObject)
+void CFileItemHandler::ParseSort(const CVariant &parameterObject, SORT_METHOD &sortmethod, SORT_ORDER &sortorder)
 {
   CStdString method = parameterObject["method"].asString();
   CStdString order  = parameterObject["order"].asString();
@@ -332,9 +389,19 @@ void CFileItemHandler::Sort(CFileItemList &items, const CVariant &parameterObjec
   method = method.ToLower();
   order  = order.ToLower();
 
-  SORT_METHOD sortmethod = SORT_METHOD_NONE;
-  SORT_ORDER  sortorder  = SORT_ORDER_ASC;
+  if (!ParseSortMethods(method, parameterObject["ignorearticle"].asBoolean(), order, sortmethod, sortorder))
+  {
+    sortmethod = SORT_METHOD_NONE;
+    sortorder  = SORT_ORDER_ASC;
+  }
+}
+
+void CFileItemHandler::Sort(CFileItemList &items, const CVariant &parameterObject)
+{
+  SORT_METHOD sortmethod;
+  SORT_ORDER  sortorder;
+  ParseSort(parameterObject, sortmethod, sortorder);
 
-  if (ParseSortMethods(method, parameterObject["ignorearticle"].asBoolean(), order, sortmethod, sortorder))
+  if (sortmethod != SORT_METHOD_NONE)
     items.Sort(sortmethod, sortorder);
 }
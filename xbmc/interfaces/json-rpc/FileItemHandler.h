@@ -4,20 +4,48 @@
 #include "utils/StdString.h"
 #include "JSONRPC.h"
 #include "JSONUtils.h"
+#include "DeferredFileItemList.h"
 #include "FileItem.h"
+#include "threads/ThreadLocal.h"
+#include <vector>
 
 namespace JSONRPC
 {
   class CFileItemHandler : public CJSONUtils
   {
+  public:
+    /*!
+     \brief Defer the listings of method results called on this thread to lists, or stop (NULL).
+     While deferring, StreamFileItemList() leaves an empty array in the result and keeps the
+     items of the page in lists, for WriteDeferredList() to serialize one at a time as the
+     response is written. The CVariant of the whole listing is never built.
+     */
+    static void DeferFileItemLists(DeferredFileItemLists *lists);
+    static bool WriteDeferredList(CJSONStreamWriter &writer, const DeferredFileItemList &list);
+
   protected:
     static void FillDetails(ISerializable* info, CFileItemPtr item, const CVariant& fields, CVariant &result);
     static void HandleFileItemList(const char *ID, bool allowFile, const char *resultname, CFileItemList &items, const CVariant &parameterObject, CVariant &result);
+    /*! \brief Add a page of items to the result.
+     \param size the number of items in the whole listing.
+     \param sortLimit false if items is already sorted and only holds the page the limits ask for.
+     */
+    static void HandleFileItemList(const char *ID, bool allowFile, const char *resultname, CFileItemList &items, const CVariant &parameterObject, CVariant &result, int size, bool sortLimit = true);
+    /*! \brief HandleFileItemList() for methods that don't touch result[resultname] afterwards, so that
+     the listing can be deferred to when the response is written.
+     \param size the number of items in the whole listing, -1 for all of items.
+     */
+    static void StreamFileItemList(const char *ID, bool allowFile, const char *resultname, CFileItemList &items, const CVariant &parameterObject, CVariant &result, int size = -1, bool sortLimit = true);
     static void HandleFileItem(const char *ID, bool allowFile, const char *resultname, CFileItemPtr item, const CVariant &parameterObject, const CVariant &validFields, CVariant &result, bool append = true);
 
     static bool FillFileItemList(const CVariant &parameterObject, CFileItemList &list);
+    static void ParseSort(const CVariant &parameterObject, SORT_METHOD &sortmethod, SORT_ORDER &sortorder);
   private:
+    static void AddFileItemList(const char *ID, bool allowFile, const char *resultname, CFileItemList &items, const CVariant &parameterObject, CVariant &result, int size, bool sortLimit, bool defer);
+    static void SerializeFileItem(const char *ID, bool allowFile, CFileItemPtr item, const CVariant &validFields, CVariant &object);
     static bool ParseSortMethods(const CStdString &method, const bool &ignorethe, const CStdString &order, SORT_METHOD &sortmethod, SORT_ORDER &sortorder);
     static void Sort(CFileItemList &items, const CVariant& parameterObject);
+
+    static XbmcThreads::ThreadLocal<DeferredFileItemLists> m_deferredLists;
   };
 }
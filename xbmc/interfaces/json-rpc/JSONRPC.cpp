@@ -1,6 +1,7 @@
 
 
 #include "JSONRPC.h"
+#include "FileItemHandler.h"
 #include "settings/AdvancedSettings.h"
 #include "interfaces/AnnouncementManager.h"
 #include "interfaces/AnnouncementUtils.h"
@@ -129,10 +130,34 @@ JSON_STATUS CJSONRPC::NotifyAll(const CStdString &method, ITransportLayer *trans
   return ACK;
 }
 
+namespace
+{
+  // collects a streamed response into a string
+  class CStringOutput : public IJSONStreamOutput
+  {
+  public:
+    virtual bool Write(const char *data, size_t length)
+    {
+      m_string.append(data, length);
+      return true;
+    }
+
+    std::string m_string;
+  };
+}
+
 CStdString CJSONRPC::MethodCall(const CStdString &inputString, ITransportLayer *transport, IClient *client)
 {
-  CVariant inputroot, outputroot, result;
-  bool hasResponse = false;
+  CStringOutput output;
+  MethodCall(inputString, transport, client, output);
+  return output.m_string;
+}
+
+bool CJSONRPC::MethodCall(const CStdString &inputString, ITransportLayer *transport, IClient *client, IJSONStreamOutput &output)
+{
+  CVariant inputroot, outputroot;
+  CJSONStreamWriter writer(output, g_advancedSettings.m_jsonOutputCompact);
+  bool success = true;
 
   CLog::Log(LOGDEBUG, "JSONRPC: Incoming request: %s", inputString.c_str());
   inputroot = CJSONVariantParser::Parse((unsigned char *)inputString.c_str(), inputString.length());
@@ -144,33 +169,49 @@ CStdString CJSONRPC::MethodCall(const CStdString &inputString, ITransportLayer *
       {
         CLog::Log(LOGERROR, "JSONRPC: Empty batch call\n");
         BuildResponse(inputroot, InvalidRequest, CVariant(), outputroot);
-        hasResponse = true;
+        success = writer.Write(outputroot);
       }
       else
       {
-        for (CVariant::const_iterator_array itr = inputroot.begin_array(); itr != inputroot.end_array(); itr++)
+        // the batch is only opened once there is a response to put in it
+        bool hasResponse = false;
+        for (CVariant::const_iterator_array itr = inputroot.begin_array(); itr != inputroot.end_array() && success; itr++)
         {
           CVariant response;
-          if (HandleMethodCall(*itr, response, transport, client))
+          DeferredFileItemLists lists;
+          CFileItemHandler::DeferFileItemLists(&lists);
+          bool respond = HandleMethodCall(*itr, response, transport, client);
+          CFileItemHandler::DeferFileItemLists(NULL);
+          if (respond)
           {
-            outputroot.append(response);
+            if (!hasResponse)
+              success = writer.OpenArray();
             hasResponse = true;
+            success = success && WriteResponse(writer, response, lists);
           }
         }
+        if (hasResponse && success)
+          success = writer.CloseArray();
       }
     }
     else
-      hasResponse = HandleMethodCall(inputroot, outputroot, transport, client);
+    {
+      DeferredFileItemLists lists;
+      CFileItemHandler::DeferFileItemLists(&lists);
+      bool respond = HandleMethodCall(inputroot, outputroot, transport, client);
+      CFileItemHandler::DeferFileItemLists(NULL);
+      if (respond)
+        success = WriteResponse(writer, outputroot, lists);
+    }
   }
   else
   {
     CLog::Log(LOGERROR, "JSONRPC: Failed to parse '%s'\n", inputString.c_str());
     BuildResponse(inputroot, ParseError, CVariant(), outputroot);
-    hasResponse = true;
+    success = writer.Write(outputroot);
   }
 
-  CStdString str = hasResponse ? CJSONVariantWriter::Write(outputroot, g_advancedSettings.m_jsonOutputCompact) : "";
-  return str;
+  return writer.Flush() && success;
 }
 
 bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client)
@@ -206,6 +247,39 @@ bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITr
   return !isNotification;
 }
 
+bool CJSONRPC::WriteResponse(CJSONStreamWriter &writer, const CVariant& response, const DeferredFileItemLists &lists)
+{
+  if (lists.empty() || !response["result"].isObject())
+    return writer.Write(response);
+
+  // as CJSONVariantWriter would write the response, but with the deferred listings written in place
+  bool success = writer.OpenObject();
+  for (CVariant::const_iterator_map itr = response.begin_map(); itr != response.end_map() && success; itr++)
+  {
+    success = writer.Key(itr->first);
+    if (!success)
+      break;
+    if (itr->first != "result")
+    {
+      success = writer.Write(itr->second);
+      continue;
+    }
+
+    success = writer.OpenObject();
+    for (CVariant::const_iterator_map field = itr->second.begin_map(); field != itr->second.end_map() && success; field++)
+    {
+      success = writer.Key(field->first);
+      DeferredFileItemLists::const_iterator list = lists.begin();
+      while (list != lists.end() && list->resultname != field->first)
+        list++;
+      if (success)
+        success = list != lists.end() ? CFileItemHandler::WriteDeferredList(writer, *list) : writer.Write(field->second);
+    }
+    success = success && writer.CloseObject();
+  }
+  return success && writer.CloseObject();
+}
+
 inline bool CJSONRPC::IsProperJSONRPC(const CVariant& inputroot)
 {
   return inputroot.isObject() && inputroot.isMember("jsonrpc") && inputroot["jsonrpc"].isString() && inputroot["jsonrpc"] == CVariant("2.0") && inputroot.isMember("method") && inputroot["method"].isString() && (!inputroot.isMember("params") || inputroot["params"].isArray() || inputroot["params"].isObject());
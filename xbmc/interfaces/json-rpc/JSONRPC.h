@@ -10,6 +10,7 @@
 #include "interfaces/IAnnouncer.h"
 #include "JSONUtils.h"
 #include "JSONServiceDescription.h"
+#include "DeferredFileItemList.h"
 
 namespace JSONRPC
 {
@@ -44,6 +45,22 @@ namespace JSONRPC
      */
     static CStdString MethodCall(const CStdString &inputString, ITransportLayer *transport, IClient *client);
 
+    /*
+     \brief Handles an incoming JSON RPC request, streaming the response
+     \param inputString received JSON RPC request
+     \param transport Transport protocol on which the request arrived
+     \param client Client which sent the request
+     \param output where the JSON RPC response is written to, in chunks
+     \return false if the output failed
+
+     As MethodCall() above, but the response is written to output as it is
+     generated. Listings in method results are serialized item by item into
+     the output rather than built up as a whole first, which keeps the memory
+     of large responses flat and sends their start before their end is ready.
+     Nothing is written if the request needs no response.
+     */
+    static bool MethodCall(const CStdString &inputString, ITransportLayer *transport, IClient *client, IJSONStreamOutput &output);
+
     static JSON_STATUS Introspect(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSON_STATUS Version(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSON_STATUS Permission(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
@@ -55,6 +72,7 @@ namespace JSONRPC
   private:
     static void setup();
     static bool HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client);
+    static bool WriteResponse(CJSONStreamWriter &writer, const CVariant& response, const DeferredFileItemLists &lists);
     static inline bool IsProperJSONRPC(const CVariant& inputroot);
 
     inline static void BuildResponse(const CVariant& request, JSON_STATUS code, const CVariant& result, CVariant& response);
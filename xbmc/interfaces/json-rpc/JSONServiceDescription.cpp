@@ -95,6 +95,7 @@ JsonRpcMethodMap CJSONServiceDescription::m_methodMaps[] = {
   
   { "Player.SetAudioStream",                        CPlayerOperations::SetAudioStream },
   { "Player.SetSubtitle",                           CPlayerOperations::SetSubtitle },
+  { "Player.GetTelemetry",                          CPlayerOperations::GetTelemetry },
 
 // Playlist
   { "Playlist.GetPlaylists",                        CPlaylistOperations::GetPlaylists },
@@ -170,7 +171,9 @@ JsonRpcMethodMap CJSONServiceDescription::m_methodMaps[] = {
 
 // XBMC operations
   { "XBMC.GetInfoLabels",                           CXBMCOperations::GetInfoLabels },
-  { "XBMC.GetInfoBooleans",                         CXBMCOperations::GetInfoBooleans }
+  { "XBMC.GetInfoBooleans",                         CXBMCOperations::GetInfoBooleans },
+  { "XBMC.SetGUIProfiler",                          CXBMCOperations::SetGUIProfiler },
+  { "XBMC.GetGUIProfile",                           CXBMCOperations::GetGUIProfile }
 };
 
 bool CJSONServiceDescription::prepareDescription(std::string &description, CVariant &descriptionObject, std::string &name)
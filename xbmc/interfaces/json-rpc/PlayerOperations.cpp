@@ -15,6 +15,7 @@
 #include "VideoLibrary.h"
 #include "video/VideoDatabase.h"
 #include "AudioLibrary.h"
+#include "cores/PlaybackTelemetry.h"
 
 using namespace JSONRPC;
 using namespace PLAYLIST;
@@ -728,6 +729,17 @@ JSON_STATUS CPlayerOperations::SetSubtitle(const CStdString &method, ITransportL
   return ACK;
 }
 
+JSON_STATUS CPlayerOperations::GetTelemetry(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  CPlaybackTelemetry::Serialize(result);
+  if (parameterObject["log"].asBoolean())
+    CPlaybackTelemetry::Log();
+  if (parameterObject["reset"].asBoolean())
+    CPlaybackTelemetry::Reset();
+
+  return OK;
+}
+
 int CPlayerOperations::GetActivePlayers()
 {
   int activePlayers = 0;
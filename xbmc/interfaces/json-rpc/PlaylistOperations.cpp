@@ -71,7 +71,7 @@ JSON_STATUS CPlaylistOperations::GetItems(const CStdString &method, ITransportLa
       break;
   }
 
-  HandleFileItemList("id", true, "items", list, parameterObject, result);
+  StreamFileItemList("id", true, "items", list, parameterObject, result);
 
   return OK;
 }
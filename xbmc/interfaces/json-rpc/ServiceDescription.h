@@ -753,6 +753,18 @@ namespace JSONRPC
           "}"
         "}"
       "}"
+    "}",
+    "\"XBMC.GUIProfile.Times\": {"
+      "\"type\": \"object\","
+      "\"properties\": {"
+        "\"count\": { \"type\": \"integer\", \"required\": true },"
+        "\"max\": { \"type\": \"integer\", \"required\": true },"
+        "\"p50\": { \"type\": \"integer\", \"required\": true },"
+        "\"p90\": { \"type\": \"integer\", \"required\": true },"
+        "\"p99\": { \"type\": \"integer\", \"required\": true },"
+        "\"total\": { \"type\": \"integer\", \"required\": true, \"description\": \"Over all the sampled frames, children included\" },"
+        "\"self\": { \"type\": \"integer\", \"required\": true, \"description\": \"Over all the sampled frames, children excluded\" }"
+      "}"
     "}"
   };
 
@@ -1161,6 +1173,35 @@ namespace JSONRPC
       "],"
       "\"returns\": \"string\""
     "}",
+    "\"Player.GetTelemetry\": {"
+      "\"type\": \"method\","
+      "\"description\": \"Retrieves the latency histograms of the playback pipeline stages (in microseconds), the bytes read and the audio underruns since startup or the last reset\","
+      "\"transport\": \"Response\","
+      "\"permission\": \"ReadData\","
+      "\"params\": ["
+        "{ \"name\": \"reset\", \"type\": \"boolean\", \"default\": false, \"description\": \"Start counting anew after retrieving\" },"
+        "{ \"name\": \"log\", \"type\": \"boolean\", \"default\": false, \"description\": \"Also write the telemetry to the log\" }"
+      "],"
+      "\"returns\": {"
+        "\"type\": \"object\","
+        "\"properties\": {"
+          "\"stages\": { \"type\": \"object\", \"required\": true,"
+            "\"additionalProperties\": { \"type\": \"object\","
+              "\"properties\": {"
+                "\"count\": { \"type\": \"integer\", \"required\": true },"
+                "\"max\": { \"type\": \"integer\", \"required\": true },"
+                "\"p50\": { \"type\": \"integer\", \"required\": true },"
+                "\"p90\": { \"type\": \"integer\", \"required\": true },"
+                "\"p99\": { \"type\": \"integer\", \"required\": true },"
+                "\"buckets\": { \"type\": \"array\", \"items\": { \"type\": \"integer\" }, \"required\": true, \"description\": \"Bucket i counts the samples below 2^i microseconds and not below 2^(i-1), the last one all longer samples\" }"
+              "}"
+            "}"
+          "},"
+          "\"bytesread\": { \"type\": \"integer\", \"required\": true },"
+          "\"underruns\": { \"type\": \"integer\", \"required\": true }"
+        "}"
+      "}"
+    "}",
     "\"Playlist.GetPlaylists\": {"
       "\"type\": \"method\","
       "\"description\": \"Returns all existing playlists\","
@@ -2025,6 +2066,44 @@ namespace JSONRPC
         "\"type\": \"object\","
         "\"description\": \"List of key-value pairs of the retrieved info booleans\""
       "}"
+    "}",
+    "\"XBMC.SetGUIProfiler\": {"
+      "\"type\": \"method\","
+      "\"description\": \"Starts or stops sampling the time each window and skin control takes to process and render\","
+      "\"transport\": \"Response\","
+      "\"permission\": \"Navigate\","
+      "\"params\": ["
+        "{ \"name\": \"enabled\", \"type\": \"boolean\", \"required\": true },"
+        "{ \"name\": \"interval\", \"type\": \"integer\", \"minimum\": 1, \"default\": 5, \"description\": \"Sample one frame in every interval frames\" }"
+      "],"
+      "\"returns\": \"string\""
+    "}",
+    "\"XBMC.GetGUIProfile\": {"
+      "\"type\": \"method\","
+      "\"description\": \"Retrieves the sampled process and render times (in microseconds) of each window and skin control, over the last 1000 to 2000 sampled frames\","
+      "\"transport\": \"Response\","
+      "\"permission\": \"ReadData\","
+      "\"params\": ["
+        "{ \"name\": \"flamegraph\", \"type\": \"boolean\", \"default\": false, \"description\": \"Also return the times as folded stacks for flame graph tools\" }"
+      "],"
+      "\"returns\": {"
+        "\"type\": \"object\","
+        "\"properties\": {"
+          "\"sampling\": { \"type\": \"boolean\", \"required\": true },"
+          "\"interval\": { \"type\": \"integer\", \"required\": true },"
+          "\"frames\": { \"type\": \"integer\", \"required\": true },"
+          "\"controls\": { \"type\": \"array\", \"required\": true,"
+            "\"items\": { \"type\": \"object\","
+              "\"properties\": {"
+                "\"stack\": { \"type\": \"string\", \"required\": true, \"description\": \"The window and the controls leading to the control, separated by semicolons\" },"
+                "\"process\": { \"$ref\": \"XBMC.GUIProfile.Times\", \"required\": true },"
+                "\"render\": { \"$ref\": \"XBMC.GUIProfile.Times\", \"required\": true }"
+              "}"
+            "}"
+          "},"
+          "\"flamegraph\": { \"type\": \"string\" }"
+        "}"
+      "}"
     "}"
   };
 
@@ -6,6 +6,7 @@
 #include "Util.h"
 #include "utils/Variant.h"
 #include "powermanagement/PowerManager.h"
+#include "guilib/GUIControlProfiler.h"
 
 using namespace JSONRPC;
 
@@ -75,3 +76,22 @@ JSON_STATUS CXBMCOperations::GetInfoBooleans(const CStdString &method, ITranspor
 
   return OK;
 }
+
+JSON_STATUS CXBMCOperations::SetGUIProfiler(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  if (parameterObject["enabled"].asBoolean())
+    CGUIControlProfiler::Instance().StartSampling((unsigned int)parameterObject["interval"].asUnsignedInteger());
+  else
+    CGUIControlProfiler::Instance().StopSampling();
+
+  return ACK;
+}
+
+JSON_STATUS CXBMCOperations::GetGUIProfile(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  CGUIControlProfiler::Instance().Serialize(result);
+  if (parameterObject["flamegraph"].asBoolean())
+    result["flamegraph"] = CGUIControlProfiler::Instance().GetFlameGraph();
+
+  return OK;
+}
@@ -0,0 +1,107 @@
+/*
+ * CoinAcceptor.cpp
+ *
+ * Reads the coin acceptor on a thread of its own.
+ */
+
+#include "CoinAcceptor.h"
+#include "JukeboxManager.h"
+#include "Application.h"
+#include "ApplicationMessenger.h"
+#include "settings/AdvancedSettings.h"
+#include "utils/log.h"
+
+#include <errno.h>
+#include <string.h>
+
+CoinAcceptor::CoinAcceptor()
+  : m_device(*this) {
+}
+
+CoinAcceptor::~CoinAcceptor() {
+  Stop();
+}
+
+bool CoinAcceptor::Start() {
+#ifdef _LINUX
+  if (g_advancedSettings.m_coinAcceptorDevice.IsEmpty())
+    return false;
+
+  if (!m_device.Open(g_advancedSettings.m_coinAcceptorDevice, g_advancedSettings.m_coinAcceptorInsertCode,
+                     g_advancedSettings.m_coinAcceptorRemoveCode, g_advancedSettings.m_coinAcceptorDebounce)) {
+    CLog::Log(LOGERROR, "CoinAcceptor: unable to create wakeup pipe (%s)", strerror(m_device.GetError()));
+    return false;
+  }
+
+  CLog::Log(LOGNOTICE, "CoinAcceptor: reading coins from %s", m_device.GetDevice().c_str());
+  Create();
+  SetPriority(THREAD_PRIORITY_ABOVE_NORMAL);
+  return true;
+#else
+  return false;
+#endif
+}
+
+void CoinAcceptor::Stop() {
+  if (!m_device.IsOpen())
+    return;
+
+  m_bStop = true;
+  // a full pipe has the thread awake already
+  if (!m_device.Interrupt() && m_device.GetError() != EAGAIN)
+    CLog::Log(LOGERROR, "CoinAcceptor: unable to interrupt the reader (%s)", strerror(m_device.GetError()));
+  StopThread();
+  m_device.Close();
+}
+
+void CoinAcceptor::Inject(ECoinEvent type) {
+  if (m_device.IsOpen() && !m_device.Inject(type))
+    CLog::Log(LOGERROR, "CoinAcceptor: dropped an injected coin (%s)", strerror(m_device.GetError()));
+}
+
+void CoinAcceptor::Process() {
+  bool reported = false;
+  while (!m_bStop) {
+    ECoinDeviceState state = m_device.Poll();
+    if (state == COIN_DEVICE_UNAVAILABLE) {
+      if (!reported)
+        CLog::Log(LOGERROR, "CoinAcceptor: unable to open %s (%s), retrying", m_device.GetDevice().c_str(), strerror(m_device.GetError()));
+      reported = true;
+      continue;
+    }
+    reported = false;
+
+    if (state == COIN_DEVICE_FAILED) {
+      CLog::Log(LOGERROR, "CoinAcceptor: poll failed (%s)", strerror(m_device.GetError()));
+      break;
+    }
+    if (state == COIN_DEVICE_LOST) {
+      CLog::Log(LOGWARNING, "CoinAcceptor: lost %s", m_device.GetDevice().c_str());
+      Sleep(m_bStop ? 0 : 100);
+    }
+  }
+}
+
+void CoinAcceptor::OnPulse(ECoinEvent type, int64_t timestamp) {
+  int64_t coins;
+  if (type == COIN_EVENT_INSERT)
+    coins = g_jukeboxManager.GetCoinsManager().InsertCoin(1);
+  else
+    coins = g_jukeboxManager.GetCoinsManager().RemoveCoin(1);
+  g_jukeboxManager.GetRandomManager().Reset();
+
+  CLog::Log(LOGDEBUG, "CoinAcceptor: coin %s, %i credits, %.2f ms after the pulse (%u bounces)",
+            type == COIN_EVENT_INSERT ? "inserted" : "removed", (int)coins,
+            (CoinDevice::Now() - timestamp) / 1000.0, m_device.GetBounces());
+
+  // the customer is at the machine, as they would be after a key press
+  static ThreadMessageCallback callback = { WakeGUI, NULL };
+  ThreadMessage msg = { TMSG_CALLBACK };
+  msg.lpVoid = (void *)&callback;
+  g_application.getApplicationMessenger().SendMessage(msg, false);
+}
+
+void CoinAcceptor::WakeGUI(void *userptr) {
+  g_application.ResetScreenSaver();
+  g_application.WakeUpScreenSaverAndDPMS();
+}
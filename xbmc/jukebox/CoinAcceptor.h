@@ -0,0 +1,51 @@
+/*
+ * CoinAcceptor.h
+ *
+ * Reads the coin acceptor on a thread of its own.
+ */
+
+#ifndef COINACCEPTOR_H_
+#define COINACCEPTOR_H_
+
+#include "CoinDevice.h"
+#include "threads/Thread.h"
+
+/*!
+ \brief Credits coins as the acceptor pulses, whatever the GUI is doing.
+
+ Coins used to arrive as key presses mapped to the InsertCredit builtin, so they were only
+ counted when the application thread got round to its input, and pulses arriving during heavy
+ GUI work got delayed or batched. This thread blocks on the device instead (see CoinDevice)
+ and credits each pulse through CoinsManager as it arrives.
+
+ The device is <coinacceptor><device> in advancedsettings.xml. "loopback" opens no device and
+ only takes coins given to Inject(), which is also how a bench or test setup without an
+ acceptor can feed coins (as can writing to a fifo).
+ */
+class CoinAcceptor : public CThread, private ICoinPulseHandler {
+public:
+  CoinAcceptor();
+  virtual ~CoinAcceptor();
+
+  /*! \brief Start reading the coin acceptor configured in advancedsettings.xml.
+   \return true if an acceptor is configured, false otherwise.
+   */
+  bool Start();
+  void Stop();
+
+  /*! \brief Feed a pulse as if it came from the device.
+   \param type the kind of pulse.
+   */
+  void Inject(ECoinEvent type);
+
+protected:
+  virtual void Process();
+
+private:
+  virtual void OnPulse(ECoinEvent type, int64_t timestamp);
+  static void WakeGUI(void *userptr);
+
+  CoinDevice m_device;
+};
+
+#endif /* COINACCEPTOR_H_ */
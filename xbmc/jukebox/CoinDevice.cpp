@@ -0,0 +1,243 @@
+/*
+ * CoinDevice.cpp
+ *
+ * The device the coin acceptor pulses on.
+ */
+
+#include "CoinDevice.h"
+
+#ifdef _LINUX
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/input.h>
+#endif
+
+// how long to wait before trying to open the device again, when it failed or went away
+#define COIN_REOPEN_DELAY 2000
+
+// what goes down the wakeup pipe
+#define COIN_WAKEUP_INTERRUPT 's'
+#define COIN_WAKEUP_INSERT    'i'
+#define COIN_WAKEUP_REMOVE    'r'
+
+CoinDevice::CoinDevice(ICoinPulseHandler &handler)
+  : m_handler(handler) {
+  m_loopback = false;
+  m_inputDevice = false;
+  m_insertCode = -1;
+  m_removeCode = -1;
+  m_debounce = 0;
+  m_lastPulse[0] = m_lastPulse[1] = 0;
+  m_bounces = 0;
+  m_error = 0;
+  m_fd = -1;
+  m_wakeup[0] = m_wakeup[1] = -1;
+}
+
+CoinDevice::~CoinDevice() {
+  Close();
+}
+
+bool CoinDevice::Open(const CStdString &device, int insertCode, int removeCode, int debounce) {
+#ifdef _LINUX
+  Close();
+
+  m_device = device;
+  m_loopback = m_device.Equals("loopback");
+  m_inputDevice = m_device.Left(11).Equals("/dev/input/");
+  m_insertCode = insertCode;
+  m_removeCode = removeCode;
+  m_debounce = (int64_t)debounce * 1000;
+  m_lastPulse[0] = m_lastPulse[1] = 0;
+  m_bounces = 0;
+  m_error = 0;
+
+  if (pipe(m_wakeup) != 0) {
+    m_error = errno;
+    return false;
+  }
+  // a full pipe wakes Poll() already, writers are not held up by it
+  fcntl(m_wakeup[1], F_SETFL, O_NONBLOCK);
+  return true;
+#else
+  return false;
+#endif
+}
+
+void CoinDevice::Close() {
+#ifdef _LINUX
+  CloseDevice();
+  if (m_wakeup[0] >= 0)
+    close(m_wakeup[0]);
+  if (m_wakeup[1] >= 0)
+    close(m_wakeup[1]);
+  m_wakeup[0] = m_wakeup[1] = -1;
+#endif
+}
+
+ECoinDeviceState CoinDevice::Poll() {
+#ifdef _LINUX
+  bool available = m_fd >= 0 || m_loopback || OpenDevice();
+
+  struct pollfd fds[2];
+  fds[0].fd = m_wakeup[0];
+  fds[0].events = POLLIN;
+  fds[0].revents = 0;
+  fds[1].fd = m_fd;
+  fds[1].events = POLLIN;
+  fds[1].revents = 0;
+  int count = poll(fds, m_fd >= 0 ? 2 : 1, available ? -1 : COIN_REOPEN_DELAY);
+  if (count < 0 && errno != EINTR) {
+    m_error = errno;
+    return COIN_DEVICE_FAILED;
+  }
+
+  if (count > 0) {
+    int64_t timestamp = Now();
+    if (fds[0].revents & POLLIN)
+      ReadWakeup(timestamp);
+    if (m_fd >= 0 && (fds[1].revents & (POLLIN | POLLERR | POLLHUP | POLLNVAL)) && !ReadDevice(timestamp)) {
+      // unplugged, or the writer of the fifo went away
+      CloseDevice();
+      return COIN_DEVICE_LOST;
+    }
+  }
+  return available ? COIN_DEVICE_OK : COIN_DEVICE_UNAVAILABLE;
+#else
+  return COIN_DEVICE_FAILED;
+#endif
+}
+
+bool CoinDevice::Interrupt() {
+  return WriteWakeup(COIN_WAKEUP_INTERRUPT);
+}
+
+bool CoinDevice::Inject(ECoinEvent type) {
+  return WriteWakeup(type == COIN_EVENT_INSERT ? COIN_WAKEUP_INSERT : COIN_WAKEUP_REMOVE);
+}
+
+int64_t CoinDevice::Now() {
+#ifdef _LINUX
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (int64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+#else
+  return 0;
+#endif
+}
+
+bool CoinDevice::OpenDevice() {
+#ifdef _LINUX
+  m_fd = open(m_device.c_str(), O_RDONLY | O_NOCTTY | O_NONBLOCK);
+  if (m_fd < 0) {
+    m_error = errno;
+    return false;
+  }
+
+  // serial lines: raw bytes, as they come
+  if (!m_inputDevice && isatty(m_fd)) {
+    struct termios options;
+    if (tcgetattr(m_fd, &options) == 0) {
+      cfmakeraw(&options);
+      options.c_cflag |= CLOCAL | CREAD;
+      tcsetattr(m_fd, TCSANOW, &options);
+    }
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+void CoinDevice::CloseDevice() {
+#ifdef _LINUX
+  if (m_fd >= 0)
+    close(m_fd);
+  m_fd = -1;
+#endif
+}
+
+bool CoinDevice::ReadDevice(int64_t timestamp) {
+#ifdef _LINUX
+  if (m_inputDevice) {
+    struct input_event events[16];
+    ssize_t length = read(m_fd, events, sizeof(events));
+    if (length <= 0)
+      return length < 0 && (errno == EAGAIN || errno == EINTR);
+    for (unsigned int i = 0; i < length / sizeof(struct input_event); i++) {
+      // key down only, repeats and releases are not pulses
+      if (events[i].type != EV_KEY || events[i].value != 1)
+        continue;
+      // the kernel stamps each event, which debounces pulses that are read together
+      int64_t pulseTime = (int64_t)events[i].time.tv_sec * 1000000 + events[i].time.tv_usec;
+      if (events[i].code == m_removeCode)
+        OnPulse(COIN_EVENT_REMOVE, pulseTime, timestamp);
+      else if (m_insertCode < 0 || events[i].code == m_insertCode)
+        OnPulse(COIN_EVENT_INSERT, pulseTime, timestamp);
+    }
+  }
+  else {
+    unsigned char bytes[64];
+    ssize_t length = read(m_fd, bytes, sizeof(bytes));
+    if (length <= 0)
+      return length < 0 && (errno == EAGAIN || errno == EINTR);
+    // each byte is a message from the acceptor's controller, which has already debounced it
+    for (ssize_t i = 0; i < length; i++) {
+      if (bytes[i] == m_removeCode)
+        OnPulse(COIN_EVENT_REMOVE, -1, timestamp);
+      else if (m_insertCode < 0 || bytes[i] == m_insertCode)
+        OnPulse(COIN_EVENT_INSERT, -1, timestamp);
+    }
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+void CoinDevice::ReadWakeup(int64_t timestamp) {
+#ifdef _LINUX
+  // injected pulses are debounced as pulses read from an input device
+  char wakeup[16];
+  ssize_t length = read(m_wakeup[0], wakeup, sizeof(wakeup));
+  for (ssize_t i = 0; i < length; i++) {
+    if (wakeup[i] == COIN_WAKEUP_INSERT)
+      OnPulse(COIN_EVENT_INSERT, timestamp, timestamp);
+    else if (wakeup[i] == COIN_WAKEUP_REMOVE)
+      OnPulse(COIN_EVENT_REMOVE, timestamp, timestamp);
+  }
+#endif
+}
+
+bool CoinDevice::WriteWakeup(char wakeup) {
+#ifdef _LINUX
+  if (m_wakeup[1] < 0)
+    return false;
+  ssize_t length;
+  do
+    length = write(m_wakeup[1], &wakeup, 1);
+  while (length < 0 && errno == EINTR);
+  if (length != 1) {
+    m_error = errno;
+    return false;
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+void CoinDevice::OnPulse(ECoinEvent type, int64_t pulseTime, int64_t timestamp) {
+  if (pulseTime >= 0) {
+    if (m_lastPulse[type] && pulseTime - m_lastPulse[type] < m_debounce) {
+      m_bounces++;
+      return;
+    }
+    m_lastPulse[type] = pulseTime;
+  }
+  m_handler.OnPulse(type, timestamp);
+}
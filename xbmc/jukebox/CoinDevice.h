@@ -0,0 +1,113 @@
+/*
+ * CoinDevice.h
+ *
+ * The device the coin acceptor pulses on.
+ */
+
+#ifndef COINDEVICE_H_
+#define COINDEVICE_H_
+
+#include "utils/StdString.h"
+#include <stdint.h>
+
+enum ECoinEvent {
+  COIN_EVENT_INSERT = 0,
+  COIN_EVENT_REMOVE = 1
+};
+
+enum ECoinDeviceState {
+  COIN_DEVICE_OK,
+  COIN_DEVICE_UNAVAILABLE,    ///< the device couldn't be opened, see CoinDevice::GetError()
+  COIN_DEVICE_LOST,           ///< the device went away, it is opened again by the next Poll()
+  COIN_DEVICE_FAILED          ///< waiting for the device failed, see CoinDevice::GetError()
+};
+
+/*!
+ \brief What gets the pulses of a CoinDevice that count.
+ */
+class ICoinPulseHandler {
+public:
+  virtual ~ICoinPulseHandler() {}
+  /*! \brief A pulse that got through debouncing.
+   \param timestamp when the pulse was read, see CoinDevice::Now().
+   */
+  virtual void OnPulse(ECoinEvent type, int64_t timestamp) = 0;
+};
+
+/*!
+ \brief Reads and debounces the pulses of a coin acceptor, for whoever waits on Poll().
+
+ The device is either a Linux input device (/dev/input/...), read as key events, or a serial
+ line or fifo, read as bytes. Each pulse is timestamped when read. Pulses from an input device
+ of the same kind closer together than the debounce time count once; bytes from a serial line
+ are messages and are not debounced.
+
+ "loopback" opens no device and only takes pulses given to Inject(), which are debounced as
+ pulses of an input device.
+ */
+class CoinDevice {
+public:
+  CoinDevice(ICoinPulseHandler &handler);
+  ~CoinDevice();
+
+  /*! \brief Get ready to read a device. The device itself is opened by Poll(), and opened again
+   when it goes away.
+   \param device path of the device, or "loopback".
+   \param insertCode,removeCode key code (input device) or byte (serial line) of each kind of pulse,
+   an insert code below zero takes anything but the remove code as an insert.
+   \param debounce in ms.
+   \return false if the wakeup pipe couldn't be created, see GetError().
+   */
+  bool Open(const CStdString &device, int insertCode, int removeCode, int debounce);
+  void Close();
+  bool IsOpen() const { return m_wakeup[1] >= 0; }
+
+  /*! \brief Wait for pulses, and hand those that count to the handler.
+   Returns after reading the device or the wakeup pipe, and after a while when the device
+   can't be opened.
+   */
+  ECoinDeviceState Poll();
+
+  /*! \brief Make a Poll() in progress return. */
+  bool Interrupt();
+
+  /*! \brief Feed a pulse as if it came from the device, to be read by Poll().
+   \return false if the device isn't open or the pulse couldn't be queued.
+   */
+  bool Inject(ECoinEvent type);
+
+  /*! \brief errno of the latest failure. */
+  int GetError() const { return m_error; }
+  /*! \brief Number of pulses ignored as bounces since Open(). */
+  unsigned int GetBounces() const { return m_bounces; }
+  const CStdString &GetDevice() const { return m_device; }
+
+  /*! \brief The clock of the pulse timestamps, in us. */
+  static int64_t Now();
+
+private:
+  bool OpenDevice();
+  void CloseDevice();
+  bool ReadDevice(int64_t timestamp);
+  void ReadWakeup(int64_t timestamp);
+  bool WriteWakeup(char wakeup);
+  /*! \param pulseTime when the pulse happened in us, for debouncing, -1 for pulses that need none.
+   \param timestamp when the pulse was read.
+   */
+  void OnPulse(ECoinEvent type, int64_t pulseTime, int64_t timestamp);
+
+  ICoinPulseHandler &m_handler;
+  CStdString m_device;
+  bool m_loopback;
+  bool m_inputDevice;         ///< true for a Linux input device, false for a serial line or fifo
+  int m_insertCode;
+  int m_removeCode;
+  int64_t m_debounce;         ///< in us
+  int64_t m_lastPulse[2];     ///< time of the last counted pulse of each kind, in us
+  unsigned int m_bounces;
+  int m_error;
+  int m_fd;
+  int m_wakeup[2];            ///< pipe that interrupts the wait for the device: interruptions and injected pulses
+};
+
+#endif /* COINDEVICE_H_ */
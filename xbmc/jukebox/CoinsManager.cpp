@@ -11,6 +11,11 @@
 #include "playlists/PlayList.h"
 #include "guilib/GUIWindowManager.h"
 #include "guilib/LocalizeStrings.h"
+#include "GUIInfoManager.h"
+#include "interfaces/Builtins.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+#include "JukeboxManager.h"
 
 CoinsManager::CoinsManager() {
   // TODO Auto-generated constructor stub
@@ -23,16 +28,43 @@ CoinsManager::~CoinsManager() {
   // TODO Auto-generated destructor stub
 }
 
+static int InsertCreditBuiltin(const std::vector<CStdString> &params) {
+  g_jukeboxManager.GetCoinsManager().InsertCoin(1);
+  CLog::Log(LOGDEBUG, "Jukebox: 1 coin inserted");
+  return 0;
+}
+
+static int RemoveCreditBuiltin(const std::vector<CStdString> &params) {
+  g_jukeboxManager.GetCoinsManager().RemoveCoin();
+  CLog::Log(LOGDEBUG, "Jukebox: 1 coin removed");
+  return 0;
+}
+
+static int RemoveLastSongBuiltin(const std::vector<CStdString> &params) {
+  g_jukeboxManager.GetCoinsManager().RemoveLastSong();
+  CLog::Log(LOGDEBUG, "Jukebox: 1 music removed and 1 coin inserted");
+  return 0;
+}
+
+void CoinsManager::RegisterBuiltins() {
+  CBuiltins::RegisterCommand("InsertCredit", InsertCreditBuiltin, false, "Jukebox: Inserts a credit");
+  CBuiltins::RegisterCommand("RemoveCredit", RemoveCreditBuiltin, false, "Jukebox: Removes a credit");
+  CBuiltins::RegisterCommand("RemoveLastSong", RemoveLastSongBuiltin, false, "Jukebox: Remove the last song and returns 1 coin");
+}
+
 int64_t CoinsManager::InsertCoin(int64_t Amount) {
+  CSingleLock lock(m_lock);
   if (!m_dbProfessional.AddCoin(Amount))
     return -1;
 
   m_coins += Amount;
   m_iErasesAvaiable += Amount;
+  g_infoManager.InvalidateDependency(INFO::DEPENDS_COINS);
   return m_coins;
 }
 
 int64_t CoinsManager::RemoveCoin(int64_t Amount) {
+  CSingleLock lock(m_lock);
   if (m_coins <= 0) {
     m_iErasesAvaiable = 0;
     m_coins = 0;
@@ -44,16 +76,19 @@ int64_t CoinsManager::RemoveCoin(int64_t Amount) {
 
   if (m_dbProfessional.RemoveCoin(Amount)) {
     m_coins -= Amount;
+    g_infoManager.InvalidateDependency(INFO::DEPENDS_COINS);
   }
 
   return m_coins;
 }
 
 inline int64_t CoinsManager::GetCoins() {
+  CSingleLock lock(m_lock);
   return m_coins;
 }
 
 int64_t CoinsManager::EraseSong(int64_t Amount) {
+  CSingleLock lock(m_lock);
   if (m_iErasesAvaiable <=0)
     return 0;
 
@@ -90,6 +125,7 @@ void CoinsManager::RemoveLastSong() {
 
 
 inline bool CoinsManager::HasCoins() {
+  CSingleLock lock(m_lock);
   return (m_coins > 0);
 }
 
@@ -107,10 +143,12 @@ void CoinsManager::ShowMessage() {
 }
 
 bool CoinsManager::Init() {
+  CSingleLock lock(m_lock);
   if (!m_dbProfessional.Open()) return false;
 
   m_coins =  m_dbProfessional.GetCoins();
   m_iErasesAvaiable = m_coins;
+  g_infoManager.InvalidateDependency(INFO::DEPENDS_COINS);
 
   m_dialog = (CGUIDialogKaiToast *)g_windowManager.GetWindow(WINDOW_DIALOG_KAI_TOAST);
   if (!m_dialog) return false;
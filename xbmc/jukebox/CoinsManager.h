@@ -11,6 +11,7 @@
 #include "IModeManager.h"
 #include "ProfessionalDatabase.h"
 #include "dialogs/GUIDialogKaiToast.h"
+#include "threads/CriticalSection.h"
 
 
 class CoinsManager: public IModeManager {
@@ -21,12 +22,19 @@ private:
 
   CGUIDialogKaiToast *m_dialog;
 
+  CCriticalSection m_lock;    ///< coins come from the coin acceptor thread as well as the GUI
+
 public:
   CoinsManager();
   virtual ~CoinsManager();
 
   virtual bool Init();
 
+  /*! \brief Register the coin builtins (InsertCredit, RemoveCredit, RemoveLastSong).
+   Must run before the keymaps that bind them to the coin acceptor are loaded.
+   */
+  static void RegisterBuiltins();
+
   int64_t InsertCoin(int64_t Amount = 1);
   int64_t RemoveCoin(int64_t Amount = 1);
   int64_t EraseSong(int64_t Amount = 1);
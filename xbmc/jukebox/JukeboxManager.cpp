@@ -5,6 +5,7 @@
 
 CJukeboxManager::CJukeboxManager() {
 	m_started = false;
+	m_opMode = JUKEBOX_OPMODE_DEFAULT;
 //	CoolDownReset();
 }
 
@@ -16,6 +17,9 @@ CJukeboxManager::CJukeboxManager() {
 
 
 bool CJukeboxManager::Start() {
+  m_opMode = g_guiSettings.GetInt("operation.mode");
+  m_recentlyPlayed.Open("special://profile/recentlyplayed.txt");
+
   m_started =
       m_coinsManager.Init() &&
       m_partyModeManager.Init();
@@ -25,12 +29,17 @@ bool CJukeboxManager::Start() {
     m_randomManager.Start();
   }
 
+  if (m_started)
+    m_coinAcceptor.Start();
+
 	return m_started;
 }
 
 CJukeboxManager::~CJukeboxManager() {
+	m_coinAcceptor.Stop();
 	m_db.Close();
 	m_randomManager.Stop();
+	m_recentlyPlayed.Close();
 }
 
 //void CJukeboxManager::CoolDownReset() {
@@ -74,8 +83,19 @@ CoinsManager& CJukeboxManager::GetCoinsManager() {
   return m_coinsManager;
 }
 
+void CJukeboxManager::OnSettingChanged(const CStdString &setting) {
+  if (setting.Equals("operation.mode"))
+    m_opMode = g_guiSettings.GetInt("operation.mode");
+  else if (setting.Equals("operation.partymode_maxlistsize") || setting.Equals("operation.partymode_queuewait"))
+    m_partyModeManager.OnSettingsChanged();
+}
+
+void CJukeboxManager::OnPlaylistChanged() {
+  m_partyModeManager.OnPlaylistChanged();
+}
+
 IModeManager& CJukeboxManager::GetModeManager() {
-  switch (g_guiSettings.GetInt("operation.mode"))
+  switch (m_opMode)
   {
     case JUKEBOX_OPMODE_DEFAULT:
     {
@@ -95,6 +115,14 @@ RandomManager& CJukeboxManager::GetRandomManager() {
   return m_randomManager;
 }
 
+CRecentlyPlayed& CJukeboxManager::GetRecentlyPlayed() {
+  return m_recentlyPlayed;
+}
+
+CoinAcceptor& CJukeboxManager::GetCoinAcceptor() {
+  return m_coinAcceptor;
+}
+
 CReportManager& CJukeboxManager::GetReportsManager() {
   return m_ReportsManager;
 }
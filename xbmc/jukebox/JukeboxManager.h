@@ -5,9 +5,11 @@
 
 //#include "utils/Stopwatch.h"
 
+#include "CoinAcceptor.h"
 #include "CoinsManager.h"
 #include "PartyModeManager.h"
 #include "RandomManager.h"
+#include "RecentlyPlayed.h"
 
 #define COOLDOWNTIME 180.0f
 #define COOLDOWNMAXSONGS 5
@@ -29,6 +31,8 @@ private:
   RandomManager m_randomManager;
   CoinsManager m_coinsManager;
   plxJukebox::PartyModeManager m_partyModeManager;
+  CoinAcceptor m_coinAcceptor;
+  CRecentlyPlayed m_recentlyPlayed;
 
 	CProfessionalDatabase m_db;
 	CReportManager m_ReportsManager;
@@ -37,6 +41,7 @@ private:
 //	unsigned int m_coolDownCounter;
 
 	bool m_started;
+	int m_opMode; ///< operation.mode, cached as it's looked up for every queue attempt and label
 
 //	int64_t m_coins;
 //	double m_totalMoney;
@@ -58,6 +63,10 @@ public:
 
 	RandomManager& GetRandomManager();
 
+	CRecentlyPlayed& GetRecentlyPlayed();
+
+	CoinAcceptor& GetCoinAcceptor();
+
 	CReportManager& GetReportsManager();
 
 	// STATS
@@ -65,6 +74,12 @@ public:
 
 
 	bool Start();
+
+	/*! \brief Refresh what is cached of the operation settings after one has changed. */
+	void OnSettingChanged(const CStdString &setting);
+
+	/*! \brief Called by the playlist player whenever a playlist has changed. */
+	void OnPlaylistChanged();
 	
 //	bool InCoolDown();
 //	void AddCoolDownCount();
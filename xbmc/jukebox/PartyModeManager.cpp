@@ -28,11 +28,20 @@ PartyModeManager::~PartyModeManager() {
   // TODO Auto-generated destructor stub
 }
 
+void PartyModeManager::OnSettingsChanged() {
+  m_iPlaylistMaxSize  = g_guiSettings.GetInt("operation.partymode_maxlistsize");
+  m_iQueueWait         = g_guiSettings.GetInt("operation.partymode_queuewait");
+  UpdateParams();
+}
+
+void PartyModeManager::OnPlaylistChanged() {
+  UpdateParams();
+}
+
 void PartyModeManager::UpdateParams() {
+  // the playlist keeps count of its playable items, so this is cheap enough for every queue attempt
   m_iCurrentPlaylist   = g_playlistPlayer.GetCurrentPlaylist();
   m_iPlaylistSize         = g_playlistPlayer.GetPlaylist(m_iCurrentPlaylist).GetPlayable();
-  m_iPlaylistMaxSize  = g_guiSettings.GetInt("operation.partymode_maxlistsize");
-  m_iQueueWait         = g_guiSettings.GetInt("operation.partymode_queuewait");
 
   if (m_iPlaylistSize <=  m_iPlaylistMaxSize - m_iQueueWait)
     m_iQueuesAllowed = m_iPlaylistMaxSize - m_iPlaylistSize;
@@ -58,7 +67,7 @@ void PartyModeManager::ShowMessage() {
 }
 
 bool PartyModeManager::Init() {
-  UpdateParams();
+  OnSettingsChanged();
 
   m_dialog = (CGUIDialogKaiToast *)g_windowManager.GetWindow(WINDOW_DIALOG_KAI_TOAST);
   if (!m_dialog) return false;
@@ -12,6 +12,14 @@
 #include "dialogs/GUIDialogKaiToast.h"
 
 namespace plxJukebox {
+/*!
+ \brief Limits how many songs may be queued in party mode.
+
+ Queueing is allowed until the playlist holds operation.partymode_maxlistsize playable
+ songs, and then not until operation.partymode_queuewait of them have been played. The
+ settings are cached, and refreshed through OnSettingsChanged(), so CanQueue() only looks at
+ the playlist's count of playable items.
+ */
 class PartyModeManager: public IModeManager {
 private:
   int m_iPlaylistSize;
@@ -26,6 +34,12 @@ public:
   virtual ~PartyModeManager();
   void UpdateParams();
 
+  /*! \brief Re-read the party mode settings. */
+  void OnSettingsChanged();
+
+  /*! \brief Update the songs left to queue after the playlist has changed. */
+  void OnPlaylistChanged();
+
   virtual bool Init();
 
   virtual bool CanQueue();
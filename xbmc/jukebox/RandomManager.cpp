@@ -17,10 +17,30 @@
 #include "PlayListPlayer.h"
 #include "FileItem.h"
 #include "Application.h"
+#include "RecentlyPlayed.h"
+
+/*! \brief Random songs of the whole music library, for smart random */
+class CSmartRandomPicker : public IRandomPicker
+{
+public:
+  CSmartRandomPicker(CMusicDatabase &database) : m_database(database), m_lastTime(time(0)) {}
+  virtual bool Pick(CFileItem &item)
+  {
+    if (time(0) != m_lastTime)
+    {
+      m_lastTime = time(0);
+      srand(m_lastTime);
+    }
+    int songID;
+    return m_database.GetRandomSong(&item, songID, "");
+  }
+private:
+  CMusicDatabase &m_database;
+  unsigned int m_lastTime;
+};
 
 RandomManager::RandomManager() {
   m_StopWatchMaxTime = 0;
-  m_history.clear();
   bActive = false;
   Reset();
 }
@@ -68,30 +88,19 @@ void RandomManager::DoWork() {
   CMusicDatabase database;
   if (!database.Open()) return;
 
-  CStdString whereClause = GetWhereClauseWithHistory();
-  CFileItemPtr item(new CFileItem);
-  int songID;
-  unsigned int ilasttime = time(0);
+  CRecentlyPlayed &recentlyPlayed = g_jukeboxManager.GetRecentlyPlayed();
+  CSmartRandomPicker picker(database);
 
-  do {
-    if ( !ItsTime() ) return;
-
-    if (time(0) != ilasttime)
-    {
-      ilasttime = time(0);
-      srand(ilasttime);
-    }
-
-    if (!database.GetRandomSong(item.get(), songID, whereClause)) return;
-
-  } while (!item.get()->Exists());
+  // pick again while the song was picked too recently, and while its file is missing
+  CFileItemPtr item = recentlyPlayed.Pick(picker, true);
+  if (!item || !ItsTime()) return;
 
 //  g_playlistPlayer.ClearPlaylist(PLAYLIST_MUSIC);
 //  g_playlistPlayer.Reset();
   g_playlistPlayer.Add(PLAYLIST_MUSIC, item);
   g_playlistPlayer.SetCurrentPlaylist(PLAYLIST_MUSIC);
   if (g_playlistPlayer.Play()) {
-    AddToHistory(songID);
+    recentlyPlayed.Add(*item);
     Reset();
     CStdString strArtist =  item.get()->GetMusicInfoTag()->GetAlbumArtist();
 
@@ -124,30 +133,3 @@ void RandomManager::Start() {
   bActive = true;
   CLog::Log(LOGNOTICE, "SmartRandom: Activated");
 }
-
-void RandomManager::AddToHistory(int songID)
-{
-  m_history.push_back(songID);
-}
-
-CStdString RandomManager::GetWhereClauseWithHistory() const
-{
-  CStdString historyWhereMusic;
-  // now add this on to the normal where clause
-  if (m_history.size())
-  {
-    historyWhereMusic = "where songview.idSong not in (";
-
-    for (unsigned int i = 0; i < m_history.size(); i++)
-    {
-      CStdString number;
-      number.Format("%i,", m_history[i]);
-      historyWhereMusic += number;
-    }
-
-    historyWhereMusic.TrimRight(",");
-    historyWhereMusic += ")";
-  }
-
-  return historyWhereMusic;
-}
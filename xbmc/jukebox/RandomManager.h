@@ -11,19 +11,14 @@
 #include "utils/Stopwatch.h"
 #include "threads/Thread.h"
 #include "utils/StdString.h"
-#include <vector>
 
 class RandomManager: CThread
 {
 private:
   CStopWatch    m_StopWatch;
   unsigned int   m_StopWatchMaxTime;
-  std::vector <int> m_history;
   bool bActive;
 
-  void AddToHistory(int songID);
-  CStdString GetWhereClauseWithHistory() const;
-
   bool ItsTime();
 protected:
   virtual void Process();
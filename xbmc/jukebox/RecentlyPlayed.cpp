@@ -0,0 +1,234 @@
+
+
+#include "RecentlyPlayed.h"
+#include "FileItem.h"
+#include "filesystem/SpecialProtocol.h"
+#include "music/tags/MusicInfoTag.h"
+#include "video/VideoInfoTag.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "utils/StringUtils.h"
+#include "utils/log.h"
+#include <stdlib.h>
+
+using namespace std;
+
+// picks are kept one per line, with tab separated fields:
+//   <time> <track> <artist> <album>
+// the file is rewritten with the picks still in a window on Open(), and once it has grown
+// to twice that plus this many lines.
+#define RECENTLYPLAYED_COMPACT_RECORDS 256
+
+static CStdString Sanitize(const CStdString &field)
+{
+  CStdString result(field);
+  for (unsigned int i = 0; i < result.size(); i++)
+  {
+    if (result[i] == '\t' || result[i] == '\n' || result[i] == '\r')
+      result[i] = ' ';
+  }
+  return result;
+}
+
+CRecentlyPlayed::CRecentlyPlayed()
+{
+  m_file = NULL;
+  m_written = 0;
+}
+
+CRecentlyPlayed::~CRecentlyPlayed()
+{
+  Close();
+}
+
+void CRecentlyPlayed::Open(const CStdString &path)
+{
+  CSingleLock lock(m_section);
+  Close();
+
+  m_windows[TRACK].SetWindow(g_advancedSettings.m_noRepeatTrackSongs, g_advancedSettings.m_noRepeatTrackHours * 3600);
+  m_windows[ARTIST].SetWindow(g_advancedSettings.m_noRepeatArtistSongs, g_advancedSettings.m_noRepeatArtistHours * 3600);
+  m_windows[ALBUM].SetWindow(g_advancedSettings.m_noRepeatAlbumSongs, g_advancedSettings.m_noRepeatAlbumHours * 3600);
+  for (unsigned int i = 0; i < KINDS; i++)
+    m_windows[i].Clear();
+  m_records.clear();
+  m_path = CSpecialProtocol::TranslatePath(path);
+
+  FILE *file = fopen(m_path.c_str(), "rb");
+  if (file)
+  {
+    char line[4096];
+    unsigned int skipped = 0;
+    while (fgets(line, sizeof(line), file))
+    {
+      CStdString record(line);
+      if (record.Right(1) != "\n")
+      {
+        skipped++; // cut short
+        continue;
+      }
+      record.TrimRight("\n");
+      CStdStringArray fields;
+      StringUtils::SplitString(record, "\t", fields);
+      if (fields.size() != KINDS + 1)
+      {
+        skipped++;
+        continue;
+      }
+      CStdString keys[KINDS];
+      for (unsigned int i = 0; i < KINDS; i++)
+        keys[i] = fields[i + 1];
+      Add(keys, (time_t)strtoll(fields[0].c_str(), NULL, 10));
+    }
+    fclose(file);
+    if (skipped)
+      CLog::Log(LOGWARNING, "%s - skipped %u invalid records in %s", __FUNCTION__, skipped, path.c_str());
+  }
+  Compact();
+  CLog::Log(LOGINFO, "%s - %u recent picks, excluding %u tracks, %u artists, %u albums", __FUNCTION__,
+            (unsigned int)m_records.size(), (unsigned int)m_windows[TRACK].Size(),
+            (unsigned int)m_windows[ARTIST].Size(), (unsigned int)m_windows[ALBUM].Size());
+}
+
+void CRecentlyPlayed::Close()
+{
+  CSingleLock lock(m_section);
+  if (m_file)
+  {
+    fclose(m_file);
+    m_file = NULL;
+  }
+}
+
+void CRecentlyPlayed::Compact()
+{
+  if (m_file)
+    fclose(m_file);
+  CStdString tempPath = m_path + ".tmp";
+  FILE *file = fopen(tempPath.c_str(), "wb");
+  bool success = file != NULL;
+  for (deque<CStdString>::const_iterator i = m_records.begin(); success && i != m_records.end(); ++i)
+    success = fputs(i->c_str(), file) >= 0;
+  if (file)
+    success = fclose(file) == 0 && success;
+  if (!success || rename(tempPath.c_str(), m_path.c_str()) != 0)
+    CLog::Log(LOGERROR, "%s - unable to write %s", __FUNCTION__, m_path.c_str());
+  m_written = m_records.size();
+
+  m_file = fopen(m_path.c_str(), "ab");
+  if (!m_file)
+    CLog::Log(LOGERROR, "%s - unable to open %s, recent picks won't be kept", __FUNCTION__, m_path.c_str());
+}
+
+bool CRecentlyPlayed::IsExcluded(const CFileItem &item)
+{
+  CStdString keys[KINDS];
+  GetKeys(item, keys);
+  CSingleLock lock(m_section);
+  time_t now = time(NULL);
+  for (unsigned int i = 0; i < KINDS; i++)
+  {
+    if (m_windows[i].Contains(keys[i], now))
+      return true;
+  }
+  return false;
+}
+
+void CRecentlyPlayed::Add(const CFileItem &item)
+{
+  CStdString keys[KINDS];
+  GetKeys(item, keys);
+  CSingleLock lock(m_section);
+  time_t now = time(NULL);
+  Add(keys, now);
+
+  if (m_file)
+  {
+    fputs(m_records.back().c_str(), m_file);
+    fflush(m_file);
+    if (++m_written > 2 * m_records.size() + RECENTLYPLAYED_COMPACT_RECORDS)
+      Compact();
+  }
+}
+
+CFileItemPtr CRecentlyPlayed::Pick(IRandomPicker &picker, bool mustExist /* = false */)
+{
+  CFileItemPtr item;
+  int attempts = 0;
+  int missing = 0;
+  while (attempts < PICK_ATTEMPTS)
+  {
+    CFileItemPtr pick(new CFileItem);
+    if (!picker.Pick(*pick))
+      break;
+    if (mustExist && !pick->Exists())
+    {
+      if (++missing >= MISSING_PICKS)
+      {
+        CLog::Log(LOGWARNING, "%s - giving up after %d picks of missing files", __FUNCTION__, missing);
+        break;
+      }
+      continue;
+    }
+    item = pick;
+    attempts++;
+    if (!IsExcluded(*item))
+      return item;
+  }
+  if (item)
+    CLog::Log(LOGDEBUG, "%s - all of %d picks were played too recently, settling for %s", __FUNCTION__, attempts, item->GetPath().c_str());
+  return item;
+}
+
+void CRecentlyPlayed::Clear()
+{
+  CSingleLock lock(m_section);
+  for (unsigned int i = 0; i < KINDS; i++)
+    m_windows[i].Clear();
+  m_records.clear();
+  if (m_file)
+    Compact();
+}
+
+void CRecentlyPlayed::Add(const CStdString keys[KINDS], time_t when)
+{
+  size_t held = 0;
+  for (unsigned int i = 0; i < KINDS; i++)
+  {
+    m_windows[i].Add(keys[i], when);
+    held = max(held, m_windows[i].Size());
+  }
+
+  // each window holds the last of the picks, so the longest holds all that are needed
+  CStdString record;
+  record.Format("%lld\t%s\t%s\t%s\n", (long long)when, keys[TRACK].c_str(), keys[ARTIST].c_str(), keys[ALBUM].c_str());
+  m_records.push_back(record);
+  while (m_records.size() > held)
+    m_records.pop_front();
+}
+
+void CRecentlyPlayed::GetKeys(const CFileItem &item, CStdString keys[KINDS])
+{
+  CStdString artist, album;
+  if (item.HasMusicInfoTag())
+  {
+    const MUSIC_INFO::CMusicInfoTag *tag = item.GetMusicInfoTag();
+    artist = tag->GetAlbumArtist();
+    if (artist.IsEmpty())
+      artist = tag->GetArtist();
+    album = tag->GetAlbum();
+  }
+  else if (item.HasVideoInfoTag())
+  {
+    artist = item.GetVideoInfoTag()->m_strArtist;
+    album = item.GetVideoInfoTag()->m_strAlbum;
+  }
+  artist.ToLower();
+  album.ToLower();
+
+  keys[TRACK] = Sanitize(item.GetPath());
+  keys[ARTIST] = Sanitize(artist);
+  // albums of the same name by different artists are different albums
+  if (!album.IsEmpty())
+    keys[ALBUM] = Sanitize(artist + " - " + album);
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+
+#include "utils/ExclusionWindow.h"
+#include "utils/StdString.h"
+#include "threads/CriticalSection.h"
+#include <deque>
+#include <stdio.h>
+#include <time.h>
+#include "boost/shared_ptr.hpp"
+
+class CFileItem; typedef boost::shared_ptr<CFileItem> CFileItemPtr;
+
+/*!
+ \ingroup jukebox
+ \brief A source of random picks for CRecentlyPlayed::Pick(), typically a random query of a library.
+ */
+class IRandomPicker
+{
+public:
+  virtual ~IRandomPicker() {}
+  /*! \brief Fill item with a random pick, false if there is nothing to pick. */
+  virtual bool Pick(CFileItem &item) = 0;
+};
+
+/*!
+ \ingroup jukebox
+ \brief What the automatic pickers (smart random, party mode) picked lately, so they don't
+ repeat a track, an artist or an album too soon.
+
+ Each of track, artist and album has its own window, a number of songs and/or hours (see
+ the <norepeat> advanced settings), and checking an item takes a hash lookup per window
+ rather than a "not in (...)" list in the database query. Picks are appended to a file in
+ the profile, so the windows survive a restart.
+ */
+class CRecentlyPlayed
+{
+public:
+  enum KIND
+  {
+    TRACK = 0,
+    ARTIST,
+    ALBUM,
+    KINDS
+  };
+
+  /*! \brief Random picks to try for one that isn't excluded, before settling for the last. */
+  static const int PICK_ATTEMPTS = 10;
+  /*! \brief Picks of missing files to skip before giving up, they don't count as attempts. */
+  static const int MISSING_PICKS = 100;
+
+  CRecentlyPlayed();
+  ~CRecentlyPlayed();
+
+  /*! \brief Set the windows from the advanced settings, and replay the picks kept in path.
+   */
+  void Open(const CStdString &path);
+  void Close();
+
+  /*! \brief Whether the item's track, artist or album has been picked too recently. */
+  bool IsExcluded(const CFileItem &item);
+
+  /*! \brief Record a pick. */
+  void Add(const CFileItem &item);
+
+  /*! \brief Pick again while the pick is excluded, settling for the last after PICK_ATTEMPTS.
+   The pick isn't recorded, call Add() once it is played or queued.
+   \param picker the source of random picks.
+   \param mustExist skip the picks whose file is missing.
+   \return the pick, empty if the picker had nothing to pick.
+   */
+  CFileItemPtr Pick(IRandomPicker &picker, bool mustExist = false);
+
+  void Clear();
+
+private:
+  static void GetKeys(const CFileItem &item, CStdString keys[KINDS]);
+  void Add(const CStdString keys[KINDS], time_t when);
+  void Compact();
+
+  CExclusionWindow m_windows[KINDS];
+  std::deque<CStdString> m_records; ///< the picks still in a window, as written to the file
+  CStdString m_path;
+  FILE *m_file;
+  unsigned int m_written;           ///< number of records in the file
+  CCriticalSection m_section;
+};
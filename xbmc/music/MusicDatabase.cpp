@@ -35,6 +35,7 @@
 #include "utils/StringUtils.h"
 #include "guilib/LocalizeStrings.h"
 #include "utils/log.h"
+#include "threads/SingleLock.h"
 #include "utils/TimeUtils.h"
 #include "TextureCache.h"
 #include "addons/AddonInstaller.h"
@@ -42,6 +43,8 @@
 #include "interfaces/AnnouncementManager.h"
 #include "dbwrappers/dataset.h"
 
+#include <deque>
+
 using namespace std;
 using namespace AUTOPTR;
 using namespace XFILE;
@@ -163,6 +166,14 @@ bool CMusicDatabase::CreateTables()
 
     CLog::Log(LOGINFO, "create thumb index");
     m_pDS->exec("CREATE INDEX idxThumb ON thumb(strThumb)");
+    if (m_sqlite)
+    {
+      // the case insensitive sorts of paged listings, see GetPageClause()
+      CLog::Log(LOGINFO, "create case insensitive indexes");
+      m_pDS->exec("CREATE INDEX idxSongTitleNoCase ON song(strTitle COLLATE NOCASE)");
+      m_pDS->exec("CREATE INDEX idxAlbumNoCase ON album(strAlbum COLLATE NOCASE)");
+      m_pDS->exec("CREATE INDEX idxArtistNoCase ON artist(strArtist COLLATE NOCASE)");
+    }
     //m_pDS->exec("CREATE INDEX idxSong ON song(dwFileNameCRC)");
     CLog::Log(LOGINFO, "create artistinfo index");
     m_pDS->exec("CREATE INDEX idxArtistInfo on artistinfo(idArtist)");
@@ -2885,110 +2896,118 @@ bool CMusicDatabase::GetAlbumsByYear(const CStdString& strBaseDir, CFileItemList
 }
 
 bool CMusicDatabase::GetArtistsNav(const CStdString& strBaseDir, CFileItemList& items, int idGenre, bool albumArtistsOnly)
+{
+  return GetArtistsByWhere(strBaseDir, GetArtistsNavWhere(idGenre, albumArtistsOnly), items);
+}
+
+CStdString CMusicDatabase::GetArtistsNavWhere(int idGenre, bool albumArtistsOnly)
+{
+  CStdString strSQL = "where (idArtist IN ";
+
+  if (idGenre==-1)
+  {
+    if (!albumArtistsOnly)  // show all artists in this case (ie those linked to a song)
+      strSQL +=         "("
+                        "select song.idArtist from song" // All primary artists linked to a song
+                        ") "
+                      "or idArtist IN "
+                        "("
+                        "select exartistsong.idArtist from exartistsong" // All extra artists linked to a song
+                        ") "
+                      "or idArtist IN ";
+
+    // and always show any artists linked to an album (may be different from above due to album artist tag)
+    strSQL +=          "("
+                        "select album.idArtist from album" // All primary artists linked to an album
+                        ") "
+                      "or idArtist IN "
+                        "("
+                        "select exartistalbum.idArtist from exartistalbum "; // All extra artists linked to an album
+    if (albumArtistsOnly)
+      strSQL +=         "join album on album.idAlbum = exartistalbum.idAlbum " // if we're hiding compilation artists,
+                        "where album.strExtraArtists != ''";                   // then exclude those that have no extra artists
+    strSQL +=           ")"
+                      ") ";
+  }
+  else
+  { // same statements as above, but limit to the specified genre
+    // in this case we show the whole lot always - there is no limitation to just album artists
+    if (!albumArtistsOnly)  // show all artists in this case (ie those linked to a song)
+      strSQL+=PrepareSQL("("
+                        "select song.idArtist from song " // All primary artists linked to primary genres
+                        "where song.idGenre=%i"
+                        ") "
+                      "or idArtist IN "
+                        "("
+                        "select song.idArtist from song " // All primary artists linked to extra genres
+                          "join exgenresong on song.idSong=exgenresong.idSong "
+                        "where exgenresong.idGenre=%i"
+                        ")"
+                      "or idArtist IN "
+                        "("
+                        "select exartistsong.idArtist from exartistsong " // All extra artists linked to extra genres
+                          "join song on exartistsong.idSong=song.idSong "
+                          "join exgenresong on song.idSong=exgenresong.idSong "
+                        "where exgenresong.idGenre=%i"
+                        ") "
+                      "or idArtist IN "
+                        "("
+                        "select exartistsong.idArtist from exartistsong " // All extra artists linked to primary genres
+                          "join song on exartistsong.idSong=song.idSong "
+                        "where song.idGenre=%i"
+                        ") "
+                      "or idArtist IN "
+                      , idGenre, idGenre, idGenre, idGenre);
+    // and add any artists linked to an album (may be different from above due to album artist tag)
+    strSQL += PrepareSQL("("
+                        "select album.idArtist from album " // All primary album artists linked to primary genres
+                        "where album.idGenre=%i"
+                        ") "
+                      "or idArtist IN "
+                        "("
+                        "select album.idArtist from album " // All primary album artists linked to extra genres
+                          "join exgenrealbum on album.idAlbum=exgenrealbum.idAlbum "
+                        "where exgenrealbum.idGenre=%i"
+                        ")"
+                      "or idArtist IN "
+                        "("
+                        "select exartistalbum.idArtist from exartistalbum " // All extra album artists linked to extra genres
+                          "join album on exartistalbum.idAlbum=album.idAlbum "
+                          "join exgenrealbum on album.idAlbum=exgenrealbum.idAlbum "
+                        "where exgenrealbum.idGenre=%i"
+                        ") "
+                      "or idArtist IN "
+                        "("
+                        "select exartistalbum.idArtist from exartistalbum " // All extra album artists linked to primary genres
+                          "join album on exartistalbum.idAlbum=album.idAlbum "
+                        "where album.idGenre=%i"
+                        ") "
+                      ")", idGenre, idGenre, idGenre, idGenre);
+  }
+
+  // remove the null string
+  strSQL += " and artist.strArtist != \"\"";
+  // and the various artist entry if applicable
+  if (!albumArtistsOnly)
+  {
+    CStdString strVariousArtists = g_localizeStrings.Get(340);
+    int idVariousArtists = AddArtist(strVariousArtists);
+    strSQL+=PrepareSQL(" and artist.idArtist<>%i", idVariousArtists);
+  }
+
+  return strSQL;
+}
+
+bool CMusicDatabase::GetArtistsByWhere(const CStdString &baseDir, const CStdString &where, CFileItemList &items, bool withInfo /* = true */)
 {
   if (NULL == m_pDB.get()) return false;
   if (NULL == m_pDS.get()) return false;
   try
   {
-    if (NULL == m_pDB.get()) return false;
-    if (NULL == m_pDS.get()) return false;
-
     unsigned int time = XbmcThreads::SystemClockMillis();
 
-    CStdString strSQL = "select * from artist where (idArtist IN ";
-
-    if (idGenre==-1)
-    {
-      if (!albumArtistsOnly)  // show all artists in this case (ie those linked to a song)
-        strSQL +=         "("
-                          "select song.idArtist from song" // All primary artists linked to a song
-                          ") "
-                        "or idArtist IN "
-                          "("
-                          "select exartistsong.idArtist from exartistsong" // All extra artists linked to a song
-                          ") "
-                        "or idArtist IN ";
-
-      // and always show any artists linked to an album (may be different from above due to album artist tag)
-      strSQL +=          "("
-                          "select album.idArtist from album" // All primary artists linked to an album
-                          ") "
-                        "or idArtist IN "
-                          "("
-                          "select exartistalbum.idArtist from exartistalbum "; // All extra artists linked to an album
-      if (albumArtistsOnly)
-        strSQL +=         "join album on album.idAlbum = exartistalbum.idAlbum " // if we're hiding compilation artists,
-                          "where album.strExtraArtists != ''";                   // then exclude those that have no extra artists
-      strSQL +=           ")"
-                        ") ";
-    }
-    else
-    { // same statements as above, but limit to the specified genre
-      // in this case we show the whole lot always - there is no limitation to just album artists
-      if (!albumArtistsOnly)  // show all artists in this case (ie those linked to a song)
-        strSQL+=PrepareSQL("("
-                          "select song.idArtist from song " // All primary artists linked to primary genres
-                          "where song.idGenre=%i"
-                          ") "
-                        "or idArtist IN "
-                          "("
-                          "select song.idArtist from song " // All primary artists linked to extra genres
-                            "join exgenresong on song.idSong=exgenresong.idSong "
-                          "where exgenresong.idGenre=%i"
-                          ")"
-                        "or idArtist IN "
-                          "("
-                          "select exartistsong.idArtist from exartistsong " // All extra artists linked to extra genres
-                            "join song on exartistsong.idSong=song.idSong "
-                            "join exgenresong on song.idSong=exgenresong.idSong "
-                          "where exgenresong.idGenre=%i"
-                          ") "
-                        "or idArtist IN "
-                          "("
-                          "select exartistsong.idArtist from exartistsong " // All extra artists linked to primary genres
-                            "join song on exartistsong.idSong=song.idSong "
-                          "where song.idGenre=%i"
-                          ") "
-                        "or idArtist IN "
-                        , idGenre, idGenre, idGenre, idGenre);
-      // and add any artists linked to an album (may be different from above due to album artist tag)
-      strSQL += PrepareSQL("("
-                          "select album.idArtist from album " // All primary album artists linked to primary genres
-                          "where album.idGenre=%i"
-                          ") "
-                        "or idArtist IN "
-                          "("
-                          "select album.idArtist from album " // All primary album artists linked to extra genres
-                            "join exgenrealbum on album.idAlbum=exgenrealbum.idAlbum "
-                          "where exgenrealbum.idGenre=%i"
-                          ")"
-                        "or idArtist IN "
-                          "("
-                          "select exartistalbum.idArtist from exartistalbum " // All extra album artists linked to extra genres
-                            "join album on exartistalbum.idAlbum=album.idAlbum "
-                            "join exgenrealbum on album.idAlbum=exgenrealbum.idAlbum "
-                          "where exgenrealbum.idGenre=%i"
-                          ") "
-                        "or idArtist IN "
-                          "("
-                          "select exartistalbum.idArtist from exartistalbum " // All extra album artists linked to primary genres
-                            "join album on exartistalbum.idAlbum=album.idAlbum "
-                          "where album.idGenre=%i"
-                          ") "
-                        ")", idGenre, idGenre, idGenre, idGenre);
-    }
-
-    // remove the null string
-    strSQL += " and artist.strArtist != \"\"";
-    // and the various artist entry if applicable
-    if (!albumArtistsOnly)
-    {
-      CStdString strVariousArtists = g_localizeStrings.Get(340);
-      int idVariousArtists = AddArtist(strVariousArtists);
-      strSQL+=PrepareSQL(" and artist.idArtist<>%i", idVariousArtists);
-    }
-
     // run query
+    CStdString strSQL = "select * from artist " + where;
     CLog::Log(LOGDEBUG, "%s query: %s", __FUNCTION__, strSQL.c_str());
     if (!m_pDS->query(strSQL.c_str())) return false;
     int iRowsFound = m_pDS->num_rows();
@@ -3009,16 +3028,19 @@ bool CMusicDatabase::GetArtistsNav(const CStdString& strBaseDir, CFileItemList&
       CStdString strDir;
       int idArtist = m_pDS->fv("idArtist").get_asInt();
       strDir.Format("%ld/", idArtist);
-      pItem->SetPath(strBaseDir + strDir);
+      pItem->SetPath(baseDir + strDir);
       pItem->m_bIsFolder=true;
       pItem->GetMusicInfoTag()->SetDatabaseId(idArtist);
       if (CFile::Exists(pItem->GetCachedArtistThumb()))
         pItem->SetThumbnailImage(pItem->GetCachedArtistThumb());
       pItem->SetIconImage("DefaultArtist.png");
-      CArtist artist;
-      GetArtistInfo(idArtist,artist,false);
+      if (withInfo)
+      {
+        CArtist artist;
+        GetArtistInfo(idArtist,artist,false);
 
-      SetPropertiesFromArtist(*pItem,artist);
+        SetPropertiesFromArtist(*pItem,artist);
+      }
       items.Add(pItem);
 
       m_pDS->next();
@@ -3110,7 +3132,20 @@ bool CMusicDatabase::GetAlbumsNav(const CStdString& strBaseDir, CFileItemList& i
     limit.Format(" limit %i,%i", start, end);
   }
 
-  // where clause
+  bool bResult = GetAlbumsByWhere(strBaseDir, GetAlbumsNavWhere(idGenre, idArtist), limit, items);
+  if (bResult && idArtist != -1)
+  {
+    CStdString strArtist = GetArtistById(idArtist);
+    CStdString strFanart = items.GetCachedThumb(strArtist,g_settings.GetMusicFanartFolder());
+    if (CFile::Exists(strFanart))
+      items.SetProperty("fanart_image",strFanart);
+  }
+
+  return bResult;
+}
+
+CStdString CMusicDatabase::GetAlbumsNavWhere(int idGenre, int idArtist)
+{
   CStdString strWhere;
   if (idGenre!=-1)
   {
@@ -3125,7 +3160,7 @@ bool CMusicDatabase::GetAlbumsNav(const CStdString& strBaseDir, CFileItemList& i
                             "join exgenresong on song.idSong=exgenresong.idSong "
                           "where exgenresong.idGenre=%i"
                           ")"
-                        ") " + limit
+                        ") "
                         , idGenre, idGenre);
   }
 
@@ -3157,7 +3192,7 @@ bool CMusicDatabase::GetAlbumsNav(const CStdString& strBaseDir, CFileItemList& i
                               "select exartistalbum.idAlbum from exartistalbum " // All albums where extra album artists fit
                               "where exartistalbum.idArtist=%i"
                             ")"
-                          ") " + limit
+                          ") "
                           , idArtist, idArtist, idArtist, idArtist);
   }
   else
@@ -3167,20 +3202,10 @@ bool CMusicDatabase::GetAlbumsNav(const CStdString& strBaseDir, CFileItemList& i
     else
       strWhere += "and albumview.strAlbum <> ''";
 
-    strWhere += " AND iVisible = 1" + limit;
-  }
-
-  
-  bool bResult = GetAlbumsByWhere(strBaseDir, strWhere, "", items);
-  if (bResult && idArtist != -1)
-  {
-    CStdString strArtist = GetArtistById(idArtist);
-    CStdString strFanart = items.GetCachedThumb(strArtist,g_settings.GetMusicFanartFolder());
-    if (CFile::Exists(strFanart))
-      items.SetProperty("fanart_image",strFanart);
+    strWhere += " AND iVisible = 1";
   }
 
-  return bResult;
+  return strWhere;
 }
 
 bool CMusicDatabase::GetAllAlbumsNav(const CStdString& strBaseDir, CFileItemList& items, int idGenre, int idArtist, int start, int end)
@@ -3384,6 +3409,23 @@ bool CMusicDatabase::GetSongsByYear(const CStdString& baseDir, CFileItemList& it
 }
 
 bool CMusicDatabase::GetSongsNav(const CStdString& strBaseDir, CFileItemList& items, int idGenre, int idArtist,int idAlbum)
+{
+  CStdString strWhere = GetSongsNavWhere(idGenre, idArtist, idAlbum);
+  strWhere += " ORDER BY iTrack"; // Laureon: Order tracks by track number
+  // run query
+  bool bResult = GetSongsByWhere(strBaseDir, strWhere, items);
+  if (bResult && idArtist != -1)
+  {
+    CStdString strArtist = GetArtistById(idArtist);
+    CStdString strFanart = items.GetCachedThumb(strArtist,g_settings.GetMusicFanartFolder());
+    if (CFile::Exists(strFanart))
+      items.SetProperty("fanart_image",strFanart);
+  }
+
+  return bResult;
+}
+
+CStdString CMusicDatabase::GetSongsNavWhere(int idGenre, int idArtist, int idAlbum)
 {
   CStdString strWhere;
 
@@ -3436,18 +3478,294 @@ bool CMusicDatabase::GetSongsNav(const CStdString& strBaseDir, CFileItemList& it
                           ") "
                           , idArtist, idArtist, idArtist, idArtist);
   }
-  strWhere += " ORDER BY iTrack"; // Laureon: Order tracks by track number
-  // run query
-  bool bResult = GetSongsByWhere(strBaseDir, strWhere, items);
-  if (bResult && idArtist != -1)
+
+  return strWhere;
+}
+
+// Sorts the database can do for a paged listing: the column of the listing's table (or view)
+// each sorts on, and whether it holds numbers rather than text.
+typedef struct
+{
+  SORT_METHOD method;
+  const char *column;
+  bool numeric;
+} PAGE_SORT;
+
+static const PAGE_SORT songPageSorts[] = {
+  { SORT_METHOD_NONE,         "iTrack",       true  }, // the order of GetSongsNav()
+  { SORT_METHOD_UNSORTED,     "iTrack",       true  },
+  { SORT_METHOD_LABEL,        "strTitle",     false },
+  { SORT_METHOD_TITLE,        "strTitle",     false },
+  { SORT_METHOD_TRACKNUM,     "iTrack",       true  },
+  { SORT_METHOD_DURATION,     "iDuration",    true  },
+  { SORT_METHOD_ARTIST,       "strArtist",    false },
+  { SORT_METHOD_ALBUM,        "strAlbum",     false },
+  { SORT_METHOD_GENRE,        "strGenre",     false },
+  { SORT_METHOD_YEAR,         "iYear",        true  },
+  { SORT_METHOD_PLAYCOUNT,    "iTimesPlayed", true  },
+  { SORT_METHOD_LASTPLAYED,   "lastplayed",   false },
+  { SORT_METHOD_SONG_RATING,  "rating",       false }
+};
+
+static const PAGE_SORT albumPageSorts[] = {
+  { SORT_METHOD_NONE,         "idAlbum",      true  },
+  { SORT_METHOD_UNSORTED,     "idAlbum",      true  },
+  { SORT_METHOD_LABEL,        "strAlbum",     false },
+  { SORT_METHOD_ALBUM,        "strAlbum",     false },
+  { SORT_METHOD_ARTIST,       "strArtist",    false },
+  { SORT_METHOD_GENRE,        "strGenre",     false },
+  { SORT_METHOD_YEAR,         "iYear",        true  }
+};
+
+static const PAGE_SORT artistPageSorts[] = {
+  { SORT_METHOD_NONE,         "idArtist",     true  },
+  { SORT_METHOD_UNSORTED,     "idArtist",     true  },
+  { SORT_METHOD_LABEL,        "strArtist",    false },
+  { SORT_METHOD_ARTIST,       "strArtist",    false }
+};
+
+static const PAGE_SORT *GetPageSort(const PAGE_SORT *sorts, unsigned int count, SORT_METHOD sortMethod, SORT_ORDER &sortOrder)
+{
+  // the listing's own order has no direction, as in CFileItemList::Sort()
+  if (sortMethod == SORT_METHOD_NONE || sortMethod == SORT_METHOD_UNSORTED)
+    sortOrder = SORT_ORDER_ASC;
+  for (unsigned int i = 0; i < count; i++)
   {
-    CStdString strArtist = GetArtistById(idArtist);
-    CStdString strFanart = items.GetCachedThumb(strArtist,g_settings.GetMusicFanartFolder());
-    if (CFile::Exists(strFanart))
-      items.SetProperty("fanart_image",strFanart);
+    if (sorts[i].method == sortMethod)
+      return &sorts[i];
   }
+  return NULL;
+}
 
-  return bResult;
+// sorts and limits a whole listing, for the sorts the database can't do (such as ignoring articles)
+static void GetPageOf(CFileItemList &all, CFileItemList &items, SORT_METHOD sortMethod, SORT_ORDER sortOrder, int start, int end, int &total)
+{
+  all.Sort(sortMethod, sortOrder);
+  total = all.Size();
+  if (end <= 0 || end > total)
+    end = total;
+  for (int i = std::max(start, 0); i < end; i++)
+    items.Add(all[i]);
+}
+
+// Where the latest pages of listings ended. A page that starts where one of them ended carries on
+// from its last row, rather than having the database sort and skip every row before it again.
+typedef struct
+{
+  CStdString listing;  ///< table, filter and sort of the listing
+  int end;
+  CStdString key;      ///< sort column of the last row of the page, as SQL
+  int id;              ///< id of the last row of the page
+} PAGE_CURSOR;
+
+#define MAX_PAGE_CURSORS 8
+
+static std::deque<PAGE_CURSOR> pageCursors;
+static CCriticalSection pageCursorsSection;
+
+static CStdString GetPageListing(const CStdString &table, const CStdString &where, const CStdString &column, SORT_ORDER sortOrder)
+{
+  CStdString listing;
+  listing.Format("%s|%s|%s|%i", table.c_str(), where.c_str(), column.c_str(), (int)sortOrder);
+  return listing;
+}
+
+bool CMusicDatabase::GetPageClause(const CStdString &table, const CStdString &idColumn, const CStdString &column, bool numeric, const CStdString &where, SORT_ORDER sortOrder, int &start, int &end, int &total, CStdString &clause)
+{
+  total = 0;
+  if (NULL == m_pDB.get()) return false;
+  if (NULL == m_pDS.get()) return false;
+
+  try
+  {
+    CStdString strSQL = "select count(1) as total from " + table + " " + where;
+    if (!m_pDS->query(strSQL.c_str())) return false;
+    if (m_pDS->num_rows() > 0)
+      total = m_pDS->fv("total").get_asInt();
+    m_pDS->close();
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s (%s) failed", __FUNCTION__, where.c_str());
+    return false;
+  }
+
+  end = (end <= 0 || end > total) ? total : end;
+  start = std::max(0, std::min(start, end));
+  if (start == end)
+    return false;
+
+  const char *direction = sortOrder == SORT_ORDER_DESC ? "DESC" : "ASC";
+  const char *after = sortOrder == SORT_ORDER_DESC ? "<" : ">";
+
+  // SQLite compares text case sensitively, sort it regardless of case as MySQL does (and as the
+  // listings were sorted before they were paged), on the NOCASE indexes of CreateTables()
+  CStdString sortKey = column;
+  if (!numeric && m_sqlite)
+    sortKey += " COLLATE NOCASE";
+
+  CStdString keyset;
+  if (start > 0)
+  {
+    CStdString listing = GetPageListing(table, where, column, sortOrder);
+    CSingleLock lock(pageCursorsSection);
+    for (unsigned int i = 0; i < pageCursors.size(); i++)
+    {
+      const PAGE_CURSOR &cursor = pageCursors[i];
+      if (cursor.end != start || cursor.listing != listing)
+        continue;
+      if (column == idColumn)
+        keyset.Format("%s %s %i", idColumn.c_str(), after, cursor.id);
+      else
+      {
+        // both SQLite and MySQL sort NULLs first, so in descending order the rows without a sort
+        // value come after every cursor (cursors are never set on them, see SetPageCursor())
+        CStdString nulls = sortOrder == SORT_ORDER_DESC ? " or " + column + " is null" : "";
+        keyset.Format("(%s %s %s%s or (%s = %s and %s %s %i))", sortKey.c_str(), after, cursor.key.c_str(), nulls.c_str(),
+                      sortKey.c_str(), cursor.key.c_str(), idColumn.c_str(), after, cursor.id);
+      }
+      break;
+    }
+  }
+
+  clause = where;
+  if (!keyset.IsEmpty())
+    clause += (where.IsEmpty() ? "where " : " and ") + keyset;
+
+  CStdString order;
+  if (column == idColumn)
+    order.Format(" order by %s %s", idColumn.c_str(), direction);
+  else
+    order.Format(" order by %s %s, %s %s", sortKey.c_str(), direction, idColumn.c_str(), direction);
+  clause += order;
+
+  CStdString limit;
+  if (keyset.IsEmpty())
+    limit.Format(" limit %i offset %i", end - start, start);
+  else
+    limit.Format(" limit %i", end - start);
+  clause += limit;
+  return true;
+}
+
+void CMusicDatabase::SetPageCursor(const CStdString &table, const CStdString &idColumn, const CStdString &column, bool numeric, const CStdString &where, SORT_ORDER sortOrder, int end, int id)
+{
+  if (NULL == m_pDB.get()) return;
+  if (NULL == m_pDS.get()) return;
+
+  PAGE_CURSOR cursor;
+  cursor.listing = GetPageListing(table, where, column, sortOrder);
+  cursor.end = end;
+  cursor.id = id;
+
+  try
+  {
+    CStdString strSQL = PrepareSQL("select %s from %s where %s=%i", column.c_str(), table.c_str(), idColumn.c_str(), id);
+    if (!m_pDS->query(strSQL.c_str())) return;
+    // rows without a sort value can't be carried on from, the next page skips to its start instead
+    bool valid = m_pDS->num_rows() > 0 && !m_pDS->fv(0).get_isNull();
+    if (valid)
+    {
+      CStdString key = m_pDS->fv(0).get_asString();
+      cursor.key = numeric ? PrepareSQL("%i", atoi(key.c_str())) : PrepareSQL("'%s'", key.c_str());
+    }
+    m_pDS->close();
+    if (!valid)
+      return;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s (%s) failed", __FUNCTION__, cursor.listing.c_str());
+    return;
+  }
+
+  CSingleLock lock(pageCursorsSection);
+  for (std::deque<PAGE_CURSOR>::iterator it = pageCursors.begin(); it != pageCursors.end(); ++it)
+  {
+    if (it->listing == cursor.listing)
+    {
+      pageCursors.erase(it);
+      break;
+    }
+  }
+  pageCursors.push_back(cursor);
+  if (pageCursors.size() > MAX_PAGE_CURSORS)
+    pageCursors.pop_front();
+}
+
+bool CMusicDatabase::GetSongsNav(const CStdString& strBaseDir, CFileItemList& items, int idGenre, int idArtist, int idAlbum, SORT_METHOD sortMethod, SORT_ORDER sortOrder, int start, int end, int &total)
+{
+  total = 0;
+  const PAGE_SORT *sort = GetPageSort(songPageSorts, sizeof(songPageSorts) / sizeof(PAGE_SORT), sortMethod, sortOrder);
+  if (!sort)
+  {
+    CFileItemList all;
+    if (!GetSongsNav(strBaseDir, all, idGenre, idArtist, idAlbum))
+      return false;
+    GetPageOf(all, items, sortMethod, sortOrder, start, end, total);
+    return true;
+  }
+
+  CStdString strWhere = GetSongsNavWhere(idGenre, idArtist, idAlbum);
+  CStdString clause;
+  if (!GetPageClause("songview", "idSong", sort->column, sort->numeric, strWhere, sortOrder, start, end, total, clause))
+    return total > 0;
+  if (!GetSongsByWhere(strBaseDir, clause, items))
+    return false;
+
+  SetPageCursor("songview", "idSong", sort->column, sort->numeric, strWhere, sortOrder,
+                start + items.Size(), items[items.Size() - 1]->GetMusicInfoTag()->GetDatabaseId());
+  return true;
+}
+
+bool CMusicDatabase::GetAlbumsNav(const CStdString& strBaseDir, CFileItemList& items, int idGenre, int idArtist, SORT_METHOD sortMethod, SORT_ORDER sortOrder, int start, int end, int &total)
+{
+  total = 0;
+  const PAGE_SORT *sort = GetPageSort(albumPageSorts, sizeof(albumPageSorts) / sizeof(PAGE_SORT), sortMethod, sortOrder);
+  if (!sort)
+  {
+    CFileItemList all;
+    if (!GetAlbumsNav(strBaseDir, all, idGenre, idArtist, -1, -1))
+      return false;
+    GetPageOf(all, items, sortMethod, sortOrder, start, end, total);
+    return true;
+  }
+
+  CStdString strWhere = GetAlbumsNavWhere(idGenre, idArtist);
+  CStdString clause;
+  if (!GetPageClause("albumview", "idAlbum", sort->column, sort->numeric, strWhere, sortOrder, start, end, total, clause))
+    return total > 0;
+  if (!GetAlbumsByWhere(strBaseDir, clause, "", items))
+    return false;
+
+  SetPageCursor("albumview", "idAlbum", sort->column, sort->numeric, strWhere, sortOrder,
+                start + items.Size(), items[items.Size() - 1]->GetMusicInfoTag()->GetDatabaseId());
+  return true;
+}
+
+bool CMusicDatabase::GetArtistsNav(const CStdString& strBaseDir, CFileItemList& items, int idGenre, bool albumArtistsOnly, SORT_METHOD sortMethod, SORT_ORDER sortOrder, int start, int end, int &total, bool withInfo /* = true */)
+{
+  total = 0;
+  const PAGE_SORT *sort = GetPageSort(artistPageSorts, sizeof(artistPageSorts) / sizeof(PAGE_SORT), sortMethod, sortOrder);
+  if (!sort)
+  {
+    CFileItemList all;
+    if (!GetArtistsByWhere(strBaseDir, GetArtistsNavWhere(idGenre, albumArtistsOnly), all, withInfo))
+      return false;
+    GetPageOf(all, items, sortMethod, sortOrder, start, end, total);
+    return true;
+  }
+
+  CStdString strWhere = GetArtistsNavWhere(idGenre, albumArtistsOnly);
+  CStdString clause;
+  if (!GetPageClause("artist", "idArtist", sort->column, sort->numeric, strWhere, sortOrder, start, end, total, clause))
+    return total > 0;
+  if (!GetArtistsByWhere(strBaseDir, clause, items, withInfo))
+    return false;
+
+  SetPageCursor("artist", "idArtist", sort->column, sort->numeric, strWhere, sortOrder,
+                start + items.Size(), items[items.Size() - 1]->GetMusicInfoTag()->GetDatabaseId());
+  return true;
 }
 
 bool CMusicDatabase::UpdateOldVersion(int version)
@@ -3551,6 +3869,12 @@ bool CMusicDatabase::UpdateOldVersion(int version)
       m_pDS->exec("CREATE INDEX idxSong5 ON song(idGenre)");
       m_pDS->exec("CREATE INDEX idxSong6 ON song(idPath)");
     }
+    if (version < 19 && m_sqlite)
+    {
+      m_pDS->exec("CREATE INDEX idxSongTitleNoCase ON song(strTitle COLLATE NOCASE)");
+      m_pDS->exec("CREATE INDEX idxAlbumNoCase ON album(strAlbum COLLATE NOCASE)");
+      m_pDS->exec("CREATE INDEX idxArtistNoCase ON artist(strArtist COLLATE NOCASE)");
+    }
 
     // always recreate the views after any table change
     CreateViews();
@@ -7,6 +7,7 @@
 #include "dbwrappers/Database.h"
 #include "Album.h"
 #include "addons/Scraper.h"
+#include "SortFileItem.h"
 
 class CArtist;
 class CFileItem;
@@ -140,6 +141,20 @@ public:
   bool GetYearsNav(const CStdString& strBaseDir, CFileItemList& items);
   bool GetArtistsNav(const CStdString& strBaseDir, CFileItemList& items, int idGenre, bool albumArtistsOnly);
   bool GetAlbumsNav(const CStdString& strBaseDir, CFileItemList& items, int idGenre, int idArtist, int start, int end);
+
+  /*! \brief Get a page of a navigation listing, sorted and limited by the database.
+   Sorts that have a column to sort on are done in SQL, and a page that starts where the previous
+   page of the same listing ended carries on from its last row. Other sorts (such as ignoring
+   articles) fall back to loading and sorting the whole listing.
+   \param start first item of the page.
+   \param end one past the last item of the page, <= 0 for the rest of the listing.
+   \param total set to the number of items in the whole listing.
+   \param withInfo false to skip loading the artist info of each artist.
+   \return true if the listing has any items, even if the page is past its end.
+   */
+  bool GetSongsNav(const CStdString& strBaseDir, CFileItemList& items, int idGenre, int idArtist, int idAlbum, SORT_METHOD sortMethod, SORT_ORDER sortOrder, int start, int end, int &total);
+  bool GetAlbumsNav(const CStdString& strBaseDir, CFileItemList& items, int idGenre, int idArtist, SORT_METHOD sortMethod, SORT_ORDER sortOrder, int start, int end, int &total);
+  bool GetArtistsNav(const CStdString& strBaseDir, CFileItemList& items, int idGenre, bool albumArtistsOnly, SORT_METHOD sortMethod, SORT_ORDER sortOrder, int start, int end, int &total, bool withInfo = true);
   bool GetAllAlbumsNav(const CStdString& strBaseDir, CFileItemList& items, int idGenre, int idArtist, int start, int end);
   
   bool GetAlbumsByYear(const CStdString &strBaseDir, CFileItemList& items, int year);
@@ -147,6 +162,7 @@ public:
   bool GetSongsByYear(const CStdString& baseDir, CFileItemList& items, int year);
   bool GetSongsByWhere(const CStdString &baseDir, const CStdString &whereClause, CFileItemList& items);
   bool GetAlbumsByWhere(const CStdString &baseDir, const CStdString &where, const CStdString &order, CFileItemList &items);
+  bool GetArtistsByWhere(const CStdString &baseDir, const CStdString &where, CFileItemList &items, bool withInfo = true);
   bool GetRandomSong(CFileItem* item, int& idSong, const CStdString& strWhere);
   int GetKaraokeSongsCount();
   int GetSongsCount(const CStdString& strWhere = "");
@@ -204,7 +220,7 @@ protected:
   std::map<CStdString, CAlbumCache> m_albumCache;
 
   virtual bool CreateTables();
-  virtual int GetMinVersion() const { return 18; };
+  virtual int GetMinVersion() const { return 19; };
   const char *GetBaseDBName() const { return "MyMusic"; };
 
   int AddAlbum(const CStdString& strAlbum1, int idArtist, const CStdString &extraArtists, const CStdString &strArtist1, int idThumb, int idGenre, const CStdString &extraGenres, int year, const CStdString strGTIN = ""); // Laureon: Added GTIN
@@ -242,6 +258,29 @@ private:
   bool SearchSongs(const CStdString& strSearch, CFileItemList &songs);
   int GetSongIDFromPath(const CStdString &filePath);
 
+  CStdString GetArtistsNavWhere(int idGenre, bool albumArtistsOnly);
+  CStdString GetAlbumsNavWhere(int idGenre, int idArtist);
+  CStdString GetSongsNavWhere(int idGenre, int idArtist, int idAlbum);
+
+  /*! \brief Build the clause that selects a page of a listing, sorted on one column.
+   \param table the table (or view) the listing selects from.
+   \param idColumn the unique id of the table, which orders rows with the same sort value.
+   \param column the column to sort on.
+   \param numeric whether the column holds numbers, text is sorted regardless of case.
+   \param where the where clause of the listing, may be empty.
+   \param start,end the page, clamped to the listing.
+   \param total set to the number of rows in the listing.
+   \param clause set to the where clause, order and limit of the page.
+   \return false if the page is empty or the listing couldn't be counted.
+   */
+  bool GetPageClause(const CStdString &table, const CStdString &idColumn, const CStdString &column, bool numeric, const CStdString &where, SORT_ORDER sortOrder, int &start, int &end, int &total, CStdString &clause);
+
+  /*! \brief Remember where a page of a listing ended, so that the next page can carry on from there.
+   \param end the end of the page.
+   \param id the id of the last row of the page.
+   */
+  void SetPageCursor(const CStdString &table, const CStdString &idColumn, const CStdString &column, bool numeric, const CStdString &where, SORT_ORDER sortOrder, int end, int id);
+
   // Fields should be ordered as they
   // appear in the songview
   enum _SongFields
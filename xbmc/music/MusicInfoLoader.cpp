@@ -47,8 +47,6 @@ void CMusicInfoLoader::OnLoaderStart()
   // Precache album thumbs
   g_directoryCache.InitMusicThumbCache();
 
-  m_strPrevPath.Empty();
-
   m_databaseHits = m_tagReads = 0;
 
   if (m_pProgressCallback)
@@ -120,15 +118,18 @@ bool CMusicInfoLoader::LoadItem(CFileItem* pItem)
     return true;
   }
 
-  CStdString strPath;
-  URIUtils::GetDirectory(pItem->GetPath(), strPath);
-  URIUtils::AddSlashAtEnd(strPath);
-  if (strPath!=m_strPrevPath)
+  if (!pItem->IsMusicDb())
   {
-    // The item is from another directory as the last one,
-    // query the database for the new directory...
-    m_musicDatabase.GetSongsByPath(strPath, m_songsMap);
-    m_databaseHits++;
+    // The items are not loaded in order, those on screen go first, so the songs of each
+    // directory are queried when the first of its items is loaded, and kept for the others
+    CStdString strPath;
+    URIUtils::GetDirectory(pItem->GetPath(), strPath);
+    URIUtils::AddSlashAtEnd(strPath);
+    if (m_queriedPaths.insert(strPath).second)
+    {
+      m_musicDatabase.GetSongsByPath(strPath, m_songsMap, true);
+      m_databaseHits++;
+    }
   }
 
   CSong *song=NULL;
@@ -160,7 +161,6 @@ bool CMusicInfoLoader::LoadItem(CFileItem* pItem)
     m_tagReads++;
   }
 
-  m_strPrevPath = strPath;
   return true;
 }
 
@@ -171,6 +171,7 @@ void CMusicInfoLoader::OnLoaderFinish()
 
   // cleanup last loaded songs from database
   m_songsMap.Clear();
+  m_queriedPaths.clear();
 
   // cleanup cache loaded from HD
   m_mapFileItems->Clear();
@@ -3,6 +3,8 @@
 #include "BackgroundInfoLoader.h"
 #include "MusicDatabase.h"
 
+#include <set>
+
 class CFileItemList;
 
 namespace MUSIC_INFO
@@ -26,7 +28,7 @@ protected:
   CStdString m_strCacheFileName;
   CFileItemList* m_mapFileItems;
   CSongMap m_songsMap;
-  CStdString m_strPrevPath;
+  std::set<CStdString> m_queriedPaths; ///< directories whose songs are in m_songsMap
   CMusicDatabase m_musicDatabase;
   unsigned int m_databaseHits;
   unsigned int m_tagReads;
@@ -62,7 +62,7 @@ using namespace MUSIC_INFO;
 
 CGUIWindowJukeboxBase::CGUIWindowJukeboxBase(int id, const CStdString &xmlFile) :
     CGUIMediaWindow(id, xmlFile) {
-
+  AddBackgroundLoader(&m_musicInfoLoader);
 }
 
 CGUIWindowJukeboxBase::~CGUIWindowJukeboxBase() {
@@ -138,10 +138,6 @@ bool CGUIWindowJukeboxBase::OnMessage(CGUIMessage& message) {
     }
     break;
 
-    case GUI_MSG_PLAYLIST_CHANGED:
-      SavePlayList("special://masterprofile/playlist.m3u");
-    break;
-
     case GUI_MSG_CLICKED: {
       int iControl = message.GetSenderId();
       if (iControl == CONTROL_BTNTYPE)
@@ -689,7 +685,6 @@ void CGUIWindowJukeboxBase::OnQueueItem(CFileItemPtr pItem) {
     }
 #ifdef IS_PROFESSIONAL // Laureon: Added: Jukebox Credits System
     g_jukeboxManager.GetModeManager().RegisterQueue();
-//    SavePlayList("special://masterprofile/playlist.m3u");
   }
   else
   {
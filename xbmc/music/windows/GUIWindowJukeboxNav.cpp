@@ -29,6 +29,7 @@
 #include "guilib/LocalizeStrings.h"
 #include "utils/log.h"
 #include "TextureCache.h"
+#include "AlbumArtAtlas.h"
 #include "../../guilib/GUIListContainer.h" // Laureon: Added: Jukebox Music library behavior
 
 using namespace std;
@@ -57,7 +58,9 @@ CGUIWindowJukeboxNav::CGUIWindowJukeboxNav(void)
   m_vecItems->SetPath("?");
   m_bDisplayEmptyDatabaseMessage = false;
   m_thumbLoader.SetObserver(this);
+  AddBackgroundLoader(&m_thumbLoader);
   m_searchWithEdit = false;
+  m_atlasPage = -1;
 }
 
 CGUIWindowJukeboxNav::~CGUIWindowJukeboxNav(void)
@@ -115,7 +118,14 @@ bool CGUIWindowJukeboxNav::OnMessage(CGUIMessage& message) {
 
       // Laureon: Added: Jukebox Music library behavior
       UpdateSongsControl();
-      LoadPlayList("special://masterprofile/playlist.m3u");
+
+      // bring back the queue left by the last session. Older versions kept it in an m3u, which
+      // is loaded once (and so recorded in the queue journal) if there's no journal yet.
+      if (!g_playlistPlayer.RestoreQueue() && CFile::Exists("special://masterprofile/playlist.m3u"))
+      {
+        LoadPlayList("special://masterprofile/playlist.m3u");
+        CFile::Delete("special://masterprofile/playlist.m3u");
+      }
       return true;
     }
     break;
@@ -822,6 +832,18 @@ void CGUIWindowJukeboxNav::FrameMove()
     SET_CONTROL_LABEL(CONTROL_LABELEMPTY,g_localizeStrings.Get(745)+'\n'+g_localizeStrings.Get(746));
   else
     SET_CONTROL_LABEL(CONTROL_LABELEMPTY,"");
+
+  // keep the atlas pages around the selected cover built
+  if (CAlbumArtAtlas::IsEnabled() && m_vecItems->Size())
+  {
+    int page = m_viewControl.GetSelectedItem() / std::max(1u, CAlbumArtAtlas::GetCoversPerPage());
+    if (page != m_atlasPage || m_vecItems->GetPath() != m_atlasPath)
+    {
+      g_albumArtAtlas.Prefetch(*m_vecItems, m_viewControl.GetSelectedItem());
+      m_atlasPage = page;
+      m_atlasPath = m_vecItems->GetPath();
+    }
+  }
   CGUIWindowJukeboxBase::FrameMove();
 }
 
@@ -50,4 +50,7 @@ protected:
   void AddSearchFolder();
   CStopWatch m_searchTimer; ///< Timer to delay a search while more characters are entered
   bool m_searchWithEdit;    ///< Whether the skin supports the new edit control searching
+
+  int m_atlasPage;          ///< atlas page holding the selected cover, when we last prefetched
+  CStdString m_atlasPath;   ///< directory shown when we last prefetched atlas pages
 };
@@ -33,6 +33,7 @@ CGUIWindowJukeboxSongs::CGUIWindowJukeboxSongs(void): CGUIWindowJukeboxBase(WIND
   m_vecItems->SetPath("?");
 
   m_thumbLoader.SetObserver(this);
+  AddBackgroundLoader(&m_thumbLoader);
   // Remove old HD cache every time XBMC is loaded
   CUtil::DeleteDirectoryCache();
 }
@@ -66,7 +66,7 @@ using namespace MUSIC_INFO;
 CGUIWindowMusicBase::CGUIWindowMusicBase(int id, const CStdString &xmlFile)
     : CGUIMediaWindow(id, xmlFile)
 {
-
+  AddBackgroundLoader(&m_musicInfoLoader);
 }
 
 CGUIWindowMusicBase::~CGUIWindowMusicBase ()
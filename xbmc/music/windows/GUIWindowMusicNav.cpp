@@ -57,6 +57,7 @@ CGUIWindowMusicNav::CGUIWindowMusicNav(void)
   m_vecItems->SetPath("?");
   m_bDisplayEmptyDatabaseMessage = false;
   m_thumbLoader.SetObserver(this);
+  AddBackgroundLoader(&m_thumbLoader);
   m_searchWithEdit = false;
 }
 
@@ -32,6 +32,7 @@ CGUIWindowMusicPlaylistEditor::CGUIWindowMusicPlaylistEditor(void)
     : CGUIWindowMusicBase(WINDOW_MUSIC_PLAYLIST_EDITOR, "MyMusicPlaylistEditor.xml")
 {
   m_thumbLoader.SetObserver(this);
+  AddBackgroundLoader(&m_thumbLoader);
   m_playlistThumbLoader.SetObserver(this);
   m_playlist = new CFileItemList;
 }
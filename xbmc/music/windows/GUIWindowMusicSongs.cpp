@@ -36,6 +36,7 @@ CGUIWindowMusicSongs::CGUIWindowMusicSongs(void)
   m_vecItems->SetPath("?");
 
   m_thumbLoader.SetObserver(this);
+  AddBackgroundLoader(&m_thumbLoader);
   // Remove old HD cache every time XBMC is loaded
   CUtil::DeleteDirectoryCache();
 }
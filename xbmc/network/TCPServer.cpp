@@ -4,8 +4,19 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <memory.h>
+#include <string.h>
+#include <errno.h>
+#include <algorithm>
 #include <netinet/in.h>
 #include <arpa/inet.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/epoll.h>
+#define HAS_EPOLL
+#endif
 
 #include "settings/AdvancedSettings.h"
 #include "interfaces/json-rpc/JSONRPC.h"
@@ -35,10 +46,77 @@ using namespace JSONRPC;
 using namespace ANNOUNCEMENT;
 //using namespace std; On VS2010, bind conflicts with std::bind
 
-#define RECEIVEBUFFER 1024
+#define RECEIVEBUFFER 4096
+#define EPOLL_EVENTS  64
+
+// how much announcement output a client may fall behind by before it is dropped
+#define ANNOUNCEMENT_QUEUE_LIMIT (4 * 1024 * 1024)
+
+#define SOCKET_READABLE 1
+#define SOCKET_WRITABLE 2
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
 
 CTCPServer *CTCPServer::ServerInstance = NULL;
 
+/*
+ Queues a JSON-RPC response for a client as it is written. The client is only locked once the
+ first chunk is ready, as the method call before it may wait on threads that announce to the
+ client, and stays locked until the response is complete so announcements can't land in the
+ middle of it.
+ */
+class CTCPServer::CTCPClient::CResponseOutput : public IJSONStreamOutput
+{
+public:
+  CResponseOutput(CTCPClient &client) : m_client(client), m_locked(false) {}
+
+  virtual ~CResponseOutput()
+  {
+    if (m_locked)
+      m_client.m_critSection.unlock();
+  }
+
+  virtual bool Write(const char *data, size_t length)
+  {
+    if (!m_locked)
+    {
+      m_client.m_critSection.lock();
+      m_locked = true;
+    }
+
+    return m_client.Send(boost::shared_ptr<const std::string>(new std::string(data, length)), false);
+  }
+
+private:
+  CTCPClient &m_client;
+  bool m_locked;
+};
+
+namespace
+{
+  bool SetNonBlocking(SOCKET socket)
+  {
+#ifdef _WIN32
+    u_long nonblocking = 1;
+    return ioctlsocket(socket, FIONBIO, &nonblocking) == 0;
+#else
+    int flags = fcntl(socket, F_GETFL, 0);
+    return flags >= 0 && fcntl(socket, F_SETFL, flags | O_NONBLOCK) == 0;
+#endif
+  }
+
+  bool WouldBlock()
+  {
+#ifdef _WIN32
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+#endif
+  }
+}
+
 bool CTCPServer::StartServer(int port, bool nonlocal)
 {
   StopServer(true);
@@ -71,84 +149,195 @@ CTCPServer::CTCPServer(int port, bool nonlocal)
   m_port = port;
   m_nonlocal = nonlocal;
   m_sdpd = NULL;
+  m_epoll = -1;
 }
 
 void CTCPServer::Process()
 {
   m_bStop = false;
 
+  ReadySockets ready;
   while (!m_bStop)
   {
-    SOCKET          max_fd = 0;
-    fd_set          rfds;
-    struct timeval  to     = {1, 0};
-    FD_ZERO(&rfds);
-
-    for (std::vector<SOCKET>::iterator it = m_servers.begin(); it != m_servers.end(); it++)
+    if (!Wait(ready, 1000))
     {
-      FD_SET(*it, &rfds);
-      if ((intptr_t)*it > (intptr_t)max_fd)
-        max_fd = *it;
+      CLog::Log(LOGERROR, "JSONRPC Server: Waiting for sockets failed");
+      Sleep(1000);
+      Initialize();
+      continue;
     }
 
-    for (unsigned int i = 0; i < m_connections.size(); i++)
+    for (ReadySockets::const_iterator it = ready.begin(); it != ready.end(); it++)
     {
-      FD_SET(m_connections[i].m_socket, &rfds);
-      if ((intptr_t)m_connections[i].m_socket > (intptr_t)max_fd)
-        max_fd = m_connections[i].m_socket;
+      if (std::find(m_servers.begin(), m_servers.end(), it->first) != m_servers.end())
+      {
+        Accept(it->first);
+        continue;
+      }
+
+      // only this thread adds and removes clients, so it needs no lock to look them up
+      std::map<SOCKET, CTCPClient*>::iterator client = m_connections.find(it->first);
+      if (client == m_connections.end())
+        continue;
+
+      bool connected = true;
+      if (it->second & SOCKET_READABLE)
+        connected = Receive(client->second);
+      if (connected && (it->second & SOCKET_WRITABLE))
+        connected = client->second->Flush();
+      if (!connected)
+        RemoveClient(client->second);
     }
+  }
+
+  Deinitialize();
+}
+
+bool CTCPServer::Wait(ReadySockets &ready, int timeout)
+{
+  ready.clear();
+
+#ifdef HAS_EPOLL
+  struct epoll_event events[EPOLL_EVENTS];
+  int res = epoll_wait(m_epoll, events, EPOLL_EVENTS, timeout);
+  if (res < 0)
+    return errno == EINTR;
+
+  for (int i = 0; i < res; i++)
+  {
+    int flags = 0;
+    if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+      flags |= SOCKET_READABLE;
+    if (events[i].events & EPOLLOUT)
+      flags |= SOCKET_WRITABLE;
+    ready.push_back(std::make_pair((SOCKET)events[i].data.fd, flags));
+  }
+  return true;
+#else
+  // no epoll: rebuild the sets every time. Output queued by other threads is picked up
+  // within the timeout, as they can't interrupt the select.
+  SOCKET          max_fd = 0;
+  fd_set          rfds, wfds;
+  struct timeval  to     = {timeout / 1000, (timeout % 1000) * 1000};
+  FD_ZERO(&rfds);
+  FD_ZERO(&wfds);
+
+  for (std::vector<SOCKET>::iterator it = m_servers.begin(); it != m_servers.end(); it++)
+  {
+    FD_SET(*it, &rfds);
+    if ((intptr_t)*it > (intptr_t)max_fd)
+      max_fd = *it;
+  }
+
+  for (std::map<SOCKET, CTCPClient*>::iterator it = m_connections.begin(); it != m_connections.end(); it++)
+  {
+    FD_SET(it->first, &rfds);
+    if (it->second->HasQueued())
+      FD_SET(it->first, &wfds);
+    if ((intptr_t)it->first > (intptr_t)max_fd)
+      max_fd = it->first;
+  }
+
+  int res = select((intptr_t)max_fd+1, &rfds, &wfds, NULL, &to);
+  if (res < 0)
+    return false;
+
+  for (std::vector<SOCKET>::iterator it = m_servers.begin(); it != m_servers.end(); it++)
+  {
+    if (FD_ISSET(*it, &rfds))
+      ready.push_back(std::make_pair(*it, SOCKET_READABLE));
+  }
+
+  for (std::map<SOCKET, CTCPClient*>::iterator it = m_connections.begin(); it != m_connections.end(); it++)
+  {
+    int flags = (FD_ISSET(it->first, &rfds) ? SOCKET_READABLE : 0) | (FD_ISSET(it->first, &wfds) ? SOCKET_WRITABLE : 0);
+    if (flags)
+      ready.push_back(std::make_pair(it->first, flags));
+  }
+  return true;
+#endif
+}
 
-    int res = select((intptr_t)max_fd+1, &rfds, NULL, NULL, &to);
-    if (res < 0)
+void CTCPServer::Watch(SOCKET socket, bool add)
+{
+#ifdef HAS_EPOLL
+  struct epoll_event event = {};
+  event.events = EPOLLIN;
+  event.data.fd = socket;
+  if (epoll_ctl(m_epoll, add ? EPOLL_CTL_ADD : EPOLL_CTL_DEL, socket, &event) < 0)
+    CLog::Log(LOGERROR, "JSONRPC Server: Failed to %s socket %d (%s)", add ? "watch" : "unwatch", (int)socket, strerror(errno));
+#endif
+}
+
+void CTCPServer::WatchOutput(CTCPClient *client, bool writable)
+{
+#ifdef HAS_EPOLL
+  struct epoll_event event = {};
+  event.events = EPOLLIN | (writable ? EPOLLOUT : 0);
+  event.data.fd = client->m_socket;
+  epoll_ctl(m_epoll, EPOLL_CTL_MOD, client->m_socket, &event);
+#endif
+}
+
+void CTCPServer::Accept(SOCKET server)
+{
+  // the listening sockets are non-blocking, take every connection that is waiting
+  while (true)
+  {
+    sockaddr_storage addr;
+    socklen_t addrlen = sizeof(addr);
+    SOCKET socket = accept(server, (sockaddr*)&addr, &addrlen);
+    if (socket == INVALID_SOCKET)
     {
-      CLog::Log(LOGERROR, "JSONRPC Server: Select failed");
-      Sleep(1000);
-      Initialize();
+      if (!WouldBlock())
+        CLog::Log(LOGERROR, "JSONRPC Server: Accept of new connection failed");
+      return;
     }
-    else if (res > 0)
+
+    if (!SetNonBlocking(socket))
     {
-      for (int i = m_connections.size() - 1; i >= 0; i--)
-      {
-        int socket = m_connections[i].m_socket;
-        if (FD_ISSET(socket, &rfds))
-        {
-          char buffer[RECEIVEBUFFER] = {};
-          int  nread = 0;
-          nread = recv(socket, (char*)&buffer, RECEIVEBUFFER, 0);
-          if (nread > 0)
-          {
-            m_connections[i].PushBuffer(this, buffer, nread);
-          }
-          if (nread <= 0)
-          {
-            CLog::Log(LOGINFO, "JSONRPC Server: Disconnection detected");
-            m_connections[i].Disconnect();
-            m_connections.erase(m_connections.begin() + i);
-          }
-        }
-      }
+      CLog::Log(LOGERROR, "JSONRPC Server: Failed to make new connection non-blocking");
+      closesocket(socket);
+      continue;
+    }
 
-      for (std::vector<SOCKET>::iterator it = m_servers.begin(); it != m_servers.end(); it++)
-      {
-        if (FD_ISSET(*it, &rfds))
-        {
-          CLog::Log(LOGDEBUG, "JSONRPC Server: New connection detected");
-          CTCPClient newconnection;
-          newconnection.m_socket = accept(*it, (sockaddr*)&newconnection.m_cliaddr, &newconnection.m_addrlen);
-
-          if (newconnection.m_socket == INVALID_SOCKET)
-            CLog::Log(LOGERROR, "JSONRPC Server: Accept of new connection failed");
-          else
-          {
-            CLog::Log(LOGINFO, "JSONRPC Server: New connection added");
-            m_connections.push_back(newconnection);
-          }
-        }
-      }
+    CTCPClient *client = new CTCPClient(this, socket, addr, addrlen);
+    {
+      CSingleLock lock(m_connectionsSection);
+      m_connections[socket] = client;
     }
+    Watch(socket, true);
+    CLog::Log(LOGINFO, "JSONRPC Server: New connection added");
   }
+}
 
-  Deinitialize();
+bool CTCPServer::Receive(CTCPClient *client)
+{
+  // level triggered, so one read per wakeup keeps a busy client from starving the others
+  char buffer[RECEIVEBUFFER];
+  int nread = recv(client->m_socket, buffer, RECEIVEBUFFER, 0);
+  if (nread > 0)
+  {
+    client->PushBuffer(buffer, nread);
+    return !client->HasFailed();
+  }
+  if (nread < 0 && WouldBlock())
+    return true;
+
+  CLog::Log(LOGINFO, "JSONRPC Server: Disconnection detected");
+  return false;
+}
+
+void CTCPServer::RemoveClient(CTCPClient *client)
+{
+  Watch(client->m_socket, false);
+  {
+    // once the client is out of the map, no announcing thread can be using it
+    CSingleLock lock(m_connectionsSection);
+    m_connections.erase(client->m_socket);
+  }
+  client->Disconnect();
+  delete client;
 }
 
 bool CTCPServer::PrepareDownload(const char *path, CVariant &details, std::string &protocol)
@@ -168,22 +357,17 @@ int CTCPServer::GetCapabilities()
 
 void CTCPServer::Announce(EAnnouncementFlag flag, const char *sender, const char *message, const CVariant &data)
 {
-  std::string str = AnnouncementToJSON(flag, sender, message, data, g_advancedSettings.m_jsonOutputCompact);
+  boost::shared_ptr<const std::string> str(new std::string(AnnouncementToJSON(flag, sender, message, data, g_advancedSettings.m_jsonOutputCompact)));
 
-  for (unsigned int i = 0; i < m_connections.size(); i++)
+  CSingleLock lock(m_connectionsSection);
+  for (std::map<SOCKET, CTCPClient*>::iterator it = m_connections.begin(); it != m_connections.end(); it++)
   {
-    {
-      CSingleLock lock (m_connections[i].m_critSection);
-      if ((m_connections[i].GetAnnouncementFlags() & flag) == 0)
-        continue;
-    }
+    CTCPClient *client = it->second;
+    CSingleLock clientLock(client->m_critSection);
+    if ((client->GetAnnouncementFlags() & flag) == 0)
+      continue;
 
-    unsigned int sent = 0;
-    do
-    {
-      CSingleLock lock (m_connections[i].m_critSection);
-      sent += send(m_connections[i].m_socket, str.c_str(), str.size() - sent, sent);
-    } while (sent < str.size());
+    client->Send(str, true);
   }
 }
 
@@ -196,9 +380,27 @@ bool CTCPServer::Initialize()
   started |= InitializeBlue();
   started |= InitializeTCP();
 
+#ifdef HAS_EPOLL
+  if (started && (m_epoll = epoll_create(EPOLL_EVENTS)) < 0)
+  {
+    CLog::Log(LOGERROR, "JSONRPC Server: Failed to create epoll instance (%s)", strerror(errno));
+    Deinitialize();
+    started = false;
+  }
+#endif
+
   if(started)
   {
-    CAnnouncementManager::AddAnnouncer(this);
+    for (std::vector<SOCKET>::iterator it = m_servers.begin(); it != m_servers.end(); it++)
+    {
+      SetNonBlocking(*it);
+      Watch(*it, true);
+    }
+
+    CAnnouncerOptions options("JSON-RPC TCP server");
+    options.async = true;
+    options.queueLimit = 4096;
+    CAnnouncementManager::AddAnnouncer(this, options);
     CLog::Log(LOGINFO, "JSONRPC Server: Successfully initialized");
     return true;
   }
@@ -427,10 +629,17 @@ bool CTCPServer::InitializeTCP()
 
 void CTCPServer::Deinitialize()
 {
-  for (unsigned int i = 0; i < m_connections.size(); i++)
-    m_connections[i].Disconnect();
+  CAnnouncementManager::RemoveAnnouncer(this);
 
-  m_connections.clear();
+  {
+    CSingleLock lock(m_connectionsSection);
+    for (std::map<SOCKET, CTCPClient*>::iterator it = m_connections.begin(); it != m_connections.end(); it++)
+    {
+      it->second->Disconnect();
+      delete it->second;
+    }
+    m_connections.clear();
+  }
 
   for (unsigned int i = 0; i < m_servers.size(); i++)
     closesocket(m_servers[i]);
@@ -443,30 +652,32 @@ void CTCPServer::Deinitialize()
   m_sdpd = NULL;
 #endif
 
-  CAnnouncementManager::RemoveAnnouncer(this);
+#ifdef HAS_EPOLL
+  if (m_epoll >= 0)
+    close(m_epoll);
+  m_epoll = -1;
+#endif
 }
 
-CTCPServer::CTCPClient::CTCPClient()
+CTCPServer::CTCPClient::CTCPClient(CTCPServer *host, SOCKET socket, const sockaddr_storage &addr, socklen_t addrlen)
 {
+  m_host = host;
+  m_socket = socket;
+  m_cliaddr = addr;
+  m_addrlen = addrlen;
   m_announcementflags = ANNOUNCE_ALL;
-  m_socket = INVALID_SOCKET;
   m_beginBrackets = 0;
   m_endBrackets = 0;
   m_beginChar = 0;
   m_endChar = 0;
-
-  m_addrlen = sizeof(m_cliaddr);
-}
-
-CTCPServer::CTCPClient::CTCPClient(const CTCPClient& client)
-{
-  Copy(client);
+  m_outboundOffset = 0;
+  m_announcementBytes = 0;
+  m_failed = false;
 }
 
-CTCPServer::CTCPClient& CTCPServer::CTCPClient::operator=(const CTCPClient& client)
+CTCPServer::CTCPClient::~CTCPClient()
 {
-  Copy(client);
-  return *this;
+  Disconnect();
 }
 
 int CTCPServer::CTCPClient::GetPermissionFlags()
@@ -485,7 +696,7 @@ bool CTCPServer::CTCPClient::SetAnnouncementFlags(int flags)
   return true;
 }
 
-void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
+void CTCPServer::CTCPClient::PushBuffer(const char *buffer, int length)
 {
   for (int i = 0; i < length; i++)
   {
@@ -511,9 +722,8 @@ void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, in
         m_endBrackets++;
       if (m_beginBrackets > 0 && m_endBrackets > 0 && m_beginBrackets == m_endBrackets)
       {
-        std::string line = CJSONRPC::MethodCall(m_buffer, host, this);
-        CSingleLock lock (m_critSection);
-        send(m_socket, line.c_str(), line.size(), 0);
+        CResponseOutput output(*this);
+        CJSONRPC::MethodCall(m_buffer, m_host, this, output);
         m_beginChar = m_beginBrackets = m_endBrackets = 0;
         m_buffer.clear();
       }
@@ -521,6 +731,99 @@ void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, in
   }
 }
 
+bool CTCPServer::CTCPClient::Send(const boost::shared_ptr<const std::string> &data, bool announcement)
+{
+  CSingleLock lock (m_critSection);
+  if (m_failed || m_socket == INVALID_SOCKET)
+    return false;
+
+  if (announcement)
+  {
+    if (m_announcementBytes + data->size() > ANNOUNCEMENT_QUEUE_LIMIT)
+    {
+      CLog::Log(LOGWARNING, "JSONRPC Server: Dropping client that fell %u bytes of announcements behind", (unsigned int)m_announcementBytes);
+      Fail();
+      return false;
+    }
+    m_announcementBytes += data->size();
+  }
+
+  COutbound outbound = { data, announcement };
+  m_outbound.push_back(outbound);
+
+  // with output already queued the server thread is waiting for the socket to drain
+  if (m_outbound.size() > 1)
+    return true;
+
+  if (!SendQueued())
+    return false;
+  if (!m_outbound.empty())
+    m_host->WatchOutput(this, true);
+  return true;
+}
+
+bool CTCPServer::CTCPClient::Flush()
+{
+  CSingleLock lock (m_critSection);
+  if (m_failed || m_socket == INVALID_SOCKET)
+    return false;
+
+  if (!SendQueued())
+    return false;
+  if (m_outbound.empty())
+    m_host->WatchOutput(this, false);
+  return true;
+}
+
+bool CTCPServer::CTCPClient::HasQueued()
+{
+  CSingleLock lock (m_critSection);
+  return !m_outbound.empty();
+}
+
+bool CTCPServer::CTCPClient::HasFailed()
+{
+  CSingleLock lock (m_critSection);
+  return m_failed;
+}
+
+bool CTCPServer::CTCPClient::SendQueued()
+{
+  while (!m_outbound.empty())
+  {
+    const std::string &data = *m_outbound.front().data;
+    int sent = send(m_socket, data.c_str() + m_outboundOffset, data.size() - m_outboundOffset, MSG_NOSIGNAL);
+    if (sent < 0)
+    {
+      if (WouldBlock())
+        return true;
+      Fail();
+      return false;
+    }
+
+    m_outboundOffset += sent;
+    if (m_outboundOffset < data.size())
+      continue;
+
+    if (m_outbound.front().announcement)
+      m_announcementBytes -= data.size();
+    m_outbound.pop_front();
+    m_outboundOffset = 0;
+  }
+  return true;
+}
+
+void CTCPServer::CTCPClient::Fail()
+{
+  // the socket is closed by the server thread, which may be waiting on it; shutting it down
+  // wakes that up to find the client gone
+  m_failed = true;
+  m_outbound.clear();
+  m_outboundOffset = 0;
+  m_announcementBytes = 0;
+  shutdown(m_socket, SHUT_RDWR);
+}
+
 void CTCPServer::CTCPClient::Disconnect()
 {
   if (m_socket > 0)
@@ -531,17 +834,3 @@ void CTCPServer::CTCPClient::Disconnect()
     m_socket = INVALID_SOCKET;
   }
 }
-
-void CTCPServer::CTCPClient::Copy(const CTCPClient& client)
-{
-  m_socket            = client.m_socket;
-  m_cliaddr           = client.m_cliaddr;
-  m_addrlen           = client.m_addrlen;
-  m_announcementflags = client.m_announcementflags;
-  m_beginBrackets     = client.m_beginBrackets;
-  m_endBrackets       = client.m_endBrackets;
-  m_beginChar         = client.m_beginChar;
-  m_endChar           = client.m_endChar;
-  m_buffer            = client.m_buffer;
-}
-
@@ -1,8 +1,11 @@
 #pragma once
 
 
+#include <deque>
+#include <map>
 #include <vector>
 #include <sys/socket.h>
+#include <boost/shared_ptr.hpp>
 #include "interfaces/IAnnouncer.h"
 #include "interfaces/json-rpc/ITransportLayer.h"
 #include "threads/Thread.h"
@@ -31,18 +34,53 @@ namespace JSONRPC
     bool InitializeTCP();
     void Deinitialize();
 
+    class CTCPClient;
+    typedef std::vector<std::pair<SOCKET, int> > ReadySockets;
+
+    /*! \brief Wait for sockets to become readable, or writable for clients with queued output.
+     \param ready the sockets that are ready and how (SOCKET_READABLE and/or SOCKET_WRITABLE).
+     \return false if waiting failed.
+     */
+    bool Wait(ReadySockets &ready, int timeout);
+    void Watch(SOCKET socket, bool add);
+    /*! \brief Ask (or stop asking) to be told when a client's socket takes more output.
+     Called by clients from whichever thread fills or drains their queue.
+     */
+    void WatchOutput(CTCPClient *client, bool writable);
+    void Accept(SOCKET server);
+    bool Receive(CTCPClient *client);
+    void RemoveClient(CTCPClient *client);
+
+    /*!
+     \brief A connection to a JSON-RPC client.
+
+     The socket is non-blocking. Whatever is sent to the client, responses and announcements,
+     goes through an outbound queue: it is written straight away as far as the socket takes it,
+     and the rest is written by the server thread as the socket drains. Queued buffers are shared,
+     so an announcement is serialized once whatever the number of clients it goes to.
+     */
     class CTCPClient : public IClient
     {
     public:
-      CTCPClient();
-      //Copying a CCriticalSection is not allowed, so copy everything but that
-      //when adding a member variable, make sure to copy it in CTCPClient::Copy
-      CTCPClient(const CTCPClient& client);
-      CTCPClient& operator=(const CTCPClient& client);
+      CTCPClient(CTCPServer *host, SOCKET socket, const sockaddr_storage &addr, socklen_t addrlen);
+      virtual ~CTCPClient();
       virtual int  GetPermissionFlags();
       virtual int  GetAnnouncementFlags();
       virtual bool SetAnnouncementFlags(int flags);
-      void PushBuffer(CTCPServer *host, const char *buffer, int length);
+      void PushBuffer(const char *buffer, int length);
+      /*! \brief Queue data for the client and write as much of it as the socket takes now.
+       \param data what to send, may be shared with other clients.
+       \param announcement true for an announcement, which the client gets dropped for rather than
+       let more than ANNOUNCEMENT_QUEUE_LIMIT bytes of announcements pile up.
+       \return false if the connection failed or the client was dropped.
+       */
+      bool Send(const boost::shared_ptr<const std::string> &data, bool announcement);
+      /*! \brief Write queued data, once the socket takes more.
+       \return false if the connection failed or the client was dropped.
+       */
+      bool Flush();
+      bool HasQueued();
+      bool HasFailed();
       void Disconnect();
 
       SOCKET           m_socket;
@@ -51,15 +89,33 @@ namespace JSONRPC
       CCriticalSection m_critSection;
 
     private:
-      void Copy(const CTCPClient& client);
+      class CResponseOutput;
+      friend class CResponseOutput;
+
+      struct COutbound
+      {
+        boost::shared_ptr<const std::string> data;
+        bool announcement;
+      };
+
+      bool SendQueued();
+      void Fail();
+
+      CTCPServer *m_host;
       int m_announcementflags;
       int m_beginBrackets, m_endBrackets;
       char m_beginChar, m_endChar;
       std::string m_buffer;
+      std::deque<COutbound> m_outbound;
+      size_t m_outboundOffset;       ///< bytes of the first queued buffer already written
+      size_t m_announcementBytes;    ///< bytes of announcements queued
+      bool m_failed;
     };
 
-    std::vector<CTCPClient> m_connections;
+    std::map<SOCKET, CTCPClient*> m_connections;
+    CCriticalSection m_connectionsSection; ///< guards m_connections, which announcing threads walk
     std::vector<SOCKET> m_servers;
+    int m_epoll;
     int m_port;
     bool m_nonlocal;
     void* m_sdpd;
@@ -239,7 +239,8 @@ void CPeripheralCecAdapter::Process(void)
 
   CLog::Log(LOGDEBUG, "%s - connection to the CEC adapter opened", __FUNCTION__);
   m_bIsReady = true;
-  CAnnouncementManager::AddAnnouncer(this);
+  // synchronous, the devices have to be off before OnQuit and OnSleep return
+  CAnnouncementManager::AddAnnouncer(this, CAnnouncerOptions("CEC adapter", System | GUI));
 
   if (GetSettingBool("cec_power_on_startup"))
   {
@@ -7,6 +7,7 @@
 #include "filesystem/File.h"
 #include "filesystem/FileCurl.h"
 #include "DllImageLib.h"
+#include "guilib/Texture.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
 
@@ -27,6 +28,11 @@ bool CPicture::CacheImage(const CStdString& sourceUrl, const CStdString& destFil
   {
     CLog::Log(LOGINFO, "Caching image from: %s to %s with width %i and height %i", sourceUrl.c_str(), destFile.c_str(), width, height);
     
+    // jpegs can be decoded straight to (roughly) the size we want, skipping the
+    // full resolution decode + rescale that ImageLib does
+    if (!URIUtils::IsInternetStream(sourceUrl, true) && CacheScaledJpeg(sourceUrl, destFile, width, height))
+      return true;
+
     DllImageLib dll;
     if (!dll.Load()) return false;
 
@@ -60,6 +66,71 @@ bool CPicture::CacheImage(const CStdString& sourceUrl, const CStdString& destFil
   }
 }
 
+bool CPicture::CacheScaledJpeg(const CStdString& sourceUrl, const CStdString& destFile, int width, int height)
+{
+  CStdString extension = URIUtils::GetExtension(sourceUrl);
+  if (!extension.Equals(".jpg") && !extension.Equals(".tbn"))
+    return false;
+
+  // the decoder only scales by powers of two, to the smallest size at least as large as asked
+  CTexture texture;
+  if (!texture.LoadFromFile(sourceUrl, width, height, true))
+    return false;
+
+  // ImageLib takes care of rotation, so leave those to it
+  if (texture.GetOrientation())
+    return false;
+
+  // fit what was decoded to width x height, keeping the aspect, as ImageLib does (it doesn't enlarge)
+  int sourceWidth = texture.GetWidth(), sourceHeight = texture.GetHeight();
+  if (sourceWidth <= width && sourceHeight <= height)
+    return CreateThumbnailFromSurface(texture.GetPixels(), sourceWidth, sourceHeight, texture.GetPitch(), destFile);
+
+  int scaledWidth = width, scaledHeight = height;
+  if ((int64_t)sourceWidth * height > (int64_t)sourceHeight * width)
+    scaledHeight = std::max(1, (int)((int64_t)sourceHeight * width / sourceWidth));
+  else
+    scaledWidth = std::max(1, (int)((int64_t)sourceWidth * height / sourceHeight));
+
+  unsigned char *scaled = new unsigned char[scaledWidth * scaledHeight * 4];
+  ScaleSurface(texture.GetPixels(), sourceWidth, sourceHeight, texture.GetPitch(), scaled, scaledWidth, scaledHeight);
+  bool success = CreateThumbnailFromSurface(scaled, scaledWidth, scaledHeight, scaledWidth * 4, destFile);
+  delete[] scaled;
+  return success;
+}
+
+void CPicture::ScaleSurface(const unsigned char *source, int sourceWidth, int sourceHeight, int sourcePitch,
+                            unsigned char *dest, int destWidth, int destHeight)
+{
+  // each destination pixel is the average of the source pixels it covers
+  for (int y = 0; y < destHeight; y++)
+  {
+    int top = y * sourceHeight / destHeight;
+    int bottom = std::max(top + 1, (y + 1) * sourceHeight / destHeight);
+    for (int x = 0; x < destWidth; x++)
+    {
+      int left = x * sourceWidth / destWidth;
+      int right = std::max(left + 1, (x + 1) * sourceWidth / destWidth);
+      unsigned int sum[4] = { 0, 0, 0, 0 };
+      for (int sy = top; sy < bottom; sy++)
+      {
+        const unsigned char *pixel = source + sy * sourcePitch + left * 4;
+        for (int sx = left; sx < right; sx++, pixel += 4)
+        {
+          sum[0] += pixel[0];
+          sum[1] += pixel[1];
+          sum[2] += pixel[2];
+          sum[3] += pixel[3];
+        }
+      }
+      unsigned int count = (bottom - top) * (right - left);
+      unsigned char *out = dest + (y * destWidth + x) * 4;
+      for (int i = 0; i < 4; i++)
+        out[i] = (unsigned char)((sum[i] + count / 2) / count);
+    }
+  }
+}
+
 bool CPicture::CacheThumb(const CStdString& sourceUrl, const CStdString& destFile)
 {
   return CacheImage(sourceUrl, destFile, g_advancedSettings.m_thumbSize, g_advancedSettings.m_thumbSize);
@@ -17,6 +17,10 @@ public:
 
 private:
   static bool CacheImage(const CStdString& sourceUrl, const CStdString& destFile, int width, int height);
+  static bool CacheScaledJpeg(const CStdString& sourceUrl, const CStdString& destFile, int width, int height);
+  /*! \brief Shrink a 32 bit surface to destWidth x destHeight, averaging the pixels each one covers */
+  static void ScaleSurface(const unsigned char *source, int sourceWidth, int sourceHeight, int sourcePitch,
+                           unsigned char *dest, int destWidth, int destHeight);
 };
 
 //this class calls CreateThumbnailFromSurface in a CJob, so a png file can be written without halting the render thread
@@ -3,6 +3,8 @@
 #include "SlideShowPicture.h"
 #include "system.h"
 #include "guilib/Texture.h"
+#include "guilib/GUIFont.h"
+#include "guilib/GUIFontTTF.h"
 #include "utils/ssrc.h"         // for M_PI
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
@@ -633,6 +635,7 @@ void CSlideShowPic::Render()
 
 void CSlideShowPic::Render(float *x, float *y, CBaseTexture* pTexture, color_t color)
 {
+  CGUIFontTTFBase::FlushBatchedText();
 #ifdef HAS_DX
   struct VERTEX
   {
@@ -23,20 +23,54 @@ CPlayList::CPlayList(void)
   m_bWasPlayed = false;
 }
 
+CPlayList::CPlayList(const CPlayList &playlist)
+  : m_strPlayListName(playlist.m_strPlayListName),
+    m_strBasePath(playlist.m_strBasePath),
+    m_iPlayableItems(playlist.m_iPlayableItems),
+    m_bShuffled(playlist.m_bShuffled),
+    m_bWasPlayed(playlist.m_bWasPlayed),
+    m_items(playlist.m_items)
+{
+  IndexPaths();
+}
+
 CPlayList::~CPlayList(void)
 {
   Clear();
 }
 
+CPlayList &CPlayList::operator=(const CPlayList &playlist)
+{
+  if (this == &playlist)
+    return *this;
+  m_strPlayListName = playlist.m_strPlayListName;
+  m_strBasePath = playlist.m_strBasePath;
+  m_iPlayableItems = playlist.m_iPlayableItems;
+  m_bShuffled = playlist.m_bShuffled;
+  m_bWasPlayed = playlist.m_bWasPlayed;
+  m_items = playlist.m_items;
+  IndexPaths();
+  return *this;
+}
+
+void CPlayList::IndexPaths()
+{
+  m_paths.clear();
+  for (int i = 0; i < m_items.Size(); i++)
+  {
+    PlayListItems::Entry *entry = m_items.EntryAt(i);
+    m_paths.insert(std::make_pair(entry->value->GetPath(), entry));
+  }
+}
+
 void CPlayList::Add(const CFileItemPtr &item, int iPosition, int iOrder)
 {
   int iOldSize = size();
   if (iPosition < 0 || iPosition >= iOldSize)
     iPosition = iOldSize;
   if (iOrder < 0 || iOrder >= iOldSize)
-    item->m_iprogramCount = iOldSize;
-  else
-    item->m_iprogramCount = iOrder;
+    iOrder = iOldSize;
+  item->m_iprogramCount = iOrder;
 
   // videodb files are not supported by the filesystem as yet
   if (item->IsVideoDb())
@@ -53,16 +87,9 @@ void CPlayList::Add(const CFileItemPtr &item, int iPosition, int iOrder)
   item->SetProperty("IsPlayable", true);
 
   //CLog::Log(LOGDEBUG,"%s item:(%02i/%02i)[%s]", __FUNCTION__, iPosition, item->m_iprogramCount, item->GetPath().c_str());
-  if (iPosition == iOldSize)
-    m_vecItems.push_back(item);
-  else
-  {
-    ivecItems it = m_vecItems.begin() + iPosition;
-    m_vecItems.insert(it, 1, item);
-    // correct any duplicate order values
-    if (iOrder < iOldSize)
-      IncrementOrder(iPosition + 1, iOrder);
-  }
+  // items after it in order move up one, the index takes care of that
+  PlayListItems::Entry *entry = m_items.Insert(iPosition, iOrder, item);
+  m_paths.insert(std::make_pair(item->GetPath(), entry));
 }
 
 void CPlayList::Add(const CFileItemPtr &item)
@@ -125,50 +152,10 @@ void CPlayList::Insert(const CFileItemPtr &item, int iPosition /* = -1 */)
   Add(item, iPosition, iPosition);
 }
 
-void CPlayList::DecrementOrder(int iOrder)
-{
-  if (iOrder < 0) return;
-
-  // it was the last item so do nothing
-  if (iOrder == size()) return;
-
-  // fix all items with an order greater than the removed iOrder
-  ivecItems it;
-  it = m_vecItems.begin();
-  while (it != m_vecItems.end())
-  {
-    CFileItemPtr item = *it;
-    if (item->m_iprogramCount > iOrder)
-    {
-      //CLog::Log(LOGDEBUG,"%s fixing item at order %i", __FUNCTION__, item->m_iprogramCount);
-      item->m_iprogramCount--;
-    }
-    ++it;
-  }
-}
-
-void CPlayList::IncrementOrder(int iPosition, int iOrder)
-{
-  if (iOrder < 0) return;
-
-  // fix all items with an order equal or greater to the added iOrder at iPos
-  ivecItems it;
-  it = m_vecItems.begin() + iPosition;
-  while (it != m_vecItems.end())
-  {
-    CFileItemPtr item = *it;
-    if (item->m_iprogramCount >= iOrder)
-    {
-      //CLog::Log(LOGDEBUG,"%s fixing item at order %i", __FUNCTION__, item->m_iprogramCount);
-      item->m_iprogramCount++;
-    }
-    ++it;
-  }
-}
-
 void CPlayList::Clear()
 {
-  m_vecItems.erase(m_vecItems.begin(), m_vecItems.end());
+  m_items.Clear();
+  m_paths.clear();
   m_strPlayListName = "";
   m_iPlayableItems = -1;
   m_bWasPlayed = false;
@@ -176,7 +163,7 @@ void CPlayList::Clear()
 
 int CPlayList::size() const
 {
-  return (int)m_vecItems.size();
+  return m_items.Size();
 }
 
 const CFileItemPtr CPlayList::operator[] (int iItem) const
@@ -187,7 +174,9 @@ const CFileItemPtr CPlayList::operator[] (int iItem) const
     CLog::Log(LOGERROR, "Error trying to retrieve an item that's out of range");
     return CFileItemPtr();
   }
-  return m_vecItems[iItem];
+  const CFileItemPtr &item = m_items.At(iItem);
+  item->m_iprogramCount = m_items.OrderAt(iItem);
+  return item;
 }
 
 CFileItemPtr CPlayList::operator[] (int iItem)
@@ -198,7 +187,9 @@ CFileItemPtr CPlayList::operator[] (int iItem)
     CLog::Log(LOGERROR, "Error trying to retrieve an item that's out of range");
     return CFileItemPtr();
   }
-  return m_vecItems[iItem];
+  CFileItemPtr &item = m_items.At(iItem);
+  item->m_iprogramCount = m_items.OrderAt(iItem);
+  return item;
 }
 
 void CPlayList::Shuffle(int iPosition)
@@ -214,25 +205,16 @@ void CPlayList::Shuffle(int iPosition)
       iPosition = 0;
     CLog::Log(LOGDEBUG,"%s shuffling at pos:%i", __FUNCTION__, iPosition);
 
-    ivecItems it = m_vecItems.begin() + iPosition;
-    random_shuffle(it, m_vecItems.end());
+    m_items.Shuffle(iPosition);
 
     // the list is now shuffled!
     m_bShuffled = true;
   }
 }
 
-struct SSortPlayListItem
-{
-  static bool PlaylistSort(const CFileItemPtr &left, const CFileItemPtr &right)
-  {
-    return (left->m_iprogramCount <= right->m_iprogramCount);
-  }
-};
-
 void CPlayList::UnShuffle()
 {
-  sort(m_vecItems.begin(), m_vecItems.end(), SSortPlayListItem::PlaylistSort);
+  m_items.SortByOrder();
   // the list is now unshuffled!
   m_bShuffled = false;
 }
@@ -244,44 +226,43 @@ const CStdString& CPlayList::GetName() const
 
 void CPlayList::Remove(const CStdString& strFileName)
 {
-  int iOrder = -1;
-  ivecItems it;
-  it = m_vecItems.begin();
-  while (it != m_vecItems.end() )
-  {
-    CFileItemPtr item = *it;
-    if (item->GetPath() == strFileName)
-    {
-      iOrder = item->m_iprogramCount;
-      it = m_vecItems.erase(it);
-      //CLog::Log(LOGDEBUG,"PLAYLIST, removing item at order %i", iPos);
-    }
-    else
-      ++it;
-  }
-  DecrementOrder(iOrder);
+  std::pair<PathMap::iterator, PathMap::iterator> range = m_paths.equal_range(strFileName);
+  std::vector<PlayListItems::Entry*> entries;
+  for (PathMap::iterator it = range.first; it != range.second; ++it)
+    entries.push_back(it->second);
+  for (unsigned int i = 0; i < entries.size(); i++)
+    RemoveEntry(entries[i]);
 }
 
 int CPlayList::FindOrder(int iOrder) const
 {
-  for (int i = 0; i < size(); i++)
-  {
-    if (m_vecItems[i]->m_iprogramCount == iOrder)
-      return i;
-  }
-  return -1;
+  return m_items.FindOrder(iOrder);
 }
 
 // remove item from playlist by position
 void CPlayList::Remove(int position)
 {
-  int iOrder = -1;
-  if (position >= 0 && position < (int)m_vecItems.size())
+  if (position >= 0 && position < size())
+    RemoveEntry(m_items.EntryAt(position));
+}
+
+void CPlayList::RemoveEntry(PlayListItems::Entry *entry)
+{
+  // the item is most likely still filed under its path, but it may have changed since
+  std::pair<PathMap::iterator, PathMap::iterator> range = m_paths.equal_range(entry->value->GetPath());
+  PathMap::iterator it = range.first;
+  while (it != range.second && it->second != entry)
+    ++it;
+  if (it == range.second)
   {
-    iOrder = m_vecItems[position]->m_iprogramCount;
-    m_vecItems.erase(m_vecItems.begin() + position);
+    for (it = m_paths.begin(); it != m_paths.end() && it->second != entry; ++it)
+      ;
   }
-  DecrementOrder(iOrder);
+  if (it != m_paths.end())
+    m_paths.erase(it);
+
+  // items after it in order move down one, the index takes care of that
+  m_items.Erase(m_items.PositionOf(entry));
 }
 
 int CPlayList::RemoveDVDItems()
@@ -289,16 +270,13 @@ int CPlayList::RemoveDVDItems()
   std::vector <CStdString> vecFilenames;
 
   // Collect playlist items from DVD share
-  ivecItems it;
-  it = m_vecItems.begin();
-  while (it != m_vecItems.end() )
+  for (int i = 0; i < size(); i++)
   {
-    CFileItemPtr item = *it;
+    const CFileItemPtr &item = m_items.At(i);
     if ( item->IsCDDA() || item->IsOnDVD() )
     {
       vecFilenames.push_back( item->GetPath() );
     }
-    it++;
   }
 
   // Delete them from playlist
@@ -330,15 +308,8 @@ bool CPlayList::Swap(int position1, int position2)
     return false;
   }
 
-  if (!IsShuffled())
-  {
-    // swap the ordinals before swapping the items!
-    //CLog::Log(LOGDEBUG,"PLAYLIST swapping items at orders (%i, %i)",m_vecItems[position1]->m_iprogramCount,m_vecItems[position2]->m_iprogramCount);
-    std::swap(m_vecItems[position1]->m_iprogramCount, m_vecItems[position2]->m_iprogramCount);
-  }
-
-  // swap the items
-  std::swap(m_vecItems[position1], m_vecItems[position2]);
+  // swap the items, and their ordinals too unless shuffled
+  m_items.Swap(position1, position2, !IsShuffled());
   return true;
 }
 
@@ -350,7 +321,7 @@ void CPlayList::SetUnPlayable(int iItem)
     return;
   }
 
-  CFileItemPtr item = m_vecItems[iItem];
+  CFileItemPtr item = m_items.At(iItem);
   if (!item->GetProperty("unplayable").asBoolean())
   {
     item->SetProperty("unplayable", true);
@@ -398,7 +369,7 @@ bool CPlayList::LoadData(const CStdString& strData)
 
 bool CPlayList::Expand(int position)
 {
-  CFileItemPtr item = m_vecItems[position];
+  CFileItemPtr item = m_items.At(position);
   std::auto_ptr<CPlayList> playlist (CPlayListFactory::Create(*item.get()));
   if ( NULL == playlist.get())
     return false;
@@ -428,15 +399,16 @@ void CPlayList::UpdateItem(const CFileItem *item)
 {
   if (!item) return;
 
-  for (ivecItems it = m_vecItems.begin(); it != m_vecItems.end(); ++it)
+  // update the first item in the playlist with this path
+  std::pair<PathMap::iterator, PathMap::iterator> range = m_paths.equal_range(item->GetPath());
+  PlayListItems::Entry *first = NULL;
+  for (PathMap::iterator it = range.first; it != range.second; ++it)
   {
-    CFileItemPtr playlistItem = *it;
-    if (playlistItem->GetPath() == item->GetPath())
-    {
-      *playlistItem = *item;
-      break;
-    }
+    if (!first || m_items.PositionOf(it->second) < m_items.PositionOf(first))
+      first = it->second;
   }
+  if (first)
+    *first->value = *item;
 }
 
 const CStdString& CPlayList::ResolveURL(const CFileItemPtr &item ) const
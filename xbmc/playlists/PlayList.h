@@ -2,7 +2,9 @@
 
 
 #include "FileItem.h"
+#include "utils/IndexedSequence.h"
 #include <boost/shared_ptr.hpp>
+#include <boost/unordered_map.hpp>
 
 namespace PLAYLIST
 {
@@ -10,7 +12,9 @@ class CPlayList
 {
 public:
   CPlayList(void);
+  CPlayList(const CPlayList &playlist);
   virtual ~CPlayList(void);
+  CPlayList &operator=(const CPlayList &playlist);
   virtual bool Load(const CStdString& strFileName);
   virtual bool LoadData(std::istream &stream);
   virtual bool LoadData(const CStdString& strData);
@@ -59,14 +63,20 @@ protected:
   bool m_bShuffled;
   bool m_bWasPlayed;
 
-//  CFileItemList m_vecItems;
-  std::vector <CFileItemPtr> m_vecItems;
-  typedef std::vector <CFileItemPtr>::iterator ivecItems;
-
 private:
+  typedef CIndexedSequence<CFileItemPtr> PlayListItems;
+  typedef boost::unordered_multimap<CStdString, PlayListItems::Entry*, boost::hash<std::string> > PathMap;
+
   void Add(const CFileItemPtr& item, int iPosition, int iOrderOffset);
-  void DecrementOrder(int iOrder);
-  void IncrementOrder(int iPosition, int iOrder);
+  void RemoveEntry(PlayListItems::Entry *entry);
+  void IndexPaths();
+
+  /*! \brief The items, by position and by playlist order.
+   An item's order (m_iprogramCount) is kept by the index, and is brought up to date as
+   the item is retrieved through operator[].
+   */
+  PlayListItems m_items;
+  PathMap m_paths; ///< items by the path they had when they were added
 };
 
 typedef boost::shared_ptr<CPlayList> CPlayListPtr;
@@ -94,7 +94,7 @@ bool CPlayListB4S::LoadData(istream& stream)
 
 void CPlayListB4S::Save(const CStdString& strFileName) const
 {
-  if (!m_vecItems.size()) return ;
+  if (!size()) return ;
   CStdString strPlaylist = strFileName;
   strPlaylist = CUtil::MakeLegalPath(strPlaylist);
   CFile file;
@@ -106,10 +106,10 @@ void CPlayListB4S::Save(const CStdString& strFileName) const
   CStdString write;
   write.AppendFormat("<?xml version=%c1.0%c encoding='UTF-8' standalone=%cyes%c?>\n", 34, 34, 34, 34);
   write.AppendFormat("<WinampXML>\n");
-  write.AppendFormat("  <playlist num_entries=%c%i%c label=%c%s%c>\n", 34, m_vecItems.size(), 34, 34, m_strPlayListName.c_str(), 34);
-  for (int i = 0; i < (int)m_vecItems.size(); ++i)
+  write.AppendFormat("  <playlist num_entries=%c%i%c label=%c%s%c>\n", 34, size(), 34, 34, m_strPlayListName.c_str(), 34);
+  for (int i = 0; i < size(); ++i)
   {
-    const CFileItemPtr item = m_vecItems[i];
+    const CFileItemPtr item = (*this)[i];
     write.AppendFormat("    <entry Playstring=%cfile:%s%c>\n", 34, item->GetPath().c_str(), 34 );
     write.AppendFormat("      <Name>%s</Name>\n", item->GetLabel().c_str());
     write.AppendFormat("      <Length>%u</Length>\n", item->GetMusicInfoTag()->GetDuration());
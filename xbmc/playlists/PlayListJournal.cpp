@@ -0,0 +1,421 @@
+
+
+#include "PlayListJournal.h"
+#include "PlayList.h"
+#include "FileItem.h"
+#include "filesystem/SpecialProtocol.h"
+#include "music/tags/MusicInfoTag.h"
+#include "threads/SingleLock.h"
+#include "utils/JobManager.h"
+#include "utils/StringUtils.h"
+#include "utils/log.h"
+#ifdef _LINUX
+#include <unistd.h>
+#endif
+
+using namespace std;
+using namespace PLAYLIST;
+
+// compact once the journal holds this many records, and more than twice the size of the queue
+#define JOURNAL_COMPACT_RECORDS 256
+
+// journal records, one per line with tab separated fields:
+//   Q <position> <duration> <path> <label>   enqueue an item at position
+//   D <position>                             dequeue an item that was playing or already played
+//   E <position>                             erase an item still waiting to be played
+//   S <position1> <position2>                swap two items
+//   C                                        clear the queue
+//   P <position>                             start playing the item at position
+// a line missing its newline was cut short by a power cut and is ignored.
+
+static CStdString Sanitize(const CStdString &field)
+{
+  CStdString result(field);
+  for (unsigned int i = 0; i < result.size(); i++)
+  {
+    if (result[i] == '\t' || result[i] == '\n' || result[i] == '\r')
+      result[i] = ' ';
+  }
+  return result;
+}
+
+static bool WriteRecords(FILE *file, const vector<CStdString> &records)
+{
+  CStdString data;
+  for (unsigned int i = 0; i < records.size(); i++)
+    data += records[i] + "\n";
+  if (fwrite(data.c_str(), 1, data.size(), file) != data.size() || fflush(file) != 0)
+    return false;
+#ifdef _LINUX
+  fsync(fileno(file));
+#endif
+  return true;
+}
+
+static bool WriteSnapshot(const CStdString &tempPath, const CStdString &path, const vector<CStdString> &records)
+{
+  FILE *file = fopen(tempPath.c_str(), "wb");
+  if (!file)
+    return false;
+  bool success = WriteRecords(file, records);
+  fclose(file);
+  if (!success || rename(tempPath.c_str(), path.c_str()) != 0)
+  {
+    CLog::Log(LOGERROR, "%s - unable to write %s", __FUNCTION__, path.c_str());
+    return false;
+  }
+  return true;
+}
+
+static vector<CStdString> FormatSnapshot(const vector<CStdString> &enqueues, int current)
+{
+  vector<CStdString> records;
+  records.reserve(enqueues.size() + 2);
+  records.push_back("C");
+  records.insert(records.end(), enqueues.begin(), enqueues.end());
+  if (current >= 0)
+  {
+    CStdString play;
+    play.Format("P\t%i", current);
+    records.push_back(play);
+  }
+  return records;
+}
+
+CPlayListJournalJob::CPlayListJournalJob(const CStdString &path, const vector<CStdString> &records)
+  : m_path(path), m_records(records)
+{
+}
+
+bool CPlayListJournalJob::DoWork()
+{
+  FILE *file = fopen(m_path.c_str(), "wb");
+  if (!file)
+    return false;
+  bool success = WriteRecords(file, m_records);
+  fclose(file);
+  return success;
+}
+
+CPlayListJournal::CPlayListJournal(const CStdString &path)
+  : m_path(path)
+{
+  m_file = NULL;
+  m_current = -1;
+  m_records = 0;
+  m_jobID = 0;
+}
+
+CPlayListJournal::~CPlayListJournal()
+{
+  Close();
+}
+
+void CPlayListJournal::Close()
+{
+  CSingleLock lock(m_section);
+  if (m_jobID)
+  {
+    CJobManager::GetInstance().CancelJob(m_jobID);
+    m_jobID = 0;
+  }
+  m_pending.clear();
+  if (m_file)
+  {
+    fclose(m_file);
+    m_file = NULL;
+  }
+}
+
+CStdString CPlayListJournal::FormatEnqueue(int position, const Entry &entry)
+{
+  CStdString record;
+  record.Format("Q\t%i\t%i\t%s\t%s", position, entry.duration, Sanitize(entry.path).c_str(), Sanitize(entry.label).c_str());
+  return record;
+}
+
+CPlayListJournal::Entry CPlayListJournal::GetEntry(const CPlayList &queue, int position)
+{
+  const CFileItemPtr item = queue[position];
+  Entry entry;
+  entry.path = item->GetPath();
+  entry.label = item->GetLabel();
+  entry.duration = item->HasMusicInfoTag() ? item->GetMusicInfoTag()->GetDuration() : 0;
+  return entry;
+}
+
+bool CPlayListJournal::ApplyRecord(const CStdString &record, vector<Entry> &queue, int &current)
+{
+  CStdStringArray fields;
+  StringUtils::SplitString(record, "\t", fields);
+  if (fields.empty() || fields[0].size() != 1)
+    return false;
+
+  int size = (int)queue.size();
+  int position = fields.size() > 1 ? atoi(fields[1].c_str()) : -1;
+  switch (fields[0][0])
+  {
+  case 'Q':
+    {
+      if (fields.size() < 4 || position < 0 || position > size)
+        return false;
+      Entry entry;
+      entry.duration = atoi(fields[2].c_str());
+      entry.path = fields[3];
+      entry.label = fields.size() > 4 ? fields[4] : "";
+      queue.insert(queue.begin() + position, entry);
+      if (position <= current)
+        current++;
+    }
+    return true;
+  case 'D':
+  case 'E':
+    if (position < 0 || position >= size)
+      return false;
+    queue.erase(queue.begin() + position);
+    if (position <= current)
+      current--;
+    return true;
+  case 'S':
+    {
+      int position2 = fields.size() > 2 ? atoi(fields[2].c_str()) : -1;
+      if (position < 0 || position >= size || position2 < 0 || position2 >= size)
+        return false;
+      swap(queue[position], queue[position2]);
+      if (current == position)
+        current = position2;
+      else if (current == position2)
+        current = position;
+    }
+    return true;
+  case 'C':
+    queue.clear();
+    current = -1;
+    return true;
+  case 'P':
+    if (position < -1 || position >= size)
+      return false;
+    current = position;
+    return true;
+  }
+  return false;
+}
+
+int CPlayListJournal::Open(CPlayList &queue)
+{
+  CSingleLock lock(m_section);
+  if (m_file)
+    return m_current;
+
+  CStdString path = CSpecialProtocol::TranslatePath(m_path);
+
+  // replay whatever made it to disk
+  m_queue.clear();
+  m_current = -1;
+  FILE *file = fopen(path.c_str(), "rb");
+  if (file)
+  {
+    CStdString data;
+    char buffer[4096];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+      data.append(buffer, read);
+    fclose(file);
+
+    unsigned int records = 0, skipped = 0;
+    size_t start = 0, end;
+    while ((end = data.find('\n', start)) != CStdString::npos)
+    {
+      CStdString record = data.substr(start, end - start);
+      start = end + 1;
+      if (record.empty())
+        continue;
+      if (ApplyRecord(record, m_queue, m_current))
+        records++;
+      else
+        skipped++;
+    }
+    if (start < data.size())
+      CLog::Log(LOGWARNING, "%s - ignoring truncated record at the end of %s", __FUNCTION__, m_path.c_str());
+    if (skipped)
+      CLog::Log(LOGWARNING, "%s - skipped %u invalid records in %s", __FUNCTION__, skipped, m_path.c_str());
+    CLog::Log(LOGINFO, "%s - replayed %u records, %u items queued", __FUNCTION__, records, (unsigned int)m_queue.size());
+  }
+
+  // start from a compact journal, which also drops any truncated record
+  vector<CStdString> enqueues;
+  for (unsigned int i = 0; i < m_queue.size(); i++)
+    enqueues.push_back(FormatEnqueue(i, m_queue[i]));
+  vector<CStdString> records = FormatSnapshot(enqueues, m_current);
+  WriteSnapshot(path + ".tmp", path, records);
+  m_records = records.size();
+
+  m_file = fopen(path.c_str(), "ab");
+  if (!m_file)
+    CLog::Log(LOGERROR, "%s - unable to open %s, queue changes won't be kept", __FUNCTION__, m_path.c_str());
+
+  queue.Clear();
+  for (unsigned int i = 0; i < m_queue.size(); i++)
+  {
+    CFileItemPtr item(new CFileItem(m_queue[i].path, false));
+    item->SetLabel(m_queue[i].label);
+    if (m_queue[i].duration > 0)
+      item->GetMusicInfoTag()->SetDuration(m_queue[i].duration);
+    queue.Add(item);
+  }
+  return m_current;
+}
+
+void CPlayListJournal::Sync(const CPlayList &queue, int current)
+{
+  CSingleLock lock(m_section);
+  if (!m_file)
+    return;
+
+  int newSize = queue.size();
+  int oldSize = (int)m_queue.size();
+
+  // the common head and tail of the queue as recorded and as it is now
+  int head = 0;
+  while (head < newSize && head < oldSize && queue[head]->GetPath() == m_queue[head].path)
+    head++;
+  int tail = 0;
+  while (tail < newSize - head && tail < oldSize - head &&
+         queue[newSize - 1 - tail]->GetPath() == m_queue[oldSize - 1 - tail].path)
+    tail++;
+
+  vector<CStdString> records;
+  CStdString record;
+  if (head == newSize && head == oldSize)
+  {
+    // unchanged
+  }
+  else if (newSize == 0)
+  {
+    records.push_back("C");
+    m_queue.clear();
+    m_current = -1;
+  }
+  else if (newSize > oldSize && head + tail == oldSize)
+  {
+    for (int i = head; i < head + newSize - oldSize; i++)
+    {
+      Entry entry = GetEntry(queue, i);
+      records.push_back(FormatEnqueue(i, entry));
+      ApplyRecord(records.back(), m_queue, m_current);
+    }
+  }
+  else if (newSize < oldSize && head + tail == newSize)
+  {
+    for (int i = 0; i < oldSize - newSize; i++)
+    {
+      record.Format("%c\t%i", head <= m_current ? 'D' : 'E', head);
+      records.push_back(record);
+      ApplyRecord(record, m_queue, m_current);
+    }
+  }
+  else if (newSize == oldSize && head + tail == newSize - 2 &&
+           queue[head]->GetPath() == m_queue[newSize - 1 - tail].path &&
+           queue[newSize - 1 - tail]->GetPath() == m_queue[head].path)
+  {
+    record.Format("S\t%i\t%i", head, newSize - 1 - tail);
+    records.push_back(record);
+    ApplyRecord(record, m_queue, m_current);
+  }
+  else
+  {
+    // too much has changed at once to describe, record the whole queue
+    vector<CStdString> enqueues;
+    m_queue.clear();
+    for (int i = 0; i < newSize; i++)
+    {
+      m_queue.push_back(GetEntry(queue, i));
+      enqueues.push_back(FormatEnqueue(i, m_queue.back()));
+    }
+    m_current = current;
+    records = FormatSnapshot(enqueues, current);
+  }
+
+  if (current != m_current && current >= 0 && current < newSize)
+  {
+    record.Format("P\t%i", current);
+    records.push_back(record);
+    m_current = current;
+  }
+
+  Append(records);
+}
+
+void CPlayListJournal::OnPlay(int position)
+{
+  CSingleLock lock(m_section);
+  if (!m_file || position == m_current || position >= (int)m_queue.size())
+    return;
+
+  CStdString record;
+  record.Format("P\t%i", position);
+  m_current = position;
+  Append(vector<CStdString>(1, record));
+}
+
+void CPlayListJournal::Append(const vector<CStdString> &records)
+{
+  if (records.empty())
+    return;
+
+  if (!WriteRecords(m_file, records))
+    CLog::Log(LOGERROR, "%s - unable to write to %s", __FUNCTION__, m_path.c_str());
+  m_records += records.size();
+
+  if (m_jobID)
+    m_pending.insert(m_pending.end(), records.begin(), records.end());
+  else if (m_records > JOURNAL_COMPACT_RECORDS && m_records > 2 * m_queue.size())
+    Compact();
+}
+
+void CPlayListJournal::Compact()
+{
+  vector<CStdString> enqueues;
+  for (unsigned int i = 0; i < m_queue.size(); i++)
+    enqueues.push_back(FormatEnqueue(i, m_queue[i]));
+
+  m_pending.clear();
+  CStdString path = CSpecialProtocol::TranslatePath(m_path) + ".tmp";
+  m_jobID = CJobManager::GetInstance().AddJob(new CPlayListJournalJob(path, FormatSnapshot(enqueues, m_current)), this);
+}
+
+void CPlayListJournal::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+{
+  CSingleLock lock(m_section);
+  if (jobID != m_jobID)
+    return;
+  m_jobID = 0;
+
+  CPlayListJournalJob *compactJob = (CPlayListJournalJob *)job;
+  CStdString path = CSpecialProtocol::TranslatePath(m_path);
+  if (!success || !m_file)
+  {
+    remove(compactJob->m_path.c_str());
+    m_pending.clear();
+    return;
+  }
+
+  // swap in the snapshot and catch up with what was recorded while it was being written
+  fclose(m_file);
+  FILE *file = fopen(compactJob->m_path.c_str(), "ab");
+  bool written = file && WriteRecords(file, m_pending);
+  if (file)
+    fclose(file);
+  if (written && rename(compactJob->m_path.c_str(), path.c_str()) == 0)
+    m_records = compactJob->GetRecordCount() + m_pending.size();
+  else
+  {
+    CLog::Log(LOGERROR, "%s - unable to replace %s", __FUNCTION__, m_path.c_str());
+    remove(compactJob->m_path.c_str());
+  }
+  m_pending.clear();
+
+  m_file = fopen(path.c_str(), "ab");
+  if (!m_file)
+    CLog::Log(LOGERROR, "%s - unable to reopen %s, queue changes won't be kept", __FUNCTION__, m_path.c_str());
+}
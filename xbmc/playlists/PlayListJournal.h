@@ -0,0 +1,103 @@
+#pragma once
+
+
+#include "utils/StdString.h"
+#include "utils/Job.h"
+#include "threads/CriticalSection.h"
+#include <stdio.h>
+#include <vector>
+
+namespace PLAYLIST
+{
+class CPlayList;
+
+/*!
+ \ingroup playlists
+ \brief Append-only journal of the music queue, so queued songs survive a crash or power cut.
+
+ Every change to the queue is written as one short record (enqueue, dequeue, erase, swap,
+ clear, play-start) and flushed to disk, rather than rewriting the whole queue. Open()
+ replays the journal to rebuild the queue on startup. Once enough records have piled up, the
+ journal is compacted in the background into a snapshot of the current queue.
+
+ The journal keeps a copy of the paths in the queue, so Sync() can work out what changed
+ however the playlist was altered (playlist player, party mode, JSON-RPC...).
+ */
+class CPlayListJournal : public IJobCallback
+{
+public:
+  CPlayListJournal(const CStdString &path);
+  virtual ~CPlayListJournal();
+
+  /*! \brief Replay the journal and start recording changes.
+   \param queue [out] the queue as it was last recorded.
+   \return index of the item that was playing, -1 if none.
+   */
+  int Open(CPlayList &queue);
+
+  /*! \brief Stop recording changes, so that clearing the playlists on shutdown isn't recorded.
+   */
+  void Close();
+
+  /*! \brief Whether Open() has been called, nothing is recorded before then.
+   */
+  bool IsOpen() const { return m_file != NULL; };
+
+  /*! \brief Record whatever has changed in the queue since the last call.
+   Cheap when nothing has changed - the playlist is only compared against the journal's copy.
+   \param queue the music playlist.
+   \param current index of the item that is playing.
+   */
+  void Sync(const CPlayList &queue, int current);
+
+  /*! \brief Record the start of playback of an item in the queue.
+   \param position index of the item in the queue.
+   */
+  void OnPlay(int position);
+
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
+
+private:
+  struct Entry
+  {
+    CStdString path;
+    CStdString label;
+    int duration;
+  };
+
+  static CStdString FormatEnqueue(int position, const Entry &entry);
+  static Entry GetEntry(const CPlayList &queue, int position);
+  static bool ApplyRecord(const CStdString &record, std::vector<Entry> &queue, int &current);
+
+  void Append(const std::vector<CStdString> &records);
+  void Compact();
+
+  CStdString m_path;
+  FILE *m_file;
+  std::vector<Entry> m_queue;          ///< the queue as recorded in the journal
+  int m_current;                       ///< index of the playing item as recorded in the journal
+  unsigned int m_records;              ///< number of records in the journal file
+  unsigned int m_jobID;                ///< compaction job, 0 if none is running
+  std::vector<CStdString> m_pending;   ///< records written since the compaction snapshot was taken
+  CCriticalSection m_section;
+};
+
+/*!
+ \ingroup playlists,jobs
+ \brief Writes a snapshot of the queue to a temporary file for CPlayListJournal to swap in.
+ */
+class CPlayListJournalJob : public CJob
+{
+public:
+  CPlayListJournalJob(const CStdString &path, const std::vector<CStdString> &records);
+
+  virtual const char* GetType() const { return "playlistjournal"; };
+  virtual bool DoWork();
+
+  unsigned int GetRecordCount() const { return m_records.size(); };
+
+  CStdString m_path;
+private:
+  std::vector<CStdString> m_records;
+};
+}
@@ -130,7 +130,7 @@ bool CPlayListM3U::Load(const CStdString& strFileName)
 void CPlayListM3U::Save(const CStdString& strFileName) const
 {
 // Laureon: Commented this 'coz we need it to save an empty file...
-//  if (!m_vecItems.size())
+//  if (!size())
 //    return;
   CStdString strPlaylist = CUtil::MakeLegalPath(strFileName);
   CFile file;
@@ -142,9 +142,9 @@ void CPlayListM3U::Save(const CStdString& strFileName) const
   CStdString strLine;
   strLine.Format("%s\n",M3U_START_MARKER);
   file.Write(strLine.c_str(),strLine.size());
-  for (int i = 0; i < (int)m_vecItems.size(); ++i)
+  for (int i = 0; i < size(); ++i)
   {
-    CFileItemPtr item = m_vecItems[i];
+    CFileItemPtr item = (*this)[i];
     CStdString strDescription=item->GetLabel();
     g_charsetConverter.utf8ToStringCharset(strDescription);
     strLine.Format( "%s:%i,%s\n", M3U_INFO_MARKER, item->GetMusicInfoTag()->GetDuration() / 1000, strDescription.c_str() );
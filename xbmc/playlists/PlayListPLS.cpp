@@ -92,6 +92,8 @@ bool CPlayListPLS::Load(const CStdString &strFile)
       return false;
   }
 
+  // entries are numbered, and may come in any order
+  vector<CFileItemPtr> items;
   bool bFailed = false;
   while (file.ReadString(szLine, sizeof(szLine) ) )
   {
@@ -109,12 +111,12 @@ bool CPlayListPLS::Load(const CStdString &strFile)
 
       if (strLeft == "numberofentries")
       {
-        m_vecItems.reserve(atoi(strValue.c_str()));
+        items.reserve(atoi(strValue.c_str()));
       }
       else if (strLeft.Left(4) == "file")
       {
         vector <int>::size_type idx = atoi(strLeft.c_str() + 4);
-        if (!Resize(idx))
+        if (!Resize(items, idx))
         {
           bFailed = true;
           break;
@@ -124,8 +126,8 @@ bool CPlayListPLS::Load(const CStdString &strFile)
         if (URIUtils::GetFileName(strValue).Equals(URIUtils::GetFileName(strFileName)))
           continue;
 
-        if (m_vecItems[idx - 1]->GetLabel().empty())
-          m_vecItems[idx - 1]->SetLabel(URIUtils::GetFileName(strValue));
+        if (items[idx - 1]->GetLabel().empty())
+          items[idx - 1]->SetLabel(URIUtils::GetFileName(strValue));
         CFileItem item(strValue, false);
         if (bShoutCast && !item.IsAudio())
           strValue.Replace("http:", "shout:");
@@ -133,28 +135,28 @@ bool CPlayListPLS::Load(const CStdString &strFile)
         strValue = URIUtils::SubstitutePath(strValue);
         CUtil::GetQualifiedFilename(m_strBasePath, strValue);
         g_charsetConverter.unknownToUTF8(strValue);
-        m_vecItems[idx - 1]->SetPath(strValue);
+        items[idx - 1]->SetPath(strValue);
       }
       else if (strLeft.Left(5) == "title")
       {
         vector <int>::size_type idx = atoi(strLeft.c_str() + 5);
-        if (!Resize(idx))
+        if (!Resize(items, idx))
         {
           bFailed = true;
           break;
         }
         g_charsetConverter.unknownToUTF8(strValue);
-        m_vecItems[idx - 1]->SetLabel(strValue);
+        items[idx - 1]->SetLabel(strValue);
       }
       else if (strLeft.Left(6) == "length")
       {
         vector <int>::size_type idx = atoi(strLeft.c_str() + 6);
-        if (!Resize(idx))
+        if (!Resize(items, idx))
         {
           bFailed = true;
           break;
         }
-        m_vecItems[idx - 1]->GetMusicInfoTag()->SetDuration(atol(strValue.c_str()));
+        items[idx - 1]->GetMusicInfoTag()->SetDuration(atol(strValue.c_str()));
       }
       else if (strLeft == "playlistname")
       {
@@ -171,18 +173,11 @@ bool CPlayListPLS::Load(const CStdString &strFile)
     return false;
   }
 
-  // check for missing entries
-  ivecItems p = m_vecItems.begin();
-  while ( p != m_vecItems.end())
+  // skip missing entries
+  for (unsigned int i = 0; i < items.size(); i++)
   {
-    if ((*p)->GetPath().empty())
-    {
-      p = m_vecItems.erase(p);
-    }
-    else
-    {
-      ++p;
-    }
+    if (!items[i]->GetPath().empty())
+      Add(items[i]);
   }
 
   return true;
@@ -190,7 +185,7 @@ bool CPlayListPLS::Load(const CStdString &strFile)
 
 void CPlayListPLS::Save(const CStdString& strFileName) const
 {
-  if (!m_vecItems.size()) return ;
+  if (!size()) return ;
   CStdString strPlaylist = CUtil::MakeLegalPath(strFileName);
   CFile file;
   if (!file.OpenForWrite(strPlaylist, true))
@@ -204,9 +199,9 @@ void CPlayListPLS::Save(const CStdString& strFileName) const
   g_charsetConverter.utf8ToStringCharset(strPlayListName);
   write.AppendFormat("PlaylistName=%s\n", strPlayListName.c_str() );
 
-  for (int i = 0; i < (int)m_vecItems.size(); ++i)
+  for (int i = 0; i < size(); ++i)
   {
-    CFileItemPtr item = m_vecItems[i];
+    CFileItemPtr item = (*this)[i];
     CStdString strFileName=item->GetPath();
     g_charsetConverter.utf8ToStringCharset(strFileName);
     CStdString strDescription=item->GetLabel();
@@ -216,7 +211,7 @@ void CPlayListPLS::Save(const CStdString& strFileName) const
     write.AppendFormat("Length%i=%u\n", i + 1, item->GetMusicInfoTag()->GetDuration() / 1000 );
   }
 
-  write.AppendFormat("NumberOfEntries=%i\n", m_vecItems.size());
+  write.AppendFormat("NumberOfEntries=%i\n", size());
   write.AppendFormat("Version=2\n");
   file.Write(write.c_str(), write.size());
   file.Close();
@@ -391,15 +386,15 @@ bool CPlayListRAM::LoadData(istream& stream)
   return true;
 }
 
-bool CPlayListPLS::Resize(vector <int>::size_type newSize)
+bool CPlayListPLS::Resize(vector<CFileItemPtr> &items, vector <int>::size_type newSize)
 {
   if (newSize == 0)
     return false;
 
-  while (m_vecItems.size() < newSize)
+  while (items.size() < newSize)
   {
     CFileItemPtr fileItem(new CFileItem());
-    m_vecItems.push_back(fileItem);
+    items.push_back(fileItem);
   }
   return true;
 }
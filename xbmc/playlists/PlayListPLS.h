@@ -12,7 +12,7 @@ public:
   virtual ~CPlayListPLS(void);
   virtual bool Load(const CStdString& strFileName);
   virtual void Save(const CStdString& strFileName) const;
-  virtual bool Resize(std::vector<int>::size_type newSize);
+  virtual bool Resize(std::vector<CFileItemPtr> &items, std::vector<int>::size_type newSize);
 };
 
 class CPlayListASX : public CPlayList
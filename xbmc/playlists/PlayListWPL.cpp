@@ -88,7 +88,7 @@ bool CPlayListWPL::LoadData(istream& stream)
 
 void CPlayListWPL::Save(const CStdString& strFileName) const
 {
-  if (!m_vecItems.size()) return ;
+  if (!size()) return ;
   CStdString strPlaylist = CUtil::MakeLegalPath(strFileName);
   CFile file;
   if (!file.OpenForWrite(strPlaylist, true))
@@ -106,9 +106,9 @@ void CPlayListWPL::Save(const CStdString& strFileName) const
   write.AppendFormat("    </head>\n");
   write.AppendFormat("    <body>\n");
   write.AppendFormat("        <seq>\n");
-  for (int i = 0; i < (int)m_vecItems.size(); ++i)
+  for (int i = 0; i < size(); ++i)
   {
-    CFileItemPtr item = m_vecItems[i];
+    CFileItemPtr item = (*this)[i];
     write.AppendFormat("            <media src=%c%s%c/>", 34, item->GetPath().c_str(), 34);
   }
   write.AppendFormat("        </seq>\n");
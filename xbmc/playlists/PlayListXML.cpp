@@ -152,7 +152,7 @@ bool CPlayListXML::Load( const CStdString& strFileName )
 
 void CPlayListXML::Save(const CStdString& strFileName) const
 {
-  if (!m_vecItems.size()) return ;
+  if (!size()) return ;
   CStdString strPlaylist = CUtil::MakeLegalPath(strFileName);
   CFile file;
   if (!file.OpenForWrite(strPlaylist, true))
@@ -163,9 +163,9 @@ void CPlayListXML::Save(const CStdString& strFileName) const
   CStdString write;
   write.AppendFormat("<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n");
   write.AppendFormat("<streams>\n");
-  for (int i = 0; i < (int)m_vecItems.size(); ++i)
+  for (int i = 0; i < size(); ++i)
   {
-    CFileItemPtr item = m_vecItems[i];
+    CFileItemPtr item = (*this)[i];
     write.AppendFormat("  <stream>\n" );
     write.AppendFormat("    <url>%s</url>", item->GetPath().c_str() );
     write.AppendFormat("    <name>%s</name>", item->GetLabel().c_str() );
@@ -31,6 +31,7 @@ CGUIWindowPrograms::CGUIWindowPrograms(void)
     : CGUIMediaWindow(WINDOW_PROGRAMS, "MyPrograms.xml")
 {
   m_thumbLoader.SetObserver(this);
+  AddBackgroundLoader(&m_thumbLoader);
   m_dlgProgress = NULL;
   m_rootDir.AllowNonLocalSources(false); // no nonlocal shares for this window please
 }
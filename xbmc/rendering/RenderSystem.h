@@ -58,6 +58,12 @@ public:
   virtual bool BeginRender() = 0;
   virtual bool EndRender() = 0;
   virtual bool PresentRender(const CDirtyRegionList& dirty) = 0;
+
+  /*! \brief Whether PresentPartial() copies just the dirty regions to the screen. Unlike a swap
+   it leaves the back buffer as it was, so the next frame need only render what changes.
+   */
+  virtual bool CanPresentPartially() const { return false; }
+  virtual bool PresentPartial(const CDirtyRegionList& dirty) { return PresentRender(dirty); }
   virtual bool ClearBuffers(color_t color) = 0;
   virtual bool IsExtSupported(const char* extension) = 0;
 
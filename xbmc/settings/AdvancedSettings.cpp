@@ -160,6 +160,7 @@ void CAdvancedSettings::Initialize()
   m_thumbSize = DEFAULT_THUMB_SIZE;
   m_fanartHeight = DEFAULT_FANART_HEIGHT;
   m_useDDSFanart = false;
+  m_useDDSThumbs = true;
 
   m_sambaclienttimeout = 10;
   m_sambadoscodepage = "";
@@ -269,6 +270,21 @@ void CAdvancedSettings::Initialize()
   m_guiVisualizeDirtyRegions = false;
   m_guiAlgorithmDirtyRegions = 1; // Laureon: Dirty Regions TODO: Over-test this defaults to 0
   m_guiDirtyRegionNoFlipTimeout = 1000; // Laureon: Dirty Regions: TODO: Over-test this defaults to -1
+  m_guiPartialPresent = false;
+  m_guiTextureMemoryBudget = 64 * 1024 * 1024;
+  m_guiAlbumArtAtlas = false;
+
+  m_coinAcceptorDevice = "";
+  m_coinAcceptorInsertCode = -1;
+  m_coinAcceptorRemoveCode = -1;
+  m_coinAcceptorDebounce = 50;
+
+  m_noRepeatTrackSongs = 200;
+  m_noRepeatTrackHours = 0;
+  m_noRepeatArtistSongs = 0;
+  m_noRepeatArtistHours = 0;
+  m_noRepeatAlbumSongs = 0;
+  m_noRepeatAlbumHours = 0;
 
   m_logEnableAirtunes = false;
   m_airTunesPort = 36666;
@@ -848,6 +864,7 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
   XMLUtils::GetInt(pRootElement, "thumbsize", m_thumbSize, 0, 1024);
   XMLUtils::GetInt(pRootElement, "fanartheight", m_fanartHeight, 0, 1080);
   XMLUtils::GetBoolean(pRootElement, "useddsfanart", m_useDDSFanart);
+  XMLUtils::GetBoolean(pRootElement, "useddsthumbs", m_useDDSThumbs);
 
   XMLUtils::GetBoolean(pRootElement, "playlistasfolders", m_playlistAsFolders);
   XMLUtils::GetBoolean(pRootElement, "detectasudf", m_detectAsUdf);
@@ -930,6 +947,28 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetString(pDatabase, "name", m_databaseMusic.name);
   }
 
+  pElement = pRootElement->FirstChildElement("coinacceptor");
+  if (pElement)
+  {
+    XMLUtils::GetString(pElement, "device", m_coinAcceptorDevice);
+    XMLUtils::GetInt(pElement, "insertcode", m_coinAcceptorInsertCode, -1, 0xffff);
+    XMLUtils::GetInt(pElement, "removecode", m_coinAcceptorRemoveCode, -1, 0xffff);
+    int debounce;
+    if (XMLUtils::GetInt(pElement, "debounce", debounce, 0, 5000)) // in ms
+      m_coinAcceptorDebounce = debounce;
+  }
+
+  pElement = pRootElement->FirstChildElement("norepeat");
+  if (pElement)
+  {
+    XMLUtils::GetInt(pElement, "tracksongs", m_noRepeatTrackSongs, 0, 10000);
+    XMLUtils::GetInt(pElement, "trackhours", m_noRepeatTrackHours, 0, 720);
+    XMLUtils::GetInt(pElement, "artistsongs", m_noRepeatArtistSongs, 0, 10000);
+    XMLUtils::GetInt(pElement, "artisthours", m_noRepeatArtistHours, 0, 720);
+    XMLUtils::GetInt(pElement, "albumsongs", m_noRepeatAlbumSongs, 0, 10000);
+    XMLUtils::GetInt(pElement, "albumhours", m_noRepeatAlbumHours, 0, 720);
+  }
+
   pElement = pRootElement->FirstChildElement("enablemultimediakeys");
   if (pElement)
   {
@@ -942,6 +981,11 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetBoolean(pElement, "visualizedirtyregions", m_guiVisualizeDirtyRegions);
     XMLUtils::GetInt(pElement, "algorithmdirtyregions",     m_guiAlgorithmDirtyRegions);
     XMLUtils::GetInt(pElement, "nofliptimeout",             m_guiDirtyRegionNoFlipTimeout);
+    XMLUtils::GetBoolean(pElement, "partialpresent",        m_guiPartialPresent);
+    XMLUtils::GetBoolean(pElement, "albumartatlas",         m_guiAlbumArtAtlas);
+    int textureBudget;
+    if (XMLUtils::GetInt(pElement, "texturememorybudget", textureBudget, 0, 1024)) // in MB
+      m_guiTextureMemoryBudget = textureBudget * 1024 * 1024;
   }
 
   // load in the GUISettings overrides:
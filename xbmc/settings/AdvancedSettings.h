@@ -179,6 +179,7 @@ class CAdvancedSettings
     int m_thumbSize;
     int m_fanartHeight;
     bool m_useDDSFanart;
+    bool m_useDDSThumbs;
 
     int m_sambaclienttimeout;
     CStdString m_sambadoscodepage;
@@ -287,9 +288,24 @@ class CAdvancedSettings
     bool m_guiVisualizeDirtyRegions;
     int  m_guiAlgorithmDirtyRegions;
     int  m_guiDirtyRegionNoFlipTimeout;
+    bool m_guiPartialPresent; ///< copy just the dirty regions to the screen, where the windowing system can do so
+    bool m_guiAlbumArtAtlas;
+    unsigned int m_guiTextureMemoryBudget; ///< bytes of GPU memory the texture manager may hold before evicting released textures
 
     unsigned int m_cacheMemBufferSize;
 
+    CStdString m_coinAcceptorDevice;       ///< input device, serial line or fifo the coin acceptor is read from, "loopback" for injected coins only
+    int m_coinAcceptorInsertCode;          ///< key code (input device) or byte (serial line) of a coin, -1 for any
+    int m_coinAcceptorRemoveCode;          ///< key code or byte that removes a credit, -1 for none
+    unsigned int m_coinAcceptorDebounce;   ///< pulses of the same kind closer together than this (ms) are one pulse
+
+    int m_noRepeatTrackSongs;              ///< automatic picks don't repeat a track within this many songs
+    int m_noRepeatTrackHours;              ///< or within this many hours, whichever is longer
+    int m_noRepeatArtistSongs;
+    int m_noRepeatArtistHours;
+    int m_noRepeatAlbumSongs;
+    int m_noRepeatAlbumHours;
+
     bool m_jsonOutputCompact;
     unsigned int m_jsonTcpPort;
 
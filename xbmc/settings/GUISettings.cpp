@@ -25,6 +25,7 @@
 #include "utils/Weather.h"
 #include "LangInfo.h"
 #include "utils/XMLUtils.h"
+#include "GUIInfoManager.h"
 #if defined(__APPLE__)
   #include "osx/DarwinUtils.h"
 #endif
@@ -1031,6 +1032,7 @@ void CGUISettings::SetBool(const char *strSetting, bool bSetting)
   if (it != settingsMap.end())
   { // old category
     ((CSettingBool*)(*it).second)->SetData(bSetting);
+    g_infoManager.InvalidateDependency(INFO::DEPENDS_SETTINGS);
     return ;
   }
   // Assert here and write debug output
@@ -1044,6 +1046,7 @@ void CGUISettings::ToggleBool(const char *strSetting)
   if (it != settingsMap.end())
   { // old category
     ((CSettingBool*)(*it).second)->SetData(!((CSettingBool *)(*it).second)->GetData());
+    g_infoManager.InvalidateDependency(INFO::DEPENDS_SETTINGS);
     return ;
   }
   // Assert here and write debug output
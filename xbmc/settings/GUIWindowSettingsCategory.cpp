@@ -45,6 +45,7 @@
 #include "guilib/GUIControlGroupList.h"
 #include "guilib/GUIWindowManager.h"
 #include "guilib/GUIFontManager.h"
+#include "GUIInfoManager.h"
 #ifdef _LINUX
 #include "LinuxTimezone.h"
 #include <dlfcn.h>
@@ -1019,7 +1020,9 @@ void CGUIWindowSettingsCategory::OnClick(CBaseSettingControl *pSettingControl)
 
   // if OnClick() returns false, the setting hasn't changed or doesn't
   // require immediate update
-  if (!pSettingControl->OnClick())
+  bool changed = pSettingControl->OnClick();
+  g_infoManager.InvalidateDependency(INFO::DEPENDS_SETTINGS);
+  if (!changed)
   {
     UpdateSettings();
     if (!pSettingControl->IsDelayed())
@@ -1051,6 +1054,7 @@ void CGUIWindowSettingsCategory::CheckForUpdates()
 void CGUIWindowSettingsCategory::OnSettingChanged(CBaseSettingControl *pSettingControl)
 {
   CStdString strSetting = pSettingControl->GetSetting()->GetSetting();
+  g_infoManager.InvalidateDependency(INFO::DEPENDS_SETTINGS);
 
   // ok, now check the various special things we need to do
   if (pSettingControl->GetSetting()->GetType() == SETTINGS_TYPE_ADDON)
@@ -1122,6 +1126,10 @@ void CGUIWindowSettingsCategory::OnSettingChanged(CBaseSettingControl *pSettingC
   {
     g_jukeboxManager.GetRandomManager().SetActionTime(g_guiSettings.GetInt("jukeboxer.autorandomtime"));
   }
+  else if (strSetting.Left(10).Equals("operation."))
+  {
+    g_jukeboxManager.OnSettingChanged(strSetting);
+  }
 
   else if (strSetting.Equals("videolibrary.cleanup"))
   {
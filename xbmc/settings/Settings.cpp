@@ -1479,6 +1479,7 @@ void CSettings::ResetSkinSetting(const CStdString &setting)
     if (settingName.Equals((*it).second.name))
     {
       (*it).second.value = false;
+      g_infoManager.InvalidateDependency(INFO::DEPENDS_SETTINGS);
       return;
     }
   }
@@ -1519,6 +1520,7 @@ void CSettings::SetSkinBool(int setting, bool set)
   if (it != m_skinBools.end())
   {
     (*it).second.value = set;
+    g_infoManager.InvalidateDependency(INFO::DEPENDS_SETTINGS);
     return;
   }
   assert(false);
@@ -3355,6 +3357,7 @@ void CSettings::ResetSkinSetting(const CStdString &setting)
     if (settingName.Equals((*it).second.name))
     {
       (*it).second.value = false;
+      g_infoManager.InvalidateDependency(INFO::DEPENDS_SETTINGS);
       return;
     }
   }
@@ -3395,6 +3398,7 @@ void CSettings::SetSkinBool(int setting, bool set)
   if (it != m_skinBools.end())
   {
     (*it).second.value = set;
+    g_infoManager.InvalidateDependency(INFO::DEPENDS_SETTINGS);
     return;
   }
   assert(false);
@@ -7,6 +7,52 @@
 #include "LockFree.h"
 #include <stdlib.h>
 
+///////////////////////////////////////////////////////////////////////////
+// atomic_ptr compare-and-swap
+///////////////////////////////////////////////////////////////////////////
+// Shared atomic_ptrs are read through volatile, so the compiler can't reuse an earlier read.
+// A read torn by a concurrent write just makes the following cas fail.
+static inline atomic_ptr atomic_ptr_load(const volatile atomic_ptr& p)
+{
+  atomic_ptr value;
+  value.ptr = p.ptr;
+#if !defined(__ppc__) && !defined(__powerpc__) && !defined(__arm__)
+  value.version = p.version;
+#endif
+  return value;
+}
+
+static inline bool atomic_ptr_equal(const atomic_ptr& a, const atomic_ptr& b)
+{
+#if defined(__ppc__) || defined(__powerpc__) || defined(__arm__)
+  return a.ptr == b.ptr;
+#else
+  return a.ptr == b.ptr && a.version == b.version;
+#endif
+}
+
+bool atomic_ptr_cas(volatile atomic_ptr* pAddr, const atomic_ptr& expectedVal, const atomic_ptr& swapVal)
+{
+#if defined(__ppc__) || defined(__powerpc__) || defined(__arm__)
+  return cas((long*)pAddr, atomic_ptr_to_long(expectedVal), atomic_ptr_to_long(swapVal)) == atomic_ptr_to_long(expectedVal);
+#elif defined(__x86_64__)
+  // cas2 only takes 64 bits, the pointer alone; the version is what protects against ABA
+  const long long* expected = (const long long*)&expectedVal;
+  const long long* swap = (const long long*)&swapVal;
+  long long lo = expected[0], hi = expected[1];
+  unsigned char swapped;
+  __asm__ __volatile__ (
+                        "lock/cmpxchg16b %1 \n"
+                        "setz %0"
+                        : "=q" (swapped), "+m" (*(volatile long long*)pAddr), "+a" (lo), "+d" (hi)
+                        : "b" (swap[0]), "c" (swap[1])
+                        : "cc", "memory");
+  return swapped != 0;
+#else
+  return cas2((long long*)pAddr, atomic_ptr_to_long_long(expectedVal), atomic_ptr_to_long_long(swapVal)) == atomic_ptr_to_long_long(expectedVal);
+#endif
+}
+
 ///////////////////////////////////////////////////////////////////////////
 // Fast stack implementation
 // NOTE: non-locking only on systems that support atomic cas2 operations
@@ -22,15 +68,13 @@ void lf_stack_push(lf_stack* pStack, lf_node* pNode)
   atomic_ptr top, newTop;
   do
   {
-    top = pStack->top;
+    top = atomic_ptr_load(pStack->top);
     pNode->next.ptr = top.ptr; // Link in the new node
     newTop.ptr = pNode;
-#if defined(__ppc__) || defined(__powerpc__) || defined(__arm__)
-  } while(cas((long*)&pStack->top, atomic_ptr_to_long(top), atomic_ptr_to_long(newTop)) != atomic_ptr_to_long(top));
-#else
+#if !defined(__ppc__) && !defined(__powerpc__) && !defined(__arm__)
     newTop.version = top.version + 1;
-  } while(cas2((long long*)&pStack->top, atomic_ptr_to_long_long(top), atomic_ptr_to_long_long(newTop)) != atomic_ptr_to_long_long(top));
 #endif
+  } while(!atomic_ptr_cas(&pStack->top, top, newTop));
   AtomicIncrement(&pStack->count);
 }
 
@@ -39,16 +83,14 @@ lf_node* lf_stack_pop(lf_stack* pStack)
   atomic_ptr top, newTop;
   do
   {
-    top = pStack->top;
+    top = atomic_ptr_load(pStack->top);
     if (top.ptr == NULL)
       return NULL;
-    newTop.ptr = ((lf_node*)top.ptr)->next.ptr; // Unlink the current top node
-#if defined(__ppc__) || defined(__powerpc__) || defined(__arm__)
-  } while(cas((long*)&pStack->top, atomic_ptr_to_long(top), atomic_ptr_to_long(newTop)) != atomic_ptr_to_long(top));
-#else
+    newTop.ptr = atomic_ptr_load(((lf_node*)top.ptr)->next).ptr; // Unlink the current top node
+#if !defined(__ppc__) && !defined(__powerpc__) && !defined(__arm__)
     newTop.version = top.version + 1;
-  } while(cas2((long long*)&pStack->top, atomic_ptr_to_long_long(top), atomic_ptr_to_long_long(newTop)) != atomic_ptr_to_long_long(top));
 #endif
+  } while(!atomic_ptr_cas(&pStack->top, top, newTop));
   AtomicDecrement(&pStack->count);
   return (lf_node*)top.ptr;
 }
@@ -73,6 +115,7 @@ void lf_heap_init(lf_heap* pHeap, size_t blockSize, size_t initialSize /*= 0*/)
   // Perform a few sanity checks on the parameters
   if (blockSize < sizeof(lf_node)) // Make sure we have blocks big enough to store in the free-list
     blockSize = sizeof(lf_node);
+  blockSize = (blockSize + sizeof(atomic_ptr) - 1) & ~(sizeof(atomic_ptr) - 1); // Keep every block's free-list link aligned for the cas
   pHeap->block_size = blockSize;
 
   if (initialSize < 10 * blockSize)
@@ -123,11 +166,10 @@ void lf_heap_deinit(lf_heap* pHeap)
 void* lf_heap_alloc(lf_heap* pHeap)
 {
   void * p = lf_stack_pop(&pHeap->free_list);
-  if (!p)
+  while (!p)
   {
     lf_heap_grow(pHeap, 0);
-    // TODO: should we just call in recursively?
-    return lf_stack_pop(&pHeap->free_list); // If growing didn't help, something is wrong (or someone else took them all REALLY fast)
+    p = lf_stack_pop(&pHeap->free_list); // Other threads may have taken all the new blocks already, grow again if they did
   }
   return p;
 }
@@ -166,44 +208,34 @@ void lf_queue_enqueue(lf_queue* pQueue, void* value)
   atomic_ptr tail, next, node;
   do
   {
-    tail = pQueue->tail;
-    next = ((lf_queue_node*)tail.ptr)->next;
-#if defined(__ppc__) || defined(__powerpc__) || defined(__arm__)
-    if (atomic_ptr_to_long(tail) == atomic_ptr_to_long(pQueue->tail)) // Check consistency
-#else
-    if (atomic_ptr_to_long_long(tail) == atomic_ptr_to_long_long(pQueue->tail)) // Check consistency
-#endif
+    tail = atomic_ptr_load(pQueue->tail);
+    next = atomic_ptr_load(((lf_queue_node*)tail.ptr)->next);
+    if (atomic_ptr_equal(tail, atomic_ptr_load(pQueue->tail))) // Check consistency
     {
       if (next.ptr == NULL) // Was tail pointing to the last node?
       {
         node.ptr = pNode;
-#if defined(__ppc__) || defined(__powerpc__) || defined(__arm__)
-        if (cas((long*)&((lf_queue_node*)tail.ptr)->next, atomic_ptr_to_long(next), atomic_ptr_to_long(node)) == atomic_ptr_to_long(next)) // Try to link node at end
-#else
+#if !defined(__ppc__) && !defined(__powerpc__) && !defined(__arm__)
         node.version = next.version + 1;
-        if (cas2((long long*)&((lf_queue_node*)tail.ptr)->next, atomic_ptr_to_long_long(next), atomic_ptr_to_long_long(node)) == atomic_ptr_to_long_long(next)) // Try to link node at end
 #endif
+        if (atomic_ptr_cas(&((lf_queue_node*)tail.ptr)->next, next, node)) // Try to link node at end
           break; // enqueue is done.
       }
       else // tail was lagging, try to help...
       {
         node.ptr = next.ptr;
-#if defined(__ppc__) || defined(__powerpc__) || defined(__arm__)
-        cas((long*)&pQueue->tail, atomic_ptr_to_long(tail), atomic_ptr_to_long(node)); // We don't care if we  are successful or not
-#else
+#if !defined(__ppc__) && !defined(__powerpc__) && !defined(__arm__)
         node.version = tail.version + 1;
-        cas2((long long*)&pQueue->tail, atomic_ptr_to_long_long(tail), atomic_ptr_to_long_long(node)); // We don't care if we  are successful or not
 #endif
+        atomic_ptr_cas(&pQueue->tail, tail, node); // We don't care if we  are successful or not
       }
     }
   } while (true); // Keep trying until the enqueue is done
   node.ptr = pNode;
-#if defined(__ppc__) || defined(__powerpc__) || defined(__arm__)
-  cas((long*)&pQueue->tail, atomic_ptr_to_long(tail), atomic_ptr_to_long(node)); // Try to swing the tail to the new node
-#else
+#if !defined(__ppc__) && !defined(__powerpc__) && !defined(__arm__)
   node.version = tail.version + 1;
-  cas2((long long*)&pQueue->tail, atomic_ptr_to_long_long(tail), atomic_ptr_to_long_long(node)); // Try to swing the tail to the new node
 #endif
+  atomic_ptr_cas(&pQueue->tail, tail, node); // Try to swing the tail to the new node
   AtomicIncrement(&pQueue->len);
 }
 
@@ -214,37 +246,29 @@ void* lf_queue_dequeue(lf_queue* pQueue)
   void* pVal = NULL;
   do
   {
-    head = pQueue->head;
-    tail = pQueue->tail;
-    next = ((lf_queue_node*)head.ptr)->next;
-#if defined(__ppc__) || defined(__powerpc__) || defined(__arm__)
-    if (atomic_ptr_to_long(head) == atomic_ptr_to_long(pQueue->head)) // Check consistency
-#else
-    if (atomic_ptr_to_long_long(head) == atomic_ptr_to_long_long(pQueue->head)) // Check consistency
-#endif
+    head = atomic_ptr_load(pQueue->head);
+    tail = atomic_ptr_load(pQueue->tail);
+    next = atomic_ptr_load(((lf_queue_node*)head.ptr)->next);
+    if (atomic_ptr_equal(head, atomic_ptr_load(pQueue->head))) // Check consistency
     {
       if (head.ptr == tail.ptr) // Queue is empty or tail is lagging
       {
         if (next.ptr == NULL) // Queue is empty
           return NULL;
         node.ptr = next.ptr;
-#if defined(__ppc__) || defined(__powerpc__) || defined(__arm__)
-        cas((long*)&pQueue->tail, atomic_ptr_to_long(tail), atomic_ptr_to_long(node)); // Tail is lagging. Try to advance it.
-#else
+#if !defined(__ppc__) && !defined(__powerpc__) && !defined(__arm__)
         node.version = tail.version + 1;
-        cas2((long long*)&pQueue->tail, atomic_ptr_to_long_long(tail), atomic_ptr_to_long_long(node)); // Tail is lagging. Try to advance it.
 #endif
+        atomic_ptr_cas(&pQueue->tail, tail, node); // Tail is lagging. Try to advance it.
       }
       else // Tail is consistent. No need to deal with it.
       {
         pVal = ((lf_queue_node*)next.ptr)->value;
         node.ptr = next.ptr;
-#if defined(__ppc__) || defined(__powerpc__) || defined(__arm__)
-        if (cas((long*)&pQueue->head, atomic_ptr_to_long(head), atomic_ptr_to_long(node)) == atomic_ptr_to_long(head))
-#else
+#if !defined(__ppc__) && !defined(__powerpc__) && !defined(__arm__)
         node.version = head.version + 1;
-        if (cas2((long long*)&pQueue->head, atomic_ptr_to_long_long(head), atomic_ptr_to_long_long(node)) == atomic_ptr_to_long_long(head))
 #endif
+        if (atomic_ptr_cas(&pQueue->head, head, node))
           break; // Dequeue is done
       }
     }
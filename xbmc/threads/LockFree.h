@@ -10,6 +10,7 @@
 #define SPINLOCK_RELEASE(l) l = 0
 
 // A unique-valued pointer. Version is incremented with each write.
+// On x86_64 the pointer and version take 16 bytes, swapped together with cmpxchg16b.
 union atomic_ptr
 {
 #if !defined(__ppc__) && !defined(__powerpc__) && !defined(__arm__)
@@ -24,7 +25,11 @@ union atomic_ptr
     void* ptr;
   };
 #endif
-};
+}
+#if defined(__x86_64__)
+__attribute__((aligned(16)))
+#endif
+;
 
 #if defined(__ppc__) || defined(__powerpc__) || defined(__arm__)
   #define atomic_ptr_to_long(p) (long) *((long*)&p)
@@ -33,6 +38,9 @@ union atomic_ptr
   #define atomic_ptr_to_long_long(p) (long long) *((long long*)&p)
 #endif
 
+// Swaps in swapVal if *pAddr (pointer and version) still is expectedVal, returns true if it did
+bool atomic_ptr_cas(volatile atomic_ptr* pAddr, const atomic_ptr& expectedVal, const atomic_ptr& swapVal);
+
 struct lf_node
 {
   atomic_ptr next;
@@ -0,0 +1,112 @@
+
+
+#include "threads/LockFree.h"
+#include "threads/Atomics.h"
+
+#include <boost/test/unit_test.hpp>
+#include <boost/shared_array.hpp>
+#include <boost/thread/thread.hpp>
+#include <set>
+
+#define TESTNUM 100000l
+#define NUMTHREADS 8l
+#define HELD 4
+
+struct block
+{
+  long owner;
+  long count;
+};
+
+void doHeapChurn(lf_heap* heap, long owner, long* collisions)
+{
+  block* held[HELD] = {};
+  for (long i = 0; i < TESTNUM; i++)
+  {
+    int slot = i % HELD;
+    if (held[slot])
+    {
+      // nobody else may have been given the block while this thread held it
+      if (held[slot]->owner != owner || held[slot]->count != i - HELD)
+        AtomicIncrement(collisions);
+      lf_heap_free(heap, held[slot]);
+    }
+    held[slot] = (block*)lf_heap_alloc(heap);
+    held[slot]->owner = owner;
+    held[slot]->count = i;
+  }
+  for (int slot = 0; slot < HELD; slot++)
+    lf_heap_free(heap, held[slot]);
+}
+
+BOOST_AUTO_TEST_CASE(TestLockFreeHeapChurn)
+{
+  lf_heap heap;
+  lf_heap_init(&heap, sizeof(block));
+
+  long collisions = 0;
+  boost::shared_array<boost::thread> t;
+  t.reset(new boost::thread[NUMTHREADS]);
+  for(size_t i=0; i<NUMTHREADS; i++)
+    t[i] = boost::thread(boost::bind(&doHeapChurn,&heap,(long)i,&collisions));
+
+  for(size_t i=0; i<NUMTHREADS; i++)
+    t[i].join();
+
+  BOOST_CHECK_EQUAL(0l, collisions);
+
+  // every block is back on the free list, once
+  std::set<void*> blocks;
+  long count = heap.free_list.count;
+  for (void* p = lf_heap_alloc(&heap); p && (long)blocks.size() < count; p = lf_heap_alloc(&heap))
+    BOOST_CHECK(blocks.insert(p).second);
+  BOOST_CHECK_EQUAL((long)blocks.size(), count);
+
+  lf_heap_deinit(&heap);
+}
+
+void doEnqueue(lf_queue* queue, long first)
+{
+  for (long i = 0; i < TESTNUM; i++)
+    lf_queue_enqueue(queue, (void*)(first + i));
+}
+
+void doDequeue(lf_queue* queue, long* sum, long* count)
+{
+  while (*count < NUMTHREADS / 2 * TESTNUM)
+  {
+    void* value = lf_queue_dequeue(queue);
+    if (!value)
+      continue;
+    AtomicAdd(sum, (long)value % 1000);
+    AtomicIncrement(count);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestLockFreeQueue)
+{
+  lf_queue queue;
+  lf_queue_init(&queue);
+
+  long sum = 0, count = 0, expected = 0;
+  boost::shared_array<boost::thread> t;
+  t.reset(new boost::thread[NUMTHREADS]);
+  for(size_t i=0; i<NUMTHREADS / 2; i++)
+  {
+    long first = 1 + i * TESTNUM;
+    for (long j = 0; j < TESTNUM; j++)
+      expected += (first + j) % 1000;
+    t[i] = boost::thread(boost::bind(&doEnqueue,&queue,first));
+  }
+  for(size_t i=NUMTHREADS / 2; i<NUMTHREADS; i++)
+    t[i] = boost::thread(boost::bind(&doDequeue,&queue,&sum,&count));
+
+  for(size_t i=0; i<NUMTHREADS; i++)
+    t[i].join();
+
+  BOOST_CHECK_EQUAL(NUMTHREADS / 2 * TESTNUM, count);
+  BOOST_CHECK_EQUAL(expected, sum);
+  BOOST_CHECK(lf_queue_dequeue(&queue) == NULL);
+
+  lf_queue_deinit(&queue);
+}
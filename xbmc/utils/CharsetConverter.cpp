@@ -5,6 +5,8 @@
 #include <fribidi/fribidi.h>
 #include "LangInfo.h"
 #include "threads/SingleLock.h"
+#include "threads/LockFree.h"
+#include "Utf8Utils.h"
 #include "log.h"
 
 #include <errno.h>
@@ -28,21 +30,9 @@
 #endif
 
 
-static iconv_t m_iconvStringCharsetToFontCharset = (iconv_t)-1;
-static iconv_t m_iconvSubtitleCharsetToW         = (iconv_t)-1;
-static iconv_t m_iconvUtf8ToStringCharset        = (iconv_t)-1;
-static iconv_t m_iconvStringCharsetToUtf8        = (iconv_t)-1;
-static iconv_t m_iconvUcs2CharsetToStringCharset = (iconv_t)-1;
-static iconv_t m_iconvUtf32ToStringCharset       = (iconv_t)-1;
-static iconv_t m_iconvWtoUtf8                    = (iconv_t)-1;
-static iconv_t m_iconvUtf16LEtoW                 = (iconv_t)-1;
-static iconv_t m_iconvUtf16BEtoUtf8              = (iconv_t)-1;
-static iconv_t m_iconvUtf16LEtoUtf8              = (iconv_t)-1;
-static iconv_t m_iconvUtf8toW                    = (iconv_t)-1;
-static iconv_t m_iconvUcs2CharsetToUtf8          = (iconv_t)-1;
-
 static FriBidiCharSet m_stringFribidiCharset     = FRIBIDI_CHAR_SET_NOT_FOUND;
 
+// libfribidi is not threadsafe, the conversions don't need it
 static CCriticalSection            m_critSection;
 
 static struct SFribidMapping
@@ -228,11 +218,95 @@ static void convert(iconv_t& type, int multiplier, const CStdString& strFromChar
     strDest = strSource;
 }
 
+enum EConverter
+{
+  CONVERTER_SUBTITLE_TO_W = 0,
+  CONVERTER_UTF8_TO_STRING,
+  CONVERTER_STRING_TO_UTF8,
+  CONVERTER_UCS2_TO_STRING,
+  CONVERTER_UTF32_TO_STRING,
+  CONVERTER_W_TO_UTF8,
+  CONVERTER_UTF16LE_TO_W,
+  CONVERTER_UTF16BE_TO_UTF8,
+  CONVERTER_UTF16LE_TO_UTF8,
+  CONVERTER_UTF8_TO_W,
+  CONVERTER_UCS2_TO_UTF8,
+  CONVERTERS
+};
+
+// One handle per converter, used by one thread at a time. Idle sets wait on a lock free
+// stack, so each thread converting takes its own set instead of queueing for shared handles.
+// Sets are never freed, there are only ever as many as threads converting at once.
+struct SConverterSet
+{
+  lf_node node; // first, the stack links the sets through it
+  long    generation;
+  iconv_t handles[CONVERTERS];
+};
+
+static lf_stack      g_converterSets;   // zero initialized, an empty stack
+static volatile long g_converterGeneration = 0; // bumped by reset(), older sets reopen their handles
+
+class CConverterHandle
+{
+public:
+  CConverterHandle(EConverter converter) : m_converter(converter)
+  {
+    long generation = g_converterGeneration;
+    m_set = (SConverterSet*)lf_stack_pop(&g_converterSets);
+    if (!m_set)
+    {
+      m_set = new SConverterSet;
+      for (int i = 0; i < CONVERTERS; i++)
+        ICONV_PREPARE(m_set->handles[i]);
+    }
+    else if (m_set->generation != generation)
+    {
+      for (int i = 0; i < CONVERTERS; i++)
+        ICONV_SAFE_CLOSE(m_set->handles[i]);
+    }
+    m_set->generation = generation;
+  }
+
+  ~CConverterHandle()
+  {
+    lf_stack_push(&g_converterSets, &m_set->node);
+  }
+
+  iconv_t& Get() { return m_set->handles[m_converter]; }
+
+private:
+  SConverterSet* m_set;
+  EConverter     m_converter;
+};
+
+// Converts well formed UTF-8 without iconv, false if iconv is needed. On OSX that is all but
+// ASCII, iconv composes the decomposed characters of UTF-8-MAC.
+static bool fastUtf8ToW(const CStdStringA& strSource, CStdStringW& strDest)
+{
+  size_t length = strlen(strSource.c_str()); // iconv stops at the first null too
+#ifdef __APPLE__
+  if (!CUtf8Utils::IsAscii(strSource.c_str(), length))
+    return false;
+#endif
+  return CUtf8Utils::Decode(strSource.c_str(), length, strDest);
+}
+
+// Text fribidi has nothing to reorder in, it would only drop the line breaks
+static bool isPlainText(const CStdStringA& str)
+{
+  for (const char *c = str.c_str(); *c; c++)
+  {
+    if ((*c < 0x20 || *c > 0x7e) && *c != '\t' && *c != '\n')
+      return false;
+  }
+  return true;
+}
+
 using namespace std;
 
 static void logicalToVisualBiDi(const CStdStringA& strSource, CStdStringA& strDest, FriBidiCharSet fribidiCharset, FriBidiCharType base = FRIBIDI_TYPE_LTR, bool* bWasFlipped =NULL)
 {
-  // libfribidi is not threadsafe, so make sure we make it so
   CSingleLock lock(m_critSection);
 
   vector<CStdString> lines;
@@ -343,20 +417,10 @@ bool CCharsetConverter::isBidiCharset(const CStdString& charset)
 
 void CCharsetConverter::reset(void)
 {
-  CSingleLock lock(m_critSection);
-
-  ICONV_SAFE_CLOSE(m_iconvStringCharsetToFontCharset);
-  ICONV_SAFE_CLOSE(m_iconvUtf8ToStringCharset);
-  ICONV_SAFE_CLOSE(m_iconvStringCharsetToUtf8);
-  ICONV_SAFE_CLOSE(m_iconvUcs2CharsetToStringCharset);
-  ICONV_SAFE_CLOSE(m_iconvSubtitleCharsetToW);
-  ICONV_SAFE_CLOSE(m_iconvWtoUtf8);
-  ICONV_SAFE_CLOSE(m_iconvUtf16BEtoUtf8);
-  ICONV_SAFE_CLOSE(m_iconvUtf16LEtoUtf8);
-  ICONV_SAFE_CLOSE(m_iconvUtf32ToStringCharset);
-  ICONV_SAFE_CLOSE(m_iconvUtf8toW);
-  ICONV_SAFE_CLOSE(m_iconvUcs2CharsetToUtf8);
+  // the handles are reopened with the new charsets as their sets are next taken
+  AtomicIncrement(&g_converterGeneration);
 
+  CSingleLock lock(m_critSection);
 
   m_stringFribidiCharset = FRIBIDI_CHAR_SET_NOT_FOUND;
 
@@ -373,26 +437,41 @@ void CCharsetConverter::reset(void)
 void CCharsetConverter::utf8ToW(const CStdStringA& utf8String, CStdStringW &wString, bool bVisualBiDiFlip/*=true*/, bool forceLTRReadingOrder /*=false*/, bool* bWasFlipped/*=NULL*/)
 {
   // Try to flip hebrew/arabic characters, if any
-  if (bVisualBiDiFlip)
+  if (bVisualBiDiFlip && isPlainText(utf8String))
+  {
+    if (bWasFlipped)
+      *bWasFlipped = false;
+    wString.clear();
+    wString.reserve(utf8String.size());
+    for (const char *c = utf8String.c_str(); *c; c++)
+    {
+      if (*c != '\n')
+        wString.push_back(*c);
+    }
+  }
+  else if (bVisualBiDiFlip)
   {
     CStdStringA strFlipped;
     FriBidiCharType charset = forceLTRReadingOrder ? FRIBIDI_TYPE_LTR : FRIBIDI_TYPE_PDF;
     logicalToVisualBiDi(utf8String, strFlipped, FRIBIDI_CHAR_SET_UTF8, charset, bWasFlipped);
-    CSingleLock lock(m_critSection);
-    convert(m_iconvUtf8toW,sizeof(wchar_t),UTF8_SOURCE,WCHAR_CHARSET,strFlipped,wString);
+    if (!fastUtf8ToW(strFlipped, wString))
+    {
+      CConverterHandle handle(CONVERTER_UTF8_TO_W);
+      convert(handle.Get(),sizeof(wchar_t),UTF8_SOURCE,WCHAR_CHARSET,strFlipped,wString);
+    }
   }
-  else
+  else if (!fastUtf8ToW(utf8String, wString))
   {
-    CSingleLock lock(m_critSection);
-    convert(m_iconvUtf8toW,sizeof(wchar_t),UTF8_SOURCE,WCHAR_CHARSET,utf8String,wString);
+    CConverterHandle handle(CONVERTER_UTF8_TO_W);
+    convert(handle.Get(),sizeof(wchar_t),UTF8_SOURCE,WCHAR_CHARSET,utf8String,wString);
   }
 }
 
 void CCharsetConverter::subtitleCharsetToW(const CStdStringA& strSource, CStdStringW& strDest)
 {
   // No need to flip hebrew/arabic as mplayer does the flipping
-  CSingleLock lock(m_critSection);
-  convert(m_iconvSubtitleCharsetToW,sizeof(wchar_t),g_langInfo.GetSubtitleCharSet(),WCHAR_CHARSET,strSource,strDest);
+  CConverterHandle handle(CONVERTER_SUBTITLE_TO_W);
+  convert(handle.Get(),sizeof(wchar_t),g_langInfo.GetSubtitleCharSet(),WCHAR_CHARSET,strSource,strDest);
 }
 
 void CCharsetConverter::fromW(const CStdStringW& strSource,
@@ -415,8 +494,15 @@ void CCharsetConverter::toW(const CStdStringA& strSource,
 
 void CCharsetConverter::utf8ToStringCharset(const CStdStringA& strSource, CStdStringA& strDest)
 {
-  CSingleLock lock(m_critSection);
-  convert(m_iconvUtf8ToStringCharset,1,UTF8_SOURCE,g_langInfo.GetGuiCharSet(),strSource,strDest);
+  CStdString strCharset = g_langInfo.GetGuiCharSet();
+  // ASCII is the same in the string charsets, bar the yen sign and overline of Shift-JIS
+  if (strCharset.ToUpper().Find("JIS") < 0 && CUtf8Utils::IsAscii(strSource.c_str(), strSource.size()))
+  {
+    strDest = strSource.c_str();
+    return;
+  }
+  CConverterHandle handle(CONVERTER_UTF8_TO_STRING);
+  convert(handle.Get(),1,UTF8_SOURCE,strCharset,strSource,strDest);
 }
 
 void CCharsetConverter::utf8ToStringCharset(CStdStringA& strSourceDest)
@@ -478,43 +564,45 @@ void CCharsetConverter::unknownToUTF8(const CStdStringA &source, CStdStringA &de
     dest = source;
   else
   {
-    CSingleLock lock(m_critSection);
-    convert(m_iconvStringCharsetToUtf8, UTF8_DEST_MULTIPLIER, g_langInfo.GetGuiCharSet(), "UTF-8", source, dest);
+    CConverterHandle handle(CONVERTER_STRING_TO_UTF8);
+    convert(handle.Get(), UTF8_DEST_MULTIPLIER, g_langInfo.GetGuiCharSet(), "UTF-8", source, dest);
   }
 }
 
 void CCharsetConverter::wToUTF8(const CStdStringW& strSource, CStdStringA &strDest)
 {
-  CSingleLock lock(m_critSection);
-  convert(m_iconvWtoUtf8,UTF8_DEST_MULTIPLIER,WCHAR_CHARSET,"UTF-8",strSource,strDest);
+  if (CUtf8Utils::Encode(strSource.c_str(), wcslen(strSource.c_str()), strDest))
+    return;
+  CConverterHandle handle(CONVERTER_W_TO_UTF8);
+  convert(handle.Get(),UTF8_DEST_MULTIPLIER,WCHAR_CHARSET,"UTF-8",strSource,strDest);
 }
 
 void CCharsetConverter::utf16BEtoUTF8(const CStdString16& strSource, CStdStringA &strDest)
 {
-  CSingleLock lock(m_critSection);
-  if(!convert_checked(m_iconvUtf16BEtoUtf8,UTF8_DEST_MULTIPLIER,"UTF-16BE","UTF-8",strSource,strDest))
+  CConverterHandle handle(CONVERTER_UTF16BE_TO_UTF8);
+  if(!convert_checked(handle.Get(),UTF8_DEST_MULTIPLIER,"UTF-16BE","UTF-8",strSource,strDest))
     strDest.empty();
 }
 
 void CCharsetConverter::utf16LEtoUTF8(const CStdString16& strSource,
                                       CStdStringA &strDest)
 {
-  CSingleLock lock(m_critSection);
-  if(!convert_checked(m_iconvUtf16LEtoUtf8,UTF8_DEST_MULTIPLIER,"UTF-16LE","UTF-8",strSource,strDest))
+  CConverterHandle handle(CONVERTER_UTF16LE_TO_UTF8);
+  if(!convert_checked(handle.Get(),UTF8_DEST_MULTIPLIER,"UTF-16LE","UTF-8",strSource,strDest))
     strDest.empty();
 }
 
 void CCharsetConverter::ucs2ToUTF8(const CStdString16& strSource, CStdStringA& strDest)
 {
-  CSingleLock lock(m_critSection);
-  if(!convert_checked(m_iconvUcs2CharsetToUtf8,UTF8_DEST_MULTIPLIER,"UCS-2LE","UTF-8",strSource,strDest))
+  CConverterHandle handle(CONVERTER_UCS2_TO_UTF8);
+  if(!convert_checked(handle.Get(),UTF8_DEST_MULTIPLIER,"UCS-2LE","UTF-8",strSource,strDest))
     strDest.empty();
 }
 
 void CCharsetConverter::utf16LEtoW(const CStdString16& strSource, CStdStringW &strDest)
 {
-  CSingleLock lock(m_critSection);
-  if(!convert_checked(m_iconvUtf16LEtoW,sizeof(wchar_t),"UTF-16LE",WCHAR_CHARSET,strSource,strDest))
+  CConverterHandle handle(CONVERTER_UTF16LE_TO_W);
+  if(!convert_checked(handle.Get(),sizeof(wchar_t),"UTF-16LE",WCHAR_CHARSET,strSource,strDest))
     strDest.empty();
 }
 
@@ -535,22 +623,23 @@ void CCharsetConverter::ucs2CharsetToStringCharset(const CStdStringW& strSource,
       s++;
     }
   }
-  CSingleLock lock(m_critSection);
-  convert(m_iconvUcs2CharsetToStringCharset,4,"UTF-16LE",
+  CConverterHandle handle(CONVERTER_UCS2_TO_STRING);
+  convert(handle.Get(),4,"UTF-16LE",
           g_langInfo.GetGuiCharSet(),strCopy,strDest);
 }
 
 void CCharsetConverter::utf32ToStringCharset(const unsigned long* strSource, CStdStringA& strDest)
 {
-  CSingleLock lock(m_critSection);
+  CConverterHandle handle(CONVERTER_UTF32_TO_STRING);
+  iconv_t& iconvUtf32ToStringCharset = handle.Get();
 
-  if (m_iconvUtf32ToStringCharset == (iconv_t) - 1)
+  if (iconvUtf32ToStringCharset == (iconv_t) - 1)
   {
     CStdString strCharset=g_langInfo.GetGuiCharSet();
-    m_iconvUtf32ToStringCharset = iconv_open(strCharset.c_str(), "UTF-32LE");
+    iconvUtf32ToStringCharset = iconv_open(strCharset.c_str(), "UTF-32LE");
   }
 
-  if (m_iconvUtf32ToStringCharset != (iconv_t) - 1)
+  if (iconvUtf32ToStringCharset != (iconv_t) - 1)
   {
     const unsigned long* ptr=strSource;
     while (*ptr) ptr++;
@@ -560,7 +649,7 @@ void CCharsetConverter::utf32ToStringCharset(const unsigned long* strSource, CSt
     char *dst = strDest.GetBuffer(inBytes);
     size_t outBytes = inBytes;
 
-    if (iconv_const(m_iconvUtf32ToStringCharset, &src, &inBytes, &dst, &outBytes) == (size_t)-1)
+    if (iconv_const(iconvUtf32ToStringCharset, &src, &inBytes, &dst, &outBytes) == (size_t)-1)
     {
       CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
       strDest.ReleaseBuffer();
@@ -568,7 +657,7 @@ void CCharsetConverter::utf32ToStringCharset(const unsigned long* strSource, CSt
       return;
     }
 
-    if (iconv(m_iconvUtf32ToStringCharset, NULL, NULL, &dst, &outBytes) == (size_t)-1)
+    if (iconv(iconvUtf32ToStringCharset, NULL, NULL, &dst, &outBytes) == (size_t)-1)
     {
       CLog::Log(LOGERROR, "%s failed cleanup", __FUNCTION__);
       strDest.ReleaseBuffer();
@@ -590,6 +679,10 @@ void CCharsetConverter::utf8ToSystem(CStdStringA& strSourceDest)
 // Taken from RFC2640
 bool CCharsetConverter::isValidUtf8(const char *buf, unsigned int len)
 {
+  size_t ascii = CUtf8Utils::AsciiLength(buf, len);
+  buf += ascii;
+  len -= ascii;
+
   const unsigned char *endbuf = (unsigned char*)buf + len;
   unsigned char byte2mask=0x00, c;
   int trailing=0; // trailing (continuation) bytes to follow
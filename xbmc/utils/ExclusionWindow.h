@@ -0,0 +1,86 @@
+#pragma once
+
+
+#include <boost/unordered_map.hpp>
+#include <deque>
+#include <string>
+#include <time.h>
+
+/*!
+ \ingroup utils
+ \brief The keys added in the last N additions or the last M seconds, for "don't repeat within"
+ rules.
+
+ Additions are kept in a ring in the order they were made, and counted per key in a hash map,
+ so Contains() is a hash lookup. Entries that have fallen out of both windows are dropped from
+ the front of the ring as keys are added and looked up. An entry stays while either window
+ holds it, and the ring never holds more than MAX_ENTRIES.
+ */
+class CExclusionWindow
+{
+public:
+  static const unsigned int MAX_ENTRIES = 10000;
+
+  CExclusionWindow(unsigned int count = 0, unsigned int seconds = 0) : m_count(count), m_seconds(seconds) {}
+
+  /*! \param count how many of the last additions to hold, 0 for none.
+   \param seconds how long to hold additions for, 0 for no time limit.
+   */
+  void SetWindow(unsigned int count, unsigned int seconds)
+  {
+    m_count = count;
+    m_seconds = seconds;
+  }
+
+  bool IsEnabled() const { return m_count || m_seconds; }
+
+  /*! \brief Add a key. An empty key counts as an addition but is never contained. */
+  void Add(const std::string &key, time_t when)
+  {
+    if (!IsEnabled())
+      return;
+    m_entries.push_back(std::make_pair(when, key));
+    if (!key.empty())
+      m_keys[key]++;
+    Expire(when);
+  }
+
+  bool Contains(const std::string &key, time_t now)
+  {
+    Expire(now);
+    return !key.empty() && m_keys.find(key) != m_keys.end();
+  }
+
+  void Clear()
+  {
+    m_entries.clear();
+    m_keys.clear();
+  }
+
+  size_t Size() const { return m_entries.size(); }
+
+private:
+  void Expire(time_t now)
+  {
+    while (!m_entries.empty())
+    {
+      const std::pair<time_t, std::string> &oldest = m_entries.front();
+      bool inCount = m_entries.size() <= m_count;
+      bool inTime = m_seconds && now - oldest.first < (time_t)m_seconds;
+      if ((inCount || inTime) && m_entries.size() <= MAX_ENTRIES)
+        break;
+      if (!oldest.second.empty())
+      {
+        boost::unordered_map<std::string, unsigned int>::iterator it = m_keys.find(oldest.second);
+        if (it != m_keys.end() && --it->second == 0)
+          m_keys.erase(it);
+      }
+      m_entries.pop_front();
+    }
+  }
+
+  std::deque< std::pair<time_t, std::string> > m_entries;
+  boost::unordered_map<std::string, unsigned int> m_keys;
+  unsigned int m_count;
+  unsigned int m_seconds;
+};
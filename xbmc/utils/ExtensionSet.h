@@ -0,0 +1,58 @@
+#pragma once
+
+
+#include <boost/unordered_set.hpp>
+#include <ctype.h>
+#include <string>
+
+/*!
+ \ingroup utils
+ \brief A "|" separated list of file extensions (".mp3|.flac"), such as the media extensions of
+ CSettings, compiled for lookups.
+
+ Looking an extension up in the list string takes a substring search of the whole list, and
+ also matches parts of extensions (".mp" is found in ".mp3"). The set matches whole
+ extensions only, case insensitively, with a hash lookup.
+ */
+class CExtensionSet
+{
+public:
+  CExtensionSet() {}
+  explicit CExtensionSet(const std::string &extensions) { Set(extensions); }
+
+  void Set(const std::string &extensions)
+  {
+    m_source = extensions;
+    m_extensions.clear();
+    std::string::size_type start = 0;
+    while (start <= extensions.size())
+    {
+      std::string::size_type end = extensions.find('|', start);
+      if (end == std::string::npos)
+        end = extensions.size();
+      if (end > start)
+        m_extensions.insert(Lower(extensions.substr(start, end - start)));
+      start = end + 1;
+    }
+  }
+
+  /*! \brief The list the set was compiled from. */
+  const std::string &GetSource() const { return m_source; }
+
+  /*! \param extension with its dot, in any case. */
+  bool Contains(const std::string &extension) const
+  {
+    return !extension.empty() && m_extensions.find(Lower(extension)) != m_extensions.end();
+  }
+
+private:
+  static std::string Lower(std::string text)
+  {
+    for (std::string::iterator it = text.begin(); it != text.end(); ++it)
+      *it = (char)tolower((unsigned char)*it);
+    return text;
+  }
+
+  std::string m_source;
+  boost::unordered_set<std::string> m_extensions;
+};
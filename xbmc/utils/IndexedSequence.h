@@ -0,0 +1,352 @@
+#pragma once
+
+
+#include <algorithm>
+#include <vector>
+#include <stddef.h>
+
+/*!
+ \ingroup utils
+ \brief A sequence of values, each of which also holds a rank in a second "order" sequence.
+
+ Both sequences are kept in randomized balanced trees (treaps) sized by subtree, so access,
+ insertion and removal by position, looking up the position of a given order and the order
+ of a given position are all O(log n). Inserting or removing a value shifts the positions and
+ orders of the values after it, without touching them.
+
+ This is what CPlayList uses to keep the playing order of a (possibly shuffled) playlist
+ alongside its unshuffled order.
+
+ Insert() hands back an Entry, which stays valid until the value is erased. PositionOf() and
+ OrderOf() find where an entry currently is.
+ */
+template<class T>
+class CIndexedSequence
+{
+public:
+  struct Entry;
+
+private:
+  struct Node
+  {
+    Node *left;
+    Node *right;
+    Node *parent;
+    unsigned int size;     ///< number of nodes in the subtree rooted here
+    unsigned int priority; ///< heap priority that keeps the tree balanced
+    Entry *entry;
+  };
+
+public:
+  struct Entry
+  {
+    T value;
+  private:
+    friend class CIndexedSequence;
+    Node *position;
+    Node *order;
+  };
+
+  CIndexedSequence() : m_positions(NULL), m_orders(NULL), m_seed(2463534242U) {}
+  CIndexedSequence(const CIndexedSequence &other) : m_positions(NULL), m_orders(NULL), m_seed(other.m_seed) { Copy(other); }
+  ~CIndexedSequence() { Clear(); }
+
+  CIndexedSequence &operator=(const CIndexedSequence &other)
+  {
+    if (this != &other)
+    {
+      Clear();
+      Copy(other);
+    }
+    return *this;
+  }
+
+  int Size() const { return (int)GetSize(m_positions); }
+
+  void Clear()
+  {
+    std::vector<Node*> nodes;
+    Collect(m_positions, nodes);
+    for (unsigned int i = 0; i < nodes.size(); i++)
+    {
+      delete nodes[i]->entry->order;
+      delete nodes[i]->entry;
+      delete nodes[i];
+    }
+    m_positions = m_orders = NULL;
+  }
+
+  /*! \brief Insert a value.
+   \param position position of the value, anything out of range appends it.
+   \param order rank of the value in the order sequence, anything out of range appends it.
+   \return the entry holding the value.
+   */
+  Entry *Insert(int position, int order, const T &value)
+  {
+    int size = Size();
+    if (position < 0 || position > size)
+      position = size;
+    if (order < 0 || order > size)
+      order = size;
+
+    Entry *entry = new Entry;
+    entry->value = value;
+    entry->position = NewNode(entry);
+    entry->order = NewNode(entry);
+    InsertNode(m_positions, position, entry->position);
+    InsertNode(m_orders, order, entry->order);
+    return entry;
+  }
+
+  /*! \brief Remove the value at the given position.
+   */
+  void Erase(int position)
+  {
+    if (position < 0 || position >= Size())
+      return;
+    Node *node = EraseNode(m_positions, position);
+    Entry *entry = node->entry;
+    delete EraseNode(m_orders, Rank(entry->order));
+    delete entry;
+    delete node;
+  }
+
+  Entry *EntryAt(int position) const { return Select(m_positions, position)->entry; }
+  T &At(int position) { return EntryAt(position)->value; }
+  const T &At(int position) const { return EntryAt(position)->value; }
+
+  /*! \brief Rank in the order sequence of the value at the given position.
+   */
+  int OrderAt(int position) const { return Rank(EntryAt(position)->order); }
+
+  /*! \brief Position of the value with the given rank in the order sequence.
+   \return the position, -1 if the order is out of range.
+   */
+  int FindOrder(int order) const
+  {
+    if (order < 0 || order >= Size())
+      return -1;
+    return Rank(Select(m_orders, order)->entry->position);
+  }
+
+  int PositionOf(const Entry *entry) const { return Rank(entry->position); }
+  int OrderOf(const Entry *entry) const { return Rank(entry->order); }
+
+  /*! \brief Swap the values at two positions.
+   \param swapOrders true to also swap their orders, so each position keeps its order.
+   */
+  void Swap(int position1, int position2, bool swapOrders)
+  {
+    if (position1 == position2)
+      return;
+    Entry *entry1 = EntryAt(position1);
+    Entry *entry2 = EntryAt(position2);
+    std::swap(entry1->position, entry2->position);
+    entry1->position->entry = entry1;
+    entry2->position->entry = entry2;
+    if (swapOrders)
+    {
+      std::swap(entry1->order, entry2->order);
+      entry1->order->entry = entry1;
+      entry2->order->entry = entry2;
+    }
+  }
+
+  /*! \brief Randomly reorder the values from the given position onwards, orders are kept.
+   */
+  void Shuffle(int from)
+  {
+    std::vector<Node*> nodes;
+    Collect(m_positions, nodes);
+    if (from < 0)
+      from = 0;
+    if (from >= (int)nodes.size())
+      return;
+    std::vector<Entry*> entries;
+    for (unsigned int i = from; i < nodes.size(); i++)
+      entries.push_back(nodes[i]->entry);
+    std::random_shuffle(entries.begin(), entries.end());
+    for (unsigned int i = 0; i < entries.size(); i++)
+      Attach(nodes[from + i], entries[i]);
+  }
+
+  /*! \brief Put the values back in their order, so that every position is equal to its order.
+   */
+  void SortByOrder()
+  {
+    std::vector<Node*> positions, orders;
+    Collect(m_positions, positions);
+    Collect(m_orders, orders);
+    for (unsigned int i = 0; i < positions.size(); i++)
+      Attach(positions[i], orders[i]->entry);
+  }
+
+private:
+  static unsigned int GetSize(const Node *node) { return node ? node->size : 0; }
+
+  static void Update(Node *node)
+  {
+    node->size = 1 + GetSize(node->left) + GetSize(node->right);
+    if (node->left)
+      node->left->parent = node;
+    if (node->right)
+      node->right->parent = node;
+  }
+
+  static void Attach(Node *positionNode, Entry *entry)
+  {
+    positionNode->entry = entry;
+    entry->position = positionNode;
+  }
+
+  Node *NewNode(Entry *entry)
+  {
+    // xorshift, so the tree shape doesn't depend on (or disturb) rand()
+    m_seed ^= m_seed << 13;
+    m_seed ^= m_seed >> 17;
+    m_seed ^= m_seed << 5;
+
+    Node *node = new Node;
+    node->left = node->right = node->parent = NULL;
+    node->size = 1;
+    node->priority = m_seed;
+    node->entry = entry;
+    return node;
+  }
+
+  // splits the tree into its first count nodes and the rest
+  static void Split(Node *node, unsigned int count, Node *&left, Node *&right)
+  {
+    if (!node)
+    {
+      left = right = NULL;
+      return;
+    }
+    if (GetSize(node->left) < count)
+    {
+      Split(node->right, count - GetSize(node->left) - 1, node->right, right);
+      left = node;
+      Update(left);
+    }
+    else
+    {
+      Split(node->left, count, left, node->left);
+      right = node;
+      Update(right);
+    }
+  }
+
+  static Node *Merge(Node *left, Node *right)
+  {
+    if (!left)
+      return right;
+    if (!right)
+      return left;
+    if (left->priority > right->priority)
+    {
+      left->right = Merge(left->right, right);
+      Update(left);
+      return left;
+    }
+    right->left = Merge(left, right->left);
+    Update(right);
+    return right;
+  }
+
+  static void SetRoot(Node *&root, Node *node)
+  {
+    root = node;
+    if (root)
+      root->parent = NULL;
+  }
+
+  static void InsertNode(Node *&root, unsigned int rank, Node *node)
+  {
+    Node *left, *right;
+    Split(root, rank, left, right);
+    SetRoot(root, Merge(Merge(left, node), right));
+  }
+
+  static Node *EraseNode(Node *&root, unsigned int rank)
+  {
+    Node *left, *middle, *right;
+    Split(root, rank, left, right);
+    Split(right, 1, middle, right);
+    SetRoot(root, Merge(left, right));
+    return middle;
+  }
+
+  static Node *Select(Node *node, unsigned int rank)
+  {
+    while (node)
+    {
+      unsigned int leftSize = GetSize(node->left);
+      if (rank < leftSize)
+        node = node->left;
+      else if (rank == leftSize)
+        return node;
+      else
+      {
+        rank -= leftSize + 1;
+        node = node->right;
+      }
+    }
+    return NULL;
+  }
+
+  static int Rank(const Node *node)
+  {
+    unsigned int rank = GetSize(node->left);
+    while (node->parent)
+    {
+      if (node == node->parent->right)
+        rank += GetSize(node->parent->left) + 1;
+      node = node->parent;
+    }
+    return (int)rank;
+  }
+
+  // appends the nodes of the tree to the vector, in sequence order
+  static void Collect(Node *node, std::vector<Node*> &nodes)
+  {
+    std::vector<Node*> stack;
+    while (node || !stack.empty())
+    {
+      while (node)
+      {
+        stack.push_back(node);
+        node = node->left;
+      }
+      node = stack.back();
+      stack.pop_back();
+      nodes.push_back(node);
+      node = node->right;
+    }
+  }
+
+  void Copy(const CIndexedSequence &other)
+  {
+    std::vector<Node*> positions, orders;
+    Collect(other.m_positions, positions);
+    Collect(other.m_orders, orders);
+
+    std::vector<Entry*> entries(positions.size());
+    for (unsigned int i = 0; i < positions.size(); i++)
+    {
+      entries[i] = new Entry;
+      entries[i]->value = positions[i]->entry->value;
+      entries[i]->position = NewNode(entries[i]);
+      SetRoot(m_positions, Merge(m_positions, entries[i]->position));
+    }
+    for (unsigned int i = 0; i < orders.size(); i++)
+    {
+      Entry *entry = entries[Rank(orders[i]->entry->position)];
+      entry->order = NewNode(entry);
+      SetRoot(m_orders, Merge(m_orders, entry->order));
+    }
+  }
+
+  Node *m_positions; ///< root of the tree in position sequence
+  Node *m_orders;    ///< root of the tree in order sequence
+  unsigned int m_seed;
+};
@@ -116,3 +116,101 @@ bool CJSONVariantWriter::InternalWrite(yajl_gen g, const CVariant &value)
 
   return success;
 }
+
+CJSONStreamWriter::CJSONStreamWriter(IJSONStreamOutput &output, bool compact, size_t chunkSize /* = JSON_STREAM_CHUNK_SIZE */)
+  : m_output(output), m_chunkSize(chunkSize), m_failed(false)
+{
+#if YAJL_MAJOR == 2
+  m_g = yajl_gen_alloc(NULL);
+  yajl_gen_config(m_g, yajl_gen_beautify, compact ? 0 : 1);
+  yajl_gen_config(m_g, yajl_gen_indent_string, "\t");
+#else
+  yajl_gen_config conf = { compact ? 0 : 1, "\t" };
+  m_g = yajl_gen_alloc(&conf, NULL);
+#endif
+}
+
+CJSONStreamWriter::~CJSONStreamWriter()
+{
+  Flush();
+  yajl_gen_free(m_g);
+}
+
+bool CJSONStreamWriter::Write(const CVariant &value)
+{
+  // Set locale to classic ("C") to ensure valid JSON numbers, only while writing them as
+  // the writer may live for as long as the output takes and the locale is the process'
+  std::string currentLocale = setlocale(LC_NUMERIC, NULL);
+  setlocale(LC_NUMERIC, "C");
+  bool success = CJSONVariantWriter::InternalWrite(m_g, value);
+  setlocale(LC_NUMERIC, currentLocale.c_str());
+
+  return Generated(success);
+}
+
+bool CJSONStreamWriter::OpenObject()
+{
+  return Generated(yajl_gen_status_ok == yajl_gen_map_open(m_g));
+}
+
+bool CJSONStreamWriter::Key(const std::string &key)
+{
+#if YAJL_MAJOR == 2
+  return Generated(yajl_gen_status_ok == yajl_gen_string(m_g, (const unsigned char*)key.c_str(), (size_t)key.length()));
+#else
+  return Generated(yajl_gen_status_ok == yajl_gen_string(m_g, (const unsigned char*)key.c_str(), key.length()));
+#endif
+}
+
+bool CJSONStreamWriter::CloseObject()
+{
+  return Generated(yajl_gen_status_ok == yajl_gen_map_close(m_g));
+}
+
+bool CJSONStreamWriter::OpenArray()
+{
+  return Generated(yajl_gen_status_ok == yajl_gen_array_open(m_g));
+}
+
+bool CJSONStreamWriter::CloseArray()
+{
+  return Generated(yajl_gen_status_ok == yajl_gen_array_close(m_g));
+}
+
+bool CJSONStreamWriter::Flush()
+{
+  const unsigned char * buffer;
+#if YAJL_MAJOR == 2
+  size_t length;
+#else
+  unsigned int length;
+#endif
+  yajl_gen_get_buf(m_g, &buffer, &length);
+  if (length == 0 || m_failed)
+    return !m_failed;
+
+  // once the output fails there is no point generating any more of the document
+  if (!m_output.Write((const char *)buffer, length))
+    m_failed = true;
+  yajl_gen_clear(m_g);
+  return !m_failed;
+}
+
+bool CJSONStreamWriter::Generated(bool success)
+{
+  if (!success)
+    m_failed = true;
+  if (m_failed)
+    return false;
+
+  const unsigned char * buffer;
+#if YAJL_MAJOR == 2
+  size_t length;
+#else
+  unsigned int length;
+#endif
+  yajl_gen_get_buf(m_g, &buffer, &length);
+  if (length >= m_chunkSize)
+    return Flush();
+  return true;
+}
@@ -8,10 +8,57 @@
 #include <yajl/yajl_version.h>
 #endif
 
+#define JSON_STREAM_CHUNK_SIZE 16384
+
 class CJSONVariantWriter
 {
 public:
   static std::string Write(const CVariant &value, bool compact);
 private:
+  friend class CJSONStreamWriter;
   static bool InternalWrite(yajl_gen g, const CVariant &value);
 };
+
+/*!
+ \brief Receives the output of a CJSONStreamWriter, a chunk at a time.
+ */
+class IJSONStreamOutput
+{
+public:
+  virtual ~IJSONStreamOutput() {}
+  virtual bool Write(const char *data, size_t length) = 0;
+};
+
+/*!
+ \brief Writes JSON to an output while it is generated.
+
+ Where CJSONVariantWriter needs the whole document as a CVariant and returns all of it at once,
+ this writes values (or the parts of objects and arrays) one at a time, and hands the output on
+ whenever about a chunk of it has built up. Large documents can then be written without ever
+ being held in memory, and their first chunk goes out before the rest is generated.
+ */
+class CJSONStreamWriter
+{
+public:
+  CJSONStreamWriter(IJSONStreamOutput &output, bool compact, size_t chunkSize = JSON_STREAM_CHUNK_SIZE);
+  ~CJSONStreamWriter();
+
+  bool Write(const CVariant &value);
+  bool OpenObject();
+  bool Key(const std::string &key);
+  bool CloseObject();
+  bool OpenArray();
+  bool CloseArray();
+
+  /*! \brief Hand whatever has been generated so far to the output.
+   */
+  bool Flush();
+
+private:
+  bool Generated(bool success);
+
+  yajl_gen m_g;
+  IJSONStreamOutput &m_output;
+  size_t m_chunkSize;
+  bool m_failed;
+};
@@ -121,6 +121,18 @@ public:
    */
   virtual const char *GetType() const { return ""; };
 
+  /*!
+   \brief Function that returns the worker the job should run on.
+
+   CJob subclasses may optionally implement this function so that jobs sharing state that
+   is costly to move between threads (such as a database connection) always run on the same
+   worker thread, one after another. Jobs with no affinity run on whichever worker is free.
+
+   \return 0 for no affinity, else jobs returning the same value share a worker.
+   \sa CJobManager
+   */
+  virtual unsigned int GetAffinity() const { return 0; };
+
   virtual bool operator==(const CJob* job) const
   {
     return false;
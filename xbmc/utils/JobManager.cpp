@@ -2,6 +2,7 @@
 
 #include "JobManager.h"
 #include <algorithm>
+#include "threads/Atomics.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 
@@ -14,9 +15,10 @@ bool CJob::ShouldCancel(unsigned int progress, unsigned int total) const
   return false;
 }
 
-CJobWorker::CJobWorker(CJobManager *manager) : CThread("Jobworker")
+CJobWorker::CJobWorker(CJobManager *manager, unsigned int slot) : CThread("Jobworker")
 {
   m_jobManager = manager;
+  m_slot = slot;
   Create(true); // start work immediately, and kill ourselves when we're done
 }
 
@@ -119,40 +121,84 @@ void CJobQueue::CancelJobs()
   m_processing.clear();
 }
 
+// Counts a job of a priority as processing when it is taken off a queue, if there are
+// workers to spare for the priority. Only jobs in hand are counted, so a worker
+// never fails to start a job because of one that another worker didn't get.
+class CWorkerReservation
+{
+public:
+  CWorkerReservation(volatile long *processing, long maxWorkers) : m_processing(processing), m_maxWorkers(maxWorkers) {}
+  bool operator()() const
+  {
+    long processing;
+    while ((processing = *m_processing) < m_maxWorkers)
+    {
+      if (cas(m_processing, processing, processing + 1) == processing)
+        return true;
+    }
+    return false;
+  }
+private:
+  volatile long *m_processing;
+  long m_maxWorkers;
+};
+
 CJobManager &CJobManager::GetInstance()
 {
   static CJobManager sJobManager;
   return sJobManager;
 }
 
-CJobManager::CJobManager()
+CJobManager::CJobManager() : m_queue(MAX_WORKERS, CJob::PRIORITY_HIGH + 1)
 {
   m_jobCounter = 0;
+  m_processing = 0;
+  m_nextSlot = 0;
   m_running = true;
 }
 
 void CJobManager::CancelJobs()
 {
-  CSingleLock lock(m_section);
   m_running = false;
 
   // clear any pending jobs
-  for (unsigned int priority = CJob::PRIORITY_LOW; priority <= CJob::PRIORITY_HIGH; ++priority)
+  vector<CWorkItem*> pending;
+  m_queue.Drain(pending);
+  for (vector<CWorkItem*>::iterator i = pending.begin(); i != pending.end(); ++i)
   {
-    for_each(m_jobQueue[priority].begin(), m_jobQueue[priority].end(), mem_fun_ref(&CWorkItem::FreeJob));
-    m_jobQueue[priority].clear();
+    CWorkItem *item = *i;
+    {
+      CJobShard &shard = GetShard(item->m_id);
+      CSingleLock lock(shard.m_section);
+      shard.m_items.erase(item->m_id);
+    }
+    item->FreeJob();
+    delete item;
   }
 
   // cancel any callbacks on jobs still processing
-  for_each(m_processing.begin(), m_processing.end(), mem_fun_ref(&CWorkItem::Cancel));
+  for (unsigned int i = 0; i < JOB_SHARDS; i++)
+  {
+    CSingleLock lock(m_shards[i].m_section);
+    for (map<unsigned int, CWorkItem*>::iterator j = m_shards[i].m_items.begin(); j != m_shards[i].m_items.end(); ++j)
+      j->second->Cancel();
+  }
 
   // tell our workers to finish
-  while (m_workers.size())
+  while (true)
   {
-    lock.Leave();
-    m_jobEvent.Set();
-    Sleep(0); // yield after setting the event to give the workers some time to die
-    lock.Enter();
+    bool workers = false;
+    for (unsigned int i = 0; i < MAX_WORKERS; i++)
+    {
+      if (m_slots[i].m_worker)
+      {
+        workers = true;
+        m_slots[i].m_wake.Set();
+      }
+    }
+    if (!workers)
+      break;
+    Sleep(0); // yield after setting the events to give the workers some time to die
   }
 }
 
@@ -162,69 +208,113 @@ CJobManager::~CJobManager()
 
 unsigned int CJobManager::AddJob(CJob *job, IJobCallback *callback, CJob::PRIORITY priority)
 {
-  CSingleLock lock(m_section);
-
   // create a work item for this job
-  CWorkItem work(job, m_jobCounter++, callback);
-  m_jobQueue[priority].push_back(work);
+  CWorkItem *work = new CWorkItem(job, AtomicIncrement(&m_jobCounter) - 1, callback, priority);
+  unsigned int affinity = job->GetAffinity();
+  work->m_slot = affinity ? affinity % MAX_WORKERS : ChooseSlot(priority);
 
-  StartWorkers(priority);
-  return work.m_id;
+  // the work item may be done and gone as soon as it is queued
+  unsigned int id = work->m_id;
+  unsigned int slot = work->m_slot;
+  {
+    CJobShard &shard = GetShard(id);
+    CSingleLock lock(shard.m_section);
+    shard.m_items[id] = work;
+  }
+  m_queue.Push(slot, priority, work, affinity != 0);
+  WakeWorker(slot);
+  return id;
 }
 
 void CJobManager::CancelJob(unsigned int jobID)
 {
-  CSingleLock lock(m_section);
+  CJobShard &shard = GetShard(jobID);
+  CSingleLock lock(shard.m_section);
+  map<unsigned int, CWorkItem*>::iterator i = shard.m_items.find(jobID);
+  if (i == shard.m_items.end())
+    return;
 
   // check whether we have this job in the queue
-  for (unsigned int priority = CJob::PRIORITY_LOW; priority <= CJob::PRIORITY_HIGH; ++priority)
+  CWorkItem *item = i->second;
+  if (m_queue.Remove(item->m_slot, item))
   {
-    JobQueue::iterator i = find(m_jobQueue[priority].begin(), m_jobQueue[priority].end(), jobID);
-    if (i != m_jobQueue[priority].end())
-    {
-      delete i->m_job;
-      m_jobQueue[priority].erase(i);
-      return;
-    }
+    shard.m_items.erase(i);
+    lock.Leave();
+    item->FreeJob();
+    delete item;
   }
-  // or if we're processing it
-  Processing::iterator it = find(m_processing.begin(), m_processing.end(), jobID);
-  if (it != m_processing.end())
-    it->m_callback = NULL; // job is in progress, so only thing to do is to remove callback
+  else // job is in progress, so only thing to do is to remove callback
+    item->Cancel();
 }
 
-void CJobManager::StartWorkers(CJob::PRIORITY priority)
+unsigned int CJobManager::ChooseSlot(CJob::PRIORITY priority)
 {
-  CSingleLock lock(m_section);
+  // do we have any sleeping threads?
+  int stopped = -1;
+  for (unsigned int i = 0; i < MAX_WORKERS; i++)
+  {
+    const CWorkerSlot &slot = m_slots[i];
+    if (!slot.m_worker)
+    {
+      if (stopped < 0)
+        stopped = i;
+    }
+    else if (!slot.m_current && m_queue.Empty(i))
+      return i;
+  }
 
-  // check how many free threads we have
-  if (m_processing.size() >= GetMaxWorkers(priority))
-    return;
+  // everyone is busy - we need more workers, if there are threads to spare for the priority
+  if (stopped >= 0 && m_processing < (long)GetMaxWorkers(priority))
+    return stopped;
 
-  // do we have any sleeping threads?
-  if (m_processing.size() < m_workers.size())
+  // queue behind a busy worker, whoever is done first takes the job
+  for (unsigned int i = 0; i < MAX_WORKERS; i++)
   {
-    m_jobEvent.Set();
-    return;
+    unsigned int slot = (unsigned long)AtomicIncrement(&m_nextSlot) % MAX_WORKERS;
+    if (m_slots[slot].m_worker)
+      return slot;
   }
+  return stopped >= 0 ? stopped : 0;
+}
 
-  // everyone is busy - we need more workers
-  m_workers.push_back(new CJobWorker(this));
+void CJobManager::WakeWorker(unsigned int slot)
+{
+  CWorkerSlot &worker = m_slots[slot];
+  CSingleLock lock(worker.m_section);
+  if (worker.m_worker)
+    worker.m_wake.Set();
+  else
+    worker.m_worker = new CJobWorker(this, slot);
 }
 
-CJob *CJobManager::PopJob()
+void CJobManager::WakeIdleWorker(unsigned int except)
+{
+  for (unsigned int i = 0; i < MAX_WORKERS; i++)
+  {
+    if (i != except && m_slots[i].m_worker && !m_slots[i].m_current)
+    {
+      m_slots[i].m_wake.Set();
+      return;
+    }
+  }
+}
+
+CJobManager::CWorkItem *CJobManager::PopJob(unsigned int slot)
 {
-  CSingleLock lock(m_section);
   for (int priority = CJob::PRIORITY_HIGH; priority >= CJob::PRIORITY_LOW; --priority)
   {
-    if (m_jobQueue[priority].size() && m_processing.size() < GetMaxWorkers(CJob::PRIORITY(priority)))
+    CWorkItem *item;
+    CWorkerReservation reserve(&m_processing, GetMaxWorkers(CJob::PRIORITY(priority)));
+    if (m_queue.Pop(slot, priority, item, reserve))
     {
-      CWorkItem job = m_jobQueue[priority].front();
-      m_jobQueue[priority].pop_front();
-      // add to the processing vector
-      m_processing.push_back(job);
-      job.m_job->m_callback = this;
-      return job.m_job;
+      CWorkerSlot &worker = m_slots[slot];
+      worker.m_current = item;
+      worker.m_currentJob = item->m_job;
+      item->m_job->m_callback = this;
+      // more jobs are waiting on us, have an idle worker steal them
+      if (m_queue.Stealable(slot) > 0)
+        WakeIdleWorker(slot);
+      return item;
     }
   }
   return NULL;
@@ -232,42 +322,55 @@ CJob *CJobManager::PopJob()
 
 CJob *CJobManager::GetNextJob(const CJobWorker *worker)
 {
-  CSingleLock lock(m_section);
-  while (m_running)
+  unsigned int slot = worker->GetSlot();
+  CWorkerSlot &us = m_slots[slot];
+  while (true)
   {
-    // grab a job off the queue if we have one
-    CJob *job = PopJob();
-    if (job)
-      return job;
+    // grab a job off the queues if we have one
+    CWorkItem *item = PopJob(slot);
+    if (item)
+      return item->m_job;
     // no jobs are left - sleep for 30 seconds to allow new jobs to come in
-    lock.Leave();
-    bool newJob = m_jobEvent.WaitMSec(30000);
-    lock.Enter();
-    if (!newJob)
-      break;
+    if (m_running && us.m_wake.WaitMSec(30000))
+      continue;
+
+    // ensure no jobs have come in during the period after timeout and before we held the lock,
+    // and stay for jobs queued on us that are waiting for a worker to spare
+    CSingleLock lock(us.m_section);
+    item = PopJob(slot);
+    if (item)
+      return item->m_job;
+    if (!m_running || m_queue.Empty(slot))
+    {
+      // have no jobs
+      if (us.m_worker == worker)
+        us.m_worker = NULL;
+      return NULL;
+    }
   }
-  // ensure no jobs have come in during the period after
-  // timeout and before we held the lock
-  CJob *job = PopJob();
-  if (job)
-    return job;
-  // have no jobs
-  RemoveWorker(worker);
-  return NULL;
+}
+
+int CJobManager::GetRunningSlot(const CJob *job) const
+{
+  for (unsigned int i = 0; i < MAX_WORKERS; i++)
+  {
+    if (m_slots[i].m_currentJob == job)
+      return i;
+  }
+  return -1;
 }
 
 bool CJobManager::OnJobProgress(unsigned int progress, unsigned int total, const CJob *job) const
 {
-  CSingleLock lock(m_section);
-  // find the job in the processing queue, and check whether it's cancelled (no callback)
-  Processing::const_iterator i = find(m_processing.begin(), m_processing.end(), job);
-  if (i != m_processing.end())
+  // find the job's worker, and check whether it's cancelled (no callback)
+  int slot = GetRunningSlot(job);
+  if (slot >= 0)
   {
-    CWorkItem item(*i);
-    lock.Leave(); // leave section prior to call
-    if (item.m_callback)
+    const CWorkItem *item = m_slots[slot].m_current;
+    IJobCallback *callback = item->m_callback;
+    if (callback)
     {
-      item.m_callback->OnJobProgress(item.m_id, progress, total, job);
+      callback->OnJobProgress(item->m_id, progress, total, job);
       return false;
     }
   }
@@ -276,43 +379,52 @@ bool CJobManager::OnJobProgress(unsigned int progress, unsigned int total, const
 
 void CJobManager::OnJobComplete(bool success, CJob *job)
 {
-  CSingleLock lock(m_section);
-  // remove the job from the processing queue
-  Processing::iterator i = find(m_processing.begin(), m_processing.end(), job);
-  if (i != m_processing.end())
+  int slot = GetRunningSlot(job);
+  if (slot < 0)
+    return;
+
+  // tell any listeners we're done with the job, then delete it
+  CWorkerSlot &worker = m_slots[slot];
+  CWorkItem *item = worker.m_current;
+  IJobCallback *callback = item->m_callback;
+  try
   {
-    // tell any listeners we're done with the job, then delete it
-    CWorkItem item(*i);
-    lock.Leave();
-    try
-    {
-      if (item.m_callback)
-        item.m_callback->OnJobComplete(item.m_id, success, item.m_job);
-    }
-    catch (...)
-    {
-      CLog::Log(LOGERROR, "%s error processing job %s", __FUNCTION__, item.m_job->GetType());
-    }
-    lock.Enter();
-    Processing::iterator j = find(m_processing.begin(), m_processing.end(), job);
-    if (j != m_processing.end())
-      m_processing.erase(j);
-    lock.Leave();
-    item.FreeJob();
+    if (callback)
+      callback->OnJobComplete(item->m_id, success, item->m_job);
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s error processing job %s", __FUNCTION__, item->m_job->GetType());
+  }
+  {
+    CJobShard &shard = GetShard(item->m_id);
+    CSingleLock lock(shard.m_section);
+    shard.m_items.erase(item->m_id);
+  }
+  worker.m_currentJob = NULL;
+  worker.m_current = NULL;
+  AtomicDecrement(&m_processing);
+  item->FreeJob();
+  delete item;
+
+  // a worker is spare now, wake those with jobs that were waiting for one
+  for (unsigned int i = 0; i < MAX_WORKERS; i++)
+  {
+    if (i != (unsigned int)slot && !m_slots[i].m_current && !m_queue.Empty(i))
+      WakeWorker(i);
   }
 }
 
 void CJobManager::RemoveWorker(const CJobWorker *worker)
 {
-  CSingleLock lock(m_section);
-  // remove our worker
-  Workers::iterator i = find(m_workers.begin(), m_workers.end(), worker);
-  if (i != m_workers.end())
-    m_workers.erase(i); // workers auto-delete
+  // remove our worker, unless it already has been
+  CWorkerSlot &slot = m_slots[worker->GetSlot()];
+  CSingleLock lock(slot.m_section);
+  if (slot.m_worker == worker)
+    slot.m_worker = NULL; // workers auto-delete
 }
 
 unsigned int CJobManager::GetMaxWorkers(CJob::PRIORITY priority) const
 {
-  static const unsigned int max_workers = 5;
-  return max_workers - (CJob::PRIORITY_HIGH - priority);
+  return MAX_WORKERS - (CJob::PRIORITY_HIGH - priority);
 }
@@ -1,24 +1,28 @@
 #pragma once
 
 
+#include <map>
 #include <queue>
 #include <vector>
 #include <string>
 #include "threads/CriticalSection.h"
 #include "threads/Thread.h"
 #include "Job.h"
+#include "WorkStealingQueue.h"
 
 class CJobManager;
 
 class CJobWorker : public CThread
 {
 public:
-  CJobWorker(CJobManager *manager);
+  CJobWorker(CJobManager *manager, unsigned int slot);
   virtual ~CJobWorker();
 
   void Process();
+  unsigned int GetSlot() const { return m_slot; };
 private:
   CJobManager  *m_jobManager;
+  unsigned int  m_slot;
 };
 
 /*!
@@ -130,6 +134,11 @@ private:
  priority levels.  Lower priority jobs are executed only if there are sufficient
  spare worker threads free to allow for higher priority jobs that may arise.
 
+ Each worker slot queues jobs of its own, a lane per priority, and idle workers steal the
+ oldest jobs of busy ones (see CWorkStealingQueue). Jobs with an affinity (CJob::GetAffinity())
+ always run on the same worker. Adding, cancelling and finishing a job take the lock of its
+ worker slot and of its shard of the job ids, no lock is shared by all jobs.
+
  \sa CJob and IJobCallback
  */
 class CJobManager
@@ -137,20 +146,14 @@ class CJobManager
   class CWorkItem
   {
   public:
-    CWorkItem(CJob *job, unsigned int id, IJobCallback *callback)
+    CWorkItem(CJob *job, unsigned int id, IJobCallback *callback, CJob::PRIORITY priority)
     {
       m_job = job;
       m_id = id;
       m_callback = callback;
+      m_priority = priority;
+      m_slot = 0;
     }
-    bool operator==(unsigned int jobID) const
-    {
-      return m_id == jobID;
-    };
-    bool operator==(const CJob *job) const
-    {
-      return m_job == job;
-    };
     void FreeJob()
     {
       delete m_job;
@@ -162,7 +165,29 @@ class CJobManager
     };
     CJob         *m_job;
     unsigned int  m_id;
-    IJobCallback *m_callback;
+    IJobCallback * volatile m_callback;
+    CJob::PRIORITY m_priority;
+    unsigned int  m_slot; ///< worker slot the job was queued on
+  };
+
+  /*! \brief A worker thread, started when jobs are queued for it and ended after idling. */
+  class CWorkerSlot
+  {
+  public:
+    CWorkerSlot() : m_worker(NULL), m_currentJob(NULL), m_current(NULL) {}
+    CCriticalSection     m_section; ///< guards m_worker against the worker ending
+    CEvent               m_wake;
+    CJobWorker * volatile m_worker;
+    CJob * volatile      m_currentJob;
+    CWorkItem * volatile m_current;
+  };
+
+  /*! \brief Part of the jobs by id, for cancelling them */
+  class CJobShard
+  {
+  public:
+    CCriticalSection m_section;
+    std::map<unsigned int, CWorkItem*> m_items;
   };
 
 public:
@@ -196,6 +221,11 @@ public:
    */
   void CancelJobs();
 
+  /*!
+   \brief The most worker threads that run jobs at once.
+   */
+  static const unsigned int MAX_WORKERS = 5;
+
 protected:
   friend class CJobWorker;
   friend class CJob;
@@ -234,26 +264,37 @@ private:
   CJobManager const& operator=(CJobManager const&);
   virtual ~CJobManager();
 
-  /*! \brief Pop a job off the job queue and add to the processing queue ready to process
+  /*! \brief Take the next job for a worker slot, from its own queue or stolen from another slot
    \return the job to process, NULL if no jobs are available
    */
-  CJob *PopJob();
+  CWorkItem *PopJob(unsigned int slot);
 
-  void StartWorkers(CJob::PRIORITY priority);
+  /*! \brief Choose the worker slot to queue a job on: an idle worker, else a new one while
+   workers are spare, else any of the busy ones.
+   */
+  unsigned int ChooseSlot(CJob::PRIORITY priority);
+
+  /*! \brief Wake the worker of a slot, starting it if it isn't running. */
+  void WakeWorker(unsigned int slot);
+
+  /*! \brief Wake a running worker other than the given one with nothing to do, to steal work. */
+  void WakeIdleWorker(unsigned int except);
+
+  /*! \brief The worker slot running the job, -1 if none is. */
+  int GetRunningSlot(const CJob *job) const;
+  CJobShard &GetShard(unsigned int jobID) { return m_shards[jobID % JOB_SHARDS]; };
   void RemoveWorker(const CJobWorker *worker);
   unsigned int GetMaxWorkers(CJob::PRIORITY priority) const;
 
-  unsigned int m_jobCounter;
+  static const unsigned int JOB_SHARDS = 16;
 
-  typedef std::deque<CWorkItem>    JobQueue;
-  typedef std::vector<CWorkItem>   Processing;
-  typedef std::vector<CJobWorker*> Workers;
+  volatile long m_jobCounter;
+  volatile long m_processing;
+  volatile long m_nextSlot;
 
-  JobQueue   m_jobQueue[CJob::PRIORITY_HIGH+1];
-  Processing m_processing;
-  Workers    m_workers;
+  CWorkStealingQueue<CWorkItem*> m_queue;
+  CWorkerSlot m_slots[MAX_WORKERS];
+  CJobShard   m_shards[JOB_SHARDS];
 
-  CCriticalSection m_section;
-  CEvent           m_jobEvent;
-  bool             m_running;
+  volatile bool m_running;
 };
@@ -0,0 +1,106 @@
+#pragma once
+
+
+#include "threads/Atomics.h"
+#include <limits.h>
+#include <stdint.h>
+
+/*!
+ \ingroup utils
+ \brief Latency histogram that can be added to from any thread without a lock.
+
+ Samples are in microseconds and counted in power of two buckets: bucket 0 counts samples of
+ 0us, bucket i those from 2^(i-1) up to 2^i us and the last bucket everything from about 4s
+ up. Adding a sample is an atomic increment of its bucket and of the count, plus a compare
+ and swap when it is the longest yet, so it is cheap enough for per-packet timing.
+
+ Percentiles are estimated from the buckets, interpolating within the bucket they fall in, so
+ they are accurate to within a factor of two. Reset() while samples are being added may lose
+ or keep some of them; the histogram is for telemetry, not accounting.
+ */
+class CLatencyHistogram
+{
+public:
+  static const int BUCKETS = 24;
+
+  CLatencyHistogram() { Reset(); }
+
+  void Add(int64_t us)
+  {
+    long sample = us <= 0 ? 0 : us > LONG_MAX ? LONG_MAX : (long)us;
+    int bucket = 0;
+    for (unsigned long bits = sample; bits && bucket < BUCKETS - 1; bits >>= 1)
+      bucket++;
+    AtomicIncrement(&m_buckets[bucket]);
+    AtomicIncrement(&m_count);
+    for (long max = m_max; sample > max; max = m_max)
+    {
+      if (cas(&m_max, max, sample) == max)
+        break;
+    }
+  }
+
+  void Reset()
+  {
+    for (int i = 0; i < BUCKETS; i++)
+      m_buckets[i] = 0;
+    m_count = 0;
+    m_max = 0;
+  }
+
+  /*! \brief Add the samples of another histogram, to report several as one. */
+  void Merge(const CLatencyHistogram &other)
+  {
+    for (int i = 0; i < BUCKETS; i++)
+      AtomicAdd(&m_buckets[i], other.m_buckets[i]);
+    AtomicAdd(&m_count, other.m_count);
+    long sample = other.m_max;
+    for (long max = m_max; sample > max; max = m_max)
+    {
+      if (cas(&m_max, max, sample) == max)
+        break;
+    }
+  }
+
+  long Count() const { return m_count; }
+  long Max() const { return m_max; }
+  long Bucket(int bucket) const { return m_buckets[bucket]; }
+
+  /*! \brief Estimate the latency not exceeded by a fraction of the samples.
+   \param fraction between 0 and 1, 0.99 for the 99th percentile.
+   \return the latency in us, 0 without samples.
+   */
+  double Percentile(double fraction) const
+  {
+    long buckets[BUCKETS];
+    long count = 0;
+    for (int i = 0; i < BUCKETS; i++)
+      count += buckets[i] = m_buckets[i];
+    if (count == 0)
+      return 0;
+
+    double rank = fraction * count;
+    double max = (double)m_max;
+    for (int i = 0; i < BUCKETS; i++)
+    {
+      if (buckets[i] == 0 || rank > buckets[i])
+      {
+        rank -= buckets[i];
+        continue;
+      }
+      double lower = i == 0 ? 0 : (double)(1L << (i - 1));
+      double upper = i == 0 ? 0 : i == BUCKETS - 1 ? max : (double)(1L << i);
+      if (upper > max)
+        upper = max;
+      if (lower > upper)
+        lower = upper;
+      return lower + (upper - lower) * rank / buckets[i];
+    }
+    return max;
+  }
+
+private:
+  volatile long m_buckets[BUCKETS];
+  volatile long m_count;
+  volatile long m_max;
+};
@@ -0,0 +1,108 @@
+#pragma once
+
+
+#include <map>
+#include <string>
+#include <vector>
+
+/*!
+ \ingroup utils
+ \brief Folder tree of a flat list of slash separated paths, such as the entry table of an archive.
+
+ Each folder keeps its children in the order they were first added, so listing a folder is
+ O(children) after one lookup of the folder, instead of splitting and comparing every path
+ of the list. Folders are created for the components leading to each path, and for paths
+ ending in a slash. Empty components ("a//b", a leading slash) are skipped.
+
+ Every node carries the value given to Add() for it; a folder carries the value of the first
+ path that created it.
+ */
+class CPathTree
+{
+public:
+  struct Node
+  {
+    std::string name;                    ///< the last component of the path
+    std::string path;                    ///< from the root, without leading or trailing slash
+    bool folder;
+    int value;
+    std::vector<unsigned int> children;  ///< node indices, in the order they were added
+  };
+
+  CPathTree() { Clear(); }
+
+  void Clear()
+  {
+    m_nodes.clear();
+    m_folders.clear();
+    Node root;
+    root.folder = true;
+    root.value = -1;
+    m_nodes.push_back(root);
+    m_folders[""] = 0;
+  }
+
+  void Add(const std::string &path, int value)
+  {
+    unsigned int parent = 0;
+    std::string::size_type start = path.find_first_not_of('/');
+    while (start != std::string::npos)
+    {
+      std::string::size_type end = path.find('/', start);
+      std::string::size_type next = end == std::string::npos ? end : path.find_first_not_of('/', end);
+      if (end == std::string::npos)
+      { // a file
+        unsigned int node = NewNode(parent, path.substr(start), false, value);
+        m_nodes[node].path = parent ? m_nodes[parent].path + "/" + m_nodes[node].name : m_nodes[node].name;
+        return;
+      }
+      parent = GetFolder(parent, path, start, end, value);
+      start = next;
+    }
+  }
+
+  /*! \brief Find a folder.
+   \param path the folder, leading and trailing slashes are ignored, "" is the root.
+   \return the folder node, NULL if there is no such folder.
+   */
+  const Node *FindFolder(const std::string &path) const
+  {
+    std::string::size_type start = path.find_first_not_of('/');
+    std::string::size_type end = path.find_last_not_of('/');
+    std::map<std::string, unsigned int>::const_iterator it = m_folders.find(start == std::string::npos ? std::string() : path.substr(start, end - start + 1));
+    return it == m_folders.end() ? NULL : &m_nodes[it->second];
+  }
+
+  const Node &GetNode(unsigned int node) const { return m_nodes[node]; }
+  unsigned int Size() const { return (unsigned int)m_nodes.size(); }
+
+private:
+  unsigned int NewNode(unsigned int parent, const std::string &name, bool folder, int value)
+  {
+    Node node;
+    node.name = name;
+    node.folder = folder;
+    node.value = value;
+    m_nodes.push_back(node);
+    unsigned int index = (unsigned int)m_nodes.size() - 1;
+    m_nodes[parent].children.push_back(index);
+    return index;
+  }
+
+  unsigned int GetFolder(unsigned int parent, const std::string &path, std::string::size_type start, std::string::size_type end, int value)
+  {
+    std::string name = path.substr(start, end - start);
+    std::string folderPath = parent ? m_nodes[parent].path + "/" + name : name;
+    std::map<std::string, unsigned int>::iterator it = m_folders.find(folderPath);
+    if (it != m_folders.end())
+      return it->second;
+
+    unsigned int node = NewNode(parent, name, true, value);
+    m_nodes[node].path = folderPath;
+    m_folders[folderPath] = node;
+    return node;
+  }
+
+  std::vector<Node> m_nodes;                     ///< node 0 is the root
+  std::map<std::string, unsigned int> m_folders; ///< folder path to node
+};
@@ -19,6 +19,8 @@ public:
                     m_updatePlayCount(updatePlayCount) {}
   virtual       ~CSaveFileStateJob() {}
   virtual bool  DoWork();
+  // played items are written to the databases one after another, on the same worker
+  virtual unsigned int GetAffinity() const { return 1; }
 };
 
 bool CSaveFileStateJob::DoWork()
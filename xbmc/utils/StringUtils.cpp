@@ -195,6 +195,53 @@ int StringUtils::DateStringToYYYYMMDD(const CStdString &dateString)
     return -1;
 }
 
+// base letter of each character in U+00C0 - U+00FF, or 0 if it has none
+static const char latin1Base[] = "aaaaaaaceeeeiiiidnooooo\0ouuuuy\0saaaaaaaceeeeiiiidnooooo\0ouuuuy\0y";
+
+void StringUtils::AlphaNumericSortKey(const wchar_t *label, std::string &key)
+{
+  key.clear();
+  key.reserve(wcslen(label) * 4 + 2);
+
+  const wchar_t *c = label;
+  while (*c)
+  {
+    if (*c >= L'0' && *c <= L'9')
+    { // numbers go in as their digit count and digits, so they order by value
+      const wchar_t *end = c;
+      while (*end >= L'0' && *end <= L'9' && end < c + 15) // compare only up to 15 digits
+        end++;
+      while (c < end - 1 && *c == L'0')
+        c++;
+      key += '\0';
+      key += '0';
+      key += (char)(end - c);
+      for (; c < end; c++)
+        key += (char)*c;
+      continue;
+    }
+    uint32_t weight = *c++;
+    if (weight >= L'A' && weight <= L'Z')
+      weight += L'a'-L'A';
+    else if (weight >= 0xc0 && weight <= 0xff && latin1Base[weight - 0xc0])
+      weight = latin1Base[weight - 0xc0];
+    else if (weight > 0xffff)
+      weight = 0xffff;
+    key += (char)(weight >> 8);
+    key += (char)(weight & 0xff);
+  }
+
+  // anything equal so far is ordered by the label as written (accents and case)
+  key += '\0';
+  key += '\0';
+  for (c = label; *c; c++)
+  {
+    uint32_t ch = std::min((uint32_t)*c, (uint32_t)0xffff);
+    key += (char)(ch >> 8);
+    key += (char)(ch & 0xff);
+  }
+}
+
 long StringUtils::TimeStringToSeconds(const CStdString &timeString)
 {
   if(timeString.Right(4).Equals(" min"))
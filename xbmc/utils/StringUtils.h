@@ -25,6 +25,13 @@ public:
   static int SplitString(const CStdString& input, const CStdString& delimiter, CStdStringArray &results, unsigned int iMaxStrings = 0);
   static int FindNumber(const CStdString& strInput, const CStdString &strFind);
   static int64_t AlphaNumericCompare(const wchar_t *left, const wchar_t *right);
+  /*! \brief build a binary key that orders labels like AlphaNumericCompare when compared bytewise
+   Numbers compare by value, case and latin accents are ignored, with the label as written breaking ties.
+   \param label the label to build the key for
+   \param key [out] the collation key
+   \sa AlphaNumericCompare
+   */
+  static void AlphaNumericSortKey(const wchar_t *label, std::string &key);
   static long TimeStringToSeconds(const CStdString &timeString);
   static void RemoveCRLF(CStdString& strLine);
 
@@ -557,6 +557,10 @@ bool URIUtils::IsInArchive(const CStdString &strFile)
 
 bool URIUtils::IsInPFC(const CStdString& strFile)
 {
+  // most paths aren't, and don't need parsing to tell
+  if (!strFile.Left(6).Equals("pfc://"))
+    return false;
+
   CURL url(strFile);
 
   return url.GetProtocol() == "pfc" && url.GetFileName() != "";
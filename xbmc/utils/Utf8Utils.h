@@ -0,0 +1,142 @@
+#pragma once
+
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/*!
+ \ingroup utils
+ \brief UTF-8 conversions for the common cases, without iconv.
+
+ Most strings passing through CCharsetConverter (labels, paths, tags) are ASCII or well formed
+ UTF-8. These convert them in place of iconv, and report anything else (malformed input,
+ surrogates, code points past U+10FFFF) so the caller can fall back to iconv and its handling
+ of bad input. ASCII runs are found a machine word at a time.
+
+ Output strings only need clear(), reserve() and push_back() of their character type, so
+ std::basic_string and CStdStr both do.
+ */
+class CUtf8Utils
+{
+public:
+  /*! \brief Length of the ASCII prefix of a buffer. */
+  static size_t AsciiLength(const char *buf, size_t len)
+  {
+    size_t i = 0;
+    for (; i + sizeof(uintptr_t) <= len; i += sizeof(uintptr_t))
+    {
+      uintptr_t word;
+      memcpy(&word, buf + i, sizeof(word));
+      if (word & HighBits())
+        break;
+    }
+    while (i < len && !(buf[i] & 0x80))
+      i++;
+    return i;
+  }
+
+  static bool IsAscii(const char *buf, size_t len) { return AsciiLength(buf, len) == len; }
+
+  /*! \brief Decode UTF-8 into UTF-32, or into UTF-16 for 2 byte characters.
+   \return false if the input is not well formed UTF-8, dest is undefined then.
+   */
+  template<class WSTRING>
+  static bool Decode(const char *buf, size_t len, WSTRING &dest)
+  {
+    dest.clear();
+    dest.reserve(len);
+    const unsigned char *s = (const unsigned char *)buf;
+    size_t i = 0;
+    while (i < len)
+    {
+      size_t ascii = AsciiLength(buf + i, len - i);
+      for (size_t end = i + ascii; i < end; i++)
+        dest.push_back(s[i]);
+      if (i == len)
+        break;
+
+      uint32_t c = s[i];
+      int trailing;
+      uint32_t min;
+      if ((c & 0xe0) == 0xc0)      { c &= 0x1f; trailing = 1; min = 0x80; }
+      else if ((c & 0xf0) == 0xe0) { c &= 0x0f; trailing = 2; min = 0x800; }
+      else if ((c & 0xf8) == 0xf0) { c &= 0x07; trailing = 3; min = 0x10000; }
+      else
+        return false;
+      if (len - i <= (size_t)trailing)
+        return false;
+      for (int j = 1; j <= trailing; j++)
+      {
+        if ((s[i + j] & 0xc0) != 0x80)
+          return false;
+        c = (c << 6) | (s[i + j] & 0x3f);
+      }
+      if (c < min || c > 0x10ffff || (c >= 0xd800 && c <= 0xdfff))
+        return false;
+      i += trailing + 1;
+
+      if (sizeof(dest[0]) == 2 && c >= 0x10000)
+      {
+        c -= 0x10000;
+        dest.push_back(0xd800 + (c >> 10));
+        dest.push_back(0xdc00 + (c & 0x3ff));
+      }
+      else
+        dest.push_back(c);
+    }
+    return true;
+  }
+
+  /*! \brief Encode UTF-32, or UTF-16 for 2 byte characters, as UTF-8.
+   \return false for surrogates that don't pair up and code points past U+10FFFF, dest is
+   undefined then.
+   */
+  template<class CHAR, class STRING>
+  static bool Encode(const CHAR *buf, size_t len, STRING &dest)
+  {
+    dest.clear();
+    dest.reserve(len);
+    for (size_t i = 0; i < len; i++)
+    {
+      uint32_t c = (uint32_t)buf[i];
+      if (sizeof(CHAR) == 2)
+        c &= 0xffff;
+      if (c < 0x80)
+      {
+        dest.push_back((char)c);
+        continue;
+      }
+      if (c >= 0xd800 && c <= 0xdfff)
+      {
+        if (sizeof(CHAR) != 2 || c >= 0xdc00 || i + 1 == len)
+          return false;
+        uint32_t low = (uint32_t)buf[i + 1] & 0xffff;
+        if (low < 0xdc00 || low > 0xdfff)
+          return false;
+        c = 0x10000 + ((c - 0xd800) << 10) + (low - 0xdc00);
+        i++;
+      }
+      if (c < 0x800)
+        dest.push_back((char)(0xc0 | (c >> 6)));
+      else if (c < 0x10000)
+      {
+        dest.push_back((char)(0xe0 | (c >> 12)));
+        dest.push_back((char)(0x80 | ((c >> 6) & 0x3f)));
+      }
+      else if (c <= 0x10ffff)
+      {
+        dest.push_back((char)(0xf0 | (c >> 18)));
+        dest.push_back((char)(0x80 | ((c >> 12) & 0x3f)));
+        dest.push_back((char)(0x80 | ((c >> 6) & 0x3f)));
+      }
+      else
+        return false;
+      dest.push_back((char)(0x80 | (c & 0x3f)));
+    }
+    return true;
+  }
+
+private:
+  static uintptr_t HighBits() { return (uintptr_t)-1 / 0xff * 0x80; }
+};
@@ -0,0 +1,196 @@
+#pragma once
+
+
+#include "threads/Atomics.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+/*!
+ \ingroup jobs
+ \brief Queues of work, one per worker, that idle workers take from.
+
+ Each worker (slot) has its own queues, one per lane (such as a priority), behind a lock of its
+ own. A worker takes from its own queue first and otherwise steals the oldest item of another
+ worker's queue in the same lane, so workers only contend when they share work. Pinned items
+ stay with their slot and are never stolen.
+
+ \sa CJobManager
+ */
+template<class T>
+class CWorkStealingQueue
+{
+public:
+  CWorkStealingQueue(unsigned int slots, unsigned int lanes) : m_slotCount(slots), m_laneCount(lanes)
+  {
+    m_slots = new CSlot[slots];
+    for (unsigned int i = 0; i < slots; i++)
+    {
+      m_slots[i].pinned.resize(lanes);
+      m_slots[i].shared.resize(lanes);
+    }
+  }
+
+  ~CWorkStealingQueue() { delete[] m_slots; }
+
+  unsigned int Slots() const { return m_slotCount; }
+
+  void Push(unsigned int slot, unsigned int lane, const T &item, bool pinned = false)
+  {
+    CSlot &queue = m_slots[slot];
+    CSingleLock lock(queue.section);
+    if (pinned)
+      queue.pinned[lane].push_back(item);
+    else
+    {
+      queue.shared[lane].push_back(item);
+      AtomicIncrement(&queue.stealable);
+    }
+  }
+
+  /*! \brief Take the oldest item of a lane, the slot's own items first.
+   \return false if there is nothing in the lane the slot may take.
+   */
+  bool Pop(unsigned int slot, unsigned int lane, T &item)
+  {
+    return Pop(slot, lane, item, AcceptAny());
+  }
+
+  /*! \brief Take the oldest item of a lane, if accept() agrees once one is found.
+   accept() is called with the queue locked, so whatever it claims (such as a worker to run the
+   item on) is only claimed for an item that is taken.
+   \return false if there is nothing in the lane the slot may take, or accept() refused it.
+   */
+  template<class ACCEPT>
+  bool Pop(unsigned int slot, unsigned int lane, T &item, const ACCEPT &accept)
+  {
+    {
+      CSlot &queue = m_slots[slot];
+      CSingleLock lock(queue.section);
+      if (!queue.pinned[lane].empty())
+        return accept() && PopFront(queue.pinned[lane], item);
+      if (!queue.shared[lane].empty())
+      {
+        if (!accept())
+          return false;
+        PopFront(queue.shared[lane], item);
+        AtomicDecrement(&queue.stealable);
+        return true;
+      }
+    }
+    for (unsigned int i = 1; i < m_slotCount; i++)
+    {
+      CSlot &victim = m_slots[(slot + i) % m_slotCount];
+      if (victim.stealable <= 0)
+        continue; // nothing to steal, don't take its lock
+      CSingleLock lock(victim.section);
+      if (!victim.shared[lane].empty())
+      {
+        if (!accept())
+          return false;
+        PopFront(victim.shared[lane], item);
+        AtomicDecrement(&victim.stealable);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /*! \brief Remove an item still queued on the slot it was pushed to.
+   \return false if it has been taken already.
+   */
+  bool Remove(unsigned int slot, const T &item)
+  {
+    CSlot &queue = m_slots[slot];
+    CSingleLock lock(queue.section);
+    for (unsigned int lane = 0; lane < m_laneCount; lane++)
+    {
+      if (Erase(queue.pinned[lane], item))
+        return true;
+      if (Erase(queue.shared[lane], item))
+      {
+        AtomicDecrement(&queue.stealable);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /*! \brief Whether nothing is queued on the slot. */
+  bool Empty(unsigned int slot) const
+  {
+    CSlot &queue = m_slots[slot];
+    CSingleLock lock(queue.section);
+    for (unsigned int lane = 0; lane < m_laneCount; lane++)
+    {
+      if (!queue.pinned[lane].empty() || !queue.shared[lane].empty())
+        return false;
+    }
+    return true;
+  }
+
+  /*! \brief Number of items queued on the slot that other slots may take. */
+  long Stealable(unsigned int slot) const { return m_slots[slot].stealable; }
+
+  /*! \brief Take everything queued on all slots. */
+  void Drain(std::vector<T> &items)
+  {
+    for (unsigned int slot = 0; slot < m_slotCount; slot++)
+    {
+      CSlot &queue = m_slots[slot];
+      CSingleLock lock(queue.section);
+      for (unsigned int lane = 0; lane < m_laneCount; lane++)
+      {
+        items.insert(items.end(), queue.pinned[lane].begin(), queue.pinned[lane].end());
+        items.insert(items.end(), queue.shared[lane].begin(), queue.shared[lane].end());
+        queue.pinned[lane].clear();
+        queue.shared[lane].clear();
+      }
+      queue.stealable = 0;
+    }
+  }
+
+private:
+  CWorkStealingQueue(const CWorkStealingQueue&);
+  CWorkStealingQueue& operator=(const CWorkStealingQueue&);
+
+  class CSlot
+  {
+  public:
+    CSlot() : stealable(0) {}
+    mutable CCriticalSection  section;
+    std::vector< std::deque<T> > pinned;
+    std::vector< std::deque<T> > shared;
+    volatile long stealable;
+  };
+
+  struct AcceptAny
+  {
+    bool operator()() const { return true; }
+  };
+
+  static bool PopFront(std::deque<T> &queue, T &item)
+  {
+    if (queue.empty())
+      return false;
+    item = queue.front();
+    queue.pop_front();
+    return true;
+  }
+
+  static bool Erase(std::deque<T> &queue, const T &item)
+  {
+    typename std::deque<T>::iterator it = std::find(queue.begin(), queue.end(), item);
+    if (it == queue.end())
+      return false;
+    queue.erase(it);
+    return true;
+  }
+
+  CSlot *m_slots;
+  unsigned int m_slotCount;
+  unsigned int m_laneCount;
+};
@@ -0,0 +1,127 @@
+
+
+#include "jukebox/CoinDevice.h"
+
+#include <boost/test/unit_test.hpp>
+#include <vector>
+#include <stdio.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+class CPulseRecorder : public ICoinPulseHandler
+{
+public:
+  virtual void OnPulse(ECoinEvent type, int64_t timestamp)
+  {
+    types.push_back(type);
+    timestamps.push_back(timestamp);
+  }
+
+  std::vector<ECoinEvent> types;
+  std::vector<int64_t> timestamps;
+};
+
+BOOST_AUTO_TEST_CASE(TestCoinDeviceLoopback)
+{
+  CPulseRecorder pulses;
+  CoinDevice device(pulses);
+  BOOST_CHECK(!device.Inject(COIN_EVENT_INSERT));
+
+  BOOST_REQUIRE(device.Open("loopback", -1, -1, 100));
+  int64_t before = CoinDevice::Now();
+  BOOST_CHECK(device.Inject(COIN_EVENT_INSERT));
+  BOOST_CHECK_EQUAL(COIN_DEVICE_OK, device.Poll());
+  BOOST_REQUIRE_EQUAL(1u, pulses.types.size());
+  BOOST_CHECK_EQUAL(COIN_EVENT_INSERT, pulses.types[0]);
+  BOOST_CHECK(pulses.timestamps[0] >= before);
+  BOOST_CHECK(pulses.timestamps[0] <= CoinDevice::Now());
+
+  // an interruption wakes the poll without a pulse
+  BOOST_CHECK(device.Interrupt());
+  BOOST_CHECK_EQUAL(COIN_DEVICE_OK, device.Poll());
+  BOOST_CHECK_EQUAL(1u, pulses.types.size());
+
+  device.Close();
+  BOOST_CHECK(!device.IsOpen());
+  BOOST_CHECK(!device.Inject(COIN_EVENT_INSERT));
+}
+
+BOOST_AUTO_TEST_CASE(TestCoinDeviceDebounce)
+{
+  CPulseRecorder pulses;
+  CoinDevice device(pulses);
+  BOOST_REQUIRE(device.Open("loopback", -1, -1, 10000));
+
+  // pulses read together are one pulse and its bounces
+  device.Inject(COIN_EVENT_INSERT);
+  device.Inject(COIN_EVENT_INSERT);
+  device.Inject(COIN_EVENT_INSERT);
+  device.Poll();
+  BOOST_CHECK_EQUAL(1u, pulses.types.size());
+  BOOST_CHECK_EQUAL(2u, device.GetBounces());
+
+  // and so is one read within the debounce time
+  device.Inject(COIN_EVENT_INSERT);
+  device.Poll();
+  BOOST_CHECK_EQUAL(1u, pulses.types.size());
+  BOOST_CHECK_EQUAL(3u, device.GetBounces());
+
+  // each kind of pulse is debounced on its own
+  device.Inject(COIN_EVENT_REMOVE);
+  device.Poll();
+  BOOST_REQUIRE_EQUAL(2u, pulses.types.size());
+  BOOST_CHECK_EQUAL(COIN_EVENT_REMOVE, pulses.types[1]);
+  BOOST_CHECK_EQUAL(3u, device.GetBounces());
+
+  // opening again starts over
+  BOOST_REQUIRE(device.Open("loopback", -1, -1, 10000));
+  BOOST_CHECK_EQUAL(0u, device.GetBounces());
+  device.Inject(COIN_EVENT_INSERT);
+  device.Poll();
+  BOOST_CHECK_EQUAL(3u, pulses.types.size());
+}
+
+BOOST_AUTO_TEST_CASE(TestCoinDeviceDebounceTime)
+{
+  CPulseRecorder pulses;
+  CoinDevice device(pulses);
+  BOOST_REQUIRE(device.Open("loopback", -1, -1, 20));
+
+  device.Inject(COIN_EVENT_INSERT);
+  device.Poll();
+  usleep(40000);
+  device.Inject(COIN_EVENT_INSERT);
+  device.Poll();
+  BOOST_CHECK_EQUAL(2u, pulses.types.size());
+  BOOST_CHECK_EQUAL(0u, device.GetBounces());
+  BOOST_CHECK(pulses.timestamps[1] - pulses.timestamps[0] >= 40000);
+}
+
+BOOST_AUTO_TEST_CASE(TestCoinDeviceFifo)
+{
+  char path[64];
+  snprintf(path, sizeof(path), "/tmp/TestCoinDevice.%i", (int)getpid());
+  unlink(path);
+  BOOST_REQUIRE_EQUAL(0, mkfifo(path, 0600));
+  // held open, so the fifo has a writer when the device is opened
+  int writer = open(path, O_RDWR | O_NONBLOCK);
+  BOOST_REQUIRE(writer >= 0);
+
+  CPulseRecorder pulses;
+  CoinDevice device(pulses);
+  BOOST_REQUIRE(device.Open(path, 'i', 'r', 10000));
+
+  // bytes are messages, counted as they come
+  BOOST_REQUIRE_EQUAL(4, write(writer, "ii?r", 4));
+  BOOST_CHECK_EQUAL(COIN_DEVICE_OK, device.Poll());
+  BOOST_REQUIRE_EQUAL(3u, pulses.types.size());
+  BOOST_CHECK_EQUAL(COIN_EVENT_INSERT, pulses.types[0]);
+  BOOST_CHECK_EQUAL(COIN_EVENT_INSERT, pulses.types[1]);
+  BOOST_CHECK_EQUAL(COIN_EVENT_REMOVE, pulses.types[2]);
+  BOOST_CHECK_EQUAL(0u, device.GetBounces());
+
+  device.Close();
+  close(writer);
+  unlink(path);
+}
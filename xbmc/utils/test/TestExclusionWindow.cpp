@@ -0,0 +1,62 @@
+
+
+#include "utils/ExclusionWindow.h"
+
+#include <boost/test/unit_test.hpp>
+#include <stdio.h>
+
+BOOST_AUTO_TEST_CASE(TestExclusionWindowCount)
+{
+  CExclusionWindow window(3, 0);
+  window.Add("a", 0);
+  window.Add("b", 0);
+  window.Add("a", 0);
+  BOOST_CHECK(window.Contains("a", 0));
+  BOOST_CHECK(window.Contains("b", 0));
+  BOOST_CHECK(!window.Contains("c", 0));
+
+  // empty keys count as songs, but are never excluded
+  window.Add("", 0);
+  BOOST_CHECK(!window.Contains("", 0));
+  BOOST_CHECK(window.Contains("a", 0)); // the second "a" is still in
+  window.Add("c", 0);
+  BOOST_CHECK(!window.Contains("b", 0));
+  BOOST_CHECK(window.Contains("a", 0));
+  window.Add("d", 0);
+  BOOST_CHECK(!window.Contains("a", 0));
+  BOOST_CHECK(window.Contains("c", 0));
+  BOOST_CHECK_EQUAL(3u, window.Size());
+}
+
+BOOST_AUTO_TEST_CASE(TestExclusionWindowTime)
+{
+  // a track within 2 songs or an hour, whichever is longer
+  CExclusionWindow window(2, 3600);
+  window.Add("a", 1000);
+  window.Add("b", 1010);
+  window.Add("c", 1020);
+  BOOST_CHECK(window.Contains("a", 1030));
+  BOOST_CHECK(window.Contains("a", 4599));
+  BOOST_CHECK(!window.Contains("a", 4600));
+  BOOST_CHECK(window.Contains("b", 10000)); // still one of the last 2
+  BOOST_CHECK_EQUAL(2u, window.Size());
+
+  CExclusionWindow disabled;
+  disabled.Add("a", 0);
+  BOOST_CHECK(!disabled.Contains("a", 0));
+  BOOST_CHECK_EQUAL(0u, disabled.Size());
+}
+
+BOOST_AUTO_TEST_CASE(TestExclusionWindowBounded)
+{
+  CExclusionWindow window(0, 3600);
+  char key[16];
+  for (unsigned int i = 0; i < CExclusionWindow::MAX_ENTRIES + 10; i++)
+  {
+    sprintf(key, "%u", i);
+    window.Add(key, 0);
+  }
+  BOOST_CHECK_EQUAL((size_t)CExclusionWindow::MAX_ENTRIES, window.Size());
+  BOOST_CHECK(!window.Contains("9", 0));
+  BOOST_CHECK(window.Contains("10", 0));
+}
@@ -0,0 +1,79 @@
+
+
+#include "utils/ExtensionSet.h"
+
+#include <boost/test/unit_test.hpp>
+#include <stdio.h>
+#include <time.h>
+#include <string>
+#include <vector>
+
+#define ITEMS 100000
+
+// the music extensions of CSettings
+static const char *MusicExtensions = ".nsv|.m4a|.flac|.aac|.strm|.pls|.rm|.rma|.mpa|.wav|.wma|.ogg|.mp3|.mp2|.m3u|.mod|.amf|.669|.dmf|.dsm|.far|.gdm|.imf|.it|.m15|.med|.okt|.s3m|.stm|.sfx|.ult|.uni|.xm|.sid|.ac3|.dts|.cue|.aif|.aiff|.wpl|.ape|.mac|.mpc|.mp+|.mpp|.shn|.zip|.rar|.wv|.nsf|.spc|.gym|.adx|.dsp|.adp|.ymf|.ast|.afc|.hps|.xsp|.xwav|.waa|.wvs|.wam|.gcm|.idsp|.mpdsp|.mss|.spt|.rsd|.mid|.kar|.sap|.cmc|.cmr|.dmc|.mpt|.mpd|.rmt|.tmc|.tm8|.tm2|.oga|.url|.pxml|.tta|.rss|.cm3|.cms|.dlt|.brstm|.wtv|.mka|.pfc|.sidstream|.oggstream|.nsfstream|.asapstream|.cdda";
+
+static std::string Extension(const std::string &path)
+{
+  std::string::size_type dot = path.rfind('.');
+  return dot == std::string::npos ? std::string() : path.substr(dot);
+}
+
+// how CFileItem::IsAudio() used to look the extension up
+static bool NaiveIsMusic(const std::string &extensions, const std::string &path)
+{
+  std::string extension = Extension(path);
+  if (extension.empty())
+    return false;
+  for (std::string::iterator it = extension.begin(); it != extension.end(); ++it)
+    *it = (char)tolower((unsigned char)*it);
+  return extensions.find(extension) != std::string::npos;
+}
+
+BOOST_AUTO_TEST_CASE(TestExtensionSetContains)
+{
+  CExtensionSet set(MusicExtensions);
+  BOOST_CHECK(set.Contains(".mp3"));
+  BOOST_CHECK(set.Contains(".FLAC"));
+  BOOST_CHECK(set.Contains(".cdda"));
+  BOOST_CHECK(set.Contains(".nsv"));
+  BOOST_CHECK(!set.Contains(".jpg"));
+  BOOST_CHECK(!set.Contains(""));
+  // whole extensions only, the list string also finds these
+  BOOST_CHECK(!set.Contains(".mp"));
+  BOOST_CHECK(!set.Contains(".cd"));
+
+  set.Set("|.a||.b|");
+  BOOST_CHECK(set.Contains(".a"));
+  BOOST_CHECK(set.Contains(".b"));
+  BOOST_CHECK(!set.Contains("|"));
+  BOOST_CHECK_EQUAL("|.a||.b|", set.GetSource());
+}
+
+BOOST_AUTO_TEST_CASE(TestExtensionSetClassify)
+{
+  const char *extensions[] = { ".mp3", ".flac", ".jpg", ".nfo", ".pfc", ".mka", ".txt", ".cdda" };
+  std::vector<std::string> paths;
+  char path[128];
+  for (int i = 0; i < ITEMS; i++)
+  {
+    sprintf(path, "pfc://%%2fmedia%%2fmusic%%2f%05d.pfc/cd1/%02d - track%s", i / 16, i % 16, extensions[i % 8]);
+    paths.push_back(path);
+  }
+
+  CExtensionSet set(MusicExtensions);
+  std::string list(MusicExtensions);
+  int naiveCount = 0, setCount = 0;
+  clock_t start = clock();
+  for (int i = 0; i < ITEMS; i++)
+    naiveCount += NaiveIsMusic(list, paths[i]);
+  double naive = (double)(clock() - start) / CLOCKS_PER_SEC;
+  start = clock();
+  for (int i = 0; i < ITEMS; i++)
+    setCount += set.Contains(Extension(paths[i]));
+  double compiled = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+  BOOST_CHECK_EQUAL(naiveCount, setCount);
+  BOOST_CHECK_EQUAL(ITEMS / 8 * 5, setCount);
+  BOOST_TEST_MESSAGE("classifying " << ITEMS << " items: extension set " << compiled << "s, list string " << naive << "s");
+}
@@ -0,0 +1,181 @@
+
+
+#include "utils/IndexedSequence.h"
+
+#include <boost/test/unit_test.hpp>
+#include <stdlib.h>
+#include <time.h>
+#include <vector>
+
+#define CHURN_ITEMS 10000
+#define CHURN_OPERATIONS 10000
+
+// the straightforward vector a playlist used to be, renumbering orders on every change
+class NaiveSequence
+{
+public:
+  void Insert(int position, int order, int value)
+  {
+    int size = (int)m_values.size();
+    if (position < 0 || position > size)
+      position = size;
+    if (order < 0 || order > size)
+      order = size;
+    for (unsigned int i = 0; i < m_orders.size(); i++)
+      if (m_orders[i] >= order)
+        m_orders[i]++;
+    m_values.insert(m_values.begin() + position, value);
+    m_orders.insert(m_orders.begin() + position, order);
+  }
+
+  void Erase(int position)
+  {
+    int order = m_orders[position];
+    m_values.erase(m_values.begin() + position);
+    m_orders.erase(m_orders.begin() + position);
+    for (unsigned int i = 0; i < m_orders.size(); i++)
+      if (m_orders[i] > order)
+        m_orders[i]--;
+  }
+
+  int FindOrder(int order) const
+  {
+    for (unsigned int i = 0; i < m_orders.size(); i++)
+      if (m_orders[i] == order)
+        return i;
+    return -1;
+  }
+
+  void Swap(int position1, int position2, bool swapOrders)
+  {
+    std::swap(m_values[position1], m_values[position2]);
+    if (!swapOrders)
+      std::swap(m_orders[position1], m_orders[position2]);
+  }
+
+  std::vector<int> m_values;
+  std::vector<int> m_orders;
+};
+
+static void CheckEqual(const CIndexedSequence<int> &sequence, const NaiveSequence &naive)
+{
+  BOOST_REQUIRE_EQUAL(sequence.Size(), (int)naive.m_values.size());
+  for (int i = 0; i < sequence.Size(); i++)
+  {
+    BOOST_REQUIRE_EQUAL(sequence.At(i), naive.m_values[i]);
+    BOOST_REQUIRE_EQUAL(sequence.OrderAt(i), naive.m_orders[i]);
+    BOOST_REQUIRE_EQUAL(sequence.FindOrder(i), naive.FindOrder(i));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestIndexedSequenceMatchesVector)
+{
+  CIndexedSequence<int> sequence;
+  NaiveSequence naive;
+  srand(1);
+  for (int i = 0; i < 5000; i++)
+  {
+    int size = sequence.Size();
+    int op = rand() % 10;
+    if (op < 5 || size < 2)
+    {
+      int position = rand() % (size + 2) - 1;
+      int order = rand() % (size + 2) - 1;
+      sequence.Insert(position, order, i);
+      naive.Insert(position, order, i);
+    }
+    else if (op < 8)
+    {
+      int position = rand() % size;
+      sequence.Erase(position);
+      naive.Erase(position);
+    }
+    else
+    {
+      int position1 = rand() % size, position2 = rand() % size;
+      bool swapOrders = (op == 8);
+      sequence.Swap(position1, position2, swapOrders);
+      naive.Swap(position1, position2, swapOrders);
+    }
+    if (i % 100 == 0)
+      CheckEqual(sequence, naive);
+  }
+  CheckEqual(sequence, naive);
+
+  // copies are independent of the original
+  CIndexedSequence<int> copy(sequence);
+  CheckEqual(copy, naive);
+  sequence.Clear();
+  CheckEqual(copy, naive);
+}
+
+BOOST_AUTO_TEST_CASE(TestIndexedSequenceShuffle)
+{
+  CIndexedSequence<int> sequence;
+  for (int i = 0; i < 100; i++)
+    sequence.Insert(-1, -1, i);
+
+  sequence.Shuffle(10);
+  for (int i = 0; i < 10; i++)
+    BOOST_CHECK_EQUAL(sequence.At(i), i);
+  for (int i = 0; i < 100; i++)
+    BOOST_CHECK_EQUAL(sequence.At(sequence.FindOrder(i)), i);
+
+  sequence.SortByOrder();
+  for (int i = 0; i < 100; i++)
+  {
+    BOOST_CHECK_EQUAL(sequence.At(i), i);
+    BOOST_CHECK_EQUAL(sequence.OrderAt(i), i);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestIndexedSequenceEntries)
+{
+  CIndexedSequence<int> sequence;
+  CIndexedSequence<int>::Entry *entry = NULL;
+  for (int i = 0; i < 50; i++)
+  {
+    CIndexedSequence<int>::Entry *inserted = sequence.Insert(-1, -1, i);
+    if (i == 25)
+      entry = inserted;
+  }
+  sequence.Erase(0);
+  sequence.Insert(0, 0, 100);
+  sequence.Insert(0, 0, 101);
+  BOOST_CHECK_EQUAL(sequence.PositionOf(entry), 26);
+  BOOST_CHECK_EQUAL(sequence.OrderOf(entry), 26);
+  BOOST_CHECK_EQUAL(entry->value, 25);
+}
+
+// queue churn as party mode does it: songs leave from the front, new ones go in anywhere
+template<class Sequence>
+static double Churn(Sequence &sequence)
+{
+  srand(2);
+  clock_t start = clock();
+  for (int i = 0; i < CHURN_OPERATIONS; i++)
+  {
+    sequence.Erase(0);
+    int position = rand() % CHURN_ITEMS;
+    sequence.Insert(position, position, i);
+    sequence.FindOrder(rand() % CHURN_ITEMS);
+  }
+  return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+BOOST_AUTO_TEST_CASE(TestIndexedSequenceChurn)
+{
+  CIndexedSequence<int> sequence;
+  NaiveSequence naive;
+  for (int i = 0; i < CHURN_ITEMS; i++)
+  {
+    sequence.Insert(-1, -1, i);
+    naive.Insert(-1, -1, i);
+  }
+
+  double indexed = Churn(sequence);
+  double vector = Churn(naive);
+  BOOST_TEST_MESSAGE("queue churn of " << CHURN_OPERATIONS << " changes at " << CHURN_ITEMS
+                     << " items: indexed " << indexed << "s, vector " << vector << "s");
+  CheckEqual(sequence, naive);
+}
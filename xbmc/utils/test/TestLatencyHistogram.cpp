@@ -0,0 +1,93 @@
+
+
+#include "utils/LatencyHistogram.h"
+
+#include <boost/test/unit_test.hpp>
+#include <boost/shared_array.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+
+#define SAMPLES 100000l
+#define NUMTHREADS 8l
+
+BOOST_AUTO_TEST_CASE(TestLatencyHistogramBuckets)
+{
+  CLatencyHistogram histogram;
+  histogram.Add(-5);
+  histogram.Add(0);
+  histogram.Add(1);
+  histogram.Add(3);
+  histogram.Add(1024);
+  histogram.Add((int64_t)1 << 40);
+
+  BOOST_CHECK_EQUAL(6l, histogram.Count());
+  BOOST_CHECK_EQUAL(2l, histogram.Bucket(0));
+  BOOST_CHECK_EQUAL(1l, histogram.Bucket(1));
+  BOOST_CHECK_EQUAL(1l, histogram.Bucket(2));
+  BOOST_CHECK_EQUAL(1l, histogram.Bucket(11));
+  BOOST_CHECK_EQUAL(1l, histogram.Bucket(CLatencyHistogram::BUCKETS - 1));
+
+  histogram.Reset();
+  BOOST_CHECK_EQUAL(0l, histogram.Count());
+  BOOST_CHECK_EQUAL(0l, histogram.Max());
+  BOOST_CHECK_EQUAL(0.0, histogram.Percentile(0.5));
+}
+
+BOOST_AUTO_TEST_CASE(TestLatencyHistogramPercentiles)
+{
+  CLatencyHistogram histogram;
+  for (long i = 1; i <= 1000; i++)
+    histogram.Add(i);
+
+  BOOST_CHECK_EQUAL(1000l, histogram.Max());
+  // estimates are within the bucket of the true value
+  double p50 = histogram.Percentile(0.5);
+  BOOST_CHECK(p50 >= 256 && p50 <= 1024);
+  double p99 = histogram.Percentile(0.99);
+  BOOST_CHECK(p99 >= 512 && p99 <= 1000);
+  BOOST_CHECK(histogram.Percentile(1.0) <= 1000);
+  BOOST_CHECK(p50 <= p99);
+}
+
+BOOST_AUTO_TEST_CASE(TestLatencyHistogramMerge)
+{
+  CLatencyHistogram first, second;
+  first.Add(1);
+  first.Add(1024);
+  second.Add(3);
+  second.Add(5000);
+
+  first.Merge(second);
+  BOOST_CHECK_EQUAL(4l, first.Count());
+  BOOST_CHECK_EQUAL(5000l, first.Max());
+  BOOST_CHECK_EQUAL(1l, first.Bucket(1));
+  BOOST_CHECK_EQUAL(1l, first.Bucket(2));
+  BOOST_CHECK_EQUAL(1l, first.Bucket(11));
+  BOOST_CHECK_EQUAL(1l, first.Bucket(13));
+  BOOST_CHECK_EQUAL(2l, second.Count());
+}
+
+void doAdd(CLatencyHistogram* histogram, long first)
+{
+  for (long i = 0; i < SAMPLES; i++)
+    histogram->Add(first + i % 5000);
+}
+
+BOOST_AUTO_TEST_CASE(TestLatencyHistogramConcurrent)
+{
+  CLatencyHistogram histogram;
+  boost::shared_array<boost::thread> t;
+  t.reset(new boost::thread[NUMTHREADS]);
+  for(size_t i=0; i<NUMTHREADS; i++)
+    t[i] = boost::thread(boost::bind(&doAdd,&histogram,(long)i * 1000));
+
+  for(size_t i=0; i<NUMTHREADS; i++)
+    t[i].join();
+
+  long total = 0;
+  for (int i = 0; i < CLatencyHistogram::BUCKETS; i++)
+    total += histogram.Bucket(i);
+  BOOST_CHECK_EQUAL(NUMTHREADS * SAMPLES, histogram.Count());
+  BOOST_CHECK_EQUAL(NUMTHREADS * SAMPLES, total);
+  BOOST_CHECK_EQUAL((NUMTHREADS - 1) * 1000 + 4999, histogram.Max());
+}
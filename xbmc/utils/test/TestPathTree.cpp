@@ -0,0 +1,148 @@
+
+
+#include "utils/PathTree.h"
+
+#include <boost/test/unit_test.hpp>
+#include <stdio.h>
+#include <time.h>
+#include <string>
+#include <vector>
+
+#define PACK_ENTRIES 5000
+#define LISTINGS 200
+
+static void Split(const std::string &path, std::vector<std::string> &tokens)
+{
+  std::string::size_type start = path.find_first_not_of('/');
+  while (start != std::string::npos)
+  {
+    std::string::size_type end = path.find('/', start);
+    tokens.push_back(path.substr(start, end == std::string::npos ? end : end - start));
+    start = end == std::string::npos ? end : path.find_first_not_of('/', end);
+  }
+}
+
+// how CPFCDirectory used to list a folder: split every entry and compare it against the folder
+static void NaiveList(const std::vector<std::string> &entries, const std::string &folder, std::vector<std::string> &listing)
+{
+  std::vector<std::string> base;
+  Split(folder, base);
+  for (unsigned int i = 0; i < entries.size(); i++)
+  {
+    std::vector<std::string> tokens;
+    Split(entries[i], tokens);
+    if (tokens.size() < base.size() + 1)
+      continue;
+    bool match = true;
+    std::string name;
+    for (unsigned int j = 0; j < base.size() && match; j++)
+    {
+      match = tokens[j] == base[j];
+      name += tokens[j] + "/";
+    }
+    if (!match)
+      continue;
+    name += tokens[base.size()];
+    if (tokens.size() > base.size() + 1 || entries[i][entries[i].size() - 1] == '/')
+    {
+      name += "/";
+      bool listed = false;
+      for (unsigned int j = 0; j < listing.size() && !listed; j++)
+        listed = listing[j] == name;
+      if (listed)
+        continue;
+    }
+    listing.push_back(name);
+  }
+}
+
+static void TreeList(const CPathTree &tree, const std::string &folder, std::vector<std::string> &listing)
+{
+  const CPathTree::Node *node = tree.FindFolder(folder);
+  if (!node)
+    return;
+  for (unsigned int i = 0; i < node->children.size(); i++)
+  {
+    const CPathTree::Node &child = tree.GetNode(node->children[i]);
+    listing.push_back(child.folder ? child.path + "/" : child.path);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestPathTreeFolders)
+{
+  CPathTree tree;
+  tree.Add("cover.jpg", 0);
+  tree.Add("cd1/01.mp3", 1);
+  tree.Add("cd1/02.mp3", 2);
+  tree.Add("/cd2//01.mp3", 3);
+  tree.Add("extras/", 4);
+  tree.Add("cd1/bonus/01.mp3", 5);
+
+  const CPathTree::Node *root = tree.FindFolder("");
+  BOOST_REQUIRE(root);
+  BOOST_REQUIRE_EQUAL(4u, root->children.size());
+  BOOST_CHECK_EQUAL("cover.jpg", tree.GetNode(root->children[0]).name);
+  BOOST_CHECK(!tree.GetNode(root->children[0]).folder);
+  BOOST_CHECK_EQUAL("cd1", tree.GetNode(root->children[1]).name);
+  BOOST_CHECK(tree.GetNode(root->children[1]).folder);
+  BOOST_CHECK_EQUAL(1, tree.GetNode(root->children[1]).value);
+  BOOST_CHECK_EQUAL("cd2", tree.GetNode(root->children[2]).name);
+  BOOST_CHECK_EQUAL("extras", tree.GetNode(root->children[3]).name);
+  BOOST_CHECK(tree.GetNode(root->children[3]).folder);
+
+  const CPathTree::Node *cd1 = tree.FindFolder("/cd1/");
+  BOOST_REQUIRE(cd1);
+  BOOST_REQUIRE_EQUAL(3u, cd1->children.size());
+  BOOST_CHECK_EQUAL("cd1/bonus", tree.GetNode(cd1->children[2]).path);
+  BOOST_CHECK_EQUAL("cd2/01.mp3", tree.GetNode(tree.FindFolder("cd2")->children[0]).path);
+  BOOST_CHECK(tree.FindFolder("extras")->children.empty());
+  BOOST_CHECK(tree.FindFolder("cd3") == NULL);
+  BOOST_CHECK(tree.FindFolder("cover.jpg") == NULL);
+}
+
+BOOST_AUTO_TEST_CASE(TestPathTreeMatchesNaive)
+{
+  // a pack of 50 albums of 2 discs of 50 tracks, plus a cover per album
+  std::vector<std::string> entries;
+  char name[64];
+  for (int i = 0; entries.size() < PACK_ENTRIES; i++)
+  {
+    int album = i / 101, track = i % 101;
+    if (track == 100)
+      sprintf(name, "album%02d/cover.jpg", album);
+    else
+      sprintf(name, "album%02d/cd%d/%02d.mp3", album, track / 50 + 1, track % 50);
+    entries.push_back(name);
+  }
+
+  CPathTree tree;
+  for (unsigned int i = 0; i < entries.size(); i++)
+    tree.Add(entries[i], i);
+
+  const char *folders[] = { "", "album07", "album07/cd2", "album49/cd1/", "missing" };
+  for (unsigned int i = 0; i < sizeof(folders) / sizeof(folders[0]); i++)
+  {
+    std::vector<std::string> naive, listed;
+    NaiveList(entries, folders[i], naive);
+    TreeList(tree, folders[i], listed);
+    BOOST_CHECK(naive == listed);
+  }
+
+  std::vector<std::string> listing;
+  clock_t start = clock();
+  for (int i = 0; i < LISTINGS; i++)
+  {
+    listing.clear();
+    NaiveList(entries, "album07/cd2", listing);
+  }
+  double naive = (double)(clock() - start) / CLOCKS_PER_SEC;
+  start = clock();
+  for (int i = 0; i < LISTINGS; i++)
+  {
+    listing.clear();
+    TreeList(tree, "album07/cd2", listing);
+  }
+  double indexed = (double)(clock() - start) / CLOCKS_PER_SEC;
+  BOOST_TEST_MESSAGE(LISTINGS << " listings of a folder in a " << PACK_ENTRIES << " entry pack: tree "
+                     << indexed << "s, tokenizing " << naive << "s");
+}
@@ -0,0 +1,179 @@
+
+
+#include "utils/Utf8Utils.h"
+
+#include <boost/test/unit_test.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <iconv.h>
+#include <string>
+#include <vector>
+
+#define NUMTHREADS 4
+#define CONVERSIONS 50000
+
+typedef std::basic_string<uint16_t> utf16string;
+
+// how CCharsetConverter converted UTF-8 to wchar_t before, in short
+static bool IconvToW(iconv_t handle, const std::string &source, std::wstring &dest)
+{
+  std::vector<wchar_t> buffer(source.size() + 1);
+  char *in = (char *)source.c_str();
+  char *out = (char *)&buffer[0];
+  size_t inBytes = source.size(), outBytes = buffer.size() * sizeof(wchar_t);
+  if (iconv(handle, &in, &inBytes, &out, &outBytes) == (size_t)-1)
+    return false;
+  iconv(handle, NULL, NULL, &out, &outBytes);
+  dest.assign(&buffer[0], (wchar_t *)out - &buffer[0]);
+  return true;
+}
+
+static const char *Titles[] =
+{
+  "Jingle Bells (Store Mix)",
+  "Caf\xc3\xa9 del Mar \xe2\x80\x93 Vol. 7",
+  "Sigur R\xc3\xb3s",
+  "\xe6\x9d\xb1\xe4\xba\xac\xe4\xba\x8b\xe5\x8f\x98",
+  "\xd0\x9a\xd0\xb8\xd0\xbd\xd0\xbe - \xd0\x93\xd1\x80\xd1\x83\xd0\xbf\xd0\xbf\xd0\xb0 \xd0\xba\xd1\x80\xd0\xbe\xd0\xb2\xd0\xb8",
+  "Music \xf0\x9d\x84\x9e for the holidays",
+  "01 - Promo loop 30s.mp3",
+  "",
+};
+
+BOOST_AUTO_TEST_CASE(TestUtf8UtilsAscii)
+{
+  char buf[64];
+  memset(buf, 'a', sizeof(buf));
+  BOOST_CHECK_EQUAL(64u, CUtf8Utils::AsciiLength(buf, sizeof(buf)));
+  for (size_t i = 0; i < sizeof(buf); i++)
+  {
+    buf[i] = (char)0xc3;
+    BOOST_CHECK_EQUAL(i, CUtf8Utils::AsciiLength(buf, sizeof(buf)));
+    // unaligned starts and short tails
+    BOOST_CHECK_EQUAL(i > 3 ? i - 3 : 0, CUtf8Utils::AsciiLength(buf + 3, i > 3 ? sizeof(buf) - 3 : 0));
+    buf[i] = 'a';
+  }
+  BOOST_CHECK(CUtf8Utils::IsAscii("", 0));
+}
+
+BOOST_AUTO_TEST_CASE(TestUtf8UtilsMatchesIconv)
+{
+  iconv_t handle = iconv_open("WCHAR_T", "UTF-8");
+  BOOST_REQUIRE(handle != (iconv_t)-1);
+  for (unsigned int i = 0; i < sizeof(Titles) / sizeof(Titles[0]); i++)
+  {
+    std::string title(Titles[i]);
+    std::wstring expected, decoded;
+    BOOST_REQUIRE(IconvToW(handle, title, expected));
+    BOOST_CHECK(CUtf8Utils::Decode(title.c_str(), title.size(), decoded));
+    BOOST_CHECK(expected == decoded);
+
+    std::string encoded;
+    BOOST_CHECK(CUtf8Utils::Encode(decoded.c_str(), decoded.size(), encoded));
+    BOOST_CHECK_EQUAL(title, encoded);
+
+    utf16string utf16;
+    BOOST_CHECK(CUtf8Utils::Decode(title.c_str(), title.size(), utf16));
+    BOOST_CHECK(CUtf8Utils::Encode(utf16.c_str(), utf16.size(), encoded));
+    BOOST_CHECK_EQUAL(title, encoded);
+  }
+  iconv_close(handle);
+
+  utf16string clef;
+  std::string gClef("\xf0\x9d\x84\x9e");
+  BOOST_REQUIRE(CUtf8Utils::Decode(gClef.c_str(), gClef.size(), clef));
+  BOOST_REQUIRE_EQUAL(2u, clef.size());
+  BOOST_CHECK_EQUAL(0xd834, clef[0]);
+  BOOST_CHECK_EQUAL(0xdd1e, clef[1]);
+}
+
+BOOST_AUTO_TEST_CASE(TestUtf8UtilsRejects)
+{
+  const char *invalid[] =
+  {
+    "\xc0\x80",         // overlong null
+    "\xe0\x80\xaf",     // overlong slash
+    "\xed\xa0\x80",     // surrogate
+    "\xf4\x90\x80\x80", // past U+10FFFF
+    "\xf8\x88\x80\x80\x80",
+    "abc\xe2\x82",      // cut short
+    "\x80",
+    "\xc3(",
+  };
+  std::wstring dest;
+  for (unsigned int i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++)
+    BOOST_CHECK(!CUtf8Utils::Decode(invalid[i], strlen(invalid[i]), dest));
+
+  std::string encoded;
+  uint32_t surrogate[] = { 'a', 0xd800 };
+  BOOST_CHECK(!CUtf8Utils::Encode(surrogate, 2, encoded));
+  uint32_t beyond[] = { 0x110000 };
+  BOOST_CHECK(!CUtf8Utils::Encode(beyond, 1, encoded));
+  uint16_t unpaired[] = { 0xd834, 'a' };
+  BOOST_CHECK(!CUtf8Utils::Encode(unpaired, 2, encoded));
+}
+
+static boost::mutex sharedLock;
+static iconv_t sharedHandle;
+
+static void SharedHandle(long *failures)
+{
+  std::wstring dest;
+  for (int i = 0; i < CONVERSIONS; i++)
+  {
+    boost::mutex::scoped_lock lock(sharedLock);
+    if (!IconvToW(sharedHandle, Titles[i % 8], dest))
+      (*failures)++;
+  }
+}
+
+static void OwnHandle(long *failures)
+{
+  iconv_t handle = iconv_open("WCHAR_T", "UTF-8");
+  std::wstring dest;
+  for (int i = 0; i < CONVERSIONS; i++)
+  {
+    if (!IconvToW(handle, Titles[i % 8], dest))
+      (*failures)++;
+  }
+  iconv_close(handle);
+}
+
+static void Codec(long *failures)
+{
+  std::wstring dest;
+  for (int i = 0; i < CONVERSIONS; i++)
+  {
+    const char *title = Titles[i % 8];
+    if (!CUtf8Utils::Decode(title, strlen(title), dest))
+      (*failures)++;
+  }
+}
+
+static double Run(void (*convert)(long *))
+{
+  long failures[NUMTHREADS] = {};
+  boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+  boost::thread_group threads;
+  for (int i = 0; i < NUMTHREADS; i++)
+    threads.create_thread(boost::bind(convert, &failures[i]));
+  threads.join_all();
+  boost::posix_time::time_duration elapsed = boost::posix_time::microsec_clock::universal_time() - start;
+  for (int i = 0; i < NUMTHREADS; i++)
+    BOOST_CHECK_EQUAL(0, failures[i]);
+  return elapsed.total_microseconds() / 1000000.0;
+}
+
+BOOST_AUTO_TEST_CASE(TestUtf8UtilsContention)
+{
+  sharedHandle = iconv_open("WCHAR_T", "UTF-8");
+  BOOST_REQUIRE(sharedHandle != (iconv_t)-1);
+  double shared = Run(SharedHandle);
+  iconv_close(sharedHandle);
+  double own = Run(OwnHandle);
+  double codec = Run(Codec);
+  BOOST_TEST_MESSAGE(NUMTHREADS << " threads converting " << CONVERSIONS << " titles each: one locked iconv handle "
+                     << shared << "s, a handle per thread " << own << "s, without iconv " << codec << "s");
+}
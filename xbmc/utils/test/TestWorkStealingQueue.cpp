@@ -0,0 +1,182 @@
+
+
+#include "utils/WorkStealingQueue.h"
+#include "utils/LatencyHistogram.h"
+#include "threads/Event.h"
+
+#include <boost/test/unit_test.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <deque>
+#include <vector>
+
+#define WORKERS 4
+#define LANES 3
+#define JOBS 200000
+
+static int64_t Now()
+{
+  static const boost::posix_time::ptime epoch = boost::posix_time::microsec_clock::universal_time();
+  return (boost::posix_time::microsec_clock::universal_time() - epoch).total_microseconds();
+}
+
+struct Refuse
+{
+  bool operator()() const { return false; }
+};
+
+BOOST_AUTO_TEST_CASE(TestWorkStealingQueueOrder)
+{
+  CWorkStealingQueue<int> queue(2, LANES);
+  int item;
+  BOOST_CHECK(!queue.Pop(0, 0, item));
+  queue.Push(0, 0, 1);
+  queue.Push(0, 0, 2);
+  queue.Push(0, 1, 3);
+  queue.Push(0, 0, 4, true);
+  BOOST_CHECK_EQUAL(3, queue.Stealable(0));
+
+  // pinned first, then the oldest of our own
+  BOOST_REQUIRE(queue.Pop(0, 0, item));
+  BOOST_CHECK_EQUAL(4, item);
+  BOOST_REQUIRE(queue.Pop(0, 0, item));
+  BOOST_CHECK_EQUAL(1, item);
+
+  // slot 1 steals the oldest, lane by lane
+  BOOST_REQUIRE(queue.Pop(1, 1, item));
+  BOOST_CHECK_EQUAL(3, item);
+  BOOST_CHECK(!queue.Pop(1, 1, item));
+  BOOST_CHECK(!queue.Pop(1, 0, item, Refuse()));
+  BOOST_REQUIRE(queue.Pop(1, 0, item));
+  BOOST_CHECK_EQUAL(2, item);
+  BOOST_CHECK(queue.Empty(0));
+  BOOST_CHECK_EQUAL(0, queue.Stealable(0));
+}
+
+BOOST_AUTO_TEST_CASE(TestWorkStealingQueuePinnedAndRemove)
+{
+  CWorkStealingQueue<int> queue(2, LANES);
+  int item;
+  queue.Push(0, 2, 1, true);
+  queue.Push(0, 2, 2);
+  queue.Push(0, 2, 3);
+  BOOST_CHECK_EQUAL(2, queue.Stealable(0));
+
+  // pinned items are never stolen
+  BOOST_REQUIRE(queue.Pop(1, 2, item));
+  BOOST_CHECK_EQUAL(2, item);
+  BOOST_CHECK(queue.Remove(0, 3));
+  BOOST_CHECK(!queue.Remove(0, 3));
+  BOOST_CHECK(!queue.Pop(1, 2, item));
+  BOOST_CHECK(!queue.Empty(0));
+
+  std::vector<int> drained;
+  queue.Drain(drained);
+  BOOST_REQUIRE_EQUAL(1u, drained.size());
+  BOOST_CHECK_EQUAL(1, drained[0]);
+  BOOST_CHECK(queue.Empty(0));
+}
+
+// how CJobManager queued jobs before: a queue per priority behind one lock, one event for all workers
+class CSharedQueue
+{
+public:
+  void Push(unsigned int lane, int64_t item)
+  {
+    {
+      CSingleLock lock(m_section);
+      m_lanes[lane].push_back(item);
+    }
+    m_event.Set();
+  }
+  bool Pop(unsigned int, int64_t &item)
+  {
+    CSingleLock lock(m_section);
+    for (int lane = LANES - 1; lane >= 0; lane--)
+    {
+      if (!m_lanes[lane].empty())
+      {
+        item = m_lanes[lane].front();
+        m_lanes[lane].pop_front();
+        return true;
+      }
+    }
+    return false;
+  }
+  void Wait(unsigned int) { m_event.WaitMSec(10); }
+private:
+  CCriticalSection m_section;
+  CEvent m_event;
+  std::deque<int64_t> m_lanes[LANES];
+};
+
+class CStealingQueue
+{
+public:
+  CStealingQueue() : m_queue(WORKERS, LANES), m_next(0) {}
+  void Push(unsigned int lane, int64_t item)
+  {
+    unsigned int slot = m_next++ % WORKERS;
+    m_queue.Push(slot, lane, item);
+    m_events[slot].Set();
+  }
+  bool Pop(unsigned int slot, int64_t &item)
+  {
+    for (int lane = LANES - 1; lane >= 0; lane--)
+    {
+      if (m_queue.Pop(slot, lane, item))
+        return true;
+    }
+    return false;
+  }
+  void Wait(unsigned int slot) { m_events[slot].WaitMSec(10); }
+private:
+  CWorkStealingQueue<int64_t> m_queue;
+  CEvent m_events[WORKERS];
+  unsigned int m_next;
+};
+
+template<class QUEUE>
+static void Work(QUEUE *queue, unsigned int slot, volatile long *done, CLatencyHistogram *latency)
+{
+  while (*done < JOBS)
+  {
+    int64_t queued;
+    if (queue->Pop(slot, queued))
+    {
+      latency->Add(Now() - queued);
+      AtomicIncrement(done);
+    }
+    else
+      queue->Wait(slot);
+  }
+}
+
+template<class QUEUE>
+static double Run(CLatencyHistogram &latency)
+{
+  QUEUE queue;
+  volatile long done = 0;
+  int64_t start = Now();
+  boost::thread_group threads;
+  for (unsigned int i = 0; i < WORKERS; i++)
+    threads.create_thread(boost::bind(&Work<QUEUE>, &queue, i, &done, &latency));
+  for (int i = 0; i < JOBS; i++)
+    queue.Push(i % LANES, Now());
+  threads.join_all();
+  BOOST_CHECK_EQUAL(JOBS, done);
+  return JOBS / ((Now() - start) / 1000000.0);
+}
+
+BOOST_AUTO_TEST_CASE(TestWorkStealingQueueThroughput)
+{
+  CLatencyHistogram shared, stealing;
+  double sharedRate = Run<CSharedQueue>(shared);
+  double stealingRate = Run<CStealingQueue>(stealing);
+  BOOST_CHECK_EQUAL(JOBS, (int)stealing.Count());
+  BOOST_TEST_MESSAGE(WORKERS << " workers, " << JOBS << " jobs: one locked queue " << (long)sharedRate
+                     << " jobs/s (queued p50 " << shared.Percentile(0.5) << "us, p99 " << shared.Percentile(0.99)
+                     << "us), a queue per worker " << (long)stealingRate << " jobs/s (p50 " << stealing.Percentile(0.5)
+                     << "us, p99 " << stealing.Percentile(0.99) << "us)");
+}
@@ -5,6 +5,7 @@
 
 #include "WinSystemX11GL.h"
 #include "utils/log.h"
+#include <math.h>
 
 CWinSystemX11GL::CWinSystemX11GL()
 {
@@ -14,6 +15,7 @@ CWinSystemX11GL::CWinSystemX11GL()
   m_glXSwapIntervalMESA  = NULL;
   m_glXGetSyncValuesOML  = NULL;
   m_glXSwapBuffersMscOML = NULL;
+  m_glXCopySubBufferMESA = NULL;
 
   m_iVSyncErrors = 0;
 }
@@ -221,7 +223,35 @@ bool CWinSystemX11GL::CreateNewWindow(const CStdString& name, bool fullScreen, R
   else
     m_glXSwapIntervalMESA = NULL;
 
+  if (IsExtSupported("GLX_MESA_copy_sub_buffer"))
+    m_glXCopySubBufferMESA = (void (*)(Display*, GLXDrawable, int, int, int, int))glXGetProcAddress((const GLubyte*)"glXCopySubBufferMESA");
+  else
+    m_glXCopySubBufferMESA = NULL;
+
+  return true;
+}
 
+bool CWinSystemX11GL::CanPresentPartially() const
+{
+  return m_glXCopySubBufferMESA != NULL;
+}
+
+bool CWinSystemX11GL::PresentPartial(const CDirtyRegionList& dirty)
+{
+  if (!m_glXCopySubBufferMESA || !m_bRenderCreated)
+    return PresentRender(dirty);
+
+  // the regions are in screen coordinates, top down, while GLX counts from the bottom
+  for (CDirtyRegionList::const_iterator i = dirty.begin(); i != dirty.end(); i++)
+  {
+    CRect region(*i);
+    region.Intersect(CRect(0, 0, (float)m_nWidth, (float)m_nHeight));
+    if (region.IsEmpty())
+      continue;
+    int x = (int)region.x1, y = (int)region.y1;
+    int w = (int)ceil(region.x2) - x, h = (int)ceil(region.y2) - y;
+    m_glXCopySubBufferMESA(m_dpy, m_glWindow, x, m_nHeight - y - h, w, h);
+  }
   return true;
 }
 
@@ -19,6 +19,9 @@ public:
 
   virtual bool IsExtSupported(const char* extension);
 
+  virtual bool CanPresentPartially() const;
+  virtual bool PresentPartial(const CDirtyRegionList& dirty);
+
 protected:
   virtual bool PresentRenderImpl(const CDirtyRegionList& dirty);
   virtual void SetVSyncImpl(bool enable);
@@ -33,6 +36,8 @@ protected:
   Bool    (*m_glXGetSyncValuesOML)(Display* dpy, GLXDrawable drawable, int64_t* ust, int64_t* msc, int64_t* sbc);
   int64_t (*m_glXSwapBuffersMscOML)(Display* dpy, GLXDrawable drawable, int64_t target_msc, int64_t divisor,int64_t remainder);
 
+  void (*m_glXCopySubBufferMESA)(Display* dpy, GLXDrawable drawable, int x, int y, int width, int height);
+
   int m_iVSyncErrors;
 };
 
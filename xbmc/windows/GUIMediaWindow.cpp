@@ -2,6 +2,7 @@
 
 #include "threads/SystemClock.h"
 #include "GUIMediaWindow.h"
+#include "BackgroundInfoLoader.h"
 #include "GUIUserMessages.h"
 #include "Util.h"
 #include "PlayListPlayer.h"
@@ -140,6 +141,27 @@ void CGUIMediaWindow::OnWindowUnload()
   m_viewControl.Reset();
 }
 
+void CGUIMediaWindow::FrameMove()
+{
+  // follow the scrolling with the loading
+  bool hasRange = false;
+  int first = 0, last = 0;
+  for (unsigned int i = 0; i < m_backgroundLoaders.size(); i++)
+  {
+    if (!m_backgroundLoaders[i]->IsLoading())
+      continue;
+    if (!hasRange && !(hasRange = m_viewControl.GetVisibleRange(first, last)))
+      break;
+    m_backgroundLoaders[i]->SetVisibleRange(*m_vecItems, first, last);
+  }
+  CGUIWindow::FrameMove();
+}
+
+void CGUIMediaWindow::AddBackgroundLoader(CBackgroundInfoLoader *loader)
+{
+  m_backgroundLoaders.push_back(loader);
+}
+
 CFileItemPtr CGUIMediaWindow::GetCurrentListItem(int offset)
 {
   int item = m_viewControl.GetSelectedItem();
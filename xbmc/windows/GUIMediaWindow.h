@@ -9,6 +9,7 @@
 #include "dialogs/GUIDialogContextMenu.h"
 
 class CFileItemList;
+class CBackgroundInfoLoader;
 
 // base class for all media windows
 class CGUIMediaWindow : public CGUIWindow
@@ -22,6 +23,7 @@ public:
   virtual void OnWindowLoaded();
   virtual void OnWindowUnload();
   virtual void OnInitWindow();
+  virtual void FrameMove();
   virtual bool IsMediaWindow() const { return true; };
   const CFileItemList &CurrentDirectory() const;
   int GetViewContainerID() const { return m_viewControl.GetCurrentControl(); };
@@ -94,6 +96,11 @@ protected:
 protected:
   bool WaitForNetwork() const;
 
+  /*! \brief Have a loader of the window's items load the items on screen first.
+   \param loader loader that lives as long as the window.
+   */
+  void AddBackgroundLoader(CBackgroundInfoLoader *loader);
+
   /*! \brief Translate the folder to start in from the given quick path
    \param dir the folder the user wants
    \return the resulting path */
@@ -116,4 +123,6 @@ protected:
   int m_iLastControl;
   int m_iSelectedItem;
   CStdString m_startDirectory;
+
+  std::vector<CBackgroundInfoLoader*> m_backgroundLoaders;
 };
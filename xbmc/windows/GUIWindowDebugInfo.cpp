@@ -13,6 +13,7 @@
 #include "guilib/GUITextLayout.h"
 #include "guilib/GUIWindowManager.h"
 #include "guilib/GUIControlProfiler.h"
+#include "guilib/TextureManager.h"
 #include "GUIInfoManager.h"
 #include "utils/Variant.h"
 
@@ -81,7 +82,7 @@ void CGUIWindowDebugInfo::Process(unsigned int currentTime, CDirtyRegionList &di
     MEMORYSTATUSEX stat;
     stat.dwLength = sizeof(MEMORYSTATUSEX);
     GlobalMemoryStatusEx(&stat);
-    CStdString profiling = CGUIControlProfiler::IsRunning() ? " (profiling)" : "";
+    CStdString profiling = CGUIControlProfiler::IsRunning() || CGUIControlProfiler::IsSampling() ? " (profiling)" : "";
     CStdString strCores = g_cpuInfo.GetCoresUsageString();
 #if !defined(_LINUX)
     info.Format("LOG: %sraven.log\nMEM: %"PRIu64"/%"PRIu64" KB - FPS: %2.1f fps\nCPU: %s%s", g_settings.m_logFolder.c_str(),
@@ -91,6 +92,11 @@ void CGUIWindowDebugInfo::Process(unsigned int currentTime, CDirtyRegionList &di
     info.Format("LOG: %sraven.log\nMEM: %"PRIu64"/%"PRIu64" KB - FPS: %2.1f fps\nCPU: %s (CPU-XBMC %4.2f%%%s)", g_settings.m_logFolder.c_str(),
                 stat.ullAvailPhys/1024, stat.ullTotalPhys/1024, g_infoManager.GetFPS(), strCores.c_str(), dCPU, profiling.c_str());
 #endif
+    info.AppendFormat("\nTEX: %u KB resident - %u hits / %u misses", g_TextureManager.GetResidentMemory() / 1024,
+                      g_TextureManager.GetCacheHits(), g_TextureManager.GetCacheMisses());
+    info.AppendFormat("\nINFO: %u conditions evaluated", g_infoManager.GetConditionEvaluations());
+    info.AppendFormat("\nGUI: %2.0f%% of the screen rendered a frame - %2.0f%% idle frames",
+                      g_windowManager.GetRenderedArea() * 100, g_windowManager.GetIdleFrames() * 100);
   }
 
   // render the skin debug info
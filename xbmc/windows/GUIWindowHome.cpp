@@ -16,8 +16,13 @@ CGUIWindowHome::CGUIWindowHome(void) : CGUIWindow(WINDOW_HOME, "Home.xml"),
                                        m_cumulativeUpdateFlag(0)
 {
   m_updateRA = (Audio | Video | Totals);
-  
-  CAnnouncementManager::AddAnnouncer(this);
+
+  // only library updates matter here. Not coalesced: a playcount update would take the place
+  // of a library update queued before it, and the refresh would be lost. A burst is cheap
+  // anyway, as the refreshes asked for while one runs are merged in AddRecentlyAddedJobs.
+  CAnnouncerOptions options("home window", VideoLibrary | AudioLibrary);
+  options.async = true;
+  CAnnouncementManager::AddAnnouncer(this, options);
 }
 
 CGUIWindowHome::~CGUIWindowHome(void)